@@ -0,0 +1,105 @@
+//! Black-Scholes 체인 계산: 옵션별 메서드 반복 vs fused 일괄 커널
+//! Monte Carlo 경로 의존 정산: 경로 수별 견적 지연
+//!
+//! `cargo bench -p btcfi-calculation --bench pricing`
+
+use btcfi_calculation::{
+    BarrierKind, BlackScholesPricing, ChainGreeks, MonteCarloPricing, OptionChain,
+    OptionParameters, Payoff, PricingEngine,
+};
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+
+const SPOT: f64 = 70_000.0;
+const RISK_FREE_RATE: f64 = 0.05;
+
+/// 기본 `price_chain` 구현(옵션별 메서드 반복)을 쓰는 엔진
+struct PerOption(BlackScholesPricing);
+
+impl PricingEngine for PerOption {
+    fn calculate_option_price(&self, params: &OptionParameters) -> f64 {
+        self.0.calculate_option_price(params)
+    }
+    fn calculate_delta(&self, params: &OptionParameters) -> f64 {
+        self.0.calculate_delta(params)
+    }
+    fn calculate_gamma(&self, params: &OptionParameters) -> f64 {
+        self.0.calculate_gamma(params)
+    }
+    fn calculate_vega(&self, params: &OptionParameters) -> f64 {
+        self.0.calculate_vega(params)
+    }
+    fn calculate_theta(&self, params: &OptionParameters) -> f64 {
+        self.0.calculate_theta(params)
+    }
+    fn calculate_rho(&self, params: &OptionParameters) -> f64 {
+        self.0.calculate_rho(params)
+    }
+}
+
+/// 행사가 ±20% x 만기 1~90일 격자 (`size`개)
+fn chain(size: usize) -> OptionChain {
+    let expiries = 16;
+    let strikes: Vec<f64> = (0..size / expiries)
+        .map(|i| SPOT * (0.8 + 0.4 * i as f64 / (size / expiries) as f64))
+        .collect();
+    let times: Vec<f64> = (0..expiries)
+        .map(|i| (1.0 + 89.0 * i as f64 / (expiries - 1) as f64) / 365.0)
+        .collect();
+    OptionChain::grid(&strikes, &times, 0.6)
+}
+
+fn bench_price_chain(c: &mut Criterion) {
+    let per_option = PerOption(BlackScholesPricing::new());
+    let fused = BlackScholesPricing::new();
+
+    let mut group = c.benchmark_group("pricing/price_chain");
+    for size in [64, 1_024, 16_384] {
+        let chain = chain(size);
+        let mut out = ChainGreeks::default();
+        group.throughput(Throughput::Elements(chain.len() as u64));
+        group.bench_with_input(BenchmarkId::new("per_option", size), &chain, |b, chain| {
+            b.iter(|| per_option.price_chain(black_box(SPOT), RISK_FREE_RATE, chain, &mut out));
+        });
+        group.bench_with_input(BenchmarkId::new("fused", size), &chain, |b, chain| {
+            b.iter(|| fused.price_chain(black_box(SPOT), RISK_FREE_RATE, chain, &mut out));
+        });
+    }
+    group.finish();
+}
+
+fn bench_monte_carlo(c: &mut Criterion) {
+    let params = OptionParameters {
+        spot: SPOT,
+        strike: SPOT,
+        time_to_expiry: 30.0 / 365.0,
+        volatility: 0.6,
+        risk_free_rate: RISK_FREE_RATE,
+        is_call: true,
+    };
+    let payoffs = [
+        ("european", Payoff::European),
+        ("asian", Payoff::AsianArithmetic),
+        (
+            "up_and_out",
+            Payoff::Barrier {
+                kind: BarrierKind::UpAndOut,
+                level: SPOT * 1.2,
+            },
+        ),
+    ];
+
+    let mut group = c.benchmark_group("pricing/monte_carlo");
+    for paths in [4_096, 65_536] {
+        let engine = MonteCarloPricing::new(paths, 64);
+        group.throughput(Throughput::Elements(paths as u64));
+        for (name, payoff) in payoffs {
+            group.bench_with_input(BenchmarkId::new(name, paths), &payoff, |b, &payoff| {
+                b.iter(|| engine.price(black_box(&params), payoff));
+            });
+        }
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_price_chain, bench_monte_carlo);
+criterion_main!(benches);
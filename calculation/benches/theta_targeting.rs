@@ -0,0 +1,103 @@
+//! Target theta IV 역산 수렴 비용 (cold start vs warm start, 체인 일괄)
+//!
+//! `cargo bench -p btcfi-calculation --bench theta_targeting`
+
+use btcfi_calculation::{
+    BlackScholesPricing, OptionParameters, PricingEngine, ThetaTarget, ThetaTargetingEngine,
+};
+use criterion::{
+    black_box, criterion_group, criterion_main, BatchSize, BenchmarkId, Criterion, Throughput,
+};
+
+const SPOT: f64 = 70_000.0;
+const RISK_FREE_RATE: f64 = 0.05;
+
+/// 변동성 60%의 일일 theta를 목표로 함 - 항상 도달 가능
+fn target(strike: f64, days: u32, is_call: bool) -> ThetaTarget {
+    let time_to_expiry = days as f64 / 365.0;
+    let params = OptionParameters {
+        spot: SPOT,
+        strike,
+        time_to_expiry,
+        volatility: 0.6,
+        risk_free_rate: RISK_FREE_RATE,
+        is_call,
+    };
+    ThetaTarget {
+        strike,
+        time_to_expiry,
+        is_call,
+        target_theta: BlackScholesPricing::new().calculate_theta(&params) / 365.0,
+    }
+}
+
+/// 행사가 ±10% x 만기 7~90일 체인 (콜/풋 번갈아)
+fn targets(size: usize) -> Vec<ThetaTarget> {
+    (0..size)
+        .map(|i| {
+            let strike = SPOT * (0.9 + 0.2 * (i % 32) as f64 / 32.0);
+            let days = 7 + ((i / 32) % 84) as u32;
+            target(strike, days, i % 2 == 0)
+        })
+        .collect()
+}
+
+fn bench_single(c: &mut Criterion) {
+    let target = target(72_000.0, 30, true);
+    let solve = |engine: &ThetaTargetingEngine, spot: f64| {
+        engine.find_iv_for_target_theta(
+            spot,
+            target.strike,
+            target.time_to_expiry,
+            RISK_FREE_RATE,
+            target.is_call,
+            target.target_theta,
+        )
+    };
+
+    let mut group = c.benchmark_group("theta_targeting/find_iv");
+    group.bench_function("cold", |b| {
+        b.iter_batched(
+            ThetaTargetingEngine::new,
+            |engine| solve(&engine, black_box(SPOT)),
+            BatchSize::SmallInput,
+        );
+    });
+
+    // 다음 tick: 직전 해에서 시작, 현물가는 조금씩 움직임
+    let engine = ThetaTargetingEngine::new();
+    solve(&engine, SPOT).unwrap();
+    let mut tick = 0u32;
+    group.bench_function("warm", |b| {
+        b.iter(|| {
+            tick = tick.wrapping_add(1);
+            solve(&engine, black_box(SPOT + (tick % 16) as f64 * 5.0))
+        });
+    });
+    group.finish();
+}
+
+fn bench_chain(c: &mut Criterion) {
+    let mut group = c.benchmark_group("theta_targeting/find_iv_chain");
+    for size in [256, 4_096] {
+        let targets = targets(size);
+        group.throughput(Throughput::Elements(size as u64));
+        group.bench_with_input(BenchmarkId::new("cold", size), &targets, |b, targets| {
+            b.iter_batched(
+                ThetaTargetingEngine::new,
+                |engine| engine.find_iv_chain(black_box(SPOT), RISK_FREE_RATE, targets),
+                BatchSize::SmallInput,
+            );
+        });
+
+        let engine = ThetaTargetingEngine::new();
+        engine.find_iv_chain(SPOT, RISK_FREE_RATE, &targets);
+        group.bench_with_input(BenchmarkId::new("warm", size), &targets, |b, targets| {
+            b.iter(|| engine.find_iv_chain(black_box(SPOT + 5.0), RISK_FREE_RATE, targets));
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_single, bench_chain);
+criterion_main!(benches);
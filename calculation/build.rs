@@ -0,0 +1,4 @@
+fn main() -> Result<(), Box<dyn std::error::Error>> {
+    tonic_build::compile_protos("../proto/oracle.proto")?;
+    Ok(())
+}
\ No newline at end of file
@@ -0,0 +1,356 @@
+//! 옵션 체인 일괄 Black-Scholes 계산
+//!
+//! 옵션 하나당 `ln` 1회, `sqrt` 1회, `exp` 2회로 콜/풋 가격과 모든 Greeks를 계산한다.
+//! φ(d2)는 φ(d1)·S/(K·e^(-rT)) 항등식으로, N(x)는 이미 구한 φ(x)를 재사용하는
+//! 다항식 근사로 구하므로 `erf` 호출이 없다.
+//!
+//! 루프 본문은 분기 없는 산술과 비트 연산만 사용하므로(`exp`/`ln`도 다항식 근사)
+//! stable 컴파일러의 자동 벡터화 대상이 된다. 만기가 지난 옵션은 루프 뒤에 따로 보정한다.
+
+use crate::models::{ChainGreeks, OptionChain};
+
+/// 1/√(2π)
+const INV_SQRT_2PI: f64 = 0.398_942_280_401_432_7;
+/// 만기 0인 행이 0으로 나누지 않도록 하는 하한 (결과는 이후 내재가치로 덮어씀)
+const MIN_TIME_TO_EXPIRY: f64 = 1e-12;
+
+/// 옵션 체인 전체 계산 - 결과는 `out`에 기록 (버퍼 재사용)
+pub fn black_scholes_chain(
+    spot: f64,
+    risk_free_rate: f64,
+    chain: &OptionChain,
+    out: &mut ChainGreeks,
+) {
+    let n = chain.len();
+    out.resize(n);
+
+    // 모든 슬라이스 길이를 n으로 맞춰 루프 안 경계 검사 제거
+    let strikes = &chain.strikes[..n];
+    let times = &chain.time_to_expiry[..n];
+    let vols = &chain.volatility[..n];
+    let ChainGreeks {
+        call_price,
+        put_price,
+        call_delta,
+        put_delta,
+        gamma,
+        vega,
+        call_theta,
+        put_theta,
+        call_rho,
+        put_rho,
+    } = out;
+    let (call_price, put_price) = (&mut call_price[..n], &mut put_price[..n]);
+    let (call_delta, put_delta) = (&mut call_delta[..n], &mut put_delta[..n]);
+    let (gamma, vega) = (&mut gamma[..n], &mut vega[..n]);
+    let (call_theta, put_theta) = (&mut call_theta[..n], &mut put_theta[..n]);
+    let (call_rho, put_rho) = (&mut call_rho[..n], &mut put_rho[..n]);
+
+    let r = risk_free_rate;
+    for i in 0..n {
+        let strike = strikes[i];
+        let t = times[i].max(MIN_TIME_TO_EXPIRY);
+        let vol = vols[i];
+
+        let sqrt_t = t.sqrt();
+        let vol_sqrt_t = vol * sqrt_t;
+        let d1 = (ln(spot / strike) + (r + 0.5 * vol * vol) * t) / vol_sqrt_t;
+        let d2 = d1 - vol_sqrt_t;
+
+        let discount = exp(-r * t);
+        let strike_pv = strike * discount;
+        let pdf_d1 = INV_SQRT_2PI * exp(-0.5 * d1 * d1);
+        let pdf_d2 = pdf_d1 * spot / strike_pv;
+
+        let (n_d1, n_neg_d1) = normal_cdf_pair(d1, pdf_d1);
+        let (n_d2, n_neg_d2) = normal_cdf_pair(d2, pdf_d2);
+
+        call_price[i] = spot * n_d1 - strike_pv * n_d2;
+        put_price[i] = strike_pv * n_neg_d2 - spot * n_neg_d1;
+        call_delta[i] = n_d1;
+        put_delta[i] = n_d1 - 1.0;
+        gamma[i] = pdf_d1 / (spot * vol_sqrt_t);
+        vega[i] = spot * pdf_d1 * sqrt_t / 100.0;
+
+        let time_decay = -(spot * pdf_d1 * vol) / (2.0 * sqrt_t);
+        call_theta[i] = (time_decay - r * strike_pv * n_d2) / 365.0;
+        put_theta[i] = (time_decay + r * strike_pv * n_neg_d2) / 365.0;
+        call_rho[i] = strike_pv * t * n_d2 / 100.0;
+        put_rho[i] = -strike_pv * t * n_neg_d2 / 100.0;
+    }
+
+    // 만기 도래 옵션 - 스칼라 엔진과 같은 내재가치/계단 델타
+    for i in 0..n {
+        if times[i] > 0.0 {
+            continue;
+        }
+        let strike = strikes[i];
+        call_price[i] = (spot - strike).max(0.0);
+        put_price[i] = (strike - spot).max(0.0);
+        call_delta[i] = if spot > strike { 1.0 } else { 0.0 };
+        put_delta[i] = if spot < strike { -1.0 } else { 0.0 };
+        gamma[i] = 0.0;
+        vega[i] = 0.0;
+        call_theta[i] = 0.0;
+        put_theta[i] = 0.0;
+        call_rho[i] = 0.0;
+        put_rho[i] = 0.0;
+    }
+}
+
+/// (N(x), N(-x)) - φ(x)를 받아 Abramowitz & Stegun 26.2.17 근사 (절대 오차 < 7.5e-8)
+///
+/// 꼬리 확률을 직접 계산하므로 1 - N(x)의 상쇄 오차가 없다.
+#[inline(always)]
+fn normal_cdf_pair(x: f64, pdf: f64) -> (f64, f64) {
+    const P: f64 = 0.231_641_9;
+    const B1: f64 = 0.319_381_530;
+    const B2: f64 = -0.356_563_782;
+    const B3: f64 = 1.781_477_937;
+    const B4: f64 = -1.821_255_978;
+    const B5: f64 = 1.330_274_429;
+
+    let k = 1.0 / (1.0 + P * x.abs());
+    let tail = pdf * k * (B1 + k * (B2 + k * (B3 + k * (B4 + k * B5))));
+    let upper = 1.0 - tail;
+    if x >= 0.0 {
+        (upper, tail)
+    } else {
+        (tail, upper)
+    }
+}
+
+/// c[0] + x·(c[1] + x·(c[2] + ...)) - 고정 길이라 컴파일 시 펼쳐짐
+#[inline(always)]
+fn horner<const N: usize>(x: f64, coefficients: &[f64; N]) -> f64 {
+    coefficients
+        .iter()
+        .rev()
+        .fold(0.0, |acc, &coefficient| acc * x + coefficient)
+}
+
+/// e^r 테일러 계수 1/k! (k = 0..=12, |r| ≤ ln2/2에서 오차 < 2e-16)
+const EXP_TAYLOR: [f64; 13] = [
+    1.0,
+    1.0,
+    1.0 / 2.0,
+    1.0 / 6.0,
+    1.0 / 24.0,
+    1.0 / 120.0,
+    1.0 / 720.0,
+    1.0 / 5_040.0,
+    1.0 / 40_320.0,
+    1.0 / 362_880.0,
+    1.0 / 3_628_800.0,
+    1.0 / 39_916_800.0,
+    1.0 / 479_001_600.0,
+];
+
+/// atanh(s)/s 급수 계수 1/(2k+1) (|s| ≤ 0.1716에서 s^22 이후 항은 f64 정밀도 밖)
+const ATANH_SERIES: [f64; 11] = [
+    1.0,
+    1.0 / 3.0,
+    1.0 / 5.0,
+    1.0 / 7.0,
+    1.0 / 9.0,
+    1.0 / 11.0,
+    1.0 / 13.0,
+    1.0 / 15.0,
+    1.0 / 17.0,
+    1.0 / 19.0,
+    1.0 / 21.0,
+];
+
+/// 1.5 * 2^52 - 더하면 정수로 반올림되고 하위 비트에 정수 값이 남음
+const ROUND_MAGIC: f64 = 6_755_399_441_055_744.0;
+
+/// e^x (상대 오차 ~1e-15, x는 [-708, 709]로 제한)
+///
+/// x = n·ln2 + r (|r| ≤ ln2/2) 로 나눈 뒤 e^r은 12차 테일러 다항식, 2^n은 지수 비트로 구성.
+#[inline(always)]
+fn exp(x: f64) -> f64 {
+    // fdlibm의 ln2 상/하위 분할 (n·LN2_HI는 정확히 표현됨)
+    const LN2_HI: f64 = 6.931_471_803_691_238_164_90e-01;
+    const LN2_LO: f64 = 1.908_214_929_270_587_700_02e-10;
+
+    let x = x.max(-708.0).min(709.0);
+    let shifted = x * std::f64::consts::LOG2_E + ROUND_MAGIC;
+    let n = shifted - ROUND_MAGIC;
+    let r = x - n * LN2_HI - n * LN2_LO;
+
+    let p = horner(r, &EXP_TAYLOR);
+
+    // 하위 비트의 n(2의 보수)에 지수 바이어스를 더해 2^n 구성
+    let n_bits = shifted.to_bits().wrapping_sub(ROUND_MAGIC.to_bits());
+    let scale = f64::from_bits(n_bits.wrapping_add(1023) << 52);
+    p * scale
+}
+
+/// ln(x) (x > 0, 정규화 수)
+///
+/// x = m·2^e (m ∈ [√½, √2)) 로 나눈 뒤 ln(m) = 2·atanh((m-1)/(m+1)) 급수 사용.
+#[inline(always)]
+fn ln(x: f64) -> f64 {
+    const MANTISSA_MASK: u64 = (1 << 52) - 1;
+    const ONE_BITS: u64 = 0x3ff0_0000_0000_0000;
+    // 2^52 - 지수 필드를 정수 그대로 f64로 옮기기 위한 기준값
+    const TWO_POW_52: f64 = 4_503_599_627_370_496.0;
+
+    let bits = x.to_bits();
+    let biased_exponent = f64::from_bits(TWO_POW_52.to_bits() | (bits >> 52)) - TWO_POW_52;
+    let m = f64::from_bits((bits & MANTISSA_MASK) | ONE_BITS);
+
+    let wrap = m > std::f64::consts::SQRT_2;
+    let m = if wrap { 0.5 * m } else { m };
+    let exponent = biased_exponent - 1023.0 + if wrap { 1.0 } else { 0.0 };
+
+    let s = (m - 1.0) / (m + 1.0);
+    let series = horner(s * s, &ATANH_SERIES);
+
+    exponent * std::f64::consts::LN_2 + 2.0 * s * series
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::models::OptionParameters;
+    use crate::pricing::{BlackScholesPricing, PricingEngine};
+
+    fn assert_close(actual: f64, expected: f64, tolerance: f64, what: &str) {
+        assert!(
+            (actual - expected).abs() <= tolerance,
+            "{}: {} vs {} (tolerance {})",
+            what,
+            actual,
+            expected,
+            tolerance
+        );
+    }
+
+    #[test]
+    fn test_exp_ln_match_std() {
+        let mut x: f64 = -50.0;
+        while x <= 50.0 {
+            let expected = x.exp();
+            assert_close(exp(x), expected, expected * 1e-14, "exp");
+            x += 0.37;
+        }
+        assert_eq!(exp(0.0), 1.0);
+        assert!(exp(-1000.0) < 1e-300);
+
+        for &x in &[1e-6, 0.05, 0.5, 0.7071, 1.0, 1.4142, 1.5, 2.0, 10.0, 1e6] {
+            assert_close(ln(x), x.ln(), 1e-15 * x.ln().abs().max(1.0), "ln");
+        }
+    }
+
+    #[test]
+    fn test_chain_matches_scalar_engine() {
+        let spot = 70_000.0;
+        let rate = 0.05;
+        let strikes: Vec<f64> = (0..13).map(|i| 40_000.0 + 5_000.0 * i as f64).collect();
+        let expiries = [1.0 / 365.0, 30.0 / 365.0, 0.5, 2.0];
+        let chain = OptionChain::grid(&strikes, &expiries, 0.6);
+
+        let mut out = ChainGreeks::default();
+        black_scholes_chain(spot, rate, &chain, &mut out);
+        assert_eq!(out.len(), strikes.len() * expiries.len());
+
+        let scalar = BlackScholesPricing::new();
+        for i in 0..chain.len() {
+            let mut params = OptionParameters {
+                spot,
+                strike: chain.strikes[i],
+                time_to_expiry: chain.time_to_expiry[i],
+                volatility: chain.volatility[i],
+                risk_free_rate: rate,
+                is_call: true,
+            };
+            // CDF 근사 오차(7.5e-8)가 S·N(d1), K·N(d2) 양쪽에 곱해짐
+            let price_tol = 1e-7 * (spot + chain.strikes[i]);
+            assert_close(
+                out.call_price[i],
+                scalar.calculate_option_price(&params),
+                price_tol,
+                "call",
+            );
+            assert_close(
+                out.call_delta[i],
+                scalar.calculate_delta(&params),
+                1e-7,
+                "call delta",
+            );
+            let gamma = scalar.calculate_gamma(&params);
+            assert_close(out.gamma[i], gamma, gamma * 1e-12, "gamma");
+            let vega = scalar.calculate_vega(&params);
+            assert_close(out.vega[i], vega, vega * 1e-12, "vega");
+            assert_close(
+                out.call_theta[i],
+                scalar.calculate_theta(&params),
+                1e-3,
+                "call theta",
+            );
+            assert_close(
+                out.call_rho[i],
+                scalar.calculate_rho(&params),
+                1e-3,
+                "call rho",
+            );
+
+            params.is_call = false;
+            assert_close(
+                out.put_price[i],
+                scalar.calculate_option_price(&params),
+                price_tol,
+                "put",
+            );
+            assert_close(
+                out.put_delta[i],
+                scalar.calculate_delta(&params),
+                1e-7,
+                "put delta",
+            );
+            assert_close(
+                out.put_theta[i],
+                scalar.calculate_theta(&params),
+                1e-3,
+                "put theta",
+            );
+            assert_close(
+                out.put_rho[i],
+                scalar.calculate_rho(&params),
+                1e-3,
+                "put rho",
+            );
+        }
+    }
+
+    #[test]
+    fn test_expired_rows_use_intrinsic_value() {
+        let mut chain = OptionChain::default();
+        chain.push(60_000.0, 0.0, 0.6);
+        chain.push(80_000.0, -1.0, 0.6);
+
+        let mut out = ChainGreeks::default();
+        black_scholes_chain(70_000.0, 0.05, &chain, &mut out);
+
+        assert_eq!(out.call_price, vec![10_000.0, 0.0]);
+        assert_eq!(out.put_price, vec![0.0, 10_000.0]);
+        assert_eq!(out.call_delta, vec![1.0, 0.0]);
+        assert_eq!(out.put_delta, vec![0.0, -1.0]);
+        assert_eq!(out.gamma, vec![0.0, 0.0]);
+    }
+
+    #[test]
+    fn test_output_buffer_is_reused() {
+        let chain = OptionChain::grid(&[60_000.0, 70_000.0], &[0.25], 0.5);
+        let mut out = ChainGreeks::default();
+
+        black_scholes_chain(70_000.0, 0.05, &chain, &mut out);
+        let first = out.call_price.clone();
+        let buffer = out.call_price.as_ptr();
+        black_scholes_chain(70_000.0, 0.05, &chain, &mut out);
+
+        assert_eq!(out.call_price.as_ptr(), buffer);
+        assert_eq!(out.call_price, first);
+    }
+}
@@ -1,11 +1,20 @@
+pub mod batch;
+pub mod metrics;
 pub mod models;
+pub mod monte_carlo;
+#[cfg(feature = "persistent")]
+pub mod premium_db;
+pub mod price_feed;
 pub mod pricing;
+pub mod quotes;
 pub mod repositories;
 pub mod services;
+pub mod surface;
 pub mod theta_targeting;
 
 pub use models::*;
+pub use monte_carlo::{BarrierKind, McEstimate, MonteCarloPricing, PathOption, Payoff};
 pub use pricing::{BlackScholesPricing, PricingEngine};
 pub use repositories::*;
 pub use services::*;
-pub use theta_targeting::{ThetaTargetingEngine, PremiumResult, DeltaNeutralManager, OptionPosition};
\ No newline at end of file
+pub use theta_targeting::{ThetaTargetingEngine, PremiumResult, DeltaNeutralManager, OptionPosition, IvSolution, ThetaTarget};
\ No newline at end of file
@@ -1,16 +1,37 @@
-use axum::{extract::Query, http::StatusCode, response::Json, routing::get, Router};
+use axum::{
+    extract::Query,
+    http::{header, HeaderMap, StatusCode},
+    response::{
+        sse::{Event, KeepAlive, Sse},
+        IntoResponse, Json, Response,
+    },
+    routing::get,
+    Router,
+};
+use std::convert::Infallible;
 use std::sync::Arc;
 use tokio::net::TcpListener;
+use tokio_stream::wrappers::{errors::BroadcastStreamRecvError, BroadcastStream};
+use tokio_stream::{Stream, StreamExt};
 use tracing::info;
 
+mod batch;
+mod metrics;
 mod models;
+#[cfg(feature = "persistent")]
+mod premium_db;
+mod price_feed;
 mod pricing;
+mod quotes;
 mod repositories;
 mod services;
+mod surface;
 
-use models::{DeltaInfo, MarketState, OptionPremium, PremiumQuery};
+use models::{DeltaInfo, PremiumQuery};
+use price_feed::PriceFeedSubscriber;
 use pricing::BlackScholesPricing;
-use repositories::{InMemoryMarketRepo, InMemoryPoolRepo, InMemoryPremiumRepo};
+use quotes::EncodedBody;
+use repositories::{InMemoryMarketRepo, InMemoryPoolRepo, InMemoryPremiumRepo, PremiumRepository};
 use services::{DeltaManagementService, MarketDataService, PremiumCalculationService};
 
 /// 애플리케이션 상태
@@ -20,16 +41,96 @@ struct AppState {
     market_service: Arc<MarketDataService>,
 }
 
+/// 사전 인코딩된 본문 응답 - `If-None-Match`가 일치하면 304, 클라이언트가 허용하면 gzip 본문
+fn encoded_response(headers: &HeaderMap, body: &EncodedBody) -> Response {
+    let header_str =
+        |name: header::HeaderName| headers.get(name).and_then(|value| value.to_str().ok());
+
+    // gzip 본문은 바이트가 다르므로 ETag도 다르다 (같은 강한 ETag를 두 표현에 쓰지 않음)
+    let gzip = body
+        .gzip
+        .as_ref()
+        .filter(|_| header_str(header::ACCEPT_ENCODING).is_some_and(quotes::accepts_gzip));
+    let etag = match gzip {
+        Some(_) => &body.gzip_etag,
+        None => &body.etag,
+    };
+    let validators = [
+        (header::ETAG, etag.clone()),
+        (header::CACHE_CONTROL, "no-cache".to_string()),
+        (header::VARY, "Accept-Encoding".to_string()),
+    ];
+
+    if header_str(header::IF_NONE_MATCH).is_some_and(|tag| body.matches(tag)) {
+        return (StatusCode::NOT_MODIFIED, validators).into_response();
+    }
+
+    match gzip {
+        Some(gzip) => (
+            validators,
+            [
+                (header::CONTENT_TYPE, "application/json"),
+                (header::CONTENT_ENCODING, "gzip"),
+            ],
+            gzip.clone(),
+        )
+            .into_response(),
+        None => (
+            validators,
+            [(header::CONTENT_TYPE, "application/json")],
+            body.json.clone(),
+        )
+            .into_response(),
+    }
+}
+
 async fn get_premium_map(
     Query(params): Query<PremiumQuery>,
     axum::extract::State(state): axum::extract::State<Arc<AppState>>,
-) -> Result<Json<Vec<OptionPremium>>, StatusCode> {
-    match state.premium_service.get_premiums_by_expiry(params.expiry).await {
-        Ok(premiums) => Ok(Json(premiums)),
-        Err(_) => Err(StatusCode::NOT_FOUND),
+    headers: HeaderMap,
+) -> Response {
+    match state.premium_service.quotes().get(params.expiry.as_deref()) {
+        Some(body) => encoded_response(&headers, &body),
+        None => StatusCode::NOT_FOUND.into_response(),
     }
 }
 
+fn snapshot_event(version: u64, all: &EncodedBody) -> Event {
+    Event::default()
+        .event("snapshot")
+        .id(version.to_string())
+        .data(String::from_utf8_lossy(&all.json))
+}
+
+/// 프리미엄 SSE - 전체 스냅샷 한 번 뒤 바뀐 셀만 `diff` 이벤트로 전송
+///
+/// 구독자가 밀려 diff를 놓치면 그 시점의 스냅샷을 다시 보낸다.
+async fn stream_premiums(
+    axum::extract::State(state): axum::extract::State<Arc<AppState>>,
+) -> Sse<impl Stream<Item = Result<Event, Infallible>>> {
+    let (version, all, diffs) = state.premium_service.quotes().subscribe();
+    let snapshot = tokio_stream::once(Ok(snapshot_event(version, &all)));
+
+    let mut last_version = version;
+    let updates = BroadcastStream::new(diffs).filter_map(move |diff| match diff {
+        Ok(diff) if diff.version > last_version => {
+            last_version = diff.version;
+            Some(Ok(Event::default()
+                .event("diff")
+                .id(diff.version.to_string())
+                .data(&*diff.data)))
+        }
+        Ok(_) => None,
+        Err(BroadcastStreamRecvError::Lagged(_)) => {
+            let (version, all) = state.premium_service.quotes().snapshot();
+            last_version = version;
+            Some(Ok(snapshot_event(version, &all)))
+        }
+    });
+
+    Sse::new(snapshot.chain(updates)).keep_alive(KeepAlive::default())
+}
+
 async fn get_pool_delta(
     axum::extract::State(state): axum::extract::State<Arc<AppState>>,
 ) -> Result<Json<DeltaInfo>, StatusCode> {
@@ -50,19 +151,46 @@ async fn get_current_delta(
 
 async fn get_market_state(
     axum::extract::State(state): axum::extract::State<Arc<AppState>>,
-) -> Result<Json<MarketState>, StatusCode> {
-    match state.market_service.get_market_state().await {
-        Ok(market_state) => Ok(Json(market_state)),
-        Err(_) => Err(StatusCode::INTERNAL_SERVER_ERROR),
+    headers: HeaderMap,
+) -> Response {
+    match state.market_service.get_market_state_body().await {
+        Ok(body) => encoded_response(&headers, &body),
+        Err(_) => StatusCode::INTERNAL_SERVER_ERROR.into_response(),
     }
 }
 
+async fn get_metrics() -> ([(header::HeaderName, &'static str); 1], String) {
+    (
+        [(header::CONTENT_TYPE, metrics::CONTENT_TYPE)],
+        metrics::render(),
+    )
+}
+
+/// 프리미엄 저장소 선택 - `persistent` 기능이 켜져 있고 `PREMIUM_DB_PATH`가 지정되면 RocksDB
+///
+/// 반환값: (저장소, 복원된 만기 수)
+fn open_premium_repo() -> (Arc<dyn PremiumRepository>, usize) {
+    #[cfg(feature = "persistent")]
+    if let Ok(path) = std::env::var("PREMIUM_DB_PATH") {
+        let config = oracle_vm_common::config::DatabaseConfig {
+            path,
+            ..Default::default()
+        };
+        let repo = premium_db::RocksDbPremiumRepo::open(&config)
+            .unwrap_or_else(|e| panic!("❌ {}", e));
+        let restored = repo.expiry_count();
+        return (Arc::new(repo), restored);
+    }
+
+    (Arc::new(InMemoryPremiumRepo::new()), 0)
+}
+
 #[tokio::main]
 async fn main() {
     tracing_subscriber::fmt::init();
 
     // 저장소 초기화
-    let premium_repo = Arc::new(InMemoryPremiumRepo::new());
+    let (premium_repo, restored_expiries) = open_premium_repo();
     let pool_repo = Arc::new(InMemoryPoolRepo::new());
     let market_repo = Arc::new(InMemoryMarketRepo::new());
 
@@ -76,8 +204,33 @@ async fn main() {
     let delta_service = Arc::new(DeltaManagementService::new(pool_repo.clone()));
     let market_service = Arc::new(MarketDataService::new(market_repo.clone()));
 
-    // 초기 데이터 설정
-    premium_service.update_premium_map(70000.0).await.unwrap();
+    // 초기 데이터 설정 (첫 집계 가격 전까지 사용) - 복원된 곡면이 있으면 그대로 사용
+    // (만기가 지나 격자에서 빠진 만기는 버리고, 남은 만기가 없으면 새로 계산)
+    let published = if restored_expiries > 0 {
+        let published = premium_service.publish_stored_premiums().await.unwrap();
+        info!(
+            "💾 Restored premiums for {} expiries ({} still on the grid)",
+            restored_expiries, published
+        );
+        published
+    } else {
+        0
+    };
+    if published == 0 {
+        premium_service.update_premium_map(70000.0).await.unwrap();
+    }
+
+    // 집계 가격이 갱신될 때마다 프리미엄 재계산
+    let aggregator_url =
+        std::env::var("AGGREGATOR_URL").unwrap_or_else(|_| "http://localhost:50051".to_string());
+    tokio::spawn(
+        PriceFeedSubscriber::new(
+            aggregator_url,
+            premium_service.clone(),
+            market_service.clone(),
+        )
+        .run(),
+    );
 
     // 애플리케이션 상태
     let app_state = Arc::new(AppState {
@@ -88,9 +241,11 @@ async fn main() {
 
     let app = Router::new()
         .route("/api/premium", get(get_premium_map))
+        .route("/api/premium/stream", get(stream_premiums))
         .route("/api/pool/delta", get(get_pool_delta))
         .route("/api/delta/current", get(get_current_delta))
         .route("/api/market", get(get_market_state))
+        .route("/metrics", get(get_metrics))
         .with_state(app_state);
 
     let listener = TcpListener::bind("127.0.0.1:3000")
@@ -100,9 +255,11 @@ async fn main() {
     info!("Calculation API server starting on http://127.0.0.1:3000");
     info!("Available endpoints:");
     info!("  GET /api/premium - 프리미엄 맵");
+    info!("  GET /api/premium/stream - 프리미엄 변경 스트림 (SSE)");
     info!("  GET /api/pool/delta - 풀 델타 정보");
     info!("  GET /api/delta/current - 현재 델타값");
     info!("  GET /api/market - 시장 상태");
+    info!("  GET /metrics - Prometheus 지표");
 
     axum::serve(listener, app)
         .await
@@ -133,14 +290,54 @@ mod tests {
         // 프리미엄 업데이트
         premium_service.update_premium_map(70000.0).await.unwrap();
 
-        // 조회 테스트
+        // 조회 테스트 (기본 만기는 현재 시각 이후 매월 1일)
+        let expiry = crate::pricing::monthly_expiries(crate::pricing::unix_now(), 1).remove(0);
         let premiums = premium_service
-            .get_premiums_by_expiry(Some("2024-02-01".to_string()))
+            .get_premiums_by_expiry(Some(expiry.clone()))
             .await
             .unwrap();
 
         assert!(!premiums.is_empty());
-        assert_eq!(premiums[0].expiry, "2024-02-01");
+        assert_eq!(premiums[0].expiry, expiry);
+
+        // 캐시된 응답 - 같은 ETag로 다시 요청하면 304
+        let body = premium_service.quotes().get(Some(&expiry)).unwrap();
+        let response = encoded_response(&HeaderMap::new(), &body);
+        assert_eq!(response.status(), StatusCode::OK);
+        let etag = response.headers()[header::ETAG].clone();
+
+        let mut headers = HeaderMap::new();
+        headers.insert(header::IF_NONE_MATCH, etag);
+        let response = encoded_response(&headers, &body);
+        assert_eq!(response.status(), StatusCode::NOT_MODIFIED);
+    }
+
+    #[test]
+    fn test_each_encoding_has_its_own_etag() {
+        let body = EncodedBody::encode(&vec![70000.5f64; 512]).unwrap();
+        let mut gzip_headers = HeaderMap::new();
+        gzip_headers.insert(
+            header::ACCEPT_ENCODING,
+            header::HeaderValue::from_static("gzip"),
+        );
+
+        let identity = encoded_response(&HeaderMap::new(), &body);
+        let gzip = encoded_response(&gzip_headers, &body);
+        assert_eq!(gzip.headers()[header::CONTENT_ENCODING], "gzip");
+        let identity_etag = identity.headers()[header::ETAG].clone();
+        let gzip_etag = gzip.headers()[header::ETAG].clone();
+        assert_ne!(identity_etag, gzip_etag);
+
+        // 각 인코딩의 ETag로 다시 요청하면 304 (응답 ETag는 그 요청이 받을 인코딩 기준)
+        for (mut headers, etag) in [
+            (HeaderMap::new(), identity_etag),
+            (gzip_headers, gzip_etag),
+        ] {
+            headers.insert(header::IF_NONE_MATCH, etag.clone());
+            let response = encoded_response(&headers, &body);
+            assert_eq!(response.status(), StatusCode::NOT_MODIFIED);
+            assert_eq!(response.headers()[header::ETAG], etag);
+        }
     }
 
     #[test]
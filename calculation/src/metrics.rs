@@ -0,0 +1,18 @@
+//! Prometheus 지표
+//!
+//! - `calculation_surface_reprice_seconds`: 가격 갱신 시 프리미엄 곡면 재계산 시간
+//!
+//! 등록과 인코딩은 다른 서비스와 같은 `oracle_vm_common::metrics`를 사용한다.
+
+use oracle_vm_common::metrics::{self, HistogramVec};
+use std::sync::LazyLock;
+
+pub use oracle_vm_common::metrics::{render, CONTENT_TYPE};
+
+pub static SURFACE_REPRICE_SECONDS: LazyLock<HistogramVec> = LazyLock::new(|| {
+    metrics::latency_histogram(
+        "calculation_surface_reprice_seconds",
+        "Premium surface repricing latency",
+        &[],
+    )
+});
@@ -10,6 +10,15 @@ pub struct OptionPremium {
     pub implied_volatility: f64,
 }
 
+/// 프리미엄 셀 - 증분 갱신 단위 (만기 문자열 없이 행사가로 식별)
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct PremiumCell {
+    pub strike: f64,
+    pub call_premium: f64,
+    pub put_premium: f64,
+    pub implied_volatility: f64,
+}
+
 /// 델타 정보
 #[derive(Debug, Clone, Serialize, Deserialize)]
 pub struct DeltaInfo {
@@ -44,7 +53,9 @@ impl DeltaInfo {
 pub struct MarketState {
     pub current_price: f64,
     pub timestamp: u64,
+    /// 연율화 변동성 - Aggregator의 EWMA 실현 변동성으로 갱신
     pub volatility_24h: f64,
+    /// 최근 1시간 거래량 (기초 자산 단위)
     pub total_volume: f64,
 }
 
@@ -70,6 +81,110 @@ pub struct OptionParameters {
     pub is_call: bool,
 }
 
+/// 옵션 체인 (struct-of-arrays) - 일괄 가격 계산 입력
+///
+/// 같은 인덱스가 행사가/만기/변동성 한 조합이며, 콜과 풋은 같은 행에서 함께 계산된다.
+#[derive(Debug, Clone, Default)]
+pub struct OptionChain {
+    pub strikes: Vec<f64>,
+    pub time_to_expiry: Vec<f64>,
+    pub volatility: Vec<f64>,
+}
+
+impl OptionChain {
+    pub fn with_capacity(capacity: usize) -> Self {
+        Self {
+            strikes: Vec::with_capacity(capacity),
+            time_to_expiry: Vec::with_capacity(capacity),
+            volatility: Vec::with_capacity(capacity),
+        }
+    }
+
+    /// 행사가 x 만기 격자 (인덱스 = 만기 * strikes.len() + 행사가)
+    pub fn grid(strikes: &[f64], times_to_expiry: &[f64], volatility: f64) -> Self {
+        let mut chain = Self::with_capacity(strikes.len() * times_to_expiry.len());
+        for &time_to_expiry in times_to_expiry {
+            for &strike in strikes {
+                chain.push(strike, time_to_expiry, volatility);
+            }
+        }
+        chain
+    }
+
+    pub fn push(&mut self, strike: f64, time_to_expiry: f64, volatility: f64) {
+        self.strikes.push(strike);
+        self.time_to_expiry.push(time_to_expiry);
+        self.volatility.push(volatility);
+    }
+
+    pub fn len(&self) -> usize {
+        self.strikes.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.strikes.is_empty()
+    }
+}
+
+/// 옵션 체인 일괄 계산 결과 (struct-of-arrays)
+///
+/// 단위는 `PricingEngine`과 동일 (vega/rho는 1%p당, theta는 일 단위).
+#[derive(Debug, Clone, Default)]
+pub struct ChainGreeks {
+    pub call_price: Vec<f64>,
+    pub put_price: Vec<f64>,
+    pub call_delta: Vec<f64>,
+    pub put_delta: Vec<f64>,
+    pub gamma: Vec<f64>,
+    pub vega: Vec<f64>,
+    pub call_theta: Vec<f64>,
+    pub put_theta: Vec<f64>,
+    pub call_rho: Vec<f64>,
+    pub put_rho: Vec<f64>,
+}
+
+impl ChainGreeks {
+    pub fn len(&self) -> usize {
+        self.call_price.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.call_price.is_empty()
+    }
+
+    /// 모든 열의 길이를 맞춤 - 같은 버퍼를 매 tick 재사용하면 재할당 없음
+    pub fn resize(&mut self, len: usize) {
+        for column in [
+            &mut self.call_price,
+            &mut self.put_price,
+            &mut self.call_delta,
+            &mut self.put_delta,
+            &mut self.gamma,
+            &mut self.vega,
+            &mut self.call_theta,
+            &mut self.put_theta,
+            &mut self.call_rho,
+            &mut self.put_rho,
+        ] {
+            column.resize(len, 0.0);
+        }
+    }
+
+    /// `source`의 한 행을 `index` 행에 복사
+    pub fn copy_row(&mut self, index: usize, source: &ChainGreeks, source_index: usize) {
+        self.call_price[index] = source.call_price[source_index];
+        self.put_price[index] = source.put_price[source_index];
+        self.call_delta[index] = source.call_delta[source_index];
+        self.put_delta[index] = source.put_delta[source_index];
+        self.gamma[index] = source.gamma[source_index];
+        self.vega[index] = source.vega[source_index];
+        self.call_theta[index] = source.call_theta[source_index];
+        self.put_theta[index] = source.put_theta[source_index];
+        self.call_rho[index] = source.call_rho[source_index];
+        self.put_rho[index] = source.put_rho[source_index];
+    }
+}
+
 /// API 쿼리 파라미터
 #[derive(Deserialize)]
 pub struct PremiumQuery {
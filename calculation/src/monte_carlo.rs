@@ -0,0 +1,564 @@
+//! Monte Carlo 가격 계산 엔진 (경로 의존 옵션)
+//!
+//! - 난수: Philox4x32-10 카운터 기반 생성기 - (블록, 관측 시점, 경로 쌍)에서 바로 계산하므로
+//!   작업자 수나 스케줄과 무관하게 같은 시드는 같은 결과를 낸다
+//! - 분산 감소: antithetic 경로 쌍 + 할인된 만기 현물가 control variate (E[e^{-rT}·S_T] = S_0)
+//! - 경로 버퍼: 현물가/누적합/극값을 배열별로 둔 SoA, 작업자 스레드별 arena에서 재사용
+//!
+//! 장벽은 관측 시점에서만 확인하는 이산 모니터링이다.
+
+use crate::models::OptionParameters;
+use crate::pricing::{time_to_expiry_between, PricingEngine};
+use rayon::prelude::*;
+use std::cell::RefCell;
+
+/// 블록당 antithetic 경로 쌍 수 (병렬 작업 단위)
+const BLOCK_PAIRS: usize = 512;
+/// Greeks 계산 변동 폭 (현물가 비율, 변동성, 이자율)
+const SPOT_BUMP: f64 = 0.01;
+const VOL_BUMP: f64 = 0.01;
+const RATE_BUMP: f64 = 0.0001;
+
+const PHILOX_M0: u32 = 0xD251_1F53;
+const PHILOX_M1: u32 = 0xCD9E_8D57;
+const PHILOX_W0: u32 = 0x9E37_79B9;
+const PHILOX_W1: u32 = 0xBB67_AE85;
+
+/// 장벽 종류
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum BarrierKind {
+    UpAndOut,
+    UpAndIn,
+    DownAndOut,
+    DownAndIn,
+}
+
+/// 정산 방식
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub enum Payoff {
+    /// 만기 현물가
+    European,
+    /// 관측 시점 현물가의 산술 평균 (평가 시점 제외)
+    AsianArithmetic,
+    /// 관측 시점에 장벽을 건드렸는지에 따라 만기 현물가로 정산
+    Barrier { kind: BarrierKind, level: f64 },
+}
+
+/// 가격 추정치
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct McEstimate {
+    pub price: f64,
+    /// 추정 표준오차
+    pub std_error: f64,
+}
+
+/// 만기를 타임스탬프로 지정한 옵션
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct PathOption {
+    pub payoff: Payoff,
+    pub is_call: bool,
+    pub spot: f64,
+    pub strike: f64,
+    pub volatility: f64,
+    pub risk_free_rate: f64,
+    /// 평가 시각 (Unix 초)
+    pub valuation_time: u64,
+    /// 만기 (Unix 초)
+    pub expiry_time: u64,
+}
+
+/// Monte Carlo 가격 계산 엔진
+#[derive(Debug, Clone)]
+pub struct MonteCarloPricing {
+    /// antithetic 경로 쌍 수 (경로 수의 절반)
+    pairs: usize,
+    /// 경로 의존 정산의 관측 시점 수 (European은 한 번에 만기까지 이동)
+    steps: usize,
+    seed: u64,
+    control_variate: bool,
+}
+
+impl MonteCarloPricing {
+    /// 경로 수 (짝수로 올림)와 관측 시점 수로 생성
+    pub fn new(paths: usize, steps: usize) -> Self {
+        Self {
+            pairs: paths.div_ceil(2).max(1),
+            steps: steps.max(1),
+            seed: 0,
+            control_variate: true,
+        }
+    }
+
+    pub fn with_seed(mut self, seed: u64) -> Self {
+        self.seed = seed;
+        self
+    }
+
+    /// control variate 끄기 (분산 감소 효과 비교용)
+    pub fn without_control_variate(mut self) -> Self {
+        self.control_variate = false;
+        self
+    }
+
+    /// 타임스탬프 만기 옵션 가격
+    pub fn price_option(&self, option: &PathOption) -> McEstimate {
+        let params = OptionParameters {
+            spot: option.spot,
+            strike: option.strike,
+            time_to_expiry: time_to_expiry_between(option.valuation_time, option.expiry_time),
+            volatility: option.volatility,
+            risk_free_rate: option.risk_free_rate,
+            is_call: option.is_call,
+        };
+        self.price(&params, option.payoff)
+    }
+
+    /// 정산 방식별 가격 (`params.time_to_expiry`는 연 단위)
+    pub fn price(&self, params: &OptionParameters, payoff: Payoff) -> McEstimate {
+        let steps = match payoff {
+            Payoff::European => 1,
+            _ => self.steps,
+        };
+        let time_to_expiry = params.time_to_expiry.max(0.0);
+        let dt = time_to_expiry / steps as f64;
+        let path = PathSpec {
+            params,
+            payoff,
+            steps,
+            drift: (params.risk_free_rate - 0.5 * params.volatility * params.volatility) * dt,
+            diffusion: params.volatility * dt.sqrt(),
+            discount: (-params.risk_free_rate * time_to_expiry).exp(),
+            key: [self.seed as u32, (self.seed >> 32) as u32],
+        };
+
+        // 블록 순서대로 합산 - 병렬 스케줄과 무관하게 결과가 같다
+        let blocks = self.pairs.div_ceil(BLOCK_PAIRS);
+        let stats = (0..blocks)
+            .into_par_iter()
+            .map(|block| {
+                let pairs = BLOCK_PAIRS.min(self.pairs - block * BLOCK_PAIRS);
+                simulate_block(&path, block as u64, pairs)
+            })
+            .collect::<Vec<_>>()
+            .into_iter()
+            .fold(BlockStats::default(), BlockStats::merge);
+
+        stats.estimate(self.control_variate)
+    }
+
+    /// 변동 폭만큼 입력을 바꾼 유럽형 가격 - 같은 시드라 공통 난수로 차분 잡음이 작다
+    fn european(&self, params: &OptionParameters, edit: impl FnOnce(&mut OptionParameters)) -> f64 {
+        let mut bumped = params.clone();
+        edit(&mut bumped);
+        self.price(&bumped, Payoff::European).price
+    }
+}
+
+impl Default for MonteCarloPricing {
+    fn default() -> Self {
+        Self::new(65_536, 64)
+    }
+}
+
+/// 유럽형 정산 기준 - Greeks는 공통 난수 차분 (단위는 `BlackScholesPricing`과 같음)
+impl PricingEngine for MonteCarloPricing {
+    fn calculate_option_price(&self, params: &OptionParameters) -> f64 {
+        self.price(params, Payoff::European).price
+    }
+
+    fn calculate_delta(&self, params: &OptionParameters) -> f64 {
+        let h = params.spot * SPOT_BUMP;
+        (self.european(params, |p| p.spot += h) - self.european(params, |p| p.spot -= h))
+            / (2.0 * h)
+    }
+
+    fn calculate_gamma(&self, params: &OptionParameters) -> f64 {
+        let h = params.spot * SPOT_BUMP;
+        (self.european(params, |p| p.spot += h) - 2.0 * self.calculate_option_price(params)
+            + self.european(params, |p| p.spot -= h))
+            / (h * h)
+    }
+
+    fn calculate_vega(&self, params: &OptionParameters) -> f64 {
+        // 변동성 1%p당
+        (self.european(params, |p| p.volatility += VOL_BUMP)
+            - self.european(params, |p| p.volatility = (p.volatility - VOL_BUMP).max(0.0)))
+            / 2.0
+    }
+
+    fn calculate_theta(&self, params: &OptionParameters) -> f64 {
+        // 하루 경과 시 가격 변화
+        self.european(params, |p| p.time_to_expiry = (p.time_to_expiry - 1.0 / 365.0).max(0.0))
+            - self.calculate_option_price(params)
+    }
+
+    fn calculate_rho(&self, params: &OptionParameters) -> f64 {
+        // 이자율 1%p당
+        (self.european(params, |p| p.risk_free_rate += RATE_BUMP)
+            - self.european(params, |p| p.risk_free_rate -= RATE_BUMP))
+            / (2.0 * RATE_BUMP)
+            / 100.0
+    }
+}
+
+/// 경로 생성 입력 (가격 계산 한 번 동안 고정)
+struct PathSpec<'a> {
+    params: &'a OptionParameters,
+    payoff: Payoff,
+    steps: usize,
+    drift: f64,
+    diffusion: f64,
+    discount: f64,
+    key: [u32; 2],
+}
+
+/// 경로 버퍼 (SoA) - 앞쪽 절반은 +z, 뒤쪽 절반은 -z 경로
+#[derive(Default)]
+struct PathArena {
+    spot: Vec<f64>,
+    /// 관측 현물가 합 (Asian)
+    sum: Vec<f64>,
+    /// 지금까지의 최고가 (상향 장벽) 또는 최저가 (하향 장벽)
+    extreme: Vec<f64>,
+    normals: Vec<f64>,
+}
+
+impl PathArena {
+    fn reset(&mut self, pairs: usize, spot: f64) {
+        for (buffer, value) in [
+            (&mut self.spot, spot),
+            (&mut self.sum, 0.0),
+            (&mut self.extreme, spot),
+        ] {
+            buffer.clear();
+            buffer.resize(2 * pairs, value);
+        }
+        self.normals.clear();
+        self.normals.resize(pairs, 0.0);
+    }
+}
+
+thread_local! {
+    static ARENA: RefCell<PathArena> = RefCell::new(PathArena::default());
+}
+
+/// 블록 하나의 antithetic 쌍 통계 (control 값은 S_0 기준 편차로 누적해 정밀도 유지)
+#[derive(Debug, Clone, Copy, Default)]
+struct BlockStats {
+    count: f64,
+    sum_y: f64,
+    sum_x: f64,
+    sum_yy: f64,
+    sum_xx: f64,
+    sum_xy: f64,
+}
+
+impl BlockStats {
+    fn add(&mut self, y: f64, x: f64) {
+        self.count += 1.0;
+        self.sum_y += y;
+        self.sum_x += x;
+        self.sum_yy += y * y;
+        self.sum_xx += x * x;
+        self.sum_xy += x * y;
+    }
+
+    fn merge(self, other: Self) -> Self {
+        Self {
+            count: self.count + other.count,
+            sum_y: self.sum_y + other.sum_y,
+            sum_x: self.sum_x + other.sum_x,
+            sum_yy: self.sum_yy + other.sum_yy,
+            sum_xx: self.sum_xx + other.sum_xx,
+            sum_xy: self.sum_xy + other.sum_xy,
+        }
+    }
+
+    fn estimate(&self, control_variate: bool) -> McEstimate {
+        let n = self.count;
+        let mean_y = self.sum_y / n;
+        let mean_x = self.sum_x / n;
+        if n < 2.0 {
+            return McEstimate {
+                price: mean_y,
+                std_error: 0.0,
+            };
+        }
+
+        let var_y = ((self.sum_yy - n * mean_y * mean_y) / (n - 1.0)).max(0.0);
+        let var_x = ((self.sum_xx - n * mean_x * mean_x) / (n - 1.0)).max(0.0);
+        let cov = (self.sum_xy - n * mean_x * mean_y) / (n - 1.0);
+
+        let (price, variance) = if control_variate && var_x > 0.0 {
+            let beta = cov / var_x;
+            (mean_y - beta * mean_x, (var_y - cov * beta).max(0.0))
+        } else {
+            (mean_y, var_y)
+        };
+        McEstimate {
+            price,
+            std_error: (variance / n).sqrt(),
+        }
+    }
+}
+
+fn simulate_block(path: &PathSpec, block: u64, pairs: usize) -> BlockStats {
+    ARENA.with(|arena| {
+        let mut arena = arena.borrow_mut();
+        let params = path.params;
+        arena.reset(pairs, params.spot);
+        let PathArena {
+            spot,
+            sum,
+            extreme,
+            normals,
+        } = &mut *arena;
+
+        for step in 0..path.steps {
+            fill_normals(normals, path.key, block, step as u32);
+
+            let (up, down) = spot.split_at_mut(pairs);
+            for ((s_up, s_down), &z) in up.iter_mut().zip(down.iter_mut()).zip(normals.iter()) {
+                *s_up *= (path.drift + path.diffusion * z).exp();
+                *s_down *= (path.drift - path.diffusion * z).exp();
+            }
+
+            match path.payoff {
+                Payoff::European => {}
+                Payoff::AsianArithmetic => {
+                    for (total, &s) in sum.iter_mut().zip(spot.iter()) {
+                        *total += s;
+                    }
+                }
+                Payoff::Barrier { kind, .. } => {
+                    let upward = matches!(kind, BarrierKind::UpAndOut | BarrierKind::UpAndIn);
+                    for (e, &s) in extreme.iter_mut().zip(spot.iter()) {
+                        *e = if upward { e.max(s) } else { e.min(s) };
+                    }
+                }
+            }
+        }
+
+        let mut stats = BlockStats::default();
+        for lane in 0..pairs {
+            let other = lane + pairs;
+            let y = 0.5
+                * path.discount
+                * (lane_payoff(path, spot[lane], sum[lane], extreme[lane])
+                    + lane_payoff(path, spot[other], sum[other], extreme[other]));
+            let x = 0.5 * path.discount * (spot[lane] + spot[other]) - params.spot;
+            stats.add(y, x);
+        }
+        stats
+    })
+}
+
+fn lane_payoff(path: &PathSpec, spot: f64, sum: f64, extreme: f64) -> f64 {
+    let params = path.params;
+    let vanilla = |underlying: f64| {
+        if params.is_call {
+            (underlying - params.strike).max(0.0)
+        } else {
+            (params.strike - underlying).max(0.0)
+        }
+    };
+
+    match path.payoff {
+        Payoff::European => vanilla(spot),
+        Payoff::AsianArithmetic => vanilla(sum / path.steps as f64),
+        Payoff::Barrier { kind, level } => {
+            let crossed = match kind {
+                BarrierKind::UpAndOut | BarrierKind::UpAndIn => extreme >= level,
+                BarrierKind::DownAndOut | BarrierKind::DownAndIn => extreme <= level,
+            };
+            let knock_in = matches!(kind, BarrierKind::UpAndIn | BarrierKind::DownAndIn);
+            if crossed == knock_in {
+                vanilla(spot)
+            } else {
+                0.0
+            }
+        }
+    }
+}
+
+/// 한 관측 시점의 표준정규 난수 - Philox 호출 한 번으로 두 쌍 (Box-Muller)
+fn fill_normals(normals: &mut [f64], key: [u32; 2], block: u64, step: u32) {
+    for (index, chunk) in normals.chunks_mut(2).enumerate() {
+        let [a, b, c, d] = philox4x32(
+            [index as u32, step, block as u32, (block >> 32) as u32],
+            key,
+        );
+        let radius = (-2.0 * unit_interval(a, b).ln()).sqrt();
+        let (sin, cos) = (std::f64::consts::TAU * unit_interval(c, d)).sin_cos();
+        chunk[0] = radius * cos;
+        if let Some(second) = chunk.get_mut(1) {
+            *second = radius * sin;
+        }
+    }
+}
+
+/// 53비트 균등 난수 (0, 1) - 0이 나오지 않아 로그가 안전하다
+fn unit_interval(high: u32, low: u32) -> f64 {
+    let bits = (u64::from(high) << 21) | (u64::from(low) >> 11);
+    (bits as f64 + 0.5) * (1.0 / (1u64 << 53) as f64)
+}
+
+/// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3")
+fn philox4x32(mut counter: [u32; 4], mut key: [u32; 2]) -> [u32; 4] {
+    for _ in 0..10 {
+        let product0 = u64::from(PHILOX_M0) * u64::from(counter[0]);
+        let product1 = u64::from(PHILOX_M1) * u64::from(counter[2]);
+        counter = [
+            (product1 >> 32) as u32 ^ counter[1] ^ key[0],
+            product1 as u32,
+            (product0 >> 32) as u32 ^ counter[3] ^ key[1],
+            product0 as u32,
+        ];
+        key = [key[0].wrapping_add(PHILOX_W0), key[1].wrapping_add(PHILOX_W1)];
+    }
+    counter
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::pricing::BlackScholesPricing;
+
+    fn params(is_call: bool) -> OptionParameters {
+        OptionParameters {
+            spot: 70000.0,
+            strike: 70000.0,
+            time_to_expiry: 30.0 / 365.0,
+            volatility: 0.6,
+            risk_free_rate: 0.05,
+            is_call,
+        }
+    }
+
+    fn barrier(kind: BarrierKind, level: f64) -> Payoff {
+        Payoff::Barrier { kind, level }
+    }
+
+    #[test]
+    fn test_philox_known_answers() {
+        // Random123 kat_vectors
+        assert_eq!(
+            philox4x32([0; 4], [0; 2]),
+            [0x6627_e8d5, 0xe169_c58d, 0xbc57_ac4c, 0x9b00_dbd8]
+        );
+        assert_eq!(
+            philox4x32(
+                [0x243f_6a88, 0x85a3_08d3, 0x1319_8a2e, 0x0370_7344],
+                [0xa409_3822, 0x299f_31d0]
+            ),
+            [0xd16c_fe09, 0x94fd_cceb, 0x5001_e420, 0x2412_6ea1]
+        );
+    }
+
+    #[test]
+    fn test_european_matches_black_scholes() {
+        let engine = MonteCarloPricing::new(65_536, 1);
+        let bs = BlackScholesPricing::new();
+
+        for is_call in [true, false] {
+            let params = params(is_call);
+            let estimate = engine.price(&params, Payoff::European);
+            let expected = bs.calculate_option_price(&params);
+            assert!(
+                (estimate.price - expected).abs() < 4.0 * estimate.std_error + 1e-9,
+                "{} vs {} (se {})",
+                estimate.price,
+                expected,
+                estimate.std_error
+            );
+        }
+    }
+
+    #[test]
+    fn test_control_variate_reduces_error() {
+        let params = params(true);
+        let with = MonteCarloPricing::new(32_768, 1).price(&params, Payoff::European);
+        let without = MonteCarloPricing::new(32_768, 1)
+            .without_control_variate()
+            .price(&params, Payoff::European);
+        assert!(with.std_error < 0.5 * without.std_error);
+    }
+
+    #[test]
+    fn test_results_depend_only_on_seed() {
+        let params = params(true);
+        let payoff = Payoff::AsianArithmetic;
+        let engine = MonteCarloPricing::new(10_000, 16).with_seed(7);
+        assert_eq!(engine.price(&params, payoff), engine.clone().price(&params, payoff));
+        assert_ne!(
+            engine.price(&params, payoff),
+            engine.clone().with_seed(8).price(&params, payoff)
+        );
+    }
+
+    #[test]
+    fn test_path_dependent_payoffs() {
+        let engine = MonteCarloPricing::new(32_768, 32);
+        let params = params(true);
+        let vanilla = BlackScholesPricing::new().calculate_option_price(&params);
+
+        // 평균은 만기 현물가보다 분산이 작다
+        let asian = engine.price(&params, Payoff::AsianArithmetic);
+        assert!(asian.price > 0.0 && asian.price < 0.75 * vanilla);
+
+        // knock-in + knock-out = 장벽 없는 옵션
+        let out = engine.price(&params, barrier(BarrierKind::UpAndOut, 84000.0));
+        let into = engine.price(&params, barrier(BarrierKind::UpAndIn, 84000.0));
+        assert!(out.price < vanilla && into.price < vanilla);
+        assert!(
+            (out.price + into.price - vanilla).abs() < 4.0 * (out.std_error + into.std_error)
+        );
+
+        // 현물가가 이미 장벽 아래면 down-and-out은 무가치
+        let knocked = engine.price(&params, barrier(BarrierKind::DownAndOut, 75000.0));
+        assert_eq!(knocked.price, 0.0);
+    }
+
+    #[test]
+    fn test_timestamp_expiry() {
+        let engine = MonteCarloPricing::new(8_192, 8);
+        let now = 1_700_000_000;
+        let option = PathOption {
+            payoff: Payoff::European,
+            is_call: true,
+            spot: 70000.0,
+            strike: 70000.0,
+            volatility: 0.6,
+            risk_free_rate: 0.05,
+            valuation_time: now,
+            expiry_time: now + 30 * 86_400,
+        };
+        assert_eq!(
+            engine.price_option(&option),
+            engine.price(&params(true), Payoff::European)
+        );
+
+        // 만기가 지나면 내재가치
+        let expired = PathOption {
+            spot: 72000.0,
+            expiry_time: now - 60,
+            ..option
+        };
+        let estimate = engine.price_option(&expired);
+        assert!((estimate.price - 2000.0).abs() < 1e-6);
+        assert!(estimate.std_error < 1e-6);
+    }
+
+    #[test]
+    fn test_greeks_track_black_scholes() {
+        let engine = MonteCarloPricing::new(65_536, 1);
+        let bs = BlackScholesPricing::new();
+        let params = params(true);
+
+        assert!((engine.calculate_delta(&params) - bs.calculate_delta(&params)).abs() < 0.02);
+        let vega = bs.calculate_vega(&params);
+        assert!((engine.calculate_vega(&params) - vega).abs() < 0.05 * vega);
+        let theta = bs.calculate_theta(&params);
+        assert!((engine.calculate_theta(&params) - theta).abs() < 0.1 * theta.abs());
+    }
+}
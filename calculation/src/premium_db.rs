@@ -0,0 +1,253 @@
+//! 프리미엄 영구 저장소 (RocksDB, `persistent` 기능)
+//!
+//! 읽기는 메모리 스냅샷(`InMemoryPremiumRepo`)에서만 처리하고, 쓰기는 바뀐 만기의 목록을
+//! RocksDB에도 기록한다. 열 때 저장된 만기를 모두 읽어 스냅샷을 복원하므로 재시작 직후에도
+//! 다시 계산하지 않고 마지막 프리미엄 곡면을 제공한다.
+//!
+//! 모든 쓰기는 블로킹 스레드에서 스냅샷의 writer 락을 잡고 "RocksDB 기록 -> 메모리 발행" 순서로
+//! 처리한다. 동시에 쓰더라도 RocksDB에 남는 값은 마지막으로 발행된 값과 같고, 기록에 실패한
+//! 값은 발행되지 않는다.
+//!
+//! 키: 만기 문자열
+//! 값: `version: u8 | (strike, call_premium, put_premium, implied_volatility): [f64 LE; 4]...`
+//! (행사가 오름차순, 만기는 키에서 복원)
+
+use crate::models::{OptionPremium, PremiumCell};
+use crate::repositories::{InMemoryPremiumRepo, PremiumRepository};
+use async_trait::async_trait;
+use oracle_vm_common::config::DatabaseConfig;
+use rocksdb::{BlockBasedOptions, Cache, DBCompressionType, IteratorMode, Options, WriteBatch, DB};
+use std::sync::Arc;
+
+/// 값 인코딩 버전
+const ENCODING_VERSION: u8 = 1;
+/// 행 하나의 크기 (f64 4개)
+const ROW_LEN: usize = 32;
+
+/// RocksDB 프리미엄 저장소 - 메모리 스냅샷 + write-through
+pub struct RocksDbPremiumRepo {
+    store: Arc<PremiumStore>,
+}
+
+/// 블로킹 쓰기 태스크와 공유하는 상태
+struct PremiumStore {
+    cache: InMemoryPremiumRepo,
+    db: DB,
+}
+
+impl PremiumStore {
+    fn persist(&self, expiry: &str, premiums: &[OptionPremium]) -> Result<(), String> {
+        self.db
+            .put(expiry.as_bytes(), encode(premiums))
+            .map_err(|e| format!("Failed to persist {} premiums: {}", expiry, e))
+    }
+
+    fn delete(&self, expiries: &[Arc<str>]) -> Result<(), String> {
+        let mut batch = WriteBatch::default();
+        for expiry in expiries {
+            batch.delete(expiry.as_bytes());
+        }
+        self.db
+            .write(batch)
+            .map_err(|e| format!("Failed to delete expired premiums: {}", e))
+    }
+
+    fn delete_all(&self) -> Result<(), String> {
+        let mut batch = WriteBatch::default();
+        for entry in self.db.iterator(IteratorMode::Start) {
+            let (key, _) = entry.map_err(|e| format!("Failed to read premium store: {}", e))?;
+            batch.delete(key);
+        }
+        self.db
+            .write(batch)
+            .map_err(|e| format!("Failed to clear premium store: {}", e))
+    }
+}
+
+impl RocksDbPremiumRepo {
+    /// `config.path`에 저장소 열기 (없으면 생성) - 저장된 만기는 모두 메모리로 복원
+    pub fn open(config: &DatabaseConfig) -> Result<Self, String> {
+        let cache = Cache::new_lru_cache(config.cache_size);
+        let mut table = BlockBasedOptions::default();
+        table.set_block_cache(&cache);
+
+        let mut options = Options::default();
+        options.create_if_missing(true);
+        options.set_write_buffer_size(config.write_buffer_size);
+        options.set_block_based_table_factory(&table);
+        options.set_compression_type(DBCompressionType::Lz4);
+
+        let db = DB::open(&options, &config.path)
+            .map_err(|e| format!("Failed to open premium store at {}: {}", config.path, e))?;
+
+        let store = PremiumStore {
+            cache: InMemoryPremiumRepo::new(),
+            db,
+        };
+        for entry in store.db.iterator(IteratorMode::Start) {
+            let (key, value) = entry.map_err(|e| format!("Failed to read premium store: {}", e))?;
+            let expiry = std::str::from_utf8(&key)
+                .map_err(|e| format!("Invalid expiry key in premium store: {}", e))?;
+            store.cache.replace_expiry(expiry, decode(expiry, &value)?.into())?;
+        }
+        Ok(Self {
+            store: Arc::new(store),
+        })
+    }
+
+    /// 저장된 만기 수 (열 때 복원된 수 포함)
+    pub fn expiry_count(&self) -> usize {
+        self.store.cache.expiry_count()
+    }
+
+    /// 블로킹 스레드에서 쓰기 실행 - RocksDB 쓰기가 런타임 워커를 막지 않도록
+    async fn write(
+        &self,
+        op: impl FnOnce(&PremiumStore) -> Result<(), String> + Send + 'static,
+    ) -> Result<(), String> {
+        let store = Arc::clone(&self.store);
+        tokio::task::spawn_blocking(move || op(&store))
+            .await
+            .map_err(|e| format!("Premium store write task failed: {}", e))?
+    }
+}
+
+#[async_trait]
+impl PremiumRepository for RocksDbPremiumRepo {
+    async fn save_premiums(&self, expiry: String, premiums: Vec<OptionPremium>) -> Result<(), String> {
+        self.write(move |store| {
+            store.cache.replace_expiry_with(&expiry, premiums.into(), |premiums| {
+                store.persist(&expiry, premiums)
+            })
+        })
+        .await
+    }
+
+    async fn get_premiums_by_expiry(&self, expiry: &str) -> Result<Arc<[OptionPremium]>, String> {
+        self.store.cache.get_premiums_by_expiry(expiry).await
+    }
+
+    async fn get_all_premiums(&self) -> Result<Arc<[OptionPremium]>, String> {
+        self.store.cache.get_all_premiums().await
+    }
+
+    async fn clear(&self) -> Result<(), String> {
+        self.write(|store| store.cache.clear_all_with(|| store.delete_all()))
+            .await
+    }
+
+    async fn remove_expiries(&self, expiries: &[Arc<str>]) -> Result<(), String> {
+        let expiries = expiries.to_vec();
+        self.write(move |store| store.cache.remove_expiries_with(&expiries, || store.delete(&expiries)))
+            .await
+    }
+
+    async fn update_premium_cells(&self, expiry: &str, cells: &[PremiumCell]) -> Result<(), String> {
+        let expiry = expiry.to_string();
+        let cells = cells.to_vec();
+        self.write(move |store| {
+            store
+                .cache
+                .merge_cells_with(&expiry, &cells, |premiums| store.persist(&expiry, premiums))
+                .map(|_| ())
+        })
+        .await
+    }
+}
+
+fn encode(premiums: &[OptionPremium]) -> Vec<u8> {
+    let mut out = Vec::with_capacity(1 + premiums.len() * ROW_LEN);
+    out.push(ENCODING_VERSION);
+    for premium in premiums {
+        for value in [
+            premium.strike,
+            premium.call_premium,
+            premium.put_premium,
+            premium.implied_volatility,
+        ] {
+            out.extend_from_slice(&value.to_le_bytes());
+        }
+    }
+    out
+}
+
+fn decode(expiry: &str, bytes: &[u8]) -> Result<Vec<OptionPremium>, String> {
+    let (&version, rows) = bytes
+        .split_first()
+        .ok_or_else(|| format!("Empty premium record for {}", expiry))?;
+    if version != ENCODING_VERSION || rows.len() % ROW_LEN != 0 {
+        return Err(format!("Unsupported premium record for {}", expiry));
+    }
+
+    Ok(rows
+        .chunks_exact(ROW_LEN)
+        .map(|row| {
+            let value = |index: usize| {
+                f64::from_le_bytes(row[index * 8..index * 8 + 8].try_into().unwrap())
+            };
+            OptionPremium {
+                strike: value(0),
+                expiry: expiry.to_string(),
+                call_premium: value(1),
+                put_premium: value(2),
+                implied_volatility: value(3),
+            }
+        })
+        .collect())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn temp_config(name: &str) -> DatabaseConfig {
+        let path =
+            std::env::temp_dir().join(format!("premium-db-{}-{}", name, std::process::id()));
+        let _ = std::fs::remove_dir_all(&path);
+        DatabaseConfig {
+            path: path.to_string_lossy().into_owned(),
+            cache_size: 8 * 1024 * 1024,
+            write_buffer_size: 4 * 1024 * 1024,
+        }
+    }
+
+    fn cell(strike: f64, call_premium: f64) -> PremiumCell {
+        PremiumCell {
+            strike,
+            call_premium,
+            put_premium: 500.0,
+            implied_volatility: 0.6,
+        }
+    }
+
+    #[tokio::test]
+    async fn test_premiums_survive_reopen() {
+        let config = temp_config("reopen");
+        {
+            let repo = RocksDbPremiumRepo::open(&config).unwrap();
+            assert_eq!(repo.expiry_count(), 0);
+            repo.update_premium_cells("2024-02-01", &[cell(70000.0, 2500.0), cell(80000.0, 900.0)])
+                .await
+                .unwrap();
+            repo.update_premium_cells("2024-02-01", &[cell(70000.0, 2600.0)])
+                .await
+                .unwrap();
+            repo.update_premium_cells("2024-03-01", &[cell(70000.0, 4000.0)])
+                .await
+                .unwrap();
+        }
+
+        let repo = RocksDbPremiumRepo::open(&config).unwrap();
+        assert_eq!(repo.expiry_count(), 2);
+        let premiums = repo.get_premiums_by_expiry("2024-02-01").await.unwrap();
+        let rows: Vec<(f64, f64)> = premiums.iter().map(|p| (p.strike, p.call_premium)).collect();
+        assert_eq!(rows, vec![(70000.0, 2600.0), (80000.0, 900.0)]);
+        assert_eq!(premiums[0].expiry, "2024-02-01");
+        assert_eq!(repo.get_all_premiums().await.unwrap().len(), 3);
+
+        repo.clear().await.unwrap();
+        drop(repo);
+        assert_eq!(RocksDbPremiumRepo::open(&config).unwrap().expiry_count(), 0);
+        let _ = std::fs::remove_dir_all(&config.path);
+    }
+}
@@ -0,0 +1,164 @@
+//! Aggregator 가격 스트림 구독
+//!
+//! 집계 가격이 갱신될 때마다 시장 상태를 반영하고 프리미엄 서피스를 재계산한다.
+//! 변동성과 거래량은 Aggregator가 스트리밍으로 계산한 실현 변동성/VWAP 구간 거래량을 사용한다.
+//! 스트림이 끊기면 일정 시간 후 재연결한다.
+
+use crate::pricing::PricingEngine;
+use crate::services::{MarketDataService, PremiumCalculationService};
+use std::sync::Arc;
+use std::time::Duration;
+use tonic::Request;
+use tracing::{debug, info, warn};
+
+pub mod oracle {
+    tonic::include_proto!("oracle");
+}
+
+use oracle::{oracle_service_client::OracleServiceClient, GetPriceRequest, PriceRequest};
+
+/// 프리미엄 기준 자산 쌍
+const SURFACE_PAIR: &str = "BTC/USD";
+/// 재연결 대기 시간
+const RECONNECT_DELAY: Duration = Duration::from_secs(5);
+/// 변동성 갱신 임계값 (상대 변화) - 작은 흔들림마다 서피스 전체를 재계산하지 않음
+const VOLATILITY_EPSILON: f64 = 0.01;
+
+/// Aggregator에서 받은 시장 데이터
+struct MarketUpdate {
+    price: f64,
+    timestamp: u64,
+    realized_volatility: Option<f64>,
+    volume: f64,
+}
+
+/// 집계 가격 구독자
+pub struct PriceFeedSubscriber<P> {
+    aggregator_url: String,
+    premium_service: Arc<PremiumCalculationService<P>>,
+    market_service: Arc<MarketDataService>,
+}
+
+impl<P> PriceFeedSubscriber<P>
+where
+    P: PricingEngine + Send + Sync + 'static,
+{
+    pub fn new(
+        aggregator_url: impl Into<String>,
+        premium_service: Arc<PremiumCalculationService<P>>,
+        market_service: Arc<MarketDataService>,
+    ) -> Self {
+        Self {
+            aggregator_url: aggregator_url.into(),
+            premium_service,
+            market_service,
+        }
+    }
+
+    /// 구독 루프 (반환하지 않음) - `tokio::spawn`으로 실행
+    pub async fn run(self) {
+        loop {
+            match self.stream_once().await {
+                Ok(()) => warn!("Aggregated price stream closed by Aggregator"),
+                Err(e) => warn!("Aggregated price stream error: {}", e),
+            }
+            tokio::time::sleep(RECONNECT_DELAY).await;
+        }
+    }
+
+    /// 연결 하나를 끊길 때까지 처리
+    async fn stream_once(&self) -> Result<(), String> {
+        let mut client = OracleServiceClient::connect(self.aggregator_url.clone())
+            .await
+            .map_err(|e| format!("Failed to connect to Aggregator: {}", e))?;
+
+        // 다음 집계까지 기다리지 않도록 현재 스냅샷 먼저 반영
+        let snapshot = client
+            .get_aggregated_price(Request::new(GetPriceRequest {
+                source_filter: None,
+                pair: Some(SURFACE_PAIR.to_string()),
+            }))
+            .await
+            .map_err(|e| e.to_string())?
+            .into_inner();
+        if snapshot.success {
+            self.apply_update(MarketUpdate {
+                price: snapshot.aggregated_price,
+                timestamp: snapshot.last_update,
+                realized_volatility: snapshot.realized_volatility,
+                volume: snapshot.volume,
+            })
+            .await;
+        }
+
+        let mut stream = client
+            .stream_prices(Request::new(tokio_stream::pending::<PriceRequest>()))
+            .await
+            .map_err(|e| e.to_string())?
+            .into_inner();
+        info!(
+            "Subscribed to aggregated price stream at {}",
+            self.aggregator_url
+        );
+
+        while let Some(update) = stream.message().await.map_err(|e| e.to_string())? {
+            // 빈 값은 이전 버전 Aggregator의 BTC/USD
+            if !update.pair.is_empty() && update.pair != SURFACE_PAIR {
+                continue;
+            }
+            self.apply_update(MarketUpdate {
+                price: update.aggregated_price,
+                timestamp: update.timestamp,
+                realized_volatility: update.realized_volatility,
+                volume: update.volume,
+            })
+            .await;
+        }
+
+        Ok(())
+    }
+
+    /// 시장 상태 갱신 후 바뀐 셀만 재계산
+    async fn apply_update(&self, update: MarketUpdate) {
+        let price = update.price;
+        match self.market_service.get_market_state().await {
+            Ok(mut state) => {
+                state.current_price = price;
+                state.timestamp = update.timestamp;
+                state.total_volume = update.volume;
+                if let Some(volatility) = update.realized_volatility {
+                    if volatility_changed(state.volatility_24h, volatility) {
+                        state.volatility_24h = volatility;
+                    }
+                }
+                if let Err(e) = self.market_service.update_market_state(state).await {
+                    warn!("Failed to update market state: {}", e);
+                }
+            }
+            Err(e) => warn!("Failed to read market state: {}", e),
+        }
+
+        match self.premium_service.update_premium_map(price).await {
+            Ok(repriced) => debug!("Spot ${:.2}: repriced {} cells", price, repriced),
+            Err(e) => warn!("Failed to update premium map: {}", e),
+        }
+    }
+}
+
+/// 변동성이 임계값 이상 바뀌었는지 (현재 값이 없으면 항상 반영)
+fn volatility_changed(current: f64, next: f64) -> bool {
+    !current.is_finite() || current <= 0.0 || (next - current).abs() > VOLATILITY_EPSILON * current
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_small_volatility_moves_are_ignored() {
+        assert!(volatility_changed(f64::NAN, 0.6));
+        assert!(volatility_changed(0.0, 0.6));
+        assert!(!volatility_changed(0.6, 0.603));
+        assert!(volatility_changed(0.6, 0.61));
+    }
+}
@@ -1,4 +1,5 @@
-use crate::models::OptionParameters;
+use crate::batch;
+use crate::models::{ChainGreeks, OptionChain, OptionParameters};
 
 /// Black-Scholes 가격 계산 인터페이스
 pub trait PricingEngine {
@@ -8,6 +9,42 @@ pub trait PricingEngine {
     fn calculate_vega(&self, params: &OptionParameters) -> f64;
     fn calculate_theta(&self, params: &OptionParameters) -> f64;
     fn calculate_rho(&self, params: &OptionParameters) -> f64;
+
+    /// 옵션 체인 전체의 콜/풋 가격과 Greeks를 한 번에 계산
+    ///
+    /// 기본 구현은 옵션별 메서드를 반복 호출한다.
+    fn price_chain(
+        &self,
+        spot: f64,
+        risk_free_rate: f64,
+        chain: &OptionChain,
+        out: &mut ChainGreeks,
+    ) {
+        out.resize(chain.len());
+
+        for i in 0..chain.len() {
+            let mut params = OptionParameters {
+                spot,
+                strike: chain.strikes[i],
+                time_to_expiry: chain.time_to_expiry[i],
+                volatility: chain.volatility[i],
+                risk_free_rate,
+                is_call: true,
+            };
+            out.call_price[i] = self.calculate_option_price(&params);
+            out.call_delta[i] = self.calculate_delta(&params);
+            out.gamma[i] = self.calculate_gamma(&params);
+            out.vega[i] = self.calculate_vega(&params);
+            out.call_theta[i] = self.calculate_theta(&params);
+            out.call_rho[i] = self.calculate_rho(&params);
+
+            params.is_call = false;
+            out.put_price[i] = self.calculate_option_price(&params);
+            out.put_delta[i] = self.calculate_delta(&params);
+            out.put_theta[i] = self.calculate_theta(&params);
+            out.put_rho[i] = self.calculate_rho(&params);
+        }
+    }
 }
 
 /// Black-Scholes 가격 계산 엔진
@@ -39,6 +76,35 @@ impl BlackScholesPricing {
     fn calculate_d2(&self, d1: f64, params: &OptionParameters) -> f64 {
         d1 - params.volatility * params.time_to_expiry.sqrt()
     }
+
+    /// theta와 변동성에 대한 theta 민감도(dθ/dσ)를 한 번에 계산 - IV 역산용
+    ///
+    /// theta 단위는 `calculate_theta`와 같고, 민감도는 변동성 1.0(100%p)당 theta 변화량.
+    pub fn theta_and_vol_sensitivity(&self, params: &OptionParameters) -> (f64, f64) {
+        if params.time_to_expiry <= 0.0 {
+            return (0.0, 0.0);
+        }
+
+        let d1 = self.calculate_d1(params);
+        let d2 = self.calculate_d2(d1, params);
+        let sqrt_t = params.time_to_expiry.sqrt();
+        let n_prime_d1 = self.normal_pdf(d1);
+        let discount_factor = (-params.risk_free_rate * params.time_to_expiry).exp();
+
+        let time_decay = -(params.spot * n_prime_d1 * params.volatility) / (2.0 * sqrt_t);
+        let carry = if params.is_call {
+            -params.risk_free_rate * params.strike * discount_factor * self.normal_cdf(d2)
+        } else {
+            params.risk_free_rate * params.strike * discount_factor * self.normal_cdf(-d2)
+        };
+
+        // 콜/풋 공통 (차이는 σ와 무관): dθ/dσ = S·φ(d1)·(r·d1/σ - (1 + d1·d2)/(2√T))
+        let sensitivity = params.spot
+            * n_prime_d1
+            * (params.risk_free_rate * d1 / params.volatility - (1.0 + d1 * d2) / (2.0 * sqrt_t));
+
+        ((time_decay + carry) / 365.0, sensitivity / 365.0)
+    }
 }
 
 impl Default for BlackScholesPricing {
@@ -160,19 +226,109 @@ impl PricingEngine for BlackScholesPricing {
             -params.strike * params.time_to_expiry * discount_factor * n_neg_d2 / 100.0
         }
     }
+
+    /// d1/d2, 할인계수, 정규분포 값을 옵션당 한 번만 계산하는 fused 커널 사용
+    fn price_chain(
+        &self,
+        spot: f64,
+        risk_free_rate: f64,
+        chain: &OptionChain,
+        out: &mut ChainGreeks,
+    ) {
+        batch::black_scholes_chain(spot, risk_free_rate, chain, out);
+    }
+}
+
+/// 연 단위 환산 (ACT/365)
+const SECONDS_PER_YEAR: f64 = 365.0 * 86_400.0;
+
+/// 평가 시각부터 만기까지 시간 (Unix 초 → 연 단위, 만기가 지났으면 0)
+pub fn time_to_expiry_between(valuation_time: u64, expiry_time: u64) -> f64 {
+    expiry_time.saturating_sub(valuation_time) as f64 / SECONDS_PER_YEAR
 }
 
-/// 만기일까지 시간 계산 유틸리티
+const SECONDS_PER_DAY: u64 = 86_400;
+
+/// 현재 Unix 시각 (초)
+pub fn unix_now() -> u64 {
+    std::time::SystemTime::now()
+        .duration_since(std::time::UNIX_EPOCH)
+        .map(|elapsed| elapsed.as_secs())
+        .unwrap_or(0)
+}
+
+/// 만기일 문자열("YYYY-MM-DD")의 만기 시각 (해당일 00:00 UTC, Unix 초)
+pub fn expiry_timestamp(expiry: &str) -> Option<u64> {
+    let mut parts = expiry.splitn(3, '-');
+    let year: i64 = parts.next()?.parse().ok()?;
+    let month: u32 = parts.next()?.parse().ok()?;
+    let day: u32 = parts.next()?.parse().ok()?;
+    if !(1..=12).contains(&month) || day == 0 || day > days_in_month(year, month) {
+        return None;
+    }
+
+    let days = days_from_civil(year, month, day);
+    u64::try_from(days).ok().map(|days| days * SECONDS_PER_DAY)
+}
+
+/// `now` 이후 매월 1일 만기 `count`개 ("YYYY-MM-01", 가까운 순)
+pub fn monthly_expiries(now: u64, count: usize) -> Vec<String> {
+    let (mut year, mut month, _) = civil_from_days((now / SECONDS_PER_DAY) as i64);
+    (0..count)
+        .map(|_| {
+            if month == 12 {
+                year += 1;
+                month = 1;
+            } else {
+                month += 1;
+            }
+            format!("{:04}-{:02}-01", year, month)
+        })
+        .collect()
+}
+
+/// 만기일까지 시간 계산 유틸리티 (현재 시각 기준, 형식이 잘못되면 0)
 pub fn calculate_time_to_expiry(expiry: &str) -> f64 {
-    // 실제 구현에서는 chrono 등을 사용하여 정확한 날짜 계산
-    match expiry {
-        "2024-02-01" => 30.0 / 365.0,
-        "2024-03-01" => 60.0 / 365.0,
-        "2024-04-01" => 90.0 / 365.0,
-        _ => 30.0 / 365.0,
+    expiry_timestamp(expiry)
+        .map(|expiry_time| time_to_expiry_between(unix_now(), expiry_time))
+        .unwrap_or(0.0)
+}
+
+fn days_in_month(year: i64, month: u32) -> u32 {
+    match month {
+        2 if year % 4 == 0 && (year % 100 != 0 || year % 400 == 0) => 29,
+        2 => 28,
+        4 | 6 | 9 | 11 => 30,
+        _ => 31,
     }
 }
 
+/// 1970-01-01 기준 일수 (그레고리력, Howard Hinnant 알고리즘)
+fn days_from_civil(year: i64, month: u32, day: u32) -> i64 {
+    let year = if month <= 2 { year - 1 } else { year };
+    let era = year.div_euclid(400);
+    let year_of_era = year - era * 400;
+    let month_index = (month as i64 + 9) % 12;
+    let day_of_year = (153 * month_index + 2) / 5 + day as i64 - 1;
+    let day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    era * 146_097 + day_of_era - 719_468
+}
+
+/// `days_from_civil`의 역변환 - (연, 월, 일)
+fn civil_from_days(days: i64) -> (i64, u32, u32) {
+    let days = days + 719_468;
+    let era = days.div_euclid(146_097);
+    let day_of_era = days - era * 146_097;
+    let year_of_era =
+        (day_of_era - day_of_era / 1460 + day_of_era / 36_524 - day_of_era / 146_096) / 365;
+    let day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    let month_index = (5 * day_of_year + 2) / 153;
+    let day = (day_of_year - (153 * month_index + 2) / 5 + 1) as u32;
+    let month = if month_index < 10 { month_index + 3 } else { month_index - 9 } as u32;
+    let year = year_of_era + era * 400 + if month <= 2 { 1 } else { 0 };
+    (year, month, day)
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -195,6 +351,30 @@ mod tests {
         assert!(price < params.spot);
     }
 
+    #[test]
+    fn test_time_to_expiry_between() {
+        let now = 1_700_000_000;
+        assert!((time_to_expiry_between(now, now + 365 * 86_400) - 1.0).abs() < 1e-12);
+        assert_eq!(time_to_expiry_between(now, now - 1), 0.0);
+    }
+
+    #[test]
+    fn test_expiry_dates() {
+        assert_eq!(expiry_timestamp("1970-01-01"), Some(0));
+        assert_eq!(expiry_timestamp("2024-02-01"), Some(1_706_745_600));
+        assert_eq!(expiry_timestamp("2024-02-29"), Some(1_709_164_800));
+        assert_eq!(expiry_timestamp("2023-02-29"), None);
+        assert_eq!(expiry_timestamp("2024-13-01"), None);
+        assert_eq!(expiry_timestamp("next-month"), None);
+
+        // 2024-01-15 기준 / 연말 넘김
+        assert_eq!(
+            monthly_expiries(1_705_276_800, 3),
+            vec!["2024-02-01", "2024-03-01", "2024-04-01"]
+        );
+        assert_eq!(monthly_expiries(1_734_220_800, 2), vec!["2025-01-01", "2025-02-01"]);
+    }
+
     #[test]
     fn test_greeks_calculation() {
         let pricing = BlackScholesPricing::new();
@@ -0,0 +1,426 @@
+//! 사전 직렬화된 시세 응답
+//!
+//! 프리미엄 곡면은 재계산될 때 한 번만 JSON으로 인코딩해 불변 `Bytes`로 보관한다. API는 그
+//! 버퍼를 그대로 돌려주고 (ETag가 같으면 304, 클라이언트가 허용하면 미리 압축해 둔 gzip -
+//! gzip 본문은 바이트가 다르므로 ETag도 따로 둔다),
+//! 바뀐 셀은 한 번 인코딩한 diff 이벤트로 SSE 구독자 모두에게 전달한다. 격자에서 빠진 만기는
+//! `removed` 목록이 있는 diff로 알린다.
+
+use crate::models::{OptionPremium, PremiumCell};
+use arc_swap::ArcSwap;
+use bytes::Bytes;
+use flate2::write::GzEncoder;
+use flate2::Compression;
+use serde::Serialize;
+use std::collections::BTreeMap;
+use std::io::Write;
+use std::sync::{Arc, Mutex};
+use tokio::sync::broadcast;
+
+/// 이보다 작은 본문은 압축하지 않음
+const GZIP_MIN_LEN: usize = 1024;
+/// 구독자별 diff 버퍼 - 넘치면 해당 구독자에게 스냅샷을 다시 보낸다
+const DIFF_BUFFER: usize = 64;
+
+/// 인코딩된 응답 본문
+#[derive(Debug)]
+pub struct EncodedBody {
+    pub json: Bytes,
+    /// gzip 본문 (작은 본문은 `None`)
+    pub gzip: Option<Bytes>,
+    /// 강한 ETag (따옴표 포함) - 본문 해시라서 내용이 같으면 재시작 후에도 같다
+    pub etag: String,
+    /// gzip 본문의 강한 ETag (`"<해시>-gz"`)
+    pub gzip_etag: String,
+}
+
+impl EncodedBody {
+    pub fn encode<T: Serialize + ?Sized>(value: &T) -> Result<Self, String> {
+        serde_json::to_vec(value)
+            .map(Self::from_json)
+            .map_err(|e| format!("Failed to encode response: {}", e))
+    }
+
+    pub fn from_json(json: Vec<u8>) -> Self {
+        let hash = fnv1a(&json);
+        let gzip = (json.len() >= GZIP_MIN_LEN).then(|| gzip(&json));
+        Self {
+            json: json.into(),
+            gzip,
+            etag: format!("\"{:016x}\"", hash),
+            gzip_etag: format!("\"{:016x}-gz\"", hash),
+        }
+    }
+
+    /// `If-None-Match` 값에 현재 본문의 ETag가 있는지 (약한 비교, 두 인코딩 중 어느 것이든)
+    pub fn matches(&self, if_none_match: &str) -> bool {
+        if_none_match.split(',').map(str::trim).any(|tag| {
+            let tag = tag.trim_start_matches("W/");
+            tag == "*" || tag == self.etag || tag == self.gzip_etag
+        })
+    }
+}
+
+/// `Accept-Encoding`이 gzip을 허용하는지 (`q=0`은 거부)
+pub fn accepts_gzip(accept_encoding: &str) -> bool {
+    accept_encoding.split(',').any(|entry| {
+        let mut parts = entry.split(';').map(str::trim);
+        let coding = parts.next().unwrap_or_default();
+        let rejected = parts.any(|param| {
+            param
+                .strip_prefix("q=")
+                .and_then(|q| q.parse::<f32>().ok())
+                .is_some_and(|q| q <= 0.0)
+        });
+        (coding.eq_ignore_ascii_case("gzip") || coding == "*") && !rejected
+    })
+}
+
+/// 프리미엄 diff 이벤트 - `data`는 `{"version":N,"premiums":[...]}` JSON
+/// (만기 삭제는 `{"version":N,"premiums":[],"removed":["YYYY-MM-DD",...]}`)
+#[derive(Debug, Clone)]
+pub struct QuoteDiff {
+    pub version: u64,
+    pub data: Arc<str>,
+}
+
+/// diff 행 - `OptionPremium`과 같은 모양 (클라이언트는 만기+행사가로 병합)
+#[derive(Serialize)]
+struct DiffRow<'a> {
+    strike: f64,
+    expiry: &'a str,
+    call_premium: f64,
+    put_premium: f64,
+    implied_volatility: f64,
+}
+
+/// 한 버전의 응답 본문
+struct QuoteSet {
+    version: u64,
+    by_expiry: BTreeMap<Arc<str>, Arc<EncodedBody>>,
+    /// 만기 순 전체 목록
+    all: Arc<EncodedBody>,
+}
+
+impl Default for QuoteSet {
+    fn default() -> Self {
+        Self {
+            version: 0,
+            by_expiry: BTreeMap::new(),
+            all: Arc::new(EncodedBody::from_json(b"[]".to_vec())),
+        }
+    }
+}
+
+/// 프리미엄 응답 캐시
+///
+/// 읽기는 현재 버전에서 `Arc` 하나만 복제한다. 게시는 바뀐 만기만 다시 인코딩하고 전체 목록은
+/// 만기별 JSON 배열을 이어 붙여 만든다 (재직렬화 없음).
+pub struct PremiumQuotes {
+    current: ArcSwap<QuoteSet>,
+    diffs: broadcast::Sender<QuoteDiff>,
+    writer: Mutex<()>,
+}
+
+impl PremiumQuotes {
+    pub fn new() -> Self {
+        let (diffs, _) = broadcast::channel(DIFF_BUFFER);
+        Self {
+            current: ArcSwap::from_pointee(QuoteSet::default()),
+            diffs,
+            writer: Mutex::new(()),
+        }
+    }
+
+    /// 만기 하나 (`None`이면 전체) 본문 - 없는 만기는 `None`
+    pub fn get(&self, expiry: Option<&str>) -> Option<Arc<EncodedBody>> {
+        let current = self.current.load();
+        match expiry {
+            Some(expiry) => current.by_expiry.get(expiry).cloned(),
+            None => Some(Arc::clone(&current.all)),
+        }
+    }
+
+    /// 현재 버전과 전체 본문
+    pub fn snapshot(&self) -> (u64, Arc<EncodedBody>) {
+        let current = self.current.load();
+        (current.version, Arc::clone(&current.all))
+    }
+
+    /// diff 구독 - 스냅샷보다 먼저 구독하므로 스냅샷 버전 이후의 diff는 빠짐없이 받는다
+    /// (스냅샷 버전 이하의 diff는 받는 쪽에서 버린다)
+    pub fn subscribe(&self) -> (u64, Arc<EncodedBody>, broadcast::Receiver<QuoteDiff>) {
+        let receiver = self.diffs.subscribe();
+        let (version, all) = self.snapshot();
+        (version, all, receiver)
+    }
+
+    /// 바뀐 만기의 목록을 인코딩해 새 버전으로 교체하고 바뀐 셀을 diff로 전송, 새 버전 반환
+    pub fn publish(
+        &self,
+        expiries: &[(Arc<str>, Arc<[OptionPremium]>)],
+        changed: &[(Arc<str>, Vec<PremiumCell>)],
+    ) -> Result<u64, String> {
+        // 인코딩은 락 밖에서
+        let encoded = expiries
+            .iter()
+            .map(|(expiry, premiums)| {
+                Ok((
+                    Arc::clone(expiry),
+                    Arc::new(EncodedBody::encode(&**premiums)?),
+                ))
+            })
+            .collect::<Result<Vec<_>, String>>()?;
+        let rows: Vec<DiffRow> = changed
+            .iter()
+            .flat_map(|(expiry, cells)| {
+                cells.iter().map(move |cell| DiffRow {
+                    strike: cell.strike,
+                    expiry,
+                    call_premium: cell.call_premium,
+                    put_premium: cell.put_premium,
+                    implied_volatility: cell.implied_volatility,
+                })
+            })
+            .collect();
+        let rows = serde_json::to_string(&rows)
+            .map_err(|e| format!("Failed to encode premium diff: {}", e))?;
+
+        let _writer = self.writer.lock().map_err(|_| "Lock error")?;
+        let current = self.current.load();
+        let version = current.version + 1;
+        let mut by_expiry = current.by_expiry.clone();
+        by_expiry.extend(encoded);
+        let all = Arc::new(join_arrays(by_expiry.values()));
+        self.current.store(Arc::new(QuoteSet {
+            version,
+            by_expiry,
+            all,
+        }));
+
+        // 버전 순서를 지키도록 락 안에서 전송 (구독자가 없으면 실패 - 무시)
+        if !changed.is_empty() {
+            let data = format!("{{\"version\":{},\"premiums\":{}}}", version, rows);
+            let _ = self.diffs.send(QuoteDiff {
+                version,
+                data: data.into(),
+            });
+        }
+        Ok(version)
+    }
+
+    /// 만기 목록을 빼고 새 버전으로 교체한 뒤 삭제 diff 전송, 새 버전 반환
+    pub fn remove(&self, expiries: &[Arc<str>]) -> Result<u64, String> {
+        let removed = serde_json::to_string(expiries)
+            .map_err(|e| format!("Failed to encode premium diff: {}", e))?;
+
+        let _writer = self.writer.lock().map_err(|_| "Lock error")?;
+        let current = self.current.load();
+        let version = current.version + 1;
+        let mut by_expiry = current.by_expiry.clone();
+        for expiry in expiries {
+            by_expiry.remove(expiry);
+        }
+        let all = Arc::new(join_arrays(by_expiry.values()));
+        self.current.store(Arc::new(QuoteSet {
+            version,
+            by_expiry,
+            all,
+        }));
+
+        let data = format!(
+            "{{\"version\":{},\"premiums\":[],\"removed\":{}}}",
+            version, removed
+        );
+        let _ = self.diffs.send(QuoteDiff {
+            version,
+            data: data.into(),
+        });
+        Ok(version)
+    }
+}
+
+impl Default for PremiumQuotes {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// 만기별 JSON 배열을 이어 붙여 전체 배열 구성
+fn join_arrays<'a>(bodies: impl Iterator<Item = &'a Arc<EncodedBody>>) -> EncodedBody {
+    let mut json = vec![b'['];
+    for body in bodies {
+        let inner = &body.json[1..body.json.len() - 1];
+        if inner.is_empty() {
+            continue;
+        }
+        if json.len() > 1 {
+            json.push(b',');
+        }
+        json.extend_from_slice(inner);
+    }
+    json.push(b']');
+    EncodedBody::from_json(json)
+}
+
+fn gzip(json: &[u8]) -> Bytes {
+    let mut encoder = GzEncoder::new(Vec::with_capacity(json.len() / 4), Compression::default());
+    encoder
+        .write_all(json)
+        .and_then(|_| encoder.finish())
+        .map(Bytes::from)
+        .expect("in-memory gzip cannot fail")
+}
+
+/// FNV-1a 64비트 (ETag용)
+fn fnv1a(bytes: &[u8]) -> u64 {
+    bytes.iter().fold(0xcbf2_9ce4_8422_2325, |hash, &byte| {
+        (hash ^ u64::from(byte)).wrapping_mul(0x0100_0000_01b3)
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn premiums(expiry: &str, strikes: &[f64]) -> (Arc<str>, Arc<[OptionPremium]>) {
+        let rows: Vec<OptionPremium> = strikes
+            .iter()
+            .map(|&strike| OptionPremium {
+                strike,
+                expiry: expiry.to_string(),
+                call_premium: 1000.0,
+                put_premium: 500.0,
+                implied_volatility: 0.6,
+            })
+            .collect();
+        (expiry.into(), rows.into())
+    }
+
+    fn cell(strike: f64) -> PremiumCell {
+        PremiumCell {
+            strike,
+            call_premium: 1000.0,
+            put_premium: 500.0,
+            implied_volatility: 0.6,
+        }
+    }
+
+    #[test]
+    fn test_all_matches_direct_encoding() {
+        let quotes = PremiumQuotes::new();
+        let march = premiums("2024-03-01", &[70000.0]);
+        let february = premiums("2024-02-01", &[60000.0, 70000.0]);
+        quotes.publish(&[march.clone()], &[]).unwrap();
+        quotes
+            .publish(&[february.clone(), premiums("2024-04-01", &[])], &[])
+            .unwrap();
+
+        let expected: Vec<OptionPremium> =
+            february.1.iter().chain(march.1.iter()).cloned().collect();
+        let all = quotes.get(None).unwrap();
+        assert_eq!(all.json, serde_json::to_vec(&expected).unwrap());
+        assert_eq!(
+            quotes.get(Some("2024-03-01")).unwrap().json,
+            serde_json::to_vec(&*march.1).unwrap()
+        );
+        assert!(quotes.get(Some("2024-05-01")).is_none());
+    }
+
+    #[test]
+    fn test_etag_follows_content() {
+        let quotes = PremiumQuotes::new();
+        quotes
+            .publish(&[premiums("2024-02-01", &[70000.0])], &[])
+            .unwrap();
+        let first = quotes.get(Some("2024-02-01")).unwrap();
+
+        // 다른 만기만 바뀌면 이 만기의 본문과 ETag는 그대로 공유
+        quotes
+            .publish(&[premiums("2024-03-01", &[70000.0])], &[])
+            .unwrap();
+        let second = quotes.get(Some("2024-02-01")).unwrap();
+        assert!(Arc::ptr_eq(&first, &second));
+        assert_ne!(first.etag, quotes.get(None).unwrap().etag);
+
+        assert!(first.matches(&first.etag));
+        assert!(first.matches(&format!("\"other\", W/{}", first.etag)));
+        assert!(first.matches("*"));
+        assert!(!first.matches("\"other\""));
+    }
+
+    #[test]
+    fn test_large_bodies_are_precompressed() {
+        let strikes: Vec<f64> = (0..100).map(|i| 50000.0 + i as f64 * 500.0).collect();
+        let body = EncodedBody::encode(&*premiums("2024-02-01", &strikes).1).unwrap();
+        let gzip = body.gzip.as_ref().unwrap();
+        assert!(gzip.len() < body.json.len());
+
+        let mut decoded = Vec::new();
+        std::io::Read::read_to_end(&mut flate2::read::GzDecoder::new(&gzip[..]), &mut decoded)
+            .unwrap();
+        assert_eq!(decoded, body.json);
+        assert!(EncodedBody::from_json(b"[]".to_vec()).gzip.is_none());
+
+        // 인코딩마다 다른 강한 ETag - 어느 쪽으로 다시 요청해도 일치
+        assert_ne!(body.etag, body.gzip_etag);
+        assert!(body.matches(&body.etag));
+        assert!(body.matches(&body.gzip_etag));
+    }
+
+    #[test]
+    fn test_accepts_gzip() {
+        assert!(accepts_gzip("gzip, deflate, br"));
+        assert!(accepts_gzip("br;q=1.0, GZIP;q=0.5"));
+        assert!(accepts_gzip("*"));
+        assert!(!accepts_gzip("gzip;q=0, br"));
+        assert!(!accepts_gzip("identity"));
+    }
+
+    #[test]
+    fn test_diffs_follow_snapshot() {
+        let quotes = PremiumQuotes::new();
+        quotes
+            .publish(&[premiums("2024-02-01", &[70000.0])], &[])
+            .unwrap();
+
+        let (version, _, mut diffs) = quotes.subscribe();
+        assert_eq!(version, 1);
+        let next = quotes
+            .publish(
+                &[premiums("2024-02-01", &[70000.0])],
+                &[("2024-02-01".into(), vec![cell(70000.0)])],
+            )
+            .unwrap();
+
+        let diff = diffs.try_recv().unwrap();
+        assert_eq!(diff.version, next);
+        let payload: serde_json::Value = serde_json::from_str(&diff.data).unwrap();
+        assert_eq!(payload["version"], 2);
+        assert_eq!(payload["premiums"][0]["expiry"], "2024-02-01");
+        assert_eq!(payload["premiums"][0]["strike"], 70000.0);
+    }
+
+    #[test]
+    fn test_removed_expiries_leave_snapshot() {
+        let quotes = PremiumQuotes::new();
+        let march = premiums("2024-03-01", &[70000.0]);
+        quotes
+            .publish(&[premiums("2024-02-01", &[70000.0]), march.clone()], &[])
+            .unwrap();
+
+        let (_, _, mut diffs) = quotes.subscribe();
+        let version = quotes.remove(&["2024-02-01".into()]).unwrap();
+        assert!(quotes.get(Some("2024-02-01")).is_none());
+        assert_eq!(
+            quotes.get(None).unwrap().json,
+            serde_json::to_vec(&*march.1).unwrap()
+        );
+
+        let diff = diffs.try_recv().unwrap();
+        assert_eq!(diff.version, version);
+        let payload: serde_json::Value = serde_json::from_str(&diff.data).unwrap();
+        assert_eq!(payload["removed"][0], "2024-02-01");
+        assert_eq!(payload["premiums"].as_array().unwrap().len(), 0);
+    }
+}
@@ -1,15 +1,58 @@
-use crate::models::{DeltaInfo, MarketState, OptionPremium};
+use crate::models::{DeltaInfo, MarketState, OptionPremium, PremiumCell};
+use arc_swap::ArcSwap;
 use async_trait::async_trait;
 use std::collections::HashMap;
-use std::sync::RwLock;
+use std::sync::{Arc, Mutex, OnceLock, RwLock};
 
 /// 프리미엄 저장소 인터페이스
+///
+/// 조회 결과는 불변 목록을 공유하는 `Arc` - 요청마다 데이터를 복제하지 않는다.
 #[async_trait]
 pub trait PremiumRepository: Send + Sync {
     async fn save_premiums(&self, expiry: String, premiums: Vec<OptionPremium>) -> Result<(), String>;
-    async fn get_premiums_by_expiry(&self, expiry: &str) -> Result<Vec<OptionPremium>, String>;
-    async fn get_all_premiums(&self) -> Result<Vec<OptionPremium>, String>;
+    async fn get_premiums_by_expiry(&self, expiry: &str) -> Result<Arc<[OptionPremium]>, String>;
+    /// 모든 만기의 프리미엄 (만기, 행사가 순)
+    async fn get_all_premiums(&self) -> Result<Arc<[OptionPremium]>, String>;
     async fn clear(&self) -> Result<(), String>;
+    /// 만기 목록 삭제 (없는 만기는 무시)
+    async fn remove_expiries(&self, expiries: &[Arc<str>]) -> Result<(), String>;
+
+    /// 만기 하나에서 주어진 행사가의 프리미엄만 갱신 (없는 행사가는 추가)
+    ///
+    /// 기본 구현은 만기 전체를 읽어 병합한 뒤 다시 저장한다.
+    async fn update_premium_cells(&self, expiry: &str, cells: &[PremiumCell]) -> Result<(), String> {
+        let mut premiums = self
+            .get_premiums_by_expiry(expiry)
+            .await
+            .map(|premiums| premiums.to_vec())
+            .unwrap_or_default();
+        for cell in cells {
+            merge_premium_cell(&mut premiums, expiry, cell);
+        }
+        self.save_premiums(expiry.to_string(), premiums).await
+    }
+}
+
+/// 행사가 오름차순 목록에 셀 하나 반영 - 기존 행은 제자리 갱신 (문자열 할당 없음)
+fn merge_premium_cell(premiums: &mut Vec<OptionPremium>, expiry: &str, cell: &PremiumCell) {
+    match premiums.binary_search_by(|premium| premium.strike.total_cmp(&cell.strike)) {
+        Ok(position) => {
+            let premium = &mut premiums[position];
+            premium.call_premium = cell.call_premium;
+            premium.put_premium = cell.put_premium;
+            premium.implied_volatility = cell.implied_volatility;
+        }
+        Err(position) => premiums.insert(
+            position,
+            OptionPremium {
+                strike: cell.strike,
+                expiry: expiry.to_string(),
+                call_premium: cell.call_premium,
+                put_premium: cell.put_premium,
+                implied_volatility: cell.implied_volatility,
+            },
+        ),
+    }
 }
 
 /// 풀 상태 저장소 인터페이스
@@ -26,16 +69,147 @@ pub trait MarketDataRepository: Send + Sync {
     async fn update_state(&self, state: MarketState) -> Result<(), String>;
 }
 
+/// 프리미엄 스냅샷 - 만기별 불변 목록
+#[derive(Default)]
+struct PremiumSnapshot {
+    by_expiry: HashMap<String, Arc<[OptionPremium]>>,
+    /// 전체 목록 - 스냅샷마다 첫 전체 조회 때 한 번만 만든다
+    all: OnceLock<Arc<[OptionPremium]>>,
+}
+
+impl PremiumSnapshot {
+    fn all(&self) -> Arc<[OptionPremium]> {
+        self.all
+            .get_or_init(|| {
+                let mut expiries: Vec<_> = self.by_expiry.iter().collect();
+                expiries.sort_unstable_by(|a, b| a.0.cmp(b.0));
+                expiries
+                    .into_iter()
+                    .flat_map(|(_, premiums)| premiums.iter().cloned())
+                    .collect()
+            })
+            .clone()
+    }
+}
+
 /// 인메모리 프리미엄 저장소 구현
+///
+/// 읽기는 락 없이 현재 스냅샷에서 `Arc` 하나만 복제한다. 쓰기는 바뀐 만기의 목록만 새로
+/// 만들어 스냅샷을 교체하며 (나머지 만기는 포인터만 복사), 쓰기끼리는 `writer` 락으로 직렬화한다.
 pub struct InMemoryPremiumRepo {
-    data: RwLock<HashMap<String, Vec<OptionPremium>>>,
+    snapshot: ArcSwap<PremiumSnapshot>,
+    writer: Mutex<()>,
 }
 
 impl InMemoryPremiumRepo {
     pub fn new() -> Self {
         Self {
-            data: RwLock::new(HashMap::new()),
+            snapshot: ArcSwap::from_pointee(PremiumSnapshot::default()),
+            writer: Mutex::new(()),
+        }
+    }
+
+    /// 저장된 만기 수
+    pub fn expiry_count(&self) -> usize {
+        self.snapshot.load().by_expiry.len()
+    }
+
+    /// 만기 하나의 목록 교체
+    pub fn replace_expiry(&self, expiry: &str, premiums: Arc<[OptionPremium]>) -> Result<(), String> {
+        self.replace_expiry_with(expiry, premiums, |_| Ok(()))
+    }
+
+    /// 만기 하나의 목록 교체 - `persist`가 성공한 뒤에만 발행
+    ///
+    /// `persist`는 writer 락 안에서 호출되므로 영구 저장 순서와 발행 순서가 같다.
+    pub fn replace_expiry_with(
+        &self,
+        expiry: &str,
+        premiums: Arc<[OptionPremium]>,
+        persist: impl FnOnce(&[OptionPremium]) -> Result<(), String>,
+    ) -> Result<(), String> {
+        let _writer = self.writer.lock().map_err(|_| "Lock error")?;
+        persist(&premiums)?;
+        self.publish(|by_expiry| {
+            by_expiry.insert(expiry.to_string(), premiums);
+        });
+        Ok(())
+    }
+
+    /// 만기 하나에 셀 반영 후 새 목록 반환
+    pub fn merge_cells(&self, expiry: &str, cells: &[PremiumCell]) -> Result<Arc<[OptionPremium]>, String> {
+        self.merge_cells_with(expiry, cells, |_| Ok(()))
+    }
+
+    /// 만기 하나에 셀 반영 - 병합한 목록을 `persist`한 뒤 발행 (writer 락 안)
+    pub fn merge_cells_with(
+        &self,
+        expiry: &str,
+        cells: &[PremiumCell],
+        persist: impl FnOnce(&[OptionPremium]) -> Result<(), String>,
+    ) -> Result<Arc<[OptionPremium]>, String> {
+        let _writer = self.writer.lock().map_err(|_| "Lock error")?;
+        let mut premiums = self
+            .snapshot
+            .load()
+            .by_expiry
+            .get(expiry)
+            .map(|premiums| premiums.to_vec())
+            .unwrap_or_default();
+        for cell in cells {
+            merge_premium_cell(&mut premiums, expiry, cell);
         }
+
+        let premiums: Arc<[OptionPremium]> = premiums.into();
+        persist(&premiums)?;
+        self.publish(|by_expiry| {
+            // 이미 있는 만기는 키 문자열을 새로 만들지 않음
+            match by_expiry.get_mut(expiry) {
+                Some(slot) => *slot = Arc::clone(&premiums),
+                None => {
+                    by_expiry.insert(expiry.to_string(), Arc::clone(&premiums));
+                }
+            }
+        });
+        Ok(premiums)
+    }
+
+    pub fn clear_all(&self) -> Result<(), String> {
+        self.clear_all_with(|| Ok(()))
+    }
+
+    /// 모든 만기 삭제 - `persist`가 성공한 뒤에만 발행 (writer 락 안)
+    pub fn clear_all_with(&self, persist: impl FnOnce() -> Result<(), String>) -> Result<(), String> {
+        let _writer = self.writer.lock().map_err(|_| "Lock error")?;
+        persist()?;
+        self.snapshot.store(Arc::new(PremiumSnapshot::default()));
+        Ok(())
+    }
+
+    /// 만기 목록 삭제 - `persist`가 성공한 뒤에만 발행 (writer 락 안)
+    pub fn remove_expiries_with(
+        &self,
+        expiries: &[Arc<str>],
+        persist: impl FnOnce() -> Result<(), String>,
+    ) -> Result<(), String> {
+        let _writer = self.writer.lock().map_err(|_| "Lock error")?;
+        persist()?;
+        self.publish(|by_expiry| {
+            for expiry in expiries {
+                by_expiry.remove(&**expiry);
+            }
+        });
+        Ok(())
+    }
+
+    /// 현재 스냅샷을 복사해 수정한 뒤 교체 (`writer` 락을 잡고 호출)
+    fn publish(&self, edit: impl FnOnce(&mut HashMap<String, Arc<[OptionPremium]>>)) {
+        let mut by_expiry = self.snapshot.load().by_expiry.clone();
+        edit(&mut by_expiry);
+        self.snapshot.store(Arc::new(PremiumSnapshot {
+            by_expiry,
+            all: OnceLock::new(),
+        }));
     }
 }
 
@@ -48,27 +222,32 @@ impl Default for InMemoryPremiumRepo {
 #[async_trait]
 impl PremiumRepository for InMemoryPremiumRepo {
     async fn save_premiums(&self, expiry: String, premiums: Vec<OptionPremium>) -> Result<(), String> {
-        let mut data = self.data.write().map_err(|_| "Lock error")?;
-        data.insert(expiry, premiums);
-        Ok(())
+        self.replace_expiry(&expiry, premiums.into())
     }
 
-    async fn get_premiums_by_expiry(&self, expiry: &str) -> Result<Vec<OptionPremium>, String> {
-        let data = self.data.read().map_err(|_| "Lock error")?;
-        data.get(expiry)
+    async fn get_premiums_by_expiry(&self, expiry: &str) -> Result<Arc<[OptionPremium]>, String> {
+        self.snapshot
+            .load()
+            .by_expiry
+            .get(expiry)
             .cloned()
             .ok_or_else(|| "Premiums not found".to_string())
     }
 
-    async fn get_all_premiums(&self) -> Result<Vec<OptionPremium>, String> {
-        let data = self.data.read().map_err(|_| "Lock error")?;
-        Ok(data.values().flat_map(|v| v.clone()).collect())
+    async fn get_all_premiums(&self) -> Result<Arc<[OptionPremium]>, String> {
+        Ok(self.snapshot.load().all())
     }
 
     async fn clear(&self) -> Result<(), String> {
-        let mut data = self.data.write().map_err(|_| "Lock error")?;
-        data.clear();
-        Ok(())
+        self.clear_all()
+    }
+
+    async fn remove_expiries(&self, expiries: &[Arc<str>]) -> Result<(), String> {
+        self.remove_expiries_with(expiries, || Ok(()))
+    }
+
+    async fn update_premium_cells(&self, expiry: &str, cells: &[PremiumCell]) -> Result<(), String> {
+        self.merge_cells(expiry, cells).map(|_| ())
     }
 }
 
@@ -165,6 +344,92 @@ mod tests {
         assert_eq!(retrieved[0].strike, 70000.0);
     }
 
+    #[tokio::test]
+    async fn test_update_premium_cells_in_place() {
+        let repo = InMemoryPremiumRepo::new();
+        let cell = |strike: f64, call_premium: f64| PremiumCell {
+            strike,
+            call_premium,
+            put_premium: 0.0,
+            implied_volatility: 0.6,
+        };
+
+        repo.update_premium_cells("2024-02-01", &[cell(70000.0, 2500.0), cell(80000.0, 900.0)])
+            .await
+            .unwrap();
+        repo.update_premium_cells("2024-02-01", &[cell(60000.0, 9000.0), cell(70000.0, 2600.0)])
+            .await
+            .unwrap();
+
+        let retrieved = repo.get_premiums_by_expiry("2024-02-01").await.unwrap();
+        let strikes: Vec<f64> = retrieved.iter().map(|p| p.strike).collect();
+        assert_eq!(strikes, vec![60000.0, 70000.0, 80000.0]);
+        assert_eq!(retrieved[1].call_premium, 2600.0);
+        assert_eq!(retrieved[1].expiry, "2024-02-01");
+    }
+
+    #[tokio::test]
+    async fn test_reads_share_snapshot() {
+        let repo = InMemoryPremiumRepo::new();
+        let cell = |strike: f64| PremiumCell {
+            strike,
+            call_premium: 1000.0,
+            put_premium: 1000.0,
+            implied_volatility: 0.6,
+        };
+        repo.update_premium_cells("2024-03-01", &[cell(70000.0)]).await.unwrap();
+        repo.update_premium_cells("2024-02-01", &[cell(65000.0), cell(75000.0)])
+            .await
+            .unwrap();
+
+        let first = repo.get_premiums_by_expiry("2024-02-01").await.unwrap();
+        let second = repo.get_premiums_by_expiry("2024-02-01").await.unwrap();
+        assert!(Arc::ptr_eq(&first, &second));
+
+        let all = repo.get_all_premiums().await.unwrap();
+        assert!(Arc::ptr_eq(&all, &repo.get_all_premiums().await.unwrap()));
+        let rows: Vec<(&str, f64)> = all.iter().map(|p| (p.expiry.as_str(), p.strike)).collect();
+        assert_eq!(
+            rows,
+            vec![("2024-02-01", 65000.0), ("2024-02-01", 75000.0), ("2024-03-01", 70000.0)]
+        );
+
+        // 다른 만기 갱신은 기존 목록을 그대로 공유하고, 전체 목록만 다시 만든다
+        repo.update_premium_cells("2024-03-01", &[cell(80000.0)]).await.unwrap();
+        let unchanged = repo.get_premiums_by_expiry("2024-02-01").await.unwrap();
+        assert!(Arc::ptr_eq(&first, &unchanged));
+        assert_eq!(repo.get_all_premiums().await.unwrap().len(), 4);
+        // 이전에 받은 목록은 그대로 유지
+        assert_eq!(all.len(), 3);
+    }
+
+    #[tokio::test]
+    async fn test_failed_persist_publishes_nothing() {
+        let repo = InMemoryPremiumRepo::new();
+        let cell = |call_premium: f64| PremiumCell {
+            strike: 70000.0,
+            call_premium,
+            put_premium: 0.0,
+            implied_volatility: 0.6,
+        };
+        repo.update_premium_cells("2024-02-01", &[cell(2500.0)]).await.unwrap();
+
+        let mut persisted = Vec::new();
+        repo.merge_cells_with("2024-02-01", &[cell(2600.0)], |premiums| {
+            persisted.push(premiums[0].call_premium);
+            Ok(())
+        })
+        .unwrap();
+        assert_eq!(persisted, vec![2600.0]);
+
+        let result =
+            repo.merge_cells_with("2024-02-01", &[cell(2700.0)], |_| Err("disk full".to_string()));
+        assert!(result.is_err());
+        assert!(repo.clear_all_with(|| Err("disk full".to_string())).is_err());
+        let retrieved = repo.get_premiums_by_expiry("2024-02-01").await.unwrap();
+        assert_eq!(retrieved[0].call_premium, 2600.0);
+    }
+
     #[tokio::test]
     async fn test_pool_repository() {
         let repo = InMemoryPoolRepo::new();
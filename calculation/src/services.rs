@@ -1,87 +1,224 @@
-use crate::models::{DeltaInfo, MarketState, OptionParameters, OptionPremium};
-use crate::pricing::{calculate_time_to_expiry, PricingEngine};
+use crate::metrics::SURFACE_REPRICE_SECONDS;
+use crate::models::{DeltaInfo, MarketState, OptionPremium, PremiumCell};
+use crate::pricing::{monthly_expiries, unix_now, PricingEngine};
+use crate::quotes::{EncodedBody, PremiumQuotes};
 use crate::repositories::{MarketDataRepository, PoolStateRepository, PremiumRepository};
-use std::sync::Arc;
+use crate::surface::PremiumSurface;
+use arc_swap::ArcSwapOption;
+use std::collections::{BTreeSet, HashSet};
+use std::sync::{Arc, Mutex};
+use std::time::{Duration, Instant};
+use tracing::{debug, warn};
+
+/// 기본 프리미엄 격자 (만기는 재계산 시점 이후 매월 1일 3개 - 만기가 지나면 다음 달로 교체)
+const DEFAULT_STRIKES: [f64; 5] = [60000.0, 65000.0, 70000.0, 75000.0, 80000.0];
+const DEFAULT_EXPIRY_COUNT: usize = 3;
+const DEFAULT_RISK_FREE_RATE: f64 = 0.05;
+/// 재계산이 이보다 오래 걸리면 경고 (집계 tick 안에 끝나야 함)
+const REPRICE_BUDGET: Duration = Duration::from_millis(500);
+
+/// 평가 시각 (Unix 초)
+pub type Clock = Arc<dyn Fn() -> u64 + Send + Sync>;
+
+/// 매월 만기 격자를 `now` 기준 만기로 교체하고 빠진 만기 반환 (지정한 격자는 그대로)
+fn roll_expiries(
+    surface: &mut PremiumSurface,
+    monthly_expiry_count: Option<usize>,
+    now: u64,
+) -> Vec<Arc<str>> {
+    let Some(count) = monthly_expiry_count else {
+        return Vec::new();
+    };
+    let expiries = monthly_expiries(now, count);
+    let expiries: Vec<&str> = expiries.iter().map(String::as_str).collect();
+    surface.set_expiries(&expiries)
+}
 
 /// 프리미엄 계산 서비스
 pub struct PremiumCalculationService<P> {
-    pricing_engine: P,
+    pricing_engine: Arc<P>,
     premium_repo: Arc<dyn PremiumRepository>,
     market_repo: Arc<dyn MarketDataRepository>,
+    /// 마지막 계산 결과 - 입력이 바뀐 셀만 다시 계산 (블로킹 스레드에서만 잠금)
+    surface: Arc<Mutex<PremiumSurface>>,
+    /// 매월 만기 격자의 만기 수 (`None`이면 지정한 격자를 그대로 사용)
+    monthly_expiry_count: Option<usize>,
+    clock: Clock,
+    /// 재계산마다 한 번 인코딩한 API 응답
+    quotes: PremiumQuotes,
 }
 
 impl<P> PremiumCalculationService<P>
 where
-    P: PricingEngine,
+    P: PricingEngine + Send + Sync + 'static,
 {
     pub fn new(
         pricing_engine: P,
         premium_repo: Arc<dyn PremiumRepository>,
         market_repo: Arc<dyn MarketDataRepository>,
     ) -> Self {
+        // 변동성은 매 갱신 시 시장 상태에서 설정
+        let expiries = monthly_expiries(unix_now(), DEFAULT_EXPIRY_COUNT);
+        let expiries: Vec<&str> = expiries.iter().map(String::as_str).collect();
+        let surface = PremiumSurface::new(
+            &DEFAULT_STRIKES,
+            &expiries,
+            f64::NAN,
+            DEFAULT_RISK_FREE_RATE,
+        );
         Self {
-            pricing_engine,
+            monthly_expiry_count: Some(DEFAULT_EXPIRY_COUNT),
+            ..Self::with_surface(pricing_engine, premium_repo, market_repo, surface)
+        }
+    }
+
+    /// 행사가/만기 격자를 지정해 생성
+    pub fn with_surface(
+        pricing_engine: P,
+        premium_repo: Arc<dyn PremiumRepository>,
+        market_repo: Arc<dyn MarketDataRepository>,
+        surface: PremiumSurface,
+    ) -> Self {
+        Self {
+            pricing_engine: Arc::new(pricing_engine),
             premium_repo,
             market_repo,
+            surface: Arc::new(Mutex::new(surface)),
+            monthly_expiry_count: None,
+            clock: Arc::new(unix_now),
+            quotes: PremiumQuotes::new(),
         }
     }
 
-    /// 프리미엄 맵 업데이트
-    pub async fn update_premium_map(&self, current_price: f64) -> Result<(), String> {
-        let strikes = vec![60000.0, 65000.0, 70000.0, 75000.0, 80000.0];
-        let expiries = vec!["2024-02-01", "2024-03-01", "2024-04-01"];
-        let risk_free_rate = 0.05;
-
-        let market_state = self.market_repo.get_current_state().await?;
-
-        for expiry in &expiries {
-            let mut options = Vec::new();
-            let time_to_expiry = calculate_time_to_expiry(expiry);
-
-            for &strike in &strikes {
-                let call_params = OptionParameters {
-                    spot: current_price,
-                    strike,
-                    time_to_expiry,
-                    volatility: market_state.volatility_24h,
-                    risk_free_rate,
-                    is_call: true,
-                };
-
-                let put_params = OptionParameters {
-                    spot: current_price,
-                    strike,
-                    time_to_expiry,
-                    volatility: market_state.volatility_24h,
-                    risk_free_rate,
-                    is_call: false,
-                };
-
-                let call_premium = self.pricing_engine.calculate_option_price(&call_params);
-                let put_premium = self.pricing_engine.calculate_option_price(&put_params);
-
-                options.push(OptionPremium {
-                    strike,
-                    expiry: expiry.to_string(),
-                    call_premium,
-                    put_premium,
-                    implied_volatility: market_state.volatility_24h,
-                });
+    /// 평가 시각 (기본은 시스템 시각)
+    pub fn with_clock(mut self, clock: impl Fn() -> u64 + Send + Sync + 'static) -> Self {
+        self.clock = Arc::new(clock);
+        self
+    }
+
+    /// 프리미엄 맵 업데이트 - 입력이 바뀐 셀만 재계산해 저장하고 재계산한 셀 수 반환
+    ///
+    /// 잔존 기간은 호출 시각 기준이므로 현물가/변동성이 그대로여도 시간이 지나면 재계산된다.
+    /// 매월 만기 격자는 먼저 호출 시각 기준 만기로 교체하고, 지난 만기는 저장소와 응답에서 뺀다.
+    pub async fn update_premium_map(&self, current_price: f64) -> Result<usize, String> {
+        let volatility = self.market_repo.get_current_state().await?.volatility_24h;
+
+        // 병렬 재계산은 CPU 작업 - 런타임 워커를 막지 않도록 블로킹 스레드에서 실행하고,
+        // 락은 그 스레드 안에서만 보유 (저장소 await 전에 해제)
+        let surface = Arc::clone(&self.surface);
+        let engine = Arc::clone(&self.pricing_engine);
+        let clock = Arc::clone(&self.clock);
+        let monthly_expiry_count = self.monthly_expiry_count;
+        let (repriced, updates, removed) = tokio::task::spawn_blocking(move || {
+            let mut surface = surface.lock().map_err(|_| "Lock error")?;
+            let now = clock();
+            let removed = roll_expiries(&mut surface, monthly_expiry_count, now);
+            surface.set_volatility(volatility);
+
+            let started = Instant::now();
+            let repriced = surface.reprice_at(&*engine, current_price, now);
+            let elapsed = started.elapsed();
+            SURFACE_REPRICE_SECONDS
+                .with_label_values(&[])
+                .observe(elapsed.as_secs_f64());
+            if elapsed > REPRICE_BUDGET {
+                warn!(
+                    "Repricing {}/{} cells took {}ms (budget {}ms)",
+                    repriced.len(),
+                    surface.len(),
+                    elapsed.as_millis(),
+                    REPRICE_BUDGET.as_millis()
+                );
+            } else {
+                debug!(
+                    "Repriced {}/{} cells in {}us",
+                    repriced.len(),
+                    surface.len(),
+                    elapsed.as_micros()
+                );
             }
 
+            Ok::<_, String>((repriced.len(), surface.cells_by_expiry(&repriced), removed))
+        })
+        .await
+        .map_err(|e| format!("Repricing task failed: {}", e))??;
+
+        if !removed.is_empty() {
+            debug!("Rolled expired premiums off the grid: {:?}", removed);
+            self.premium_repo.remove_expiries(&removed).await?;
+            self.quotes.remove(&removed)?;
+        }
+
+        for (expiry, cells) in &updates {
             self.premium_repo
-                .save_premiums(expiry.to_string(), options)
+                .update_premium_cells(expiry, cells)
                 .await?;
         }
+        if !updates.is_empty() {
+            self.publish_quotes(&updates).await?;
+        }
 
-        Ok(())
+        Ok(repriced)
+    }
+
+    /// 저장소에 있는 프리미엄 전체로 응답 캐시 구성 (복원된 저장소로 시작할 때)
+    ///
+    /// 중지된 동안 만기가 지나 현재 격자에 없는 만기는 발행하지 않고 저장소에서 지운다.
+    /// 발행한 만기 수를 반환.
+    pub async fn publish_stored_premiums(&self) -> Result<usize, String> {
+        // 첫 재계산 전이므로 격자를 먼저 현재 시각 기준으로 맞춤
+        let grid: HashSet<Arc<str>> = {
+            let mut surface = self.surface.lock().map_err(|_| "Lock error")?;
+            roll_expiries(&mut surface, self.monthly_expiry_count, (self.clock)());
+            surface.expiries().iter().cloned().collect()
+        };
+
+        // 저장소의 정렬 순서에 기대지 않고 만기별로 묶음
+        let all = self.premium_repo.get_all_premiums().await?;
+        let stored: BTreeSet<&str> = all.iter().map(|premium| premium.expiry.as_str()).collect();
+        let mut expiries = Vec::new();
+        let mut stale: Vec<Arc<str>> = Vec::new();
+        for expiry in stored {
+            if !grid.contains(expiry) {
+                stale.push(expiry.into());
+                continue;
+            }
+            let premiums = self.premium_repo.get_premiums_by_expiry(expiry).await?;
+            expiries.push((expiry.into(), premiums));
+        }
+
+        if !stale.is_empty() {
+            debug!("Dropping restored premiums off the grid: {:?}", stale);
+            self.premium_repo.remove_expiries(&stale).await?;
+        }
+        if !expiries.is_empty() {
+            self.quotes.publish(&expiries, &[])?;
+        }
+        Ok(expiries.len())
+    }
+
+    /// 사전 인코딩된 프리미엄 응답
+    pub fn quotes(&self) -> &PremiumQuotes {
+        &self.quotes
+    }
+
+    /// 바뀐 만기를 다시 인코딩해 게시하고 바뀐 셀을 diff로 전송
+    async fn publish_quotes(&self, updates: &[(Arc<str>, Vec<PremiumCell>)]) -> Result<(), String> {
+        let mut expiries = Vec::with_capacity(updates.len());
+        for (expiry, _) in updates {
+            expiries.push((
+                Arc::clone(expiry),
+                self.premium_repo.get_premiums_by_expiry(expiry).await?,
+            ));
+        }
+        self.quotes.publish(&expiries, updates).map(|_| ())
     }
 
     /// 특정 만기의 프리미엄 조회
     pub async fn get_premiums_by_expiry(
         &self,
         expiry: Option<String>,
-    ) -> Result<Vec<OptionPremium>, String> {
+    ) -> Result<Arc<[OptionPremium]>, String> {
         if let Some(exp) = expiry {
             self.premium_repo.get_premiums_by_expiry(&exp).await
         } else {
@@ -128,11 +265,16 @@ impl DeltaManagementService {
 /// 시장 데이터 서비스
 pub struct MarketDataService {
     market_repo: Arc<dyn MarketDataRepository>,
+    /// 인코딩된 현재 상태 - 갱신 때 교체, 비어 있으면 첫 조회 때 채움
+    encoded: ArcSwapOption<EncodedBody>,
 }
 
 impl MarketDataService {
     pub fn new(market_repo: Arc<dyn MarketDataRepository>) -> Self {
-        Self { market_repo }
+        Self {
+            market_repo,
+            encoded: ArcSwapOption::empty(),
+        }
     }
 
     /// 현재 시장 상태 조회
@@ -140,9 +282,25 @@ impl MarketDataService {
         self.market_repo.get_current_state().await
     }
 
+    /// 인코딩된 현재 시장 상태
+    pub async fn get_market_state_body(&self) -> Result<Arc<EncodedBody>, String> {
+        if let Some(body) = self.encoded.load_full() {
+            return Ok(body);
+        }
+
+        let body = Arc::new(EncodedBody::encode(&self.market_repo.get_current_state().await?)?);
+        // 그 사이 갱신이 들어왔으면 갱신 쪽 본문을 유지
+        self.encoded
+            .compare_and_swap(&None::<Arc<EncodedBody>>, Some(Arc::clone(&body)));
+        Ok(body)
+    }
+
     /// 시장 상태 업데이트
     pub async fn update_market_state(&self, state: MarketState) -> Result<(), String> {
-        self.market_repo.update_state(state).await
+        let body = EncodedBody::encode(&state)?;
+        self.market_repo.update_state(state).await?;
+        self.encoded.store(Some(Arc::new(body)));
+        Ok(())
     }
 }
 
@@ -164,14 +322,149 @@ mod tests {
             market_repo.clone(),
         );
 
-        service.update_premium_map(70000.0).await.unwrap();
+        assert_eq!(service.update_premium_map(70000.0).await.unwrap(), 15);
 
+        // 기본 만기는 현재 시각 이후 매월 1일
+        let expiry = monthly_expiries(unix_now(), 1).remove(0);
         let premiums = service
-            .get_premiums_by_expiry(Some("2024-02-01".to_string()))
+            .get_premiums_by_expiry(Some(expiry.clone()))
+            .await
+            .unwrap();
+
+        assert_eq!(premiums.len(), 5);
+
+        // 입력이 그대로면 재계산 없음, 변동성이 바뀌면 전체 재계산
+        assert_eq!(service.update_premium_map(70000.0).await.unwrap(), 0);
+        market_repo
+            .update_state(MarketState::new(70000.0, 0.8))
+            .await
+            .unwrap();
+        assert_eq!(service.update_premium_map(70000.0).await.unwrap(), 15);
+
+        let updated = service
+            .get_premiums_by_expiry(Some(expiry.clone()))
+            .await
+            .unwrap();
+        assert_eq!(updated.len(), 5);
+        assert_eq!(updated[0].implied_volatility, 0.8);
+        assert!(updated[0].call_premium > premiums[0].call_premium);
+
+        // 응답 캐시는 재계산이 있던 갱신마다 한 버전씩 (재계산 없는 갱신은 게시하지 않음)
+        let (version, all) = service.quotes().snapshot();
+        assert_eq!(version, 2);
+        let stored = service.get_premiums_by_expiry(None).await.unwrap();
+        assert_eq!(all.json, serde_json::to_vec(&*stored).unwrap());
+        assert_eq!(
+            service.quotes().get(Some(&expiry)).unwrap().json,
+            serde_json::to_vec(&*updated).unwrap()
+        );
+    }
+
+    #[tokio::test]
+    async fn test_expiry_grid_rolls_with_clock() {
+        use std::sync::atomic::{AtomicU64, Ordering};
+
+        // 2024-01-15 00:00 UTC
+        let now = Arc::new(AtomicU64::new(1_705_276_800));
+        let clock = Arc::clone(&now);
+        let premium_repo = Arc::new(InMemoryPremiumRepo::new());
+        let service = PremiumCalculationService::new(
+            BlackScholesPricing::new(),
+            premium_repo.clone(),
+            Arc::new(InMemoryMarketRepo::new()),
+        )
+        .with_clock(move || clock.load(Ordering::Relaxed));
+
+        assert_eq!(service.update_premium_map(70000.0).await.unwrap(), 15);
+        assert!(service.quotes().get(Some("2024-02-01")).is_some());
+        let (_, _, mut diffs) = service.quotes().subscribe();
+
+        // 가장 가까운 만기가 지나면 그 행을 빼고 다음 달 만기를 추가
+        now.store(1_706_745_600 + 60, Ordering::Relaxed);
+        assert_eq!(service.update_premium_map(70000.0).await.unwrap(), 15);
+        assert!(premium_repo.get_premiums_by_expiry("2024-02-01").await.is_err());
+        assert!(service.quotes().get(Some("2024-02-01")).is_none());
+        let may = service
+            .get_premiums_by_expiry(Some("2024-05-01".to_string()))
             .await
             .unwrap();
+        assert_eq!(may.len(), 5);
+        assert!(may.iter().all(|premium| premium.call_premium > 0.0));
+
+        let expiries: Vec<String> = service
+            .get_premiums_by_expiry(None)
+            .await
+            .unwrap()
+            .iter()
+            .map(|premium| premium.expiry.clone())
+            .collect();
+        assert_eq!(expiries.len(), 15);
+        assert_eq!(expiries[0], "2024-03-01");
+        let removal: serde_json::Value =
+            serde_json::from_str(&diffs.try_recv().unwrap().data).unwrap();
+        assert_eq!(removal["removed"][0], "2024-02-01");
+    }
+
+    #[tokio::test]
+    async fn test_restored_premiums_off_the_grid_are_pruned() {
+        // 2024-02-01 00:01 UTC - 2024-02-01 만기는 이미 지남
+        let premium_repo = Arc::new(InMemoryPremiumRepo::new());
+        let service = PremiumCalculationService::new(
+            BlackScholesPricing::new(),
+            premium_repo.clone(),
+            Arc::new(InMemoryMarketRepo::new()),
+        )
+        .with_clock(|| 1_706_745_600 + 60);
+
+        // 중지 전에 저장된 만기 (저장 순서는 정렬되어 있지 않음)
+        let premium = |expiry: &str, strike: f64| OptionPremium {
+            strike,
+            expiry: expiry.to_string(),
+            call_premium: 1.0,
+            put_premium: 1.0,
+            implied_volatility: 0.6,
+        };
+        for expiry in ["2024-03-01", "2024-02-01", "2024-04-01"] {
+            premium_repo
+                .save_premiums(
+                    expiry.to_string(),
+                    vec![premium(expiry, 60000.0), premium(expiry, 70000.0)],
+                )
+                .await
+                .unwrap();
+        }
+
+        assert_eq!(service.publish_stored_premiums().await.unwrap(), 2);
+        assert!(premium_repo.get_premiums_by_expiry("2024-02-01").await.is_err());
+        assert!(service.quotes().get(Some("2024-02-01")).is_none());
+        assert_eq!(service.quotes().get(Some("2024-03-01")).unwrap().json, {
+            let stored = premium_repo.get_premiums_by_expiry("2024-03-01").await.unwrap();
+            serde_json::to_vec(&*stored).unwrap()
+        });
+        let (_, all) = service.quotes().snapshot();
+        let published: Vec<OptionPremium> = serde_json::from_slice(&all.json).unwrap();
+        assert_eq!(published.len(), 4);
+
+        // 첫 재계산은 남은 만기를 유지하고 새 만기만 추가
+        assert_eq!(service.update_premium_map(70000.0).await.unwrap(), 15);
+        assert!(premium_repo.get_premiums_by_expiry("2024-02-01").await.is_err());
+        assert!(service.quotes().get(Some("2024-05-01")).is_some());
+    }
+
+    #[tokio::test]
+    async fn test_market_state_body_follows_updates() {
+        let service = MarketDataService::new(Arc::new(InMemoryMarketRepo::new()));
+        let initial = service.get_market_state_body().await.unwrap();
+        assert!(Arc::ptr_eq(&initial, &service.get_market_state_body().await.unwrap()));
 
-        assert!(!premiums.is_empty());
+        service
+            .update_market_state(MarketState::new(71000.0, 0.7))
+            .await
+            .unwrap();
+        let updated = service.get_market_state_body().await.unwrap();
+        assert_ne!(initial.etag, updated.etag);
+        let state: MarketState = serde_json::from_slice(&updated.json).unwrap();
+        assert_eq!(state.current_price, 71000.0);
     }
 
     #[tokio::test]
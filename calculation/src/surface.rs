@@ -0,0 +1,401 @@
+//! 실시간 프리미엄 서피스
+//!
+//! 행사가 x 만기 격자의 마지막 계산 결과와, 셀별로 계산 당시의 입력(현물가, 변동성, 잔존 기간)을
+//! 보관한다. 잔존 기간은 재계산마다 평가 시각에서 다시 구하므로 만기가 다가오면 시간 가치가 줄어든다.
+//! 새 입력이 들어오면 임계값 이상 바뀐 셀만 골라 rayon으로 나눠 다시 계산한다.
+
+use crate::models::{ChainGreeks, OptionChain, PremiumCell};
+use crate::pricing::{expiry_timestamp, time_to_expiry_between, unix_now, PricingEngine};
+use rayon::prelude::*;
+use std::sync::Arc;
+
+/// 현물가 재계산 임계값 기본값 (상대 변화 0.01%)
+pub const DEFAULT_SPOT_EPSILON: f64 = 1e-4;
+/// 잔존 기간 재계산 임계값 기본값 (초) - 이보다 시간이 덜 지났으면 시간 감소만으로는 재계산 안 함
+pub const DEFAULT_TIME_EPSILON_SECS: u64 = 60;
+/// 병렬 작업 단위 (셀 수) - 이보다 작은 체인은 스레드 하나에서 계산
+const CHUNK_SIZE: usize = 512;
+
+/// 행사가 x 만기 프리미엄 서피스
+pub struct PremiumSurface {
+    /// 오름차순 행사가
+    strikes: Vec<f64>,
+    expiries: Vec<Arc<str>>,
+    /// 만기별 만기 시각 (Unix 초)
+    expiry_times: Vec<u64>,
+    risk_free_rate: f64,
+    spot_epsilon: f64,
+    /// 잔존 기간 재계산 임계값 (연 단위)
+    time_epsilon: f64,
+    /// 셀 입력 (인덱스 = 만기 * strikes.len() + 행사가)
+    chain: OptionChain,
+    /// 셀별 마지막 계산 결과
+    greeks: ChainGreeks,
+    /// 셀별 마지막 계산 현물가 (NaN = 아직 계산 안 됨)
+    priced_spot: Vec<f64>,
+    /// 셀별 마지막 계산 변동성
+    priced_volatility: Vec<f64>,
+    /// 셀별 마지막 계산 잔존 기간
+    priced_time: Vec<f64>,
+}
+
+impl PremiumSurface {
+    /// 만기는 "YYYY-MM-DD" (해당일 00:00 UTC 만기) - 형식이 잘못된 만기는 이미 만기된 것으로 계산
+    pub fn new(strikes: &[f64], expiries: &[&str], volatility: f64, risk_free_rate: f64) -> Self {
+        let mut strikes = strikes.to_vec();
+        strikes.sort_by(f64::total_cmp);
+        strikes.dedup();
+
+        // 잔존 기간은 재계산 때마다 평가 시각 기준으로 채움
+        let chain = OptionChain::grid(&strikes, &vec![0.0; expiries.len()], volatility);
+        let mut greeks = ChainGreeks::default();
+        greeks.resize(chain.len());
+
+        Self {
+            priced_spot: vec![f64::NAN; chain.len()],
+            priced_volatility: vec![f64::NAN; chain.len()],
+            priced_time: vec![f64::NAN; chain.len()],
+            strikes,
+            expiries: expiries.iter().map(|&expiry| Arc::from(expiry)).collect(),
+            expiry_times: expiries
+                .iter()
+                .map(|expiry| expiry_timestamp(expiry).unwrap_or(0))
+                .collect(),
+            risk_free_rate,
+            spot_epsilon: DEFAULT_SPOT_EPSILON,
+            time_epsilon: time_to_expiry_between(0, DEFAULT_TIME_EPSILON_SECS),
+            chain,
+            greeks,
+        }
+    }
+
+    /// 현물가 재계산 임계값 설정 (상대 변화)
+    pub fn with_spot_epsilon(mut self, spot_epsilon: f64) -> Self {
+        self.spot_epsilon = spot_epsilon;
+        self
+    }
+
+    /// 잔존 기간 재계산 임계값 설정 (초)
+    pub fn with_time_epsilon(mut self, seconds: u64) -> Self {
+        self.time_epsilon = time_to_expiry_between(0, seconds);
+        self
+    }
+
+    pub fn strikes(&self) -> &[f64] {
+        &self.strikes
+    }
+
+    pub fn expiries(&self) -> &[Arc<str>] {
+        &self.expiries
+    }
+
+    /// 셀 수
+    pub fn len(&self) -> usize {
+        self.chain.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.chain.is_empty()
+    }
+
+    pub fn greeks(&self) -> &ChainGreeks {
+        &self.greeks
+    }
+
+    /// 만기 목록 교체 - 남는 만기는 계산 결과를 유지하고, 새 만기는 다음 `reprice`에서 계산한다
+    ///
+    /// 새 만기 행의 변동성은 첫 셀의 변동성으로 채운다. 목록에서 빠진 만기를 반환.
+    pub fn set_expiries(&mut self, expiries: &[&str]) -> Vec<Arc<str>> {
+        if self.expiries.iter().map(|expiry| &**expiry).eq(expiries.iter().copied()) {
+            return Vec::new();
+        }
+
+        let row_len = self.strikes.len();
+        let volatility = self.chain.volatility.first().copied().unwrap_or(f64::NAN);
+        let len = expiries.len() * row_len;
+        let mut chain = OptionChain::with_capacity(len);
+        let mut greeks = ChainGreeks::default();
+        greeks.resize(len);
+        let mut priced_spot = Vec::with_capacity(len);
+        let mut priced_volatility = Vec::with_capacity(len);
+        let mut priced_time = Vec::with_capacity(len);
+        let mut kept = Vec::with_capacity(expiries.len());
+
+        for (row, &expiry) in expiries.iter().enumerate() {
+            let previous = self.expiries.iter().position(|current| **current == *expiry);
+            for (offset, &strike) in self.strikes.iter().enumerate() {
+                let index = row * row_len + offset;
+                match previous {
+                    Some(previous) => {
+                        let old = previous * row_len + offset;
+                        chain.push(
+                            strike,
+                            self.chain.time_to_expiry[old],
+                            self.chain.volatility[old],
+                        );
+                        greeks.copy_row(index, &self.greeks, old);
+                        priced_spot.push(self.priced_spot[old]);
+                        priced_volatility.push(self.priced_volatility[old]);
+                        priced_time.push(self.priced_time[old]);
+                    }
+                    None => {
+                        chain.push(strike, 0.0, volatility);
+                        priced_spot.push(f64::NAN);
+                        priced_volatility.push(f64::NAN);
+                        priced_time.push(f64::NAN);
+                    }
+                }
+            }
+            kept.push(match previous {
+                Some(previous) => Arc::clone(&self.expiries[previous]),
+                None => Arc::from(expiry),
+            });
+        }
+
+        let removed = self
+            .expiries
+            .iter()
+            .filter(|current| !expiries.contains(&&***current))
+            .cloned()
+            .collect();
+        self.expiry_times = expiries
+            .iter()
+            .map(|expiry| expiry_timestamp(expiry).unwrap_or(0))
+            .collect();
+        self.expiries = kept;
+        self.chain = chain;
+        self.greeks = greeks;
+        self.priced_spot = priced_spot;
+        self.priced_volatility = priced_volatility;
+        self.priced_time = priced_time;
+        removed
+    }
+
+    /// 모든 만기의 변동성 설정 (다음 `reprice`에서 값이 바뀐 셀만 재계산)
+    pub fn set_volatility(&mut self, volatility: f64) {
+        self.chain.volatility.fill(volatility);
+    }
+
+    /// 만기 하나의 변동성 설정
+    pub fn set_expiry_volatility(&mut self, expiry: usize, volatility: f64) {
+        let row = expiry * self.strikes.len();
+        self.chain.volatility[row..row + self.strikes.len()].fill(volatility);
+    }
+
+    /// 평가 시각 기준 잔존 기간으로 격자 갱신
+    fn set_valuation_time(&mut self, valuation_time: u64) {
+        let row_len = self.strikes.len();
+        for (expiry, &expiry_time) in self.expiry_times.iter().enumerate() {
+            let row = expiry * row_len;
+            self.chain.time_to_expiry[row..row + row_len]
+                .fill(time_to_expiry_between(valuation_time, expiry_time));
+        }
+    }
+
+    /// 마지막 계산 이후 입력이 임계값 이상 바뀌었는지
+    fn is_stale(&self, index: usize, spot: f64) -> bool {
+        let priced_spot = self.priced_spot[index];
+        priced_spot.is_nan()
+            || (spot - priced_spot).abs() > self.spot_epsilon * priced_spot
+            || self.chain.volatility[index] != self.priced_volatility[index]
+            || (self.chain.time_to_expiry[index] - self.priced_time[index]).abs()
+                >= self.time_epsilon
+    }
+
+    /// 현재 시각 기준으로 입력이 바뀐 셀만 재계산 - 재계산한 셀 인덱스를 오름차순으로 반환
+    pub fn reprice<P: PricingEngine + Sync>(&mut self, engine: &P, spot: f64) -> Vec<usize> {
+        self.reprice_at(engine, spot, unix_now())
+    }
+
+    /// `valuation_time`(Unix 초) 기준 재계산
+    pub fn reprice_at<P: PricingEngine + Sync>(
+        &mut self,
+        engine: &P,
+        spot: f64,
+        valuation_time: u64,
+    ) -> Vec<usize> {
+        self.set_valuation_time(valuation_time);
+        let stale: Vec<usize> = (0..self.len())
+            .filter(|&index| self.is_stale(index, spot))
+            .collect();
+        if stale.is_empty() {
+            return stale;
+        }
+
+        let chain = &self.chain;
+        let risk_free_rate = self.risk_free_rate;
+        let priced: Vec<ChainGreeks> = stale
+            .par_chunks(CHUNK_SIZE)
+            .map(|rows| {
+                let mut subset = OptionChain::with_capacity(rows.len());
+                for &index in rows {
+                    subset.push(
+                        chain.strikes[index],
+                        chain.time_to_expiry[index],
+                        chain.volatility[index],
+                    );
+                }
+                let mut out = ChainGreeks::default();
+                engine.price_chain(spot, risk_free_rate, &subset, &mut out);
+                out
+            })
+            .collect();
+
+        for (rows, out) in stale.chunks(CHUNK_SIZE).zip(&priced) {
+            for (offset, &index) in rows.iter().enumerate() {
+                self.greeks.copy_row(index, out, offset);
+                self.priced_spot[index] = spot;
+                self.priced_volatility[index] = self.chain.volatility[index];
+                self.priced_time[index] = self.chain.time_to_expiry[index];
+            }
+        }
+
+        stale
+    }
+
+    /// 셀 하나의 프리미엄
+    pub fn cell(&self, index: usize) -> PremiumCell {
+        PremiumCell {
+            strike: self.chain.strikes[index],
+            call_premium: self.greeks.call_price[index],
+            put_premium: self.greeks.put_price[index],
+            implied_volatility: self.priced_volatility[index],
+        }
+    }
+
+    /// 셀 인덱스(오름차순)를 만기별 프리미엄 셀 묶음으로 변환
+    pub fn cells_by_expiry(&self, indices: &[usize]) -> Vec<(Arc<str>, Vec<PremiumCell>)> {
+        let row_len = self.strikes.len().max(1);
+        let mut grouped: Vec<(Arc<str>, Vec<PremiumCell>)> = Vec::new();
+
+        for &index in indices {
+            let expiry = &self.expiries[index / row_len];
+            match grouped.last_mut() {
+                Some((current, cells)) if Arc::ptr_eq(current, expiry) => {
+                    cells.push(self.cell(index))
+                }
+                _ => grouped.push((Arc::clone(expiry), vec![self.cell(index)])),
+            }
+        }
+
+        grouped
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::pricing::BlackScholesPricing;
+
+    const STRIKES: [f64; 5] = [60000.0, 65000.0, 70000.0, 75000.0, 80000.0];
+    const EXPIRIES: [&str; 3] = ["2024-02-01", "2024-03-01", "2024-04-01"];
+    /// 2024-01-02 00:00 UTC
+    const VALUATION: u64 = 1_704_153_600;
+
+    #[test]
+    fn test_only_changed_inputs_are_repriced() {
+        let engine = BlackScholesPricing::new();
+        let mut surface = PremiumSurface::new(&STRIKES, &EXPIRIES, 0.6, 0.05);
+
+        // 최초 계산은 전체
+        assert_eq!(surface.reprice_at(&engine, 70000.0, VALUATION).len(), 15);
+        // 같은 가격, 임계값 미만 변화는 재계산 없음
+        assert!(surface.reprice_at(&engine, 70000.0, VALUATION).is_empty());
+        assert!(surface.reprice_at(&engine, 70003.0, VALUATION).is_empty());
+
+        // 한 만기의 변동성만 바뀌면 그 만기 행만
+        surface.set_expiry_volatility(1, 0.7);
+        assert_eq!(
+            surface.reprice_at(&engine, 70000.0, VALUATION),
+            (5..10).collect::<Vec<_>>()
+        );
+
+        // 임계값 이상 현물가 변화는 전체
+        assert_eq!(surface.reprice_at(&engine, 71000.0, VALUATION).len(), 15);
+    }
+
+    #[test]
+    fn test_incremental_result_matches_full_chain() {
+        let engine = BlackScholesPricing::new();
+        let mut surface = PremiumSurface::new(&STRIKES, &EXPIRIES, 0.6, 0.05);
+        surface.reprice_at(&engine, 70000.0, VALUATION);
+        surface.set_expiry_volatility(2, 0.8);
+        surface.reprice_at(&engine, 70000.0, VALUATION);
+
+        let mut chain = OptionChain::default();
+        for (expiry, volatility) in EXPIRIES.iter().zip([0.6, 0.6, 0.8]) {
+            for &strike in &STRIKES {
+                let expiry_time = expiry_timestamp(expiry).unwrap();
+                chain.push(strike, time_to_expiry_between(VALUATION, expiry_time), volatility);
+            }
+        }
+        let mut expected = ChainGreeks::default();
+        engine.price_chain(70000.0, 0.05, &chain, &mut expected);
+
+        assert_eq!(surface.greeks().call_price, expected.call_price);
+        assert_eq!(surface.greeks().put_price, expected.put_price);
+        assert_eq!(surface.cell(12).implied_volatility, 0.8);
+    }
+
+    #[test]
+    fn test_time_decay_reprices_toward_expiry() {
+        let engine = BlackScholesPricing::new();
+        let mut surface = PremiumSurface::new(&STRIKES, &EXPIRIES, 0.6, 0.05);
+        surface.reprice_at(&engine, 70000.0, VALUATION);
+        let before = surface.greeks().call_price.clone();
+
+        // 임계값보다 적게 지나면 그대로, 하루 지나면 전체 재계산하고 시간 가치 감소
+        assert!(surface.reprice_at(&engine, 70000.0, VALUATION + 30).is_empty());
+        assert_eq!(surface.reprice_at(&engine, 70000.0, VALUATION + 86_400).len(), 15);
+        let after = surface.greeks().call_price.clone();
+        assert!(after.iter().zip(&before).all(|(after, before)| after < before));
+
+        // 만기가 지난 행은 내재가치만 남고 더 이상 재계산하지 않음
+        let expired = expiry_timestamp("2024-02-01").unwrap() + 60;
+        surface.reprice_at(&engine, 70000.0, expired);
+        assert_eq!(surface.cell(0).call_premium, 10000.0);
+        assert_eq!(surface.cell(4).call_premium, 0.0);
+        assert_eq!(
+            surface.reprice_at(&engine, 70000.0, expired + 3600),
+            (5..15).collect::<Vec<_>>()
+        );
+    }
+
+    #[test]
+    fn test_rolling_expiries_keeps_surviving_rows() {
+        let engine = BlackScholesPricing::new();
+        let mut surface = PremiumSurface::new(&STRIKES, &EXPIRIES, 0.6, 0.05);
+        surface.reprice_at(&engine, 70000.0, VALUATION);
+        let march = surface.cell(5);
+
+        assert!(surface.set_expiries(&EXPIRIES).is_empty());
+        let removed = surface.set_expiries(&["2024-03-01", "2024-04-01", "2024-05-01"]);
+        assert_eq!(removed, vec![Arc::<str>::from("2024-02-01")]);
+        assert_eq!(&*surface.expiries()[2], "2024-05-01");
+        assert_eq!(surface.len(), 15);
+        // 남은 만기는 이전 결과 유지, 새 만기 행만 재계산
+        assert_eq!(surface.cell(0), march);
+        assert_eq!(
+            surface.reprice_at(&engine, 70000.0, VALUATION),
+            (10..15).collect::<Vec<_>>()
+        );
+        assert!(surface.cell(10).call_premium > surface.cell(5).call_premium);
+    }
+
+    #[test]
+    fn test_parallel_chunks_cover_large_chain() {
+        let engine = BlackScholesPricing::new();
+        let strikes: Vec<f64> = (0..400).map(|i| 40000.0 + 100.0 * i as f64).collect();
+        let mut surface = PremiumSurface::new(&strikes, &EXPIRIES, 0.6, 0.05);
+
+        let repriced = surface.reprice_at(&engine, 70000.0, VALUATION);
+        assert_eq!(repriced.len(), 1200);
+        assert!(surface.greeks().call_price.iter().all(|&price| price > 0.0));
+
+        let grouped = surface.cells_by_expiry(&repriced);
+        assert_eq!(grouped.len(), 3);
+        assert_eq!(&*grouped[1].0, "2024-03-01");
+        assert_eq!(grouped[1].1.len(), 400);
+        assert_eq!(grouped[1].1[0].strike, 40000.0);
+    }
+}
@@ -1,15 +1,61 @@
 use crate::models::OptionParameters;
 use crate::pricing::{BlackScholesPricing, PricingEngine};
+use rayon::prelude::*;
+use std::collections::HashMap;
+use std::sync::Mutex;
+
+/// IV 탐색 범위 (1% ~ 500%)
+const MIN_IV: f64 = 0.01;
+const MAX_IV: f64 = 5.0;
+/// 이전 해가 없을 때 초기 추정값 (50%)
+const INITIAL_IV: f64 = 0.5;
+/// 목표 theta 허용 오차
+const THETA_TOLERANCE: f64 = 0.0001;
+/// 구간이 이보다 좁아지면 수렴으로 판단
+const IV_TOLERANCE: f64 = 1e-10;
+/// theta 평가 횟수 상한
+const MAX_ITERATIONS: u32 = 50;
+
+/// IV 역산 결과
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct IvSolution {
+    pub implied_volatility: f64,
+    /// theta 평가 횟수
+    pub iterations: u32,
+}
+
+/// 체인 일괄 역산 입력 (현물가/금리는 체인 공통)
+#[derive(Debug, Clone, Copy)]
+pub struct ThetaTarget {
+    pub strike: f64,
+    pub time_to_expiry: f64,
+    pub is_call: bool,
+    pub target_theta: f64,
+}
+
+/// warm start 키 - (행사가, 만기일, 콜/풋). 만기는 일 단위로 묶어 tick마다 키가 바뀌지 않게 함
+type WarmStartKey = (u64, i64, bool);
+
+fn warm_start_key(strike: f64, time_to_expiry: f64, is_call: bool) -> WarmStartKey {
+    (
+        strike.to_bits(),
+        (time_to_expiry * 365.0).round() as i64,
+        is_call,
+    )
+}
 
 /// Target Theta 기반 옵션 프리미엄 계산
 pub struct ThetaTargetingEngine {
     pricing_engine: BlackScholesPricing,
+    /// 직전 tick의 해 - 다음 역산의 초기값
+    warm_starts: Mutex<HashMap<WarmStartKey, f64>>,
 }
 
 impl ThetaTargetingEngine {
     pub fn new() -> Self {
         Self {
             pricing_engine: BlackScholesPricing::new(),
+            warm_starts: Mutex::new(HashMap::new()),
         }
     }
 
@@ -23,43 +69,216 @@ impl ThetaTargetingEngine {
         is_call: bool,
         target_theta: f64, // 일일 theta (음수)
     ) -> Result<f64, String> {
-        // Newton-Raphson method로 IV 찾기
-        let mut iv = 0.5; // 초기 추정값 50%
-        let tolerance = 0.0001;
-        let max_iterations = 100;
-        
-        for _ in 0..max_iterations {
+        self.solve_iv_for_target_theta(
+            spot,
+            strike,
+            time_to_expiry,
+            risk_free_rate,
+            is_call,
+            target_theta,
+        )
+        .map(|solution| solution.implied_volatility)
+    }
+
+    /// `find_iv_for_target_theta`와 같지만 평가 횟수까지 반환
+    ///
+    /// 같은 (행사가, 만기, 콜/풋)의 직전 해에서 시작하고, 성공하면 해를 저장한다.
+    pub fn solve_iv_for_target_theta(
+        &self,
+        spot: f64,
+        strike: f64,
+        time_to_expiry: f64,
+        risk_free_rate: f64,
+        is_call: bool,
+        target_theta: f64,
+    ) -> Result<IvSolution, String> {
+        let key = warm_start_key(strike, time_to_expiry, is_call);
+        let warm_start = self
+            .warm_starts
+            .lock()
+            .map_err(|_| "Lock error")?
+            .get(&key)
+            .copied();
+
+        let target = ThetaTarget {
+            strike,
+            time_to_expiry,
+            is_call,
+            target_theta,
+        };
+        let solution = self.solve(spot, risk_free_rate, &target, warm_start)?;
+
+        self.warm_starts
+            .lock()
+            .map_err(|_| "Lock error")?
+            .insert(key, solution.implied_volatility);
+        Ok(solution)
+    }
+
+    /// 체인 전체를 병렬로 역산 (결과 순서 = 입력 순서)
+    ///
+    /// warm start 캐시는 시작과 끝에 한 번씩만 잠근다.
+    pub fn find_iv_chain(
+        &self,
+        spot: f64,
+        risk_free_rate: f64,
+        targets: &[ThetaTarget],
+    ) -> Vec<Result<IvSolution, String>> {
+        let warm_starts: Vec<Option<f64>> = match self.warm_starts.lock() {
+            Ok(cache) => targets
+                .iter()
+                .map(|target| {
+                    cache
+                        .get(&warm_start_key(
+                            target.strike,
+                            target.time_to_expiry,
+                            target.is_call,
+                        ))
+                        .copied()
+                })
+                .collect(),
+            Err(_) => vec![None; targets.len()],
+        };
+
+        let results: Vec<Result<IvSolution, String>> = targets
+            .par_iter()
+            .zip(&warm_starts)
+            .map(|(target, &warm_start)| self.solve(spot, risk_free_rate, target, warm_start))
+            .collect();
+
+        if let Ok(mut cache) = self.warm_starts.lock() {
+            for (target, result) in targets.iter().zip(&results) {
+                if let Ok(solution) = result {
+                    cache.insert(
+                        warm_start_key(target.strike, target.time_to_expiry, target.is_call),
+                        solution.implied_volatility,
+                    );
+                }
+            }
+        }
+
+        results
+    }
+
+    /// 구간 보호 Newton 역산
+    ///
+    /// Newton 스텝(dθ/dσ 해석식)을 쓰되, 부호가 다른 두 점으로 구간이 잡힌 뒤에는
+    /// 스텝이 구간을 벗어나거나 충분히 줄지 않으면 이분법으로 대체한다.
+    /// Newton이 쓸 수 없으면(기울기 0, 범위 밖, 오차 증가) 탐색 범위 양 끝으로 구간을 잡는다.
+    fn solve(
+        &self,
+        spot: f64,
+        risk_free_rate: f64,
+        target: &ThetaTarget,
+        warm_start: Option<f64>,
+    ) -> Result<IvSolution, String> {
+        if target.time_to_expiry <= 0.0 {
+            return Err("Option already expired".to_string());
+        }
+
+        // f(σ) = 일일 theta - 목표, f'(σ) = dθ/dσ
+        let objective = |iv: f64| {
             let params = OptionParameters {
                 spot,
-                strike,
+                strike: target.strike,
                 volatility: iv,
                 risk_free_rate,
-                time_to_expiry,
-                is_call,
+                time_to_expiry: target.time_to_expiry,
+                is_call: target.is_call,
             };
-            
-            let current_theta = self.pricing_engine.calculate_theta(&params);
-            let daily_theta = current_theta / 365.0; // 연간 theta를 일일 theta로 변환
-            
-            let diff = daily_theta - target_theta;
-            
-            if diff.abs() < tolerance {
-                return Ok(iv);
+            let (theta, sensitivity) = self.pricing_engine.theta_and_vol_sensitivity(&params);
+            (theta / 365.0 - target.target_theta, sensitivity / 365.0)
+        };
+
+        let mut iv = warm_start.unwrap_or(INITIAL_IV).clamp(MIN_IV, MAX_IV);
+        // (a, f(a), b, f(b)) - f(a)와 f(b)의 부호가 다름
+        let mut bracket: Option<(f64, f64, f64, f64)> = None;
+        let mut previous: Option<(f64, f64)> = None;
+        let mut last_step = MAX_IV - MIN_IV;
+        let mut iterations = 0;
+
+        while iterations < MAX_ITERATIONS {
+            let (diff, slope) = objective(iv);
+            iterations += 1;
+
+            if diff.abs() < THETA_TOLERANCE {
+                return Ok(IvSolution {
+                    implied_volatility: iv,
+                    iterations,
+                });
             }
-            
-            // Vega를 사용해 다음 IV 추정
-            let vega = self.pricing_engine.calculate_vega(&params);
-            if vega.abs() < 1e-10 {
-                return Err("Vega too small for convergence".to_string());
+
+            match bracket.as_mut() {
+                Some((a, fa, b, fb)) => {
+                    if (diff < 0.0) == (*fa < 0.0) {
+                        *a = iv;
+                        *fa = diff;
+                    } else {
+                        *b = iv;
+                        *fb = diff;
+                    }
+                }
+                None => {
+                    if let Some((prev_iv, prev_diff)) = previous {
+                        if (diff < 0.0) != (prev_diff < 0.0) {
+                            bracket = Some((prev_iv, prev_diff, iv, diff));
+                        }
+                    }
+                }
             }
-            
-            // Theta는 IV에 대해 증가함수이므로
-            iv = iv - diff / (vega * 0.01); // 적절한 스케일링
-            
-            // IV 범위 제한
-            iv = iv.max(0.01).min(5.0); // 1% ~ 500%
+
+            let newton = if slope.abs() > 1e-12 {
+                Some(iv - diff / slope)
+            } else {
+                None
+            };
+
+            let next = match bracket {
+                Some((a, _, b, _)) => {
+                    let (lo, hi) = (a.min(b), a.max(b));
+                    if hi - lo < IV_TOLERANCE {
+                        return Ok(IvSolution {
+                            implied_volatility: iv,
+                            iterations,
+                        });
+                    }
+                    match newton {
+                        Some(n) if n > lo && n < hi && (n - iv).abs() < 0.5 * last_step => n,
+                        _ => 0.5 * (lo + hi),
+                    }
+                }
+                None => {
+                    let improving =
+                        previous.map_or(true, |(_, prev_diff)| diff.abs() < prev_diff.abs());
+                    match newton {
+                        Some(n) if improving && (MIN_IV..=MAX_IV).contains(&n) => n,
+                        _ => {
+                            // 탐색 범위 양 끝에서 현재 점과 부호가 다른 쪽으로 구간 설정
+                            let (lo_diff, _) = objective(MIN_IV);
+                            let (hi_diff, _) = objective(MAX_IV);
+                            iterations += 2;
+                            if (lo_diff < 0.0) != (diff < 0.0) {
+                                bracket = Some((MIN_IV, lo_diff, iv, diff));
+                            } else if (hi_diff < 0.0) != (diff < 0.0) {
+                                bracket = Some((iv, diff, MAX_IV, hi_diff));
+                            } else {
+                                return Err(format!(
+                                    "Target theta {} not attainable for IV in [{}, {}]",
+                                    target.target_theta, MIN_IV, MAX_IV
+                                ));
+                            }
+                            let (a, _, b, _) = bracket.unwrap();
+                            0.5 * (a + b)
+                        }
+                    }
+                }
+            };
+
+            last_step = (next - iv).abs();
+            previous = Some((iv, diff));
+            iv = next;
         }
-        
+
         Err("Failed to converge to target theta".to_string())
     }
 
@@ -203,7 +422,7 @@ impl DeltaNeutralManager {
                 
                 let theta = self.engine.pricing_engine.calculate_theta(&params);
                 let daily_theta = theta / 365.0;
-                daily_theta * pos.quantity * if pos.is_long { -1.0 } else { 1.0 }
+                daily_theta * pos.quantity * if pos.is_long { 1.0 } else { -1.0 }
             })
             .sum()
     }
@@ -243,6 +462,120 @@ mod tests {
         assert!(iv > 0.0 && iv < 5.0);
     }
 
+    #[test]
+    fn test_solution_hits_target_theta() {
+        let engine = ThetaTargetingEngine::new();
+        let pricing = BlackScholesPricing::new();
+
+        for (strike, is_call, target) in [
+            (75000.0, true, -0.02),
+            (65000.0, false, -0.05),
+            (70000.0, true, -0.5),
+        ] {
+            let solution = engine
+                .solve_iv_for_target_theta(70000.0, strike, 30.0 / 365.0, 0.05, is_call, target)
+                .unwrap();
+            let params = OptionParameters {
+                spot: 70000.0,
+                strike,
+                volatility: solution.implied_volatility,
+                risk_free_rate: 0.05,
+                time_to_expiry: 30.0 / 365.0,
+                is_call,
+            };
+            let daily_theta = pricing.calculate_theta(&params) / 365.0;
+            assert!((daily_theta - target).abs() < THETA_TOLERANCE);
+            assert!(solution.iterations < MAX_ITERATIONS);
+        }
+    }
+
+    #[test]
+    fn test_vol_sensitivity_matches_finite_difference() {
+        let pricing = BlackScholesPricing::new();
+        for is_call in [true, false] {
+            let mut params = OptionParameters {
+                spot: 70000.0,
+                strike: 72000.0,
+                volatility: 0.6,
+                risk_free_rate: 0.05,
+                time_to_expiry: 0.1,
+                is_call,
+            };
+            let (_, sensitivity) = pricing.theta_and_vol_sensitivity(&params);
+            params.volatility = 0.6 + 1e-5;
+            let up = pricing.calculate_theta(&params);
+            params.volatility = 0.6 - 1e-5;
+            let down = pricing.calculate_theta(&params);
+            let numeric = (up - down) / 2e-5;
+            assert!((sensitivity - numeric).abs() < 1e-4 * numeric.abs());
+        }
+    }
+
+    #[test]
+    fn test_warm_start_reduces_iterations() {
+        let engine = ThetaTargetingEngine::new();
+        let cold = engine
+            .solve_iv_for_target_theta(70000.0, 75000.0, 7.0 / 365.0, 0.05, true, -0.02)
+            .unwrap();
+        // 다음 tick: 현물가가 조금 움직임
+        let warm = engine
+            .solve_iv_for_target_theta(70050.0, 75000.0, 7.0 / 365.0, 0.05, true, -0.02)
+            .unwrap();
+
+        assert!(warm.iterations < cold.iterations);
+        assert!((warm.implied_volatility - cold.implied_volatility).abs() < 0.01);
+    }
+
+    #[test]
+    fn test_unattainable_target_is_rejected() {
+        let engine = ThetaTargetingEngine::new();
+        // 1%~500% 범위에서 도달할 수 없는 감쇠
+        let result =
+            engine.find_iv_for_target_theta(70000.0, 75000.0, 7.0 / 365.0, 0.05, true, -1e6);
+        assert!(result.is_err());
+        // 만기 지난 옵션
+        assert!(engine
+            .find_iv_for_target_theta(70000.0, 75000.0, 0.0, 0.05, true, -0.02)
+            .is_err());
+    }
+
+    #[test]
+    fn test_chain_matches_single_solves() {
+        let engine = ThetaTargetingEngine::new();
+        let targets: Vec<ThetaTarget> = (0..40)
+            .map(|i| ThetaTarget {
+                strike: 60000.0 + 500.0 * i as f64,
+                time_to_expiry: (7 + i % 4 * 7) as f64 / 365.0,
+                is_call: i % 2 == 0,
+                target_theta: -0.05,
+            })
+            .collect();
+
+        let chain = engine.find_iv_chain(70000.0, 0.05, &targets);
+        let single = ThetaTargetingEngine::new();
+        for (target, result) in targets.iter().zip(&chain) {
+            let expected = single.find_iv_for_target_theta(
+                70000.0,
+                target.strike,
+                target.time_to_expiry,
+                0.05,
+                target.is_call,
+                target.target_theta,
+            );
+            assert_eq!(
+                result.as_ref().map(|s| s.implied_volatility).ok(),
+                expected.ok()
+            );
+        }
+
+        // 두 번째 호출은 캐시된 해에서 바로 끝남
+        let again = engine.find_iv_chain(70000.0, 0.05, &targets);
+        assert!(again
+            .iter()
+            .flatten()
+            .all(|solution| solution.iterations == 1));
+    }
+
     #[test]
     fn test_premium_calculation_with_aggregated_prices() {
         let engine = ThetaTargetingEngine::new();
@@ -0,0 +1,52 @@
+//! 정산 증명 생성 처리량 (옵션 하나 vs rayon 일괄)
+//!
+//! `cargo bench -p btcfi-contracts --bench proof_generation`
+
+use btcfi_contracts::bitvmx_proof_generator::{OptionSettlementProofGenerator, SettlementRequest};
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+
+/// 정산 현물가 $70,000 (센트)
+const SPOT_CENTS: u32 = 70_000_00;
+
+fn generator() -> OptionSettlementProofGenerator {
+    // 증명은 ELF 해시에만 의존하므로 ELF 매직만 넣어도 충분
+    OptionSettlementProofGenerator::new(&[0x7f, 0x45, 0x4c, 0x46]).unwrap()
+}
+
+/// 행사가 $60k~$80k 콜/풋 번갈아 (ITM/OTM 섞임)
+fn requests(count: usize) -> Vec<SettlementRequest> {
+    (0..count)
+        .map(|i| SettlementRequest {
+            option_type: (i % 2) as u32,
+            strike_price: 60_000_00 + (i % 200) as u32 * 100_00,
+            quantity: 100,
+        })
+        .collect()
+}
+
+fn bench_single(c: &mut Criterion) {
+    let generator = generator();
+    c.bench_function("proof_generation/single", |b| {
+        b.iter(|| generator.generate_settlement_proof(0, black_box(65_000_00), SPOT_CENTS, 100));
+    });
+}
+
+fn bench_batch(c: &mut Criterion) {
+    let generator = generator();
+    let mut group = c.benchmark_group("proof_generation/batch");
+    for count in [256, 4_096, 65_536] {
+        let requests = requests(count);
+        group.throughput(Throughput::Elements(count as u64));
+        group.bench_with_input(
+            BenchmarkId::from_parameter(count),
+            &requests,
+            |b, requests| {
+                b.iter(|| generator.generate_settlement_proofs(black_box(SPOT_CENTS), requests));
+            },
+        );
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_single, bench_batch);
+criterion_main!(benches);
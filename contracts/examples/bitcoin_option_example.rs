@@ -1,5 +1,6 @@
 use btcfi_contracts::bitcoin_option::{BitcoinOption, OptionType};
 use btcfi_contracts::bitvmx_bridge::BitVmxBridge;
+use oracle_vm_common::Price;
 use bitcoin::secp256k1::{Secp256k1, SecretKey, PublicKey};
 use bitcoin::secp256k1::rand::thread_rng;
 use anyhow::Result;
@@ -36,7 +37,7 @@ async fn main() -> Result<()> {
     // 2. 콜 옵션 생성 (Strike: $50k, Premium: 0.01 BTC, Collateral: 0.1 BTC)
     let option = BitcoinOption {
         option_type: OptionType::Call,
-        strike_price: 50_000_000_000, // $50k in satoshis (assuming 1 BTC = $100k)
+        strike_price: Price::from_units(50_000), // $50k
         expiry_block: 850_000,
         buyer_pubkey,
         seller_pubkey,
@@ -69,17 +70,13 @@ async fn main() -> Result<()> {
     
     // 시나리오 1: ITM (In The Money) - Spot $52k
     println!("1️⃣ ITM 시나리오: Spot Price = $52,000");
-    let spot_itm = 52_000_000_000; // $52k in satoshis
+    let spot_itm = Price::from_units(52_000);
     
     let input_itm = bridge.prepare_settlement_input(&option, spot_itm);
     println!("  - BitVMX 입력: {}", hex::encode(&input_itm));
     
     // 실제로는 BitVMX가 증명을 생성하지만, 여기서는 시뮬레이션
-    let settlement_amount_itm = if spot_itm > option.strike_price {
-        option.collateral // 구매자가 담보 전액 수령
-    } else {
-        0
-    };
+    let settlement_amount_itm = option.calculate_settlement(spot_itm); // 구매자가 담보 전액 수령
     
     println!("  - 정산 결과: 구매자가 {} sats 수령", settlement_amount_itm);
     println!("  - 수익률: {}%", (settlement_amount_itm as f64 / option.premium as f64 - 1.0) * 100.0);
@@ -87,16 +84,12 @@ async fn main() -> Result<()> {
     
     // 시나리오 2: OTM (Out of The Money) - Spot $48k
     println!("2️⃣ OTM 시나리오: Spot Price = $48,000");
-    let spot_otm = 48_000_000_000; // $48k in satoshis
+    let spot_otm = Price::from_units(48_000);
     
     let input_otm = bridge.prepare_settlement_input(&option, spot_otm);
     println!("  - BitVMX 입력: {}", hex::encode(&input_otm));
     
-    let settlement_amount_otm = if spot_otm > option.strike_price {
-        option.collateral
-    } else {
-        0 // 판매자가 담보 유지
-    };
+    let settlement_amount_otm = option.calculate_settlement(spot_otm); // 판매자가 담보 유지
     
     println!("  - 정산 결과: 판매자가 담보 {} sats 유지", option.collateral);
     println!("  - 구매자 손실: {} sats (프리미엄)", option.premium);
@@ -53,10 +53,10 @@ fn main() -> Result<()> {
     let is_itm = spot_price > strike_price;
     let intrinsic_value = if is_itm { spot_price - strike_price } else { 0 };
     
-    // BTC 가격으로 변환 (1 BTC = $50,000 가정)
+    // BTC 가격으로 변환 (1 BTC = $50,000 가정, 수량은 1/100 BTC 단위)
     let btc_price = 50_000_00;
     let settlement_sats = if is_itm {
-        ((intrinsic_value as u64 * quantity as u64 * 100_000_000) / btc_price as u64) as u32
+        ((intrinsic_value as u64 * quantity as u64 * 100_000_000) / (btc_price as u64 * 100)) as u32
     } else {
         0
     };
@@ -1,5 +1,6 @@
 use btcfi_contracts::bitcoin_option::{BitcoinOption, OptionType};
 use btcfi_contracts::testnet_deployer::TestnetDeployer;
+use oracle_vm_common::Price;
 use bitcoin::secp256k1::{Secp256k1, SecretKey, PublicKey};
 use bitcoin::{Network, Transaction, Address};
 use anyhow::Result;
@@ -34,7 +35,7 @@ async fn main() -> Result<()> {
     // 2. 옵션 파라미터 설정
     let option = BitcoinOption {
         option_type: OptionType::Call,
-        strike_price: 50_000_000_000, // $50k in satoshis
+        strike_price: Price::from_units(50_000), // $50k
         expiry_block: 2_580_000, // 약 1주일 후
         buyer_pubkey,
         seller_pubkey,
@@ -1,18 +1,18 @@
-use bitcoin::blockdata::opcodes::all::*;
-use bitcoin::blockdata::script::{Builder, ScriptBuf};
-use bitcoin::taproot::{TaprootBuilder, TaprootSpendInfo};
-use bitcoin::secp256k1::{Secp256k1};
-use bitcoin::XOnlyPublicKey;
+use crate::taproot_template::{TaprootTemplate, TaprootTemplateCache};
+use bitcoin::blockdata::script::ScriptBuf;
+use bitcoin::taproot::TaprootSpendInfo;
 use anyhow::Result;
 use oracle_vm_common::types::OptionType;
+use oracle_vm_common::Price;
+use std::sync::Arc;
 
 /// Bitcoin L1 단방향 옵션 컨트랙트
 /// BitVMX를 사용하여 오프체인 계산과 온체인 검증을 결합
 pub struct BitcoinOption {
     /// 옵션 타입 (Call/Put)
     pub option_type: OptionType,
-    /// 행사가 (satoshis)
-    pub strike_price: u64,
+    /// 행사가 (고정소수점, 10^-8 단위)
+    pub strike_price: Price,
     /// 만기 블록 높이
     pub expiry_block: u32,
     /// 구매자 공개키
@@ -29,91 +29,18 @@ pub struct BitcoinOption {
 
 
 impl BitcoinOption {
+    /// 옵션 컨트랙트의 Taproot 템플릿 (공용 캐시 - 같은 만기/키 조합은 한 번만 계산)
+    pub fn taproot_template(&self) -> Result<Arc<TaprootTemplate>> {
+        TaprootTemplateCache::global().get(self)
+    }
+
     /// 옵션 컨트랙트의 Taproot 스크립트 생성
+    ///
+    /// Key-path는 협력 정산, script-path는 BitVMX 증명 기반 정산과 환불 리프
+    /// (구성은 [`TaprootTemplate::build`]).
     pub fn create_taproot_script(&self) -> Result<(ScriptBuf, TaprootSpendInfo)> {
-        let secp = Secp256k1::new();
-        
-        // 1. Key-path spending: 정상적인 협력 정산
-        let internal_key = self.create_musig_internal_key()?;
-        
-        // 2. Script-path spending: BitVMX 증명 기반 정산
-        let settlement_script = self.create_settlement_script();
-        let refund_script = self.create_refund_script();
-        
-        // Taproot tree 구성
-        let taproot_builder = TaprootBuilder::new()
-            .add_leaf(1, settlement_script.clone())?
-            .add_leaf(1, refund_script.clone())?;
-            
-        let internal_xonly = XOnlyPublicKey::from(internal_key);
-        let taproot_spend_info = taproot_builder.finalize(&secp, internal_xonly)
-            .map_err(|_| anyhow::anyhow!("Failed to finalize taproot"))?;
-        
-        // Taproot output script
-        let taproot_output = Builder::new()
-            .push_opcode(OP_PUSHNUM_1)
-            .push_slice(&internal_xonly.serialize())
-            .into_script();
-        
-        Ok((taproot_output, taproot_spend_info))
-    }
-    
-    /// MuSig 내부 키 생성 (구매자 + 판매자 협력)
-    fn create_musig_internal_key(&self) -> Result<bitcoin::secp256k1::PublicKey> {
-        // 실제 구현에서는 MuSig2 프로토콜 사용
-        // 여기서는 단순화를 위해 구매자 키 반환
-        Ok(self.buyer_pubkey)
-    }
-    
-    /// 정산 스크립트: BitVMX 증명 검증 후 자동 정산
-    fn create_settlement_script(&self) -> ScriptBuf {
-        Builder::new()
-            // 만기 시간 체크
-            .push_int(self.expiry_block as i64)
-            .push_opcode(OP_CLTV)
-            .push_opcode(OP_DROP)
-            
-            // BitVMX 증명 검증
-            // 증명 포맷: [option_type || strike || spot || settlement_amount]
-            .push_opcode(OP_DUP)
-            .push_opcode(OP_SHA256)
-            
-            // 예상 증명 해시와 비교 (실제로는 동적으로 계산)
-            .push_slice(&[0u8; 32]) // placeholder for proof hash
-            .push_opcode(OP_EQUAL)
-            .push_opcode(OP_VERIFY)
-            
-            // 검증자 서명 확인
-            .push_slice(&self.verifier_pubkey.serialize())
-            .push_opcode(OP_CHECKSIGVERIFY)
-            
-            // 정산 금액에 따라 수령인 결정
-            // 스택: [settlement_amount]
-            .push_int(0)
-            .push_opcode(OP_GREATERTHAN)
-            .push_opcode(OP_IF)
-                // ITM: 구매자가 수령
-                .push_slice(&self.buyer_pubkey.serialize())
-            .push_opcode(OP_ELSE)
-                // OTM: 판매자가 담보 회수
-                .push_slice(&self.seller_pubkey.serialize())
-            .push_opcode(OP_ENDIF)
-            .push_opcode(OP_CHECKSIG)
-            .into_script()
-    }
-    
-    /// 환불 스크립트: 만기 후 일정 시간 지나면 판매자가 회수
-    fn create_refund_script(&self) -> ScriptBuf {
-        Builder::new()
-            // 만기 + 1일 후
-            .push_int((self.expiry_block + 144) as i64)
-            .push_opcode(OP_CLTV)
-            .push_opcode(OP_DROP)
-            
-            // 판매자 서명
-            .push_slice(&self.seller_pubkey.serialize())
-            .push_opcode(OP_CHECKSIG)
-            .into_script()
+        let template = self.taproot_template()?;
+        Ok((template.output_script.clone(), template.spend_info.clone()))
     }
     
     /// 옵션 구매 트랜잭션 생성
@@ -129,7 +56,7 @@ impl BitcoinOption {
     /// BitVMX 증명 데이터 구조
     pub fn create_settlement_proof(
         &self,
-        spot_price: u64,
+        spot_price: Price,
         oracle_signatures: Vec<Vec<u8>>,
     ) -> Result<Vec<u8>> {
         let mut proof_data = Vec::new();
@@ -140,9 +67,9 @@ impl BitcoinOption {
             OptionType::Put => 1,
         });
         
-        // 가격 데이터 (little-endian)
-        proof_data.extend_from_slice(&self.strike_price.to_le_bytes());
-        proof_data.extend_from_slice(&spot_price.to_le_bytes());
+        // 가격 데이터 (고정소수점 가수, little-endian)
+        proof_data.extend_from_slice(&self.strike_price.mantissa().to_le_bytes());
+        proof_data.extend_from_slice(&spot_price.mantissa().to_le_bytes());
         
         // 정산 금액 계산
         let settlement_amount = self.calculate_settlement(spot_price);
@@ -156,8 +83,8 @@ impl BitcoinOption {
         Ok(proof_data)
     }
     
-    /// 정산 금액 계산
-    fn calculate_settlement(&self, spot_price: u64) -> u64 {
+    /// 정산 금액 계산 (가격 비교는 고정소수점 정수 그대로)
+    pub fn calculate_settlement(&self, spot_price: Price) -> u64 {
         match self.option_type {
             OptionType::Call => {
                 if spot_price > self.strike_price {
@@ -183,7 +110,7 @@ impl BitcoinOption {
 #[cfg(test)]
 mod tests {
     use super::*;
-    use bitcoin::secp256k1::{SecretKey, PublicKey, rand::thread_rng};
+    use bitcoin::secp256k1::{Secp256k1, SecretKey, PublicKey, rand::thread_rng};
     
     #[test]
     fn test_create_option_script() {
@@ -196,7 +123,7 @@ mod tests {
         
         let option = BitcoinOption {
             option_type: OptionType::Call,
-            strike_price: 50_000_000, // 0.5 BTC
+            strike_price: Price::from_units(50_000), // $50,000
             expiry_block: 800_000,
             buyer_pubkey: PublicKey::from_secret_key(&secp, &buyer_key),
             seller_pubkey: PublicKey::from_secret_key(&secp, &seller_key),
@@ -216,7 +143,7 @@ mod tests {
         
         let option = BitcoinOption {
             option_type: OptionType::Call,
-            strike_price: 50_000_000,
+            strike_price: Price::from_units(50_000),
             expiry_block: 800_000,
             buyer_pubkey: PublicKey::from_secret_key(&secp, &SecretKey::new(&mut rng)),
             seller_pubkey: PublicKey::from_secret_key(&secp, &SecretKey::new(&mut rng)),
@@ -226,9 +153,13 @@ mod tests {
         };
         
         // Call ITM
-        assert_eq!(option.calculate_settlement(60_000_000), 10_000_000);
+        assert_eq!(option.calculate_settlement(Price::from_units(60_000)), 10_000_000);
         
         // Call OTM
-        assert_eq!(option.calculate_settlement(40_000_000), 0);
+        assert_eq!(option.calculate_settlement(Price::from_units(40_000)), 0);
+        
+        // 행사가와 같으면 OTM (센트 미만 차이도 구분)
+        assert_eq!(option.calculate_settlement(Price::from_units(50_000)), 0);
+        assert_eq!(option.calculate_settlement("50000.00000001".parse().unwrap()), 10_000_000);
     }
 }
\ No newline at end of file
@@ -1,32 +1,49 @@
 use crate::bitcoin_option::BitcoinOption;
+use crate::bitvmx_emulator_integration::{ElfSettlement, SettlementElfExecutor};
+use crate::metrics::PROOF_GENERATION_SECONDS;
 use oracle_vm_common::types::OptionType;
+use oracle_vm_common::Price;
 use anyhow::Result;
 use bitcoin::hashes::{sha256, Hash};
-use std::process::Command;
+use std::sync::OnceLock;
 
 /// BitVMX와 Bitcoin 옵션을 연결하는 브릿지
 /// 오프체인에서 가격을 받아 BitVMX로 증명을 생성하고
 /// 온체인에서 검증 가능한 형태로 변환
 pub struct BitVmxBridge {
-    /// BitVMX 바이너리 경로
-    bitvmx_path: String,
     /// 옵션 정산 프로그램 경로
     settlement_program: String,
+    /// 첫 정산 때 로드한 실행기 (이후 재사용)
+    executor: OnceLock<SettlementElfExecutor>,
 }
 
 impl BitVmxBridge {
     pub fn new() -> Self {
+        Self::with_program("../bitvmx_protocol/execution_files/option_settlement.elf")
+    }
+
+    /// 정산 ELF 경로 지정
+    pub fn with_program(settlement_program: impl Into<String>) -> Self {
         Self {
-            bitvmx_path: "../bitvmx_protocol/BitVMX-CPU/target/release/emulator".to_string(),
-            settlement_program: "../bitvmx_protocol/execution_files/option_settlement.elf".to_string(),
+            settlement_program: settlement_program.into(),
+            executor: OnceLock::new(),
+        }
+    }
+
+    /// 정산 실행기 - 처음 호출될 때 ELF를 로드
+    fn executor(&self) -> Result<&SettlementElfExecutor> {
+        if let Some(executor) = self.executor.get() {
+            return Ok(executor);
         }
+        let executor = SettlementElfExecutor::load(&self.settlement_program)?;
+        Ok(self.executor.get_or_init(|| executor))
     }
     
     /// Oracle 가격 데이터를 BitVMX 입력 형식으로 변환
     pub fn prepare_settlement_input(
         &self,
         option: &BitcoinOption,
-        spot_price: u64,
+        spot_price: Price,
     ) -> Vec<u8> {
         let mut input = Vec::with_capacity(16);
         
@@ -38,11 +55,11 @@ impl BitVmxBridge {
         input.extend_from_slice(&option_type_bytes.to_le_bytes());
         
         // Strike price in cents (4 bytes)
-        let strike_cents = (option.strike_price / 1_000) as u32; // satoshis to cents
+        let strike_cents = option.strike_price.to_cents() as u32;
         input.extend_from_slice(&strike_cents.to_le_bytes());
         
         // Spot price in cents (4 bytes)
-        let spot_cents = (spot_price / 1_000) as u32;
+        let spot_cents = spot_price.to_cents() as u32;
         input.extend_from_slice(&spot_cents.to_le_bytes());
         
         // Quantity (4 bytes) - simplified to 1 unit
@@ -56,28 +73,15 @@ impl BitVmxBridge {
     pub async fn generate_settlement_proof(
         &self,
         option: &BitcoinOption,
-        spot_price: u64,
+        spot_price: Price,
     ) -> Result<SettlementProof> {
+        let _timer = PROOF_GENERATION_SECONDS.with_label_values(&["emulator"]).start_timer();
         let input = self.prepare_settlement_input(option, spot_price);
-        let input_hex = hex::encode(&input);
-        
-        // BitVMX 에뮬레이터 실행
-        let output = Command::new(&self.bitvmx_path)
-            .arg("execute")
-            .arg("--elf")
-            .arg(&self.settlement_program)
-            .arg("--input")
-            .arg(&input_hex)
-            .arg("--trace")
-            .output()?;
-            
-        if !output.status.success() {
-            anyhow::bail!("BitVMX execution failed");
-        }
         
-        // 실행 결과 파싱
-        let stdout = String::from_utf8(output.stdout)?;
-        let settlement_amount = self.parse_settlement_amount(&stdout)?;
+        // 인프로세스 에뮬레이터 실행
+        let execution = self.executor()?.execute(&input)?;
+        // cents to satoshis (assuming 1 BTC = $100,000)
+        let settlement_amount = execution.settlement_cents * 1_000;
         
         // 증명 데이터 구성
         let proof_data = self.create_proof_data(
@@ -93,33 +97,15 @@ impl BitVmxBridge {
             proof_data,
             proof_hash: proof_hash.to_byte_array(),
             settlement_amount,
-            execution_trace: stdout,
+            execution,
         })
     }
     
-    /// BitVMX 출력에서 정산 금액 파싱
-    fn parse_settlement_amount(&self, output: &str) -> Result<u64> {
-        // BitVMX 출력 형식: "Settlement amount: XXXX cents"
-        for line in output.lines() {
-            if line.contains("Settlement amount:") {
-                let parts: Vec<&str> = line.split_whitespace().collect();
-                if parts.len() >= 3 {
-                    let cents: u64 = parts[2].parse()?;
-                    // cents to satoshis (assuming 1 BTC = $100,000)
-                    return Ok(cents * 1_000);
-                }
-            }
-        }
-        
-        // ITM이 아니면 0 반환
-        Ok(0)
-    }
-    
     /// 온체인 검증을 위한 증명 데이터 생성
     fn create_proof_data(
         &self,
         option: &BitcoinOption,
-        spot_price: u64,
+        spot_price: Price,
         settlement_amount: u64,
     ) -> Vec<u8> {
         let mut data = Vec::new();
@@ -129,8 +115,8 @@ impl BitVmxBridge {
             OptionType::Call => 0,
             OptionType::Put => 1,
         });
-        data.extend_from_slice(&option.strike_price.to_le_bytes());
-        data.extend_from_slice(&spot_price.to_le_bytes());
+        data.extend_from_slice(&option.strike_price.mantissa().to_le_bytes());
+        data.extend_from_slice(&spot_price.mantissa().to_le_bytes());
         data.extend_from_slice(&settlement_amount.to_le_bytes());
         
         // 타임스탬프 추가
@@ -163,8 +149,8 @@ pub struct SettlementProof {
     pub proof_hash: [u8; 32],
     /// 정산 금액 (satoshis)
     pub settlement_amount: u64,
-    /// BitVMX 실행 트레이스
-    pub execution_trace: String,
+    /// BitVMX 실행 결과 (스텝 수, 최종 트레이스 해시)
+    pub execution: ElfSettlement,
 }
 
 #[cfg(test)]
@@ -181,7 +167,7 @@ mod tests {
         
         let option = BitcoinOption {
             option_type: OptionType::Call,
-            strike_price: 50_000_000_000, // $50k in satoshis
+            strike_price: Price::from_units(50_000), // $50k
             expiry_block: 800_000,
             buyer_pubkey: PublicKey::from_secret_key(&secp, &SecretKey::new(&mut rng)),
             seller_pubkey: PublicKey::from_secret_key(&secp, &SecretKey::new(&mut rng)),
@@ -190,7 +176,7 @@ mod tests {
             collateral: 10_000_000_000,
         };
         
-        let input = bridge.prepare_settlement_input(&option, 52_000_000_000);
+        let input = bridge.prepare_settlement_input(&option, Price::from_units(52_000));
         
         // Verify input format
         assert_eq!(input.len(), 16);
@@ -198,10 +184,14 @@ mod tests {
         // Check option type
         assert_eq!(&input[0..4], &[0, 0, 0, 0]); // Call = 0
         
-        // Check strike price (50M satoshis = 50M/1000 = 50k cents)
+        // Check strike price ($50k = 5M cents)
         let strike_bytes = &input[4..8];
         let strike = u32::from_le_bytes(strike_bytes.try_into().unwrap());
-        assert_eq!(strike, 50_000_000);
+        assert_eq!(strike, 5_000_000);
+        
+        // Check spot price ($52k = 5.2M cents)
+        let spot = u32::from_le_bytes(input[8..12].try_into().unwrap());
+        assert_eq!(spot, 5_200_000);
     }
     
     #[test]
@@ -215,7 +205,11 @@ mod tests {
             proof_data: proof_data.clone(),
             proof_hash,
             settlement_amount: 1_000_000,
-            execution_trace: "test trace".to_string(),
+            execution: ElfSettlement {
+                settlement_cents: 1_000,
+                steps: 42,
+                final_trace_hash: "test trace".to_string(),
+            },
         };
         
         // Should verify with correct hash
@@ -225,4 +219,28 @@ mod tests {
         let wrong_hash = [0u8; 32];
         assert!(!bridge.verify_proof(&proof, &wrong_hash));
     }
-}
\ No newline at end of file
+    
+    #[tokio::test]
+    async fn test_missing_program_is_reported() {
+        let bridge = BitVmxBridge::with_program("does/not/exist.elf");
+        let secp = Secp256k1::new();
+        let mut rng = thread_rng();
+        let pubkey = PublicKey::from_secret_key(&secp, &SecretKey::new(&mut rng));
+        
+        let option = BitcoinOption {
+            option_type: OptionType::Put,
+            strike_price: Price::from_units(50_000),
+            expiry_block: 800_000,
+            buyer_pubkey: pubkey,
+            seller_pubkey: pubkey,
+            verifier_pubkey: pubkey,
+            premium: 1_000_000_000,
+            collateral: 10_000_000_000,
+        };
+        
+        let result = bridge.generate_settlement_proof(&option, Price::from_units(48_000)).await;
+        assert!(result.unwrap_err().to_string().contains("does/not/exist.elf"));
+        // 로드 실패는 캐시하지 않음
+        assert!(bridge.executor.get().is_none());
+    }
+}
@@ -2,15 +2,121 @@
 //! 
 //! 실제 emulator를 사용하여 옵션 정산 로직 실행
 
+use crate::execution_trace::{CompactTrace, TraceWriter};
 use anyhow::{Result, anyhow};
 use emulator::{
-    executor::fetcher::Fetcher,
+    executor::{
+        fetcher::{execute_program, Fetcher},
+        utils::FailConfiguration,
+    },
     loader::program::{Program, load_elf},
+    ExecutionResult,
     REGISTERS_BASE_ADDRESS,
 };
 use bitcoin_script_riscv::riscv::decoder::decode_instruction;
 use sha2::{Sha256, Digest};
 
+/// 정산 ELF 입력/출력 섹션
+const INPUT_SECTION: &str = ".input";
+const OUTPUT_SECTION: &str = ".output";
+/// 정산 프로그램 스텝 상한 (무한 루프 방지)
+const SETTLEMENT_STEP_LIMIT: u64 = 1_000_000;
+
+/// 정산 ELF를 한 번 로드해 두고 옵션마다 실행하는 인프로세스 실행기
+///
+/// 실행마다 로드된 프로그램(메모리 이미지)을 복제해 쓰므로 ELF 파싱과 프로세스 생성이 없고,
+/// `&self`로 여러 스레드에서 동시에 실행할 수 있다.
+///
+/// `bitvmx_protocol/BitVMX-CPU/emulator`의 `execute_program` 형식(인자 15개, 요청한 스텝의
+/// `(트레이스, 해시 hex)` 목록 반환)에 맞춰 작성했다. 이 트리에는 서브모듈 체크아웃이 없어
+/// 컴파일 확인이 되지 않았으므로, 서브모듈을 복원하면 `--ignored` 테스트로 확인해야 한다.
+pub struct SettlementElfExecutor {
+    program: Program,
+}
+
+impl SettlementElfExecutor {
+    /// ELF 로드 (파일은 에뮬레이터 로더가 한 번만 읽음)
+    pub fn load(elf_path: &str) -> Result<Self> {
+        // 로더가 읽기 실패를 오류로 돌려주지 않을 수 있으므로 파일 존재만 먼저 확인 (읽지 않음)
+        std::fs::metadata(elf_path)
+            .map_err(|e| anyhow!("Failed to read settlement ELF {}: {}", elf_path, e))?;
+        let program = load_elf(elf_path, false)
+            .map_err(|e| anyhow!("Failed to load settlement ELF {}: {:?}", elf_path, e))?;
+
+        Ok(Self { program })
+    }
+
+    /// 입력 하나로 정산 프로그램 실행
+    ///
+    /// 프로그램은 `.output` 섹션 첫 워드(LE u32)에 정산 금액(cents)을 남기고 종료해야 한다.
+    /// 에뮬레이터는 요청한 스텝의 트레이스 해시만 돌려주므로, 해시 없이 한 번 실행해 종료
+    /// 스텝을 구한 뒤 그 스텝의 해시를 요청해 다시 실행한다 (전체 트레이스는 만들지 않음).
+    pub fn execute(&self, input: &[u8]) -> Result<ElfSettlement> {
+        let (program, steps, _) = self.run(input, None)?;
+        let output = program
+            .find_section_by_name(OUTPUT_SECTION)
+            .ok_or_else(|| anyhow!("Settlement ELF has no {} section", OUTPUT_SECTION))?
+            .start;
+        let settlement_cents = program.read_mem(output) as u64;
+
+        // 종료 스텝 번호가 0/1 기준 어느 쪽이든 마지막 해시를 얻도록 두 스텝 요청
+        let (_, _, hashes) = self.run(input, Some(vec![steps.saturating_sub(1), steps]))?;
+        let final_trace_hash = hashes
+            .into_iter()
+            .last()
+            .filter(|hash| !hash.is_empty())
+            .ok_or_else(|| anyhow!("Emulator returned no trace hash for step {}", steps))?;
+
+        Ok(ElfSettlement {
+            settlement_cents,
+            steps,
+            final_trace_hash,
+        })
+    }
+
+    /// 프로그램 이미지를 복제해 실행 - (실행 후 프로그램, 스텝 수, 요청한 스텝의 해시 hex)
+    ///
+    /// `trace_steps`가 없으면 해시 계산을 생략한다.
+    fn run(&self, input: &[u8], trace_steps: Option<Vec<u64>>) -> Result<(Program, u64, Vec<String>)> {
+        let mut program = self.program.clone();
+        let no_hash = trace_steps.is_none();
+        let (result, trace) = execute_program(
+            &mut program,
+            input.to_vec(),
+            INPUT_SECTION,
+            false, // CLI `execute --input`과 같은 바이트 순서
+            &None,
+            Some(SETTLEMENT_STEP_LIMIT),
+            false, // 전체 트레이스 출력 안 함
+            false,
+            false,
+            false,
+            false,
+            no_hash,
+            trace_steps,
+            None,
+            FailConfiguration::default(),
+        );
+
+        let steps = match result {
+            ExecutionResult::Halt(0, steps) => steps,
+            other => return Err(anyhow!("Settlement program did not halt cleanly: {:?}", other)),
+        };
+        Ok((program, steps, trace.into_iter().map(|(_, hash)| hash).collect()))
+    }
+}
+
+/// ELF 정산 실행 결과
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ElfSettlement {
+    /// 정산 금액 (cents)
+    pub settlement_cents: u64,
+    /// 실행 스텝 수
+    pub steps: u64,
+    /// 마지막 스텝 트레이스 해시 (hex) - 분쟁 시 비교 기준
+    pub final_trace_hash: String,
+}
+
 /// BitVMX 옵션 정산 실행기
 pub struct OptionSettlementExecutor {
     /// 프로그램 해시
@@ -93,10 +199,7 @@ impl OptionSettlementExecutor {
         instructions: Vec<u32>,
         input_data: Vec<u8>,
     ) -> Result<SettlementTrace> {
-        let mut trace = SettlementTrace {
-            steps: Vec::new(),
-            final_result: SettlementResult::default(),
-        };
+        let mut trace = TraceWriter::new();
         
         // 레지스터 초기화
         let mut registers = [0u32; 32];
@@ -125,21 +228,17 @@ impl OptionSettlementExecutor {
             0
         };
         
-        // BTC 환산 (1 BTC = $50,000)
+        // BTC 환산 (1 BTC = $50,000, 수량은 1/100 BTC 단위)
         let btc_price = 50_000_00;
         let settlement_sats = if is_itm {
-            ((intrinsic_value as u64 * quantity as u64 * 100_000_000) / btc_price as u64) as u32
+            ((intrinsic_value as u64 * quantity as u64 * 100_000_000) / (btc_price as u64 * 100)) as u32
         } else {
             0
         };
         
-        // 실행 단계 기록
-        for (i, &instruction) in instructions.iter().enumerate() {
-            trace.steps.push(ExecutionStep {
-                pc: pc,
-                instruction,
-                registers: registers.clone(),
-            });
+        // 실행 단계 기록 (바뀐 레지스터만)
+        for &instruction in &instructions {
+            trace.record(pc, instruction, &registers)?;
             pc += 4;
             
             // ecall에서 종료
@@ -148,19 +247,19 @@ impl OptionSettlementExecutor {
             }
         }
         
-        // 최종 결과 설정
-        trace.final_result = SettlementResult {
-            is_itm,
-            intrinsic_value,
-            settlement_amount: settlement_sats,
-        };
-        
-        Ok(trace)
+        Ok(SettlementTrace {
+            trace: trace.finish()?,
+            final_result: SettlementResult {
+                is_itm,
+                intrinsic_value,
+                settlement_amount: settlement_sats,
+            },
+        })
     }
 }
 
 /// 실행 단계
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, PartialEq, Eq)]
 pub struct ExecutionStep {
     /// 프로그램 카운터
     pub pc: u32,
@@ -173,8 +272,8 @@ pub struct ExecutionStep {
 /// 정산 실행 트레이스
 #[derive(Debug)]
 pub struct SettlementTrace {
-    /// 실행 단계들
-    pub steps: Vec<ExecutionStep>,
+    /// 실행 단계들 (델타 인코딩)
+    pub trace: CompactTrace,
     /// 최종 정산 결과
     pub final_result: SettlementResult,
 }
@@ -193,6 +292,25 @@ pub struct SettlementResult {
 #[cfg(test)]
 mod tests {
     use super::*;
+
+    /// 실제 정산 ELF (bitvmx_protocol 체크아웃 필요)
+    const SETTLEMENT_ELF: &str = "../bitvmx_protocol/execution_files/option_settlement.elf";
+
+    #[test]
+    #[ignore = "bitvmx_protocol 체크아웃과 정산 ELF 필요"]
+    fn test_settlement_elf_reports_final_trace_hash() {
+        let executor = SettlementElfExecutor::load(SETTLEMENT_ELF).unwrap();
+        let mut input = Vec::new();
+        for word in [0u32, 5_000_000, 5_200_000, 100] {
+            input.extend_from_slice(&word.to_le_bytes());
+        }
+
+        let first = executor.execute(&input).unwrap();
+        assert!(first.steps > 0);
+        assert!(!first.final_trace_hash.is_empty());
+        // 같은 입력은 같은 트레이스로 끝남
+        assert_eq!(executor.execute(&input).unwrap(), first);
+    }
     
     #[test]
     fn test_simple_execution() {
@@ -209,6 +327,6 @@ mod tests {
         assert!(trace.final_result.is_itm);
         assert_eq!(trace.final_result.intrinsic_value, 2_000_00);
         assert_eq!(trace.final_result.settlement_amount, 4_000_000); // 0.04 BTC
-        assert!(!trace.steps.is_empty());
+        assert!(!trace.trace.is_empty());
     }
 }
\ No newline at end of file
@@ -11,7 +11,8 @@ use crate::bitvmx_proof_generator::SettlementResult;
 
 /// Pre-signed 옵션 정산 트랜잭션 생성기
 pub struct PreSignedSettlementBuilder {
-    secp: Secp256k1<bitcoin::secp256k1::All>,
+    /// 프로세스 공용 컨텍스트
+    secp: &'static Secp256k1<bitcoin::secp256k1::All>,
     network: Network,
 }
 
@@ -19,7 +20,7 @@ impl PreSignedSettlementBuilder {
     /// 새로운 빌더 생성
     pub fn new(network: Network) -> Self {
         Self {
-            secp: Secp256k1::new(),
+            secp: oracle_vm_common::crypto::secp(),
             network,
         }
     }
@@ -35,9 +36,9 @@ impl PreSignedSettlementBuilder {
         expiry_height: u32,
     ) -> Result<(Transaction, Vec<Vec<u8>>)> {
         // 매수자 주소 생성
-        let buyer_pubkey = PublicKey::from_secret_key(&self.secp, buyer_key);
+        let buyer_pubkey = PublicKey::from_secret_key(self.secp, buyer_key);
         let compressed_pubkey = bitcoin::key::CompressedPublicKey::from_private_key(
-            &self.secp,
+            self.secp,
             &bitcoin::key::PrivateKey::new(*buyer_key, self.network)
         ).unwrap();
         let buyer_address = Address::p2wpkh(&compressed_pubkey, self.network);
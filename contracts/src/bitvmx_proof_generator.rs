@@ -2,14 +2,33 @@
 //! 
 //! 실제 BitVMX 통합을 위한 개념 증명 구현
 
+use crate::metrics::PROOF_GENERATION_SECONDS;
 use anyhow::{Result, anyhow};
 use bitcoin::{Script, ScriptBuf};
+use rayon::prelude::*;
 use sha2::{Sha256, Digest};
 
+/// 일괄 생성 시 한 번에 병렬 처리하는 옵션 수 - 묶음이 끝날 때마다 순서대로 내보냄
+const BATCH_CHUNK_SIZE: usize = 256;
+/// 정산 결과 검증 스크립트 길이 (ITM 1 + 내재가치 push 5 + 정산 금액 push 5)
+const RESULT_SCRIPT_LEN: usize = 11;
+/// 수량 고정소수점 배율 (100 = 1.00 BTC)
+const QUANTITY_SCALE: u64 = 100;
+
 /// 옵션 정산 증명 생성기
 pub struct OptionSettlementProofGenerator {
     /// 프로그램 해시 (실제로는 ROM commitment)
     program_hash: [u8; 32],
+    /// 프로그램 해시 검증 스크립트 (모든 증명에서 공통)
+    program_verify: ScriptBuf,
+}
+
+/// 일괄 정산 입력 (정산 현물가는 묶음 공통)
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct SettlementRequest {
+    pub option_type: u32,
+    pub strike_price: u32,
+    pub quantity: u32,
 }
 
 impl OptionSettlementProofGenerator {
@@ -18,9 +37,22 @@ impl OptionSettlementProofGenerator {
         // 프로그램 해시 계산
         let mut hasher = Sha256::new();
         hasher.update(elf_bytes);
-        let program_hash = hasher.finalize().into();
+        let program_hash: [u8; 32] = hasher.finalize().into();
+        
+        // 1. 프로그램 해시 검증
+        let mut program_verify = Vec::with_capacity(program_hash.len() + 2);
+        program_verify.push(bitcoin::opcodes::all::OP_SHA256.to_u8());
+        program_verify.extend_from_slice(&program_hash);
+        program_verify.push(bitcoin::opcodes::all::OP_EQUAL.to_u8());
         
-        Ok(Self { program_hash })
+        Ok(Self {
+            program_hash,
+            program_verify: ScriptBuf::from(program_verify),
+        })
+    }
+    
+    pub fn program_hash(&self) -> &[u8; 32] {
+        &self.program_hash
     }
     
     /// 옵션 정산 증명 생성
@@ -31,38 +63,8 @@ impl OptionSettlementProofGenerator {
         spot_price: u32,
         quantity: u32,
     ) -> Result<(Vec<ScriptBuf>, SettlementResult)> {
-        // 정산 계산
-        let (is_itm, intrinsic_value) = match option_type {
-            0 => { // Call
-                if spot_price > strike_price {
-                    (true, spot_price - strike_price)
-                } else {
-                    (false, 0)
-                }
-            },
-            1 => { // Put
-                if spot_price < strike_price {
-                    (true, strike_price - spot_price)
-                } else {
-                    (false, 0)
-                }
-            },
-            _ => return Err(anyhow!("Invalid option type")),
-        };
-        
-        // 정산 금액 계산 (USD cents to satoshi, 1 BTC = $50,000 가정)
-        let btc_price = 50_000_00; // cents
-        let settlement_amount = if is_itm {
-            ((intrinsic_value as u64 * quantity as u64 * 100_000_000) / btc_price as u64) as u32
-        } else {
-            0
-        };
-        
-        let result = SettlementResult {
-            is_itm,
-            intrinsic_value,
-            settlement_amount,
-        };
+        let _timer = PROOF_GENERATION_SECONDS.with_label_values(&["script"]).start_timer();
+        let result = settle(option_type, strike_price, spot_price, quantity)?;
         
         // 증명 스크립트 생성 (간소화)
         let proof_scripts = self.create_proof_scripts(&result)?;
@@ -70,20 +72,52 @@ impl OptionSettlementProofGenerator {
         Ok((proof_scripts, result))
     }
     
+    /// 같은 정산 현물가의 옵션 묶음에 대한 증명을 병렬로 생성 (결과 순서 = 입력 순서)
+    pub fn generate_settlement_proofs(
+        &self,
+        spot_price: u32,
+        requests: &[SettlementRequest],
+    ) -> Vec<Result<(Vec<ScriptBuf>, SettlementResult)>> {
+        let mut proofs = Vec::with_capacity(requests.len());
+        self.stream_settlement_proofs(spot_price, requests, |_, proof| proofs.push(proof));
+        proofs
+    }
+    
+    /// 묶음 증명 생성 - 결과를 입력 순서대로 `sink(index, proof)`에 넘김
+    ///
+    /// `BATCH_CHUNK_SIZE`개씩 rayon 풀에서 병렬 생성하고, 한 묶음이 끝나면 바로 내보내므로
+    /// 전체 배치를 기다리지 않고 앞쪽 옵션부터 지급을 진행할 수 있다.
+    pub fn stream_settlement_proofs<F>(
+        &self,
+        spot_price: u32,
+        requests: &[SettlementRequest],
+        mut sink: F,
+    ) where
+        F: FnMut(usize, Result<(Vec<ScriptBuf>, SettlementResult)>),
+    {
+        for (chunk_index, chunk) in requests.chunks(BATCH_CHUNK_SIZE).enumerate() {
+            let proofs: Vec<_> = chunk
+                .par_iter()
+                .map(|request| {
+                    self.generate_settlement_proof(
+                        request.option_type,
+                        request.strike_price,
+                        spot_price,
+                        request.quantity,
+                    )
+                })
+                .collect();
+            
+            for (offset, proof) in proofs.into_iter().enumerate() {
+                sink(chunk_index * BATCH_CHUNK_SIZE + offset, proof);
+            }
+        }
+    }
+    
     /// 증명 스크립트 생성
     fn create_proof_scripts(&self, result: &SettlementResult) -> Result<Vec<ScriptBuf>> {
-        let mut scripts = Vec::new();
-        
-        // 1. 프로그램 해시 검증
-        let mut program_verify = vec![
-            bitcoin::opcodes::all::OP_SHA256.to_u8(),
-        ];
-        program_verify.extend_from_slice(&self.program_hash);
-        program_verify.push(bitcoin::opcodes::all::OP_EQUAL.to_u8());
-        scripts.push(ScriptBuf::from(program_verify));
-        
         // 2. 정산 결과 검증
-        let mut result_verify = vec![];
+        let mut result_verify = Vec::with_capacity(RESULT_SCRIPT_LEN);
         
         // ITM 여부
         if result.is_itm {
@@ -100,12 +134,51 @@ impl OptionSettlementProofGenerator {
         result_verify.push(4); // PUSH 4 bytes
         result_verify.extend_from_slice(&result.settlement_amount.to_le_bytes());
         
-        scripts.push(ScriptBuf::from(result_verify));
-        
-        Ok(scripts)
+        Ok(vec![self.program_verify.clone(), ScriptBuf::from(result_verify)])
     }
 }
 
+/// 정산 계산
+fn settle(
+    option_type: u32,
+    strike_price: u32,
+    spot_price: u32,
+    quantity: u32,
+) -> Result<SettlementResult> {
+    let (is_itm, intrinsic_value) = match option_type {
+        0 => { // Call
+            if spot_price > strike_price {
+                (true, spot_price - strike_price)
+            } else {
+                (false, 0)
+            }
+        },
+        1 => { // Put
+            if spot_price < strike_price {
+                (true, strike_price - spot_price)
+            } else {
+                (false, 0)
+            }
+        },
+        _ => return Err(anyhow!("Invalid option type")),
+    };
+    
+    // 정산 금액 계산 (USD cents to satoshi, 1 BTC = $50,000 가정, 수량은 1/100 BTC 단위)
+    let btc_price = 50_000_00; // cents
+    let settlement_amount = if is_itm {
+        ((intrinsic_value as u64 * quantity as u64 * 100_000_000)
+            / (btc_price as u64 * QUANTITY_SCALE)) as u32
+    } else {
+        0
+    };
+    
+    Ok(SettlementResult {
+        is_itm,
+        intrinsic_value,
+        settlement_amount,
+    })
+}
+
 /// 정산 결과
 #[derive(Debug, Clone)]
 pub struct SettlementResult {
@@ -157,4 +230,43 @@ mod tests {
         assert_eq!(result.intrinsic_value, 0);
         assert_eq!(result.settlement_amount, 0);
     }
-}
\ No newline at end of file
+    
+    #[test]
+    fn test_batch_matches_single_and_keeps_order() {
+        let dummy_elf = vec![0x7f, 0x45, 0x4c, 0x46];
+        let generator = OptionSettlementProofGenerator::new(&dummy_elf).unwrap();
+        
+        // 묶음 경계를 넘도록 생성, 중간에 잘못된 옵션 타입 포함
+        let requests: Vec<SettlementRequest> = (0..600u32)
+            .map(|i| SettlementRequest {
+                option_type: if i == 300 { 7 } else { i % 2 },
+                strike_price: 45000_00 + i * 20_00,
+                quantity: 100,
+            })
+            .collect();
+        
+        let mut order = Vec::new();
+        generator.stream_settlement_proofs(52000_00, &requests, |index, _| order.push(index));
+        assert_eq!(order, (0..600).collect::<Vec<_>>());
+        
+        let batch = generator.generate_settlement_proofs(52000_00, &requests);
+        for (request, proof) in requests.iter().zip(&batch) {
+            let single = generator.generate_settlement_proof(
+                request.option_type,
+                request.strike_price,
+                52000_00,
+                request.quantity,
+            );
+            match (proof, single) {
+                (Ok((scripts, result)), Ok((expected_scripts, expected))) => {
+                    assert_eq!(scripts, &expected_scripts);
+                    assert_eq!(result.settlement_amount, expected.settlement_amount);
+                }
+                (Err(_), Err(_)) => {}
+                _ => panic!("batch and single results differ"),
+            }
+        }
+        assert!(batch[300].is_err());
+        assert_eq!(batch[0].as_ref().unwrap().0[0].as_bytes()[1..33], generator.program_hash()[..]);
+    }
+}
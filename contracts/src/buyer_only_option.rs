@@ -1,8 +1,19 @@
 use anyhow::Result;
+use btcfi_calculation::pricing::time_to_expiry_between;
+use btcfi_calculation::{
+    BlackScholesPricing, ChainGreeks, MonteCarloPricing, OptionChain, OptionParameters, PathOption,
+    Payoff, PricingEngine,
+};
+use rayon::prelude::*;
 use serde::{Deserialize, Serialize};
 use std::collections::HashMap;
 use oracle_vm_common::types::OptionType;
 
+/// Greeks 계산 무위험 이자율 (계산 서비스 기본값과 동일)
+const RISK_FREE_RATE: f64 = 0.05;
+/// 재평가 병렬 작업 단위 (옵션 수)
+const REVALUE_CHUNK_SIZE: usize = 512;
+
 /// 단방향 옵션 (Buyer-only Option)
 #[derive(Debug, Clone, Serialize, Deserialize)]
 pub struct BuyerOnlyOption {
@@ -73,10 +84,38 @@ pub struct AggregatedPrice {
     pub timestamp: u64,        // Unix timestamp
 }
 
+/// 옵션 하나가 풀 Greeks에 더하는 값 (BTC 수량 반영)
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct PositionGreeks {
+    pub delta: f64,
+    pub gamma: f64,
+    pub vega: f64,
+    pub theta: f64, // Target theta (daily decay)
+}
+
+impl PositionGreeks {
+    fn new(option: &BuyerOnlyOption, delta: f64, gamma: f64, vega: f64) -> Self {
+        let notional_btc = option.quantity as f64 / 1e8;
+        Self {
+            delta: delta * notional_btc,
+            gamma: gamma * notional_btc,
+            vega: vega * notional_btc,
+            theta: option.target_theta,
+        }
+    }
+}
+
 /// 단방향 옵션 관리자
 pub struct BuyerOnlyOptionManager {
     pool: DeltaNeutralPool,
     price_cache: Option<AggregatedPrice>,
+    pricing_engine: BlackScholesPricing,
+    /// 경로 의존 정산(Asian/장벽) 견적용
+    path_engine: MonteCarloPricing,
+    /// 옵션별 Greeks 기여분 - 풀 합계는 이 값의 누적합으로 유지 (추가/제거 O(1))
+    position_greeks: HashMap<String, PositionGreeks>,
+    /// 같은 밀리초에 같은 주소로 산 옵션도 ID가 겹치지 않도록 붙이는 일련번호
+    next_option_seq: u64,
 }
 
 impl BuyerOnlyOptionManager {
@@ -102,12 +141,19 @@ impl BuyerOnlyOptionManager {
                 active_options: HashMap::new(),
             },
             price_cache: None,
+            pricing_engine: BlackScholesPricing::new(),
+            path_engine: MonteCarloPricing::default(),
+            position_greeks: HashMap::new(),
+            next_option_seq: 0,
         }
     }
 
-    /// 3개 거래소 가격 업데이트
+    /// 3개 거래소 가격 업데이트 - 활성 옵션 Greeks를 새 가격으로 재평가
     pub fn update_price(&mut self, aggregated_price: AggregatedPrice) {
         self.price_cache = Some(aggregated_price);
+        if !self.pool.active_options.is_empty() {
+            self.revalue_pool_greeks();
+        }
     }
 
     /// Target theta에 맞는 프리미엄 계산
@@ -145,6 +191,36 @@ impl BuyerOnlyOptionManager {
         Ok((total_premium, adjusted_iv))
     }
 
+    /// 정산 방식(Asian/장벽 등)별 프리미엄 견적 - (프리미엄, 표준오차) satoshis
+    pub fn quote_settlement_variant(
+        &self,
+        option_type: OptionType,
+        strike_price: u64,
+        quantity: u64,
+        implied_volatility: f64,
+        expiry_timestamp: u64,
+        payoff: Payoff,
+    ) -> Result<(u64, f64)> {
+        let spot = self.price_cache.as_ref()
+            .ok_or_else(|| anyhow::anyhow!("No price data available"))?
+            .average_price as f64 / 100.0;
+
+        let estimate = self.path_engine.price_option(&PathOption {
+            payoff,
+            is_call: option_type == OptionType::Call,
+            spot,
+            strike: strike_price as f64 / 100.0,
+            volatility: implied_volatility,
+            risk_free_rate: RISK_FREE_RATE,
+            valuation_time: chrono::Utc::now().timestamp() as u64,
+            expiry_time: expiry_timestamp,
+        });
+
+        // USD 프리미엄 (1 BTC당) → 수량만큼의 satoshis
+        let sats_per_usd = quantity as f64 / spot;
+        Ok(((estimate.price * sats_per_usd).round() as u64, estimate.std_error * sats_per_usd))
+    }
+
     /// 옵션 구매 (단방향)
     pub fn buy_option(
         &mut self,
@@ -179,9 +255,11 @@ impl BuyerOnlyOptionManager {
         }
         
         // 3. Create option
-        let option_id = format!("OPT-{}-{}", 
+        self.next_option_seq += 1;
+        let option_id = format!("OPT-{}-{}-{}", 
             chrono::Utc::now().timestamp_millis(), 
-            buyer_address.chars().take(8).collect::<String>()
+            buyer_address.chars().take(8).collect::<String>(),
+            self.next_option_seq
         );
         
         let expiry_timestamp = chrono::Utc::now().timestamp() as u64 
@@ -218,22 +296,16 @@ impl BuyerOnlyOptionManager {
 
     /// Update pool Greeks after new option
     fn update_pool_greeks(&mut self, option: &BuyerOnlyOption) {
-        // Simplified Greeks calculation
-        let spot = self.price_cache.as_ref().unwrap().average_price as f64;
-        let strike = option.strike_price as f64;
-        let time_to_expiry = (option.expiry_timestamp - chrono::Utc::now().timestamp() as u64) as f64 / 86400.0 / 365.0;
-        
-        // Delta calculation (simplified)
-        let moneyness = spot / strike;
-        let delta = match option.option_type {
-            OptionType::Call => 0.5 + 0.5 * moneyness.ln(),
-            OptionType::Put => -0.5 + 0.5 * moneyness.ln(),
-        }.max(-1.0).min(1.0);
-        
-        // Update pool Greeks
-        self.pool.net_delta += delta * (option.quantity as f64 / 1e8);
-        self.pool.net_theta += option.target_theta;
-        
+        let spot = self.price_cache.as_ref().unwrap().average_price;
+        let params = option_parameters(option, spot, chrono::Utc::now().timestamp() as u64);
+        let greeks = PositionGreeks::new(
+            option,
+            self.pricing_engine.calculate_delta(&params),
+            self.pricing_engine.calculate_gamma(&params),
+            self.pricing_engine.calculate_vega(&params),
+        );
+        self.add_position_greeks(&option.option_id, greeks);
+
         // Trigger rebalance if delta exceeds threshold
         if self.pool.net_delta.abs() > 0.1 {
             // In production, this would trigger external hedge rebalancing
@@ -241,6 +313,92 @@ impl BuyerOnlyOptionManager {
         }
     }
 
+    /// 옵션 기여분을 풀 합계에 더함
+    fn add_position_greeks(&mut self, option_id: &str, greeks: PositionGreeks) {
+        self.pool.net_delta += greeks.delta;
+        self.pool.net_gamma += greeks.gamma;
+        self.pool.net_vega += greeks.vega;
+        self.pool.net_theta += greeks.theta;
+        if let Some(previous) = self.position_greeks.insert(option_id.to_string(), greeks) {
+            self.subtract_from_pool(&previous);
+        }
+    }
+
+    /// 옵션 기여분을 풀 합계에서 뺌
+    fn remove_position_greeks(&mut self, option_id: &str) {
+        if let Some(greeks) = self.position_greeks.remove(option_id) {
+            self.subtract_from_pool(&greeks);
+        }
+        // 누적 오차가 남지 않도록 빈 풀은 정확히 0
+        if self.position_greeks.is_empty() {
+            self.pool.net_delta = 0.0;
+            self.pool.net_gamma = 0.0;
+            self.pool.net_vega = 0.0;
+            self.pool.net_theta = 0.0;
+        }
+    }
+
+    fn subtract_from_pool(&mut self, greeks: &PositionGreeks) {
+        self.pool.net_delta -= greeks.delta;
+        self.pool.net_gamma -= greeks.gamma;
+        self.pool.net_vega -= greeks.vega;
+        self.pool.net_theta -= greeks.theta;
+    }
+
+    /// 현재 가격으로 모든 활성 옵션의 Greeks 재평가
+    ///
+    /// 옵션을 묶음으로 나눠 계산 엔진의 체인 커널(`price_chain`)로 병렬 계산하고,
+    /// 기여분과 풀 합계를 새로 만든다. 현재 시각은 한 번만 읽는다.
+    pub fn revalue_pool_greeks(&mut self) {
+        let spot = match &self.price_cache {
+            Some(price_data) => price_data.average_price,
+            None => return,
+        };
+        let now = chrono::Utc::now().timestamp() as u64;
+        let options: Vec<&BuyerOnlyOption> = self
+            .pool
+            .active_options
+            .values()
+            .filter(|option| option.status == OptionStatus::Active)
+            .collect();
+
+        let engine = &self.pricing_engine;
+        let revalued: Vec<(String, PositionGreeks)> = options
+            .par_chunks(REVALUE_CHUNK_SIZE)
+            .flat_map_iter(|chunk| {
+                let mut chain = OptionChain::with_capacity(chunk.len());
+                for option in chunk {
+                    let params = option_parameters(option, spot, now);
+                    chain.push(params.strike, params.time_to_expiry, params.volatility);
+                }
+                let mut out = ChainGreeks::default();
+                engine.price_chain(spot as f64 / 100.0, RISK_FREE_RATE, &chain, &mut out);
+
+                chunk
+                    .iter()
+                    .enumerate()
+                    .map(|(i, option)| {
+                        let delta = match option.option_type {
+                            OptionType::Call => out.call_delta[i],
+                            OptionType::Put => out.put_delta[i],
+                        };
+                        let greeks = PositionGreeks::new(option, delta, out.gamma[i], out.vega[i]);
+                        (option.option_id.clone(), greeks)
+                    })
+                    .collect::<Vec<_>>()
+            })
+            .collect();
+
+        self.position_greeks.clear();
+        self.pool.net_delta = 0.0;
+        self.pool.net_gamma = 0.0;
+        self.pool.net_vega = 0.0;
+        self.pool.net_theta = 0.0;
+        for (option_id, greeks) in revalued {
+            self.add_position_greeks(&option_id, greeks);
+        }
+    }
+
     /// Settle expired option
     pub fn settle_option(&mut self, option_id: &str, settlement_price: u64) -> Result<u64> {
         let option = self.pool.active_options.get_mut(option_id)
@@ -288,48 +446,29 @@ impl BuyerOnlyOptionManager {
         // Remove settled option from active options
         self.pool.active_options.remove(option_id);
         
-        // Recalculate Greeks after removing option
-        self.recalculate_pool_greeks();
+        self.remove_position_greeks(option_id);
         
         Ok(payout)
     }
 
-    /// Recalculate pool Greeks from all active options
-    fn recalculate_pool_greeks(&mut self) {
-        self.pool.net_delta = 0.0;
-        self.pool.net_gamma = 0.0;
-        self.pool.net_vega = 0.0;
-        self.pool.net_theta = 0.0;
-        
-        if let Some(price_data) = &self.price_cache {
-            let spot = price_data.average_price as f64;
-            
-            for option in self.pool.active_options.values() {
-                if option.status == OptionStatus::Active {
-                    // Simplified Greeks calculation
-                    let strike = option.strike_price as f64;
-                    let time_to_expiry = (option.expiry_timestamp - chrono::Utc::now().timestamp() as u64) as f64 / 86400.0 / 365.0;
-                    
-                    // Delta calculation (simplified)
-                    let moneyness = spot / strike;
-                    let delta = match option.option_type {
-                        OptionType::Call => 0.5 + 0.5 * moneyness.ln(),
-                        OptionType::Put => -0.5 + 0.5 * moneyness.ln(),
-                    }.max(-1.0).min(1.0);
-                    
-                    self.pool.net_delta += delta * (option.quantity as f64 / 1e8);
-                    self.pool.net_theta += option.target_theta;
-                }
-            }
-        }
-    }
-    
     /// Get pool statistics
     pub fn get_pool_stats(&self) -> &DeltaNeutralPool {
         &self.pool
     }
 }
 
+/// 계산 엔진 입력으로 변환 (가격은 USD, 만기 지난 옵션은 만기 0)
+fn option_parameters(option: &BuyerOnlyOption, spot: u64, now: u64) -> OptionParameters {
+    OptionParameters {
+        spot: spot as f64 / 100.0,
+        strike: option.strike_price as f64 / 100.0,
+        volatility: option.implied_volatility,
+        risk_free_rate: RISK_FREE_RATE,
+        time_to_expiry: time_to_expiry_between(now, option.expiry_timestamp),
+        is_call: option.option_type == OptionType::Call,
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -392,4 +531,99 @@ mod tests {
         // Check pool updated
         assert_eq!(manager.pool.total_payouts, payout);
     }
-}
\ No newline at end of file
+
+    fn manager_at(price: u64) -> BuyerOnlyOptionManager {
+        let mut manager = BuyerOnlyOptionManager::new(100_000_000_000);
+        manager.update_price(AggregatedPrice {
+            binance_price: price,
+            coinbase_price: price,
+            kraken_price: price,
+            average_price: price,
+            timestamp: 1234567890,
+        });
+        manager
+    }
+
+    #[test]
+    fn test_running_greeks_match_revaluation() {
+        let mut manager = manager_at(7000000);
+        let mut ids = Vec::new();
+        for i in 0..20u64 {
+            let option_type = if i % 2 == 0 { OptionType::Call } else { OptionType::Put };
+            let option = manager
+                .buy_option(
+                    option_type,
+                    6000000 + i * 100000,
+                    1_000_000,
+                    -0.0002,
+                    1.0 + i as f64,
+                    format!("bc1q{:04}", i),
+                )
+                .unwrap();
+            ids.push(option.option_id);
+        }
+        assert!(manager.pool.net_gamma > 0.0);
+
+        // 누적합과 전체 재평가가 같아야 함
+        let running = (manager.pool.net_delta, manager.pool.net_gamma, manager.pool.net_theta);
+        manager.revalue_pool_greeks();
+        assert!((running.0 - manager.pool.net_delta).abs() < 1e-7);
+        assert!((running.1 - manager.pool.net_gamma).abs() < 1e-9);
+        assert!((running.2 - manager.pool.net_theta).abs() < 1e-6);
+
+        // 하나 정산하면 그 기여분만 빠짐
+        let removed = manager.position_greeks[&ids[3]];
+        let before = manager.pool.net_delta;
+        manager.settle_option(&ids[3], 7000000).unwrap();
+        assert!((before - removed.delta - manager.pool.net_delta).abs() < 1e-12);
+
+        // 전부 정산하면 정확히 0
+        for id in ids.iter().filter(|id| *id != &ids[3]) {
+            manager.settle_option(id, 7000000).unwrap();
+        }
+        assert_eq!(manager.pool.net_delta, 0.0);
+        assert_eq!(manager.pool.net_theta, 0.0);
+        assert!(manager.position_greeks.is_empty());
+    }
+
+    #[test]
+    fn test_quote_settlement_variants() {
+        use btcfi_calculation::BarrierKind;
+
+        let manager = manager_at(7000000);
+        let expiry = chrono::Utc::now().timestamp() as u64 + 30 * 86400;
+        let quote = |payoff| {
+            manager
+                .quote_settlement_variant(OptionType::Call, 7000000, 10_000_000, 0.6, expiry, payoff)
+                .unwrap()
+        };
+
+        let (european, error) = quote(Payoff::European);
+        let (asian, _) = quote(Payoff::AsianArithmetic);
+        let (capped, _) = quote(Payoff::Barrier { kind: BarrierKind::UpAndOut, level: 84000.0 });
+
+        // 0.1 BTC ATM 콜 30일 (σ 60%) ≈ 0.007 BTC
+        assert!(european > 600_000 && european < 800_000);
+        assert!(error < european as f64 * 0.01);
+        assert!(asian < european);
+        assert!(capped < european);
+    }
+
+    #[test]
+    fn test_price_update_revalues_greeks() {
+        let mut manager = manager_at(7000000);
+        manager
+            .buy_option(OptionType::Call, 7000000, 10_000_000, -0.0002, 7.0, "bc1qtest".to_string())
+            .unwrap();
+        let delta_at_70k = manager.pool.net_delta;
+
+        manager.update_price(AggregatedPrice {
+            binance_price: 7500000,
+            coinbase_price: 7500000,
+            kraken_price: 7500000,
+            average_price: 7500000,
+            timestamp: 1234567900,
+        });
+        assert!(manager.pool.net_delta > delta_at_70k);
+    }
+}
@@ -0,0 +1,355 @@
+//! 델타 인코딩 실행 트레이스
+//!
+//! 스텝마다 레지스터 전체를 복사하지 않고, 직전 스텝 대비 바뀐 레지스터만 기록한다.
+//! 레코드 형식 (LE): `pc: u32 | instruction: u32 | mask: u32 | 바뀐 레지스터 값: u32 * popcount(mask)`
+//!
+//! 버퍼가 임계값을 넘으면 파일로 내보내고(spill), 완료 후에는 파일을 메모리 매핑해 읽는다.
+//! 분쟁 게임(이분 탐색)에서 임의 스텝을 빠르게 찾도록 일정 간격으로 레지스터 체크포인트를 둔다.
+
+use crate::bitvmx_emulator_integration::ExecutionStep;
+use anyhow::{anyhow, Result};
+use memmap2::Mmap;
+use std::fs::File;
+use std::io::{BufWriter, Write};
+use std::ops::Deref;
+use std::path::{Path, PathBuf};
+
+/// 레코드 헤더 길이 (pc + instruction + mask)
+const HEADER_LEN: usize = 12;
+/// 레지스터 체크포인트 간격 (스텝)
+const CHECKPOINT_INTERVAL: u64 = 4096;
+
+/// 레지스터 체크포인트 - `step`번째 레코드 직전 상태
+#[derive(Debug, Clone)]
+struct Checkpoint {
+    step: u64,
+    offset: usize,
+    registers: [u32; 32],
+}
+
+/// 디스크로 내보내는 중인 트레이스 파일
+struct Spill {
+    path: PathBuf,
+    writer: BufWriter<File>,
+    threshold: usize,
+}
+
+/// 트레이스 기록기
+pub struct TraceWriter {
+    buffer: Vec<u8>,
+    spill: Option<Spill>,
+    /// 파일로 내보낸 바이트 수
+    flushed: usize,
+    registers: [u32; 32],
+    steps: u64,
+    checkpoints: Vec<Checkpoint>,
+}
+
+impl TraceWriter {
+    /// 메모리에만 기록
+    pub fn new() -> Self {
+        Self {
+            buffer: Vec::new(),
+            spill: None,
+            flushed: 0,
+            registers: [0; 32],
+            steps: 0,
+            checkpoints: Vec::new(),
+        }
+    }
+
+    /// 버퍼가 `threshold` 바이트를 넘을 때마다 `path`로 내보냄 (완료 후에도 파일은 남음)
+    pub fn with_spill(path: impl AsRef<Path>, threshold: usize) -> Result<Self> {
+        let path = path.as_ref().to_path_buf();
+        let file = File::create(&path)
+            .map_err(|e| anyhow!("Failed to create trace file {}: {}", path.display(), e))?;
+
+        Ok(Self {
+            buffer: Vec::with_capacity(threshold),
+            spill: Some(Spill {
+                path,
+                writer: BufWriter::new(file),
+                threshold,
+            }),
+            ..Self::new()
+        })
+    }
+
+    /// 스텝 하나 기록 - `registers`는 이 스텝 실행 시점의 레지스터 상태
+    pub fn record(&mut self, pc: u32, instruction: u32, registers: &[u32; 32]) -> Result<()> {
+        if self.steps % CHECKPOINT_INTERVAL == 0 {
+            self.checkpoints.push(Checkpoint {
+                step: self.steps,
+                offset: self.flushed + self.buffer.len(),
+                registers: self.registers,
+            });
+        }
+
+        let mask = registers
+            .iter()
+            .zip(&self.registers)
+            .enumerate()
+            .filter(|(_, (new, old))| new != old)
+            .fold(0u32, |mask, (index, _)| mask | 1 << index);
+
+        self.buffer.extend_from_slice(&pc.to_le_bytes());
+        self.buffer.extend_from_slice(&instruction.to_le_bytes());
+        self.buffer.extend_from_slice(&mask.to_le_bytes());
+        for index in set_bits(mask) {
+            self.buffer
+                .extend_from_slice(&registers[index].to_le_bytes());
+        }
+        self.registers = *registers;
+        self.steps += 1;
+
+        if let Some(spill) = &mut self.spill {
+            if self.buffer.len() >= spill.threshold {
+                spill.writer.write_all(&self.buffer)?;
+                self.flushed += self.buffer.len();
+                self.buffer.clear();
+            }
+        }
+
+        Ok(())
+    }
+
+    /// 기록 종료 - 파일로 내보냈다면 남은 버퍼를 쓰고 메모리 매핑
+    pub fn finish(mut self) -> Result<CompactTrace> {
+        let storage = match self.spill.take() {
+            None => TraceStorage::Memory(self.buffer),
+            Some(mut spill) => {
+                spill.writer.write_all(&self.buffer)?;
+                let file = spill
+                    .writer
+                    .into_inner()
+                    .map_err(|e| anyhow!("Failed to flush trace file: {}", e.error()))?;
+                file.sync_all()?;
+                drop(file);
+
+                let file = File::open(&spill.path)?;
+                // 파일은 트레이스가 살아 있는 동안 수정하지 않는다
+                let map = unsafe { Mmap::map(&file)? };
+                TraceStorage::Mapped {
+                    map,
+                    path: spill.path,
+                }
+            }
+        };
+
+        Ok(CompactTrace {
+            storage,
+            steps: self.steps,
+            checkpoints: self.checkpoints,
+        })
+    }
+}
+
+impl Default for TraceWriter {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+enum TraceStorage {
+    Memory(Vec<u8>),
+    Mapped { map: Mmap, path: PathBuf },
+}
+
+impl Deref for TraceStorage {
+    type Target = [u8];
+
+    fn deref(&self) -> &[u8] {
+        match self {
+            TraceStorage::Memory(bytes) => bytes,
+            TraceStorage::Mapped { map, .. } => map,
+        }
+    }
+}
+
+/// 완료된 트레이스 (읽기 전용)
+pub struct CompactTrace {
+    storage: TraceStorage,
+    steps: u64,
+    checkpoints: Vec<Checkpoint>,
+}
+
+impl std::fmt::Debug for CompactTrace {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("CompactTrace")
+            .field("steps", &self.steps)
+            .field("encoded_len", &self.encoded_len())
+            .field("spill_path", &self.spill_path())
+            .finish()
+    }
+}
+
+impl CompactTrace {
+    /// 스텝 수
+    pub fn len(&self) -> u64 {
+        self.steps
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.steps == 0
+    }
+
+    /// 인코딩된 크기 (bytes)
+    pub fn encoded_len(&self) -> usize {
+        self.storage.len()
+    }
+
+    /// 파일로 내보낸 경우 그 경로
+    pub fn spill_path(&self) -> Option<&Path> {
+        match &self.storage {
+            TraceStorage::Memory(_) => None,
+            TraceStorage::Mapped { path, .. } => Some(path),
+        }
+    }
+
+    /// 처음부터 순서대로 스텝 복원
+    pub fn iter(&self) -> TraceIter<'_> {
+        TraceIter {
+            bytes: &self.storage,
+            offset: 0,
+            registers: [0; 32],
+        }
+    }
+
+    /// `step`번째 스텝 - 가장 가까운 체크포인트부터 재생
+    pub fn get(&self, step: u64) -> Option<ExecutionStep> {
+        if step >= self.steps {
+            return None;
+        }
+        let checkpoint = &self.checkpoints[(step / CHECKPOINT_INTERVAL) as usize];
+        let mut iter = TraceIter {
+            bytes: &self.storage,
+            offset: checkpoint.offset,
+            registers: checkpoint.registers,
+        };
+        iter.nth((step - checkpoint.step) as usize)
+    }
+}
+
+/// 스트리밍 트레이스 반복자 - 레지스터 상태를 델타로 누적해 스텝마다 복원
+pub struct TraceIter<'a> {
+    bytes: &'a [u8],
+    offset: usize,
+    registers: [u32; 32],
+}
+
+impl<'a> TraceIter<'a> {
+    fn read_u32(&mut self) -> u32 {
+        let value =
+            u32::from_le_bytes(self.bytes[self.offset..self.offset + 4].try_into().unwrap());
+        self.offset += 4;
+        value
+    }
+}
+
+impl<'a> Iterator for TraceIter<'a> {
+    type Item = ExecutionStep;
+
+    fn next(&mut self) -> Option<ExecutionStep> {
+        if self.offset + HEADER_LEN > self.bytes.len() {
+            return None;
+        }
+
+        let pc = self.read_u32();
+        let instruction = self.read_u32();
+        let mask = self.read_u32();
+        for index in set_bits(mask) {
+            self.registers[index] = self.read_u32();
+        }
+
+        Some(ExecutionStep {
+            pc,
+            instruction,
+            registers: self.registers,
+        })
+    }
+}
+
+/// mask에서 1인 비트 위치 (오름차순)
+fn set_bits(mut mask: u32) -> impl Iterator<Item = usize> {
+    std::iter::from_fn(move || {
+        if mask == 0 {
+            return None;
+        }
+        let index = mask.trailing_zeros() as usize;
+        mask &= mask - 1;
+        Some(index)
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// 스텝마다 레지스터 하나씩 바뀌는 트레이스
+    fn sample_steps(count: u32) -> Vec<ExecutionStep> {
+        let mut registers = [0u32; 32];
+        (0..count)
+            .map(|i| {
+                registers[(i % 31 + 1) as usize] = i * 7;
+                ExecutionStep {
+                    pc: 0x8000_0000 + i * 4,
+                    instruction: 0x0000_0013 ^ i,
+                    registers,
+                }
+            })
+            .collect()
+    }
+
+    fn write(writer: &mut TraceWriter, steps: &[ExecutionStep]) {
+        for step in steps {
+            writer
+                .record(step.pc, step.instruction, &step.registers)
+                .unwrap();
+        }
+    }
+
+    #[test]
+    fn test_round_trip_and_random_access() {
+        let steps = sample_steps(10_000);
+        let mut writer = TraceWriter::new();
+        write(&mut writer, &steps);
+        let trace = writer.finish().unwrap();
+
+        assert_eq!(trace.len(), 10_000);
+        // 헤더 + 바뀐 레지스터 1개 (첫 스텝의 0 기록은 변화 없음)
+        assert!(trace.encoded_len() <= 10_000 * (HEADER_LEN + 4));
+
+        for (decoded, expected) in trace.iter().zip(&steps) {
+            assert_eq!(decoded.pc, expected.pc);
+            assert_eq!(decoded.instruction, expected.instruction);
+            assert_eq!(decoded.registers, expected.registers);
+        }
+        for step in [0u64, 1, 4095, 4096, 4097, 9999] {
+            assert_eq!(
+                trace.get(step).unwrap().registers,
+                steps[step as usize].registers
+            );
+        }
+        assert!(trace.get(10_000).is_none());
+    }
+
+    #[test]
+    fn test_spilled_trace_is_memory_mapped() {
+        let path = std::env::temp_dir().join(format!("trace-{}.bin", std::process::id()));
+        let steps = sample_steps(5_000);
+        let mut writer = TraceWriter::with_spill(&path, 1024).unwrap();
+        write(&mut writer, &steps);
+        let trace = writer.finish().unwrap();
+
+        assert_eq!(trace.spill_path(), Some(path.as_path()));
+        assert_eq!(
+            std::fs::metadata(&path).unwrap().len() as usize,
+            trace.encoded_len()
+        );
+        assert_eq!(trace.get(4_321).unwrap().registers, steps[4_321].registers);
+        assert_eq!(trace.iter().count(), 5_000);
+
+        drop(trace);
+        std::fs::remove_file(&path).unwrap();
+    }
+}
@@ -7,9 +7,12 @@ pub mod price_feed_client;
 pub mod bitvmx_proof_generator;
 pub mod bitvmx_presign;
 pub mod bitvmx_emulator_integration;
+pub mod execution_trace;
+pub mod metrics;
+pub mod taproot_template;
 
 pub use simple_contract::{
-    OptionStatus, SimpleContractManager, SimpleOption, SimplePoolState,
+    BatchSettlement, OptionStatus, SimpleContractManager, SimpleOption, SimplePoolState,
 };
 pub use buyer_only_option::{
     BuyerOnlyOption, BuyerOnlyOptionManager, DeltaNeutralPool, AggregatedPrice,
@@ -0,0 +1,17 @@
+//! Prometheus 지표
+//!
+//! - `contracts_proof_generation_seconds{prover}`: 정산 증명 생성 시간
+//!   (`script`: 증명 스크립트 생성기, `emulator`: BitVMX 에뮬레이터 실행)
+//!
+//! 프로세스 기본 레지스트리에 등록되므로 이 크레이트를 쓰는 서비스의 `/metrics`로 함께 노출된다.
+
+use oracle_vm_common::metrics::{self, HistogramVec};
+use std::sync::LazyLock;
+
+pub static PROOF_GENERATION_SECONDS: LazyLock<HistogramVec> = LazyLock::new(|| {
+    metrics::latency_histogram(
+        "contracts_proof_generation_seconds",
+        "Settlement proof generation latency",
+        &["prover"],
+    )
+});
@@ -1,7 +1,8 @@
 use anyhow::Result;
+use oracle_vm_common::Price;
 use tonic::transport::Channel;
 use tonic::Request;
-use tracing::{info, error};
+use tracing::{info, error, warn};
 
 // gRPC 클라이언트 코드
 pub mod oracle {
@@ -10,11 +11,19 @@ pub mod oracle {
 
 use oracle::{
     oracle_service_client::OracleServiceClient,
-    GetPriceRequest,
+    AggregatedPriceUpdate, FixedPrice, GetPriceRequest, PriceDataPoint, PriceRequest,
 };
 
 use crate::buyer_only_option::AggregatedPrice;
 
+/// 옵션 정산 기준 자산 쌍
+const SETTLEMENT_PAIR: &str = "BTC/USD";
+
+/// 스트림 업데이트가 정산 기준 자산 쌍인지 (빈 값은 이전 버전 Aggregator의 BTC/USD)
+fn is_settlement_pair(update: &AggregatedPriceUpdate) -> bool {
+    update.pair.is_empty() || update.pair == SETTLEMENT_PAIR
+}
+
 /// Aggregator에서 가격을 가져오는 클라이언트
 pub struct PriceFeedClient {
     client: OracleServiceClient<Channel>,
@@ -38,6 +47,7 @@ impl PriceFeedClient {
     pub async fn get_aggregated_price(&mut self) -> Result<AggregatedPrice> {
         let request = Request::new(GetPriceRequest {
             source_filter: None,
+            pair: Some(SETTLEMENT_PAIR.to_string()),
         });
         
         let response = self.client.get_aggregated_price(request).await?;
@@ -47,37 +57,79 @@ impl PriceFeedClient {
             anyhow::bail!("No valid aggregated price available");
         }
         
-        // gRPC response에서 개별 거래소 가격 추출
-        let mut binance_price = 0u64;
-        let mut coinbase_price = 0u64;
-        let mut kraken_price = 0u64;
+        to_aggregated_price(
+            price_response.aggregated_price_fixed.as_ref(),
+            &price_response.recent_prices,
+            price_response.last_update,
+        )
+        .ok_or_else(|| anyhow::anyhow!("Aggregator did not send a fixed-point price"))
+    }
+    
+    /// Aggregator 집계 가격 스트림 구독
+    ///
+    /// 구독자는 가격을 제출하지 않으므로 빈 스트림을 보내고,
+    /// Aggregator가 합의할 때마다 업데이트를 받는다.
+    pub async fn subscribe(&mut self) -> Result<tonic::Streaming<AggregatedPriceUpdate>> {
+        let request = Request::new(tokio_stream::pending::<PriceRequest>());
+        let response = self.client.stream_prices(request).await?;
         
-        for data_point in &price_response.recent_prices {
-            let price_cents = (data_point.price * 100.0) as u64;
-            match data_point.source.as_str() {
-                "binance" => binance_price = price_cents,
-                "coinbase" => coinbase_price = price_cents,
-                "kraken" => kraken_price = price_cents,
-                _ => {}
-            }
+        Ok(response.into_inner())
+    }
+}
+
+/// 스트림 업데이트를 AggregatedPrice로 변환 (고정소수점 가격이 없으면 None)
+fn from_update(update: &AggregatedPriceUpdate) -> Option<AggregatedPrice> {
+    to_aggregated_price(
+        update.aggregated_price_fixed.as_ref(),
+        &update.sources,
+        update.timestamp,
+    )
+}
+
+/// 고정소수점 가격 -> 센트 (정수 연산만 사용, 없거나 음수면 None)
+fn to_cents(price: Option<&FixedPrice>) -> Option<u64> {
+    let price = Price::from_parts(price?.mantissa, price?.exponent)?;
+    u64::try_from(price.to_cents()).ok()
+}
+
+/// gRPC 데이터 포인트에서 개별 거래소 가격 추출
+///
+/// 정산 계약은 센트 단위라 고정소수점 필드만 사용한다 (표시용 double은 쓰지 않음).
+fn to_aggregated_price(
+    aggregated_price: Option<&FixedPrice>,
+    points: &[PriceDataPoint],
+    timestamp: u64,
+) -> Option<AggregatedPrice> {
+    let average_price = to_cents(aggregated_price)?;
+    let mut binance_price = 0u64;
+    let mut coinbase_price = 0u64;
+    let mut kraken_price = 0u64;
+    
+    for data_point in points {
+        let Some(price_cents) = to_cents(data_point.price_fixed.as_ref()) else {
+            continue;
+        };
+        match data_point.source.as_str() {
+            "binance" => binance_price = price_cents,
+            "coinbase" => coinbase_price = price_cents,
+            "kraken" => kraken_price = price_cents,
+            _ => {}
         }
-        
-        // 평균 가격 계산
-        let average_price = (price_response.aggregated_price * 100.0) as u64;
-        
-        Ok(AggregatedPrice {
-            binance_price,
-            coinbase_price,
-            kraken_price,
-            average_price,
-            timestamp: price_response.last_update,
-        })
     }
+    
+    Some(AggregatedPrice {
+        binance_price,
+        coinbase_price,
+        kraken_price,
+        average_price,
+        timestamp,
+    })
 }
 
-/// 정기적으로 가격을 업데이트하는 서비스
+/// Aggregator 스트림을 구독하여 가격을 업데이트하는 서비스
 pub struct PriceFeedService {
     client: PriceFeedClient,
+    /// 스트림이 끊겼을 때 재연결 대기 시간
     update_interval: std::time::Duration,
 }
 
@@ -93,34 +145,69 @@ impl PriceFeedService {
     }
     
     /// 가격 피드 서비스 실행
+    ///
+    /// 폴링 대신 StreamPrices를 구독하므로 집계 즉시 콜백이 호출된다.
+    /// 스트림이 끊기면 `update_interval` 후 재연결한다.
     pub async fn run<F>(&mut self, mut callback: F) -> Result<()>
     where
         F: FnMut(AggregatedPrice) + Send,
     {
-        let mut interval = tokio::time::interval(self.update_interval);
-        
         loop {
-            interval.tick().await;
-            
+            // 구독 직후 다음 집계까지 기다리지 않도록 현재 스냅샷 먼저 전달
             match self.client.get_aggregated_price().await {
                 Ok(price) => {
-                    info!(
-                        "Received aggregated price: ${:.2} (Binance: ${:.2}, Coinbase: ${:.2}, Kraken: ${:.2})",
-                        price.average_price as f64 / 100.0,
-                        price.binance_price as f64 / 100.0,
-                        price.coinbase_price as f64 / 100.0,
-                        price.kraken_price as f64 / 100.0,
-                    );
+                    log_price(&price);
                     callback(price);
                 }
                 Err(e) => {
-                    error!("Failed to get aggregated price: {}", e);
+                    warn!("No aggregated price snapshot yet: {}", e);
+                }
+            }
+            
+            match self.client.subscribe().await {
+                Ok(mut stream) => {
+                    info!("Subscribed to aggregated price stream");
+                    loop {
+                        match stream.message().await {
+                            Ok(Some(update)) if !is_settlement_pair(&update) => {}
+                            Ok(Some(update)) => match from_update(&update) {
+                                Some(price) => {
+                                    log_price(&price);
+                                    callback(price);
+                                }
+                                None => warn!("Skipping update without a fixed-point price"),
+                            },
+                            Ok(None) => {
+                                warn!("Aggregated price stream closed by Aggregator");
+                                break;
+                            }
+                            Err(status) => {
+                                error!("Aggregated price stream error: {}", status);
+                                break;
+                            }
+                        }
+                    }
+                }
+                Err(e) => {
+                    error!("Failed to subscribe to aggregated prices: {}", e);
                 }
             }
+            
+            tokio::time::sleep(self.update_interval).await;
         }
     }
 }
 
+fn log_price(price: &AggregatedPrice) {
+    info!(
+        "Received aggregated price: ${:.2} (Binance: ${:.2}, Coinbase: ${:.2}, Kraken: ${:.2})",
+        price.average_price as f64 / 100.0,
+        price.binance_price as f64 / 100.0,
+        price.coinbase_price as f64 / 100.0,
+        price.kraken_price as f64 / 100.0,
+    );
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -139,4 +226,53 @@ mod tests {
         assert_eq!(price.average_price, 7000000);
         assert_eq!(price.binance_price, 7000000);
     }
+    
+    fn fixed(mantissa: i64, exponent: i32) -> Option<FixedPrice> {
+        Some(FixedPrice { mantissa, exponent })
+    }
+    
+    #[test]
+    fn test_stream_update_conversion() {
+        let update = AggregatedPriceUpdate {
+            aggregated_price: 70000.0,
+            aggregated_price_fixed: fixed(7_000_000_000_000, -8),
+            data_points: 3,
+            timestamp: 1234567890,
+            active_nodes: vec!["oracle-node-1".to_string()],
+            pair: "BTC/USD".to_string(),
+            sources: vec![
+                PriceDataPoint {
+                    price: 70050.0,
+                    timestamp: 1234567880,
+                    source: "coinbase".to_string(),
+                    node_id: "oracle-node-1".to_string(),
+                    price_fixed: fixed(7_005_000_000_000, -8),
+                },
+                PriceDataPoint {
+                    price: 69950.0,
+                    timestamp: 1234567880,
+                    source: "kraken".to_string(),
+                    node_id: "oracle-node-1".to_string(),
+                    // 다른 exponent도 정수로 재조정
+                    price_fixed: fixed(6_995_000, -2),
+                },
+            ],
+            ..Default::default()
+        };
+        
+        let price = from_update(&update).unwrap();
+        assert_eq!(price.average_price, 7000000);
+        assert_eq!(price.coinbase_price, 7005000);
+        assert_eq!(price.kraken_price, 6995000);
+        assert_eq!(price.binance_price, 0);
+        assert_eq!(price.timestamp, 1234567890);
+        assert!(is_settlement_pair(&update));
+        
+        // 표시용 double만 있는 업데이트는 정산에 쓰지 않음
+        let legacy = AggregatedPriceUpdate {
+            aggregated_price: 70000.0,
+            ..Default::default()
+        };
+        assert!(from_update(&legacy).is_none());
+    }
 }
\ No newline at end of file
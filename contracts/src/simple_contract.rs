@@ -1,6 +1,6 @@
 use anyhow::Result;
 use serde::{Deserialize, Serialize};
-use std::collections::HashMap;
+use std::collections::{BTreeMap, HashMap};
 use oracle_vm_common::types::OptionType;
 
 /// 옵션 상태
@@ -61,10 +61,20 @@ impl Default for SimplePoolState {
     }
 }
 
+/// 만기 일괄 정산 결과
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct BatchSettlement {
+    /// (옵션 ID, 지급액) - 만기 높이 오름차순
+    pub settlements: Vec<(String, u64)>,
+    pub total_payout: u64,
+}
+
 /// 간단한 컨트랙트 관리자
 pub struct SimpleContractManager {
     pub options: HashMap<String, SimpleOption>,
     pub pool_state: SimplePoolState,
+    /// 만기 높이 -> 활성 옵션 ID (블록마다 만기 도래분만 조회)
+    expiry_index: BTreeMap<u32, Vec<String>>,
 }
 
 impl SimpleContractManager {
@@ -72,6 +82,7 @@ impl SimpleContractManager {
         Self {
             options: HashMap::new(),
             pool_state: SimplePoolState::new(),
+            expiry_index: BTreeMap::new(),
         }
     }
 
@@ -127,6 +138,10 @@ impl SimpleContractManager {
         };
 
         // 상태 업데이트
+        self.expiry_index
+            .entry(expiry_height)
+            .or_default()
+            .push(option_id.clone());
         self.options.insert(option_id, option);
         self.pool_state.available_liquidity -= collateral;
         self.pool_state.locked_collateral += collateral;
@@ -149,55 +164,85 @@ impl SimpleContractManager {
             return Err(anyhow::anyhow!("Option not active"));
         }
 
-        // ITM 여부 확인
-        let is_itm = match option.option_type {
-            OptionType::Call => spot_price > option.strike_price,
-            OptionType::Put => spot_price < option.strike_price,
+        let (payout, collateral) = settlement_amounts(option, spot_price);
+        option.status = OptionStatus::Settled;
+        let expiry_height = option.expiry_height;
+
+        // 인덱스에서 제거
+        if let Some(ids) = self.expiry_index.get_mut(&expiry_height) {
+            ids.retain(|id| id != option_id);
+            if ids.is_empty() {
+                self.expiry_index.remove(&expiry_height);
+            }
+        }
+
+        self.apply_settlement(payout, collateral, 1);
+
+        Ok(payout)
+    }
+
+    /// 만기가 도래한 옵션을 한 번에 정산
+    ///
+    /// 인덱스에서 `current_height` 이하 구간을 떼어내 순회하고, 풀 상태는 합계로 한 번만 갱신한다.
+    /// 비용은 만기 도래 옵션 수에 비례한다.
+    pub fn settle_expired_batch(
+        &mut self,
+        current_height: u32,
+        spot_price: u64,
+    ) -> BatchSettlement {
+        let due = match current_height.checked_add(1) {
+            Some(next_height) => {
+                let remaining = self.expiry_index.split_off(&next_height);
+                std::mem::replace(&mut self.expiry_index, remaining)
+            }
+            None => std::mem::take(&mut self.expiry_index),
         };
 
-        let payout = if is_itm {
-            let intrinsic_value = match option.option_type {
-                OptionType::Call => spot_price - option.strike_price,
-                OptionType::Put => option.strike_price - spot_price,
+        let mut result = BatchSettlement::default();
+        let mut total_collateral = 0;
+        for option_id in due.into_values().flatten() {
+            let option = match self.options.get_mut(&option_id) {
+                Some(option) if option.status == OptionStatus::Active => option,
+                _ => continue,
             };
-            // USD cents를 satoshis로 변환
-            (intrinsic_value * option.quantity) / 100_000_000
-        } else {
-            0
-        };
 
-        // 담보금 계산
-        let collateral = match option.option_type {
-            OptionType::Call => option.quantity,
-            OptionType::Put => (option.strike_price * option.quantity) / 100_000_000,
-        };
+            let (payout, collateral) = settlement_amounts(option, spot_price);
+            option.status = OptionStatus::Settled;
+            total_collateral += collateral;
+            result.total_payout += payout;
+            result.settlements.push((option_id, payout));
+        }
 
-        // 상태 업데이트
-        option.status = OptionStatus::Settled;
+        self.apply_settlement(
+            result.total_payout,
+            total_collateral,
+            result.settlements.len() as u32,
+        );
+
+        result
+    }
+
+    /// 정산 결과를 풀 상태에 반영 (옵션 하나 또는 묶음의 합계)
+    fn apply_settlement(&mut self, payout: u64, collateral: u64, settled: u32) {
         self.pool_state.locked_collateral -= collateral;
 
         if payout > 0 {
             self.pool_state.total_payout += payout;
             self.pool_state.total_liquidity -= payout;
-            // 잔여 담보금은 풀로 반환
-            self.pool_state.available_liquidity += collateral - payout;
-        } else {
-            // OTM인 경우 전체 담보금이 풀로 반환
-            self.pool_state.available_liquidity += collateral;
         }
+        // 잔여 담보금은 풀로 반환 (OTM이면 전체)
+        self.pool_state.available_liquidity += collateral - payout;
 
-        self.pool_state.active_options -= 1;
-
-        Ok(payout)
+        self.pool_state.active_options -= settled;
     }
 
     /// 만료된 옵션 조회
     pub fn get_expired_options(&self, current_height: u32) -> Vec<&SimpleOption> {
-        self.options
-            .values()
-            .filter(|option| {
-                option.status == OptionStatus::Active && current_height >= option.expiry_height
-            })
+        self.expiry_index
+            .range(..=current_height)
+            .flat_map(|(_, ids)| ids)
+            .filter_map(|id| self.options.get(id))
+            .filter(|option| option.status == OptionStatus::Active)
             .collect()
     }
 
@@ -213,6 +258,34 @@ impl SimpleContractManager {
     }
 }
 
+/// 정산 지급액과 반환할 담보금 (satoshis)
+fn settlement_amounts(option: &SimpleOption, spot_price: u64) -> (u64, u64) {
+    // ITM 여부 확인
+    let is_itm = match option.option_type {
+        OptionType::Call => spot_price > option.strike_price,
+        OptionType::Put => spot_price < option.strike_price,
+    };
+
+    let payout = if is_itm {
+        let intrinsic_value = match option.option_type {
+            OptionType::Call => spot_price - option.strike_price,
+            OptionType::Put => option.strike_price - spot_price,
+        };
+        // USD cents를 satoshis로 변환
+        (intrinsic_value * option.quantity) / 100_000_000
+    } else {
+        0
+    };
+
+    // 담보금 계산
+    let collateral = match option.option_type {
+        OptionType::Call => option.quantity,
+        OptionType::Put => (option.strike_price * option.quantity) / 100_000_000,
+    };
+
+    (payout, collateral)
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -308,4 +381,54 @@ mod tests {
 
         println!("Call OTM Payout: {} sats (should be 0)", payout);
     }
+
+    #[test]
+    fn test_settle_expired_batch() {
+        let mut manager = SimpleContractManager::new();
+        manager.add_liquidity(1_000_000_000).unwrap();
+
+        for (i, expiry_height) in [800_000, 799_000, 801_000, 800_000].into_iter().enumerate() {
+            manager
+                .create_option(
+                    format!("OPT-{}", i),
+                    if i % 2 == 0 {
+                        OptionType::Call
+                    } else {
+                        OptionType::Put
+                    },
+                    7_000_000,
+                    10_000_000,
+                    100_000,
+                    expiry_height,
+                    format!("user{}", i),
+                )
+                .unwrap();
+        }
+        // 만기 전에 개별 정산된 옵션은 일괄 정산에서 제외
+        manager.settle_option("OPT-3", 7_000_000).unwrap();
+        assert_eq!(manager.get_expired_options(800_000).len(), 2);
+
+        let batch = manager.settle_expired_batch(800_000, 7_200_000);
+        let settled: Vec<&str> = batch
+            .settlements
+            .iter()
+            .map(|(id, _)| id.as_str())
+            .collect();
+        assert_eq!(settled, ["OPT-1", "OPT-0"]);
+        // Call ITM ($2,000 x 0.1 BTC), Put OTM
+        assert_eq!(batch.total_payout, 20_000);
+        assert_eq!(manager.pool_state.total_payout, 20_000);
+        assert_eq!(manager.pool_state.active_options, 1);
+        assert!(manager.get_expired_options(800_000).is_empty());
+
+        // 남은 옵션만 다음 높이에서 정산
+        assert!(manager
+            .settle_expired_batch(800_999, 7_200_000)
+            .settlements
+            .is_empty());
+        let last = manager.settle_expired_batch(801_000, 6_000_000);
+        assert_eq!(last.settlements, [("OPT-2".to_string(), 0)]);
+        assert_eq!(manager.pool_state.active_options, 0);
+        assert_eq!(manager.pool_state.locked_collateral, 0);
+    }
 }
@@ -0,0 +1,276 @@
+//! 옵션 Taproot 스크립트 템플릿 캐시
+//!
+//! 정산/환불 스크립트는 만기 블록과 세 공개키(구매자/판매자/검증자)로만 정해진다 (행사가,
+//! 옵션 타입, 금액은 스크립트에 들어가지 않음). 같은 조합이면 스크립트, 리프 해시,
+//! `TaprootSpendInfo`, control block을 한 번만 계산해 모든 트랜잭션 빌더가 공유한다.
+
+use crate::bitcoin_option::BitcoinOption;
+use anyhow::Result;
+use bitcoin::blockdata::opcodes::all::*;
+use bitcoin::blockdata::script::{Builder, ScriptBuf};
+use bitcoin::secp256k1::PublicKey;
+use bitcoin::taproot::{
+    ControlBlock, LeafVersion, TapLeafHash, TaprootBuilder, TaprootSpendInfo,
+};
+use bitcoin::XOnlyPublicKey;
+use oracle_vm_common::crypto::secp;
+use std::collections::HashMap;
+use std::sync::{Arc, OnceLock, RwLock};
+
+/// 캐시 최대 템플릿 수 - 넘치면 비우고 다시 채운다 (만기 지난 템플릿 정리 겸)
+const MAX_TEMPLATES: usize = 16_384;
+
+/// 스크립트를 결정하는 옵션 파라미터
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub struct TemplateKey {
+    pub expiry_block: u32,
+    pub buyer_pubkey: PublicKey,
+    pub seller_pubkey: PublicKey,
+    pub verifier_pubkey: PublicKey,
+}
+
+impl From<&BitcoinOption> for TemplateKey {
+    fn from(option: &BitcoinOption) -> Self {
+        Self {
+            expiry_block: option.expiry_block,
+            buyer_pubkey: option.buyer_pubkey,
+            seller_pubkey: option.seller_pubkey,
+            verifier_pubkey: option.verifier_pubkey,
+        }
+    }
+}
+
+/// 미리 계산한 옵션 Taproot 출력
+#[derive(Debug)]
+pub struct TaprootTemplate {
+    /// BitVMX 증명 기반 정산 리프
+    pub settlement_script: ScriptBuf,
+    /// 만기 + 144블록 후 판매자 회수 리프
+    pub refund_script: ScriptBuf,
+    pub settlement_leaf_hash: TapLeafHash,
+    pub refund_leaf_hash: TapLeafHash,
+    /// 정산 리프 script-path 지출용
+    pub settlement_control_block: ControlBlock,
+    pub spend_info: TaprootSpendInfo,
+    pub output_script: ScriptBuf,
+}
+
+impl TaprootTemplate {
+    pub fn build(key: &TemplateKey) -> Result<Self> {
+        let settlement_script = settlement_script(key);
+        let refund_script = refund_script(key);
+
+        // Key-path: 구매자 + 판매자 협력 정산
+        // (실제 구현에서는 MuSig2 집계 키, 여기서는 단순화를 위해 구매자 키)
+        let internal_xonly = XOnlyPublicKey::from(key.buyer_pubkey);
+        let spend_info = TaprootBuilder::new()
+            .add_leaf(1, settlement_script.clone())?
+            .add_leaf(1, refund_script.clone())?
+            .finalize(secp(), internal_xonly)
+            .map_err(|_| anyhow::anyhow!("Failed to finalize taproot"))?;
+
+        let settlement_control_block = spend_info
+            .control_block(&(settlement_script.clone(), LeafVersion::TapScript))
+            .ok_or_else(|| anyhow::anyhow!("Settlement leaf missing from taproot tree"))?;
+
+        // 출력 키는 내부 키를 스크립트 트리 머클 루트로 tweak한 키 (BIP-341)
+        let output_script = ScriptBuf::new_p2tr_tweaked(spend_info.output_key());
+
+        Ok(Self {
+            settlement_leaf_hash: TapLeafHash::from_script(
+                &settlement_script,
+                LeafVersion::TapScript,
+            ),
+            refund_leaf_hash: TapLeafHash::from_script(&refund_script, LeafVersion::TapScript),
+            settlement_script,
+            refund_script,
+            settlement_control_block,
+            spend_info,
+            output_script,
+        })
+    }
+}
+
+/// 템플릿 캐시 (읽기 위주 - 발행/정산마다 조회, 새 조합일 때만 쓰기)
+pub struct TaprootTemplateCache {
+    templates: RwLock<HashMap<TemplateKey, Arc<TaprootTemplate>>>,
+    capacity: usize,
+}
+
+impl TaprootTemplateCache {
+    pub fn new(capacity: usize) -> Self {
+        Self {
+            templates: RwLock::new(HashMap::new()),
+            capacity: capacity.max(1),
+        }
+    }
+
+    /// 프로세스 공용 캐시
+    pub fn global() -> &'static Self {
+        static CACHE: OnceLock<TaprootTemplateCache> = OnceLock::new();
+        CACHE.get_or_init(|| Self::new(MAX_TEMPLATES))
+    }
+
+    /// 옵션의 템플릿 조회 (없으면 계산해 저장)
+    pub fn get(&self, option: &BitcoinOption) -> Result<Arc<TaprootTemplate>> {
+        let key = TemplateKey::from(option);
+        let cached = self
+            .templates
+            .read()
+            .map_err(|_| anyhow::anyhow!("Lock error"))?
+            .get(&key)
+            .cloned();
+        if let Some(template) = cached {
+            return Ok(template);
+        }
+
+        // 해싱은 락 밖에서 - 동시에 같은 키를 만들면 먼저 저장된 쪽을 사용
+        let built = Arc::new(TaprootTemplate::build(&key)?);
+        let mut templates = self
+            .templates
+            .write()
+            .map_err(|_| anyhow::anyhow!("Lock error"))?;
+        if templates.len() >= self.capacity && !templates.contains_key(&key) {
+            templates.clear();
+        }
+        Ok(Arc::clone(templates.entry(key).or_insert(built)))
+    }
+
+    pub fn len(&self) -> usize {
+        self.templates.read().map(|templates| templates.len()).unwrap_or(0)
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+}
+
+/// 정산 스크립트: BitVMX 증명 검증 후 자동 정산
+fn settlement_script(key: &TemplateKey) -> ScriptBuf {
+    Builder::new()
+        // 만기 시간 체크
+        .push_int(key.expiry_block as i64)
+        .push_opcode(OP_CLTV)
+        .push_opcode(OP_DROP)
+
+        // BitVMX 증명 검증
+        // 증명 포맷: [option_type || strike || spot || settlement_amount]
+        .push_opcode(OP_DUP)
+        .push_opcode(OP_SHA256)
+
+        // 예상 증명 해시와 비교 (실제로는 동적으로 계산)
+        .push_slice(&[0u8; 32]) // placeholder for proof hash
+        .push_opcode(OP_EQUAL)
+        .push_opcode(OP_VERIFY)
+
+        // 검증자 서명 확인
+        .push_slice(&key.verifier_pubkey.serialize())
+        .push_opcode(OP_CHECKSIGVERIFY)
+
+        // 정산 금액에 따라 수령인 결정
+        // 스택: [settlement_amount]
+        .push_int(0)
+        .push_opcode(OP_GREATERTHAN)
+        .push_opcode(OP_IF)
+            // ITM: 구매자가 수령
+            .push_slice(&key.buyer_pubkey.serialize())
+        .push_opcode(OP_ELSE)
+            // OTM: 판매자가 담보 회수
+            .push_slice(&key.seller_pubkey.serialize())
+        .push_opcode(OP_ENDIF)
+        .push_opcode(OP_CHECKSIG)
+        .into_script()
+}
+
+/// 환불 스크립트: 만기 후 일정 시간 지나면 판매자가 회수
+fn refund_script(key: &TemplateKey) -> ScriptBuf {
+    Builder::new()
+        // 만기 + 1일 후
+        .push_int((key.expiry_block + 144) as i64)
+        .push_opcode(OP_CLTV)
+        .push_opcode(OP_DROP)
+
+        // 판매자 서명
+        .push_slice(&key.seller_pubkey.serialize())
+        .push_opcode(OP_CHECKSIG)
+        .into_script()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use bitcoin::secp256k1::rand::thread_rng;
+    use bitcoin::secp256k1::SecretKey;
+    use oracle_vm_common::types::OptionType;
+    use oracle_vm_common::Price;
+
+    fn option(expiry_block: u32, strike: i64, keys: [PublicKey; 3]) -> BitcoinOption {
+        BitcoinOption {
+            option_type: OptionType::Call,
+            strike_price: Price::from_units(strike),
+            expiry_block,
+            buyer_pubkey: keys[0],
+            seller_pubkey: keys[1],
+            verifier_pubkey: keys[2],
+            premium: 1_000_000,
+            collateral: 10_000_000,
+        }
+    }
+
+    fn keys() -> [PublicKey; 3] {
+        let mut rng = thread_rng();
+        [(); 3].map(|_| PublicKey::from_secret_key(secp(), &SecretKey::new(&mut rng)))
+    }
+
+    #[test]
+    fn test_options_share_templates_by_script_parameters() {
+        let cache = TaprootTemplateCache::new(16);
+        let keys = keys();
+
+        let first = cache.get(&option(800_000, 50_000, keys)).unwrap();
+        // 행사가만 다르면 같은 스크립트 - 다시 계산하지 않음
+        let same = cache.get(&option(800_000, 60_000, keys)).unwrap();
+        assert!(Arc::ptr_eq(&first, &same));
+
+        let later = cache.get(&option(800_144, 50_000, keys)).unwrap();
+        assert!(!Arc::ptr_eq(&first, &later));
+        assert_ne!(first.settlement_script, later.settlement_script);
+        assert_eq!(cache.len(), 2);
+    }
+
+    #[test]
+    fn test_template_commits_to_settlement_leaf() {
+        let key = TemplateKey::from(&option(800_000, 50_000, keys()));
+        let template = TaprootTemplate::build(&key).unwrap();
+
+        assert!(template.output_script.is_p2tr());
+        assert_eq!(
+            template.output_script,
+            ScriptBuf::new_p2tr_tweaked(template.spend_info.output_key())
+        );
+        assert_eq!(
+            template.settlement_leaf_hash,
+            TapLeafHash::from_script(&template.settlement_script, LeafVersion::TapScript)
+        );
+
+        // control block은 스크립트에 실제로 들어간 키(OP_1 <32바이트>)에 대해 검증되어야 한다
+        let script_key =
+            XOnlyPublicKey::from_slice(&template.output_script.as_bytes()[2..34]).unwrap();
+        assert_ne!(script_key, XOnlyPublicKey::from(key.buyer_pubkey));
+        assert!(template.settlement_control_block.verify_taproot_commitment(
+            secp(),
+            script_key,
+            &template.settlement_script,
+        ));
+    }
+
+    #[test]
+    fn test_cache_is_bounded() {
+        let cache = TaprootTemplateCache::new(2);
+        let keys = keys();
+        for expiry_block in 800_000..800_005 {
+            cache.get(&option(expiry_block, 50_000, keys)).unwrap();
+        }
+        assert!(cache.len() <= 2);
+    }
+}
@@ -1,24 +1,27 @@
 use crate::bitcoin_option::BitcoinOption;
 use oracle_vm_common::types::OptionType;
+use oracle_vm_common::Price;
 use bitcoin::{
     Network, Transaction, TxIn, TxOut, OutPoint, Sequence, Witness,
     Amount, Address, ScriptBuf, absolute::LockTime,
 };
-use bitcoin::secp256k1::{Secp256k1, SecretKey};
+use bitcoin::secp256k1::{All, Secp256k1, SecretKey};
 use bitcoin::{CompressedPublicKey, PublicKey};
 use anyhow::Result;
+use oracle_vm_common::crypto::secp;
 
 /// Bitcoin Testnet 배포 및 테스트 도구
 pub struct TestnetDeployer {
     network: Network,
-    secp: Secp256k1<bitcoin::secp256k1::All>,
+    /// 프로세스 공용 컨텍스트 (빌더마다 곱셈 테이블을 다시 만들지 않음)
+    secp: &'static Secp256k1<All>,
 }
 
 impl TestnetDeployer {
     pub fn new() -> Self {
         Self {
             network: Network::Testnet,
-            secp: Secp256k1::new(),
+            secp: secp(),
         }
     }
     
@@ -34,8 +37,8 @@ impl TestnetDeployer {
         buyer_key: &SecretKey,
         seller_key: &SecretKey,
     ) -> Result<Transaction> {
-        // Taproot 스크립트 생성
-        let (taproot_script, spend_info) = option.create_taproot_script()?;
+        // Taproot 출력 (같은 만기/키 조합이면 캐시된 템플릿)
+        let template = option.taproot_template()?;
         
         // 입력 생성
         let buyer_input = TxIn {
@@ -56,7 +59,7 @@ impl TestnetDeployer {
         // 1. 옵션 컨트랙트 출력 (프리미엄 + 담보)
         let option_output = TxOut {
             value: Amount::from_sat(option.premium + option.collateral),
-            script_pubkey: taproot_script.clone(),
+            script_pubkey: template.output_script.clone(),
         };
         
         // 2. 구매자 잔액 반환 (수수료 제외)
@@ -64,8 +67,8 @@ impl TestnetDeployer {
         let buyer_change_output = TxOut {
             value: buyer_change,
             script_pubkey: {
-                let secp_pubkey = bitcoin::secp256k1::PublicKey::from_secret_key(&self.secp, buyer_key);
-                let pubkey = PublicKey::from_private_key(&self.secp, &bitcoin::PrivateKey::new(*buyer_key, self.network));
+                let secp_pubkey = bitcoin::secp256k1::PublicKey::from_secret_key(self.secp, buyer_key);
+                let pubkey = PublicKey::from_private_key(self.secp, &bitcoin::PrivateKey::new(*buyer_key, self.network));
                 let compressed = CompressedPublicKey::try_from(pubkey).unwrap();
                 Address::p2wpkh(&compressed, self.network).script_pubkey()
             },
@@ -76,8 +79,8 @@ impl TestnetDeployer {
         let seller_change_output = TxOut {
             value: seller_change,
             script_pubkey: {
-                let secp_pubkey = bitcoin::secp256k1::PublicKey::from_secret_key(&self.secp, seller_key);
-                let pubkey = PublicKey::from_private_key(&self.secp, &bitcoin::PrivateKey::new(*seller_key, self.network));
+                let secp_pubkey = bitcoin::secp256k1::PublicKey::from_secret_key(self.secp, seller_key);
+                let pubkey = PublicKey::from_private_key(self.secp, &bitcoin::PrivateKey::new(*seller_key, self.network));
                 let compressed = CompressedPublicKey::try_from(pubkey).unwrap();
                 Address::p2wpkh(&compressed, self.network).script_pubkey()
             },
@@ -103,29 +106,14 @@ impl TestnetDeployer {
         &self,
         option: &BitcoinOption,
         option_utxo: OutPoint,
-        spot_price: u64,
+        spot_price: Price,
         oracle_proof: Vec<u8>,
         verifier_key: &SecretKey,
     ) -> Result<Transaction> {
-        let (taproot_script, spend_info) = option.create_taproot_script()?;
+        let template = option.taproot_template()?;
         
         // 정산 금액 계산
-        let settlement_amount = match option.option_type {
-            OptionType::Call => {
-                if spot_price > option.strike_price {
-                    option.collateral // ITM: 구매자가 받음
-                } else {
-                    0 // OTM: 판매자가 유지
-                }
-            }
-            OptionType::Put => {
-                if spot_price < option.strike_price {
-                    option.collateral // ITM: 구매자가 받음
-                } else {
-                    0 // OTM: 판매자가 유지
-                }
-            }
-        };
+        let settlement_amount = option.calculate_settlement(spot_price);
         
         // 입력
         let input = TxIn {
@@ -165,12 +153,12 @@ impl TestnetDeployer {
             output: vec![output],
         };
         
-        // Script path witness 구성
+        // Script path witness 구성 (control block과 정산 리프는 템플릿에 미리 계산됨)
         println!("⚠️  실제 배포시 필요:");
         println!("  1. Oracle 증명 데이터");
-        println!("  2. 검증자 서명");
-        println!("  3. Control block");
-        println!("  4. Script revelation");
+        println!("  2. 검증자 서명 (리프 해시 {})", template.settlement_leaf_hash);
+        println!("  3. Control block ({} bytes)", template.settlement_control_block.size());
+        println!("  4. Script revelation ({} bytes)", template.settlement_script.len());
         
         Ok(tx)
     }
@@ -184,8 +172,8 @@ impl TestnetDeployer {
     
     /// Taproot 주소 생성
     pub fn generate_taproot_address(&self, option: &BitcoinOption) -> Result<Address> {
-        let (script, _) = option.create_taproot_script()?;
-        Ok(Address::from_script(&script, self.network)?)
+        let template = option.taproot_template()?;
+        Ok(Address::from_script(&template.output_script, self.network)?)
     }
 }
 
@@ -211,7 +199,7 @@ mod tests {
         // 옵션 생성
         let option = BitcoinOption {
             option_type: OptionType::Call,
-            strike_price: 50_000_000_000,
+            strike_price: Price::from_units(50_000),
             expiry_block: 850_000,
             buyer_pubkey: PublicKey::from_secret_key(&secp, &buyer_key),
             seller_pubkey: PublicKey::from_secret_key(&secp, &seller_key),
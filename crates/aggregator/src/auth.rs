@@ -0,0 +1,286 @@
+//! 제출 서명 검증
+//!
+//! 모든 제출(단건/일괄)에는 노드 키의 BIP340 Schnorr 서명이 있어야 한다.
+//! 일괄 제출은 배치 전체에 서명 하나이므로 수집 주기당 노드별 검증은 한 번이다.
+//! - 신뢰 키 목록이 있으면 목록에 있는 키만, 그 키에 묶인 노드 ID로만 허용 (운영 기본값).
+//!   신뢰 키 하나로 다른 노드 ID를 사칭할 수 없다. 노드 ID 끝의 `*`는 접두사 일치
+//!   (예: 부하 생성기의 `load-generator-*`).
+//! - 없으면 노드 ID별로 처음 검증에 성공한 키를 고정 (TOFU) - 이후 다른 키의 제출은 거부.
+//!   누구나 새 노드 ID를 고정할 수 있으므로 개발용이며, 고정할 수 있는 노드 수에 상한이 있다.
+//!
+//! 검증은 요청의 노드 ID 문자열로 하고, 호출자는 검증에 성공한 뒤에만 노드 ID를 인턴한다.
+//! 서명이 없거나 틀린 요청으로는 레지스트리도 고정 키 테이블도 늘어나지 않는다.
+//!
+//! secp256k1 컨텍스트는 프로세스 전역으로 한 번만 만들고(`crypto::secp`),
+//! 파싱한 공개키는 노드별로 캐시해 요청마다 다시 파싱하지 않는다.
+
+use oracle_vm_common::crypto::{self, schnorr, XOnlyPublicKey};
+use std::collections::HashMap;
+use std::sync::RwLock;
+
+/// TOFU 모드에서 고정할 수 있는 최대 노드 수
+const MAX_PINNED_NODES: usize = 1024;
+
+/// 노드별 고정 공개키 (요청의 hex 문자열, 파싱된 키)
+type PinnedKey = (String, XOnlyPublicKey);
+
+/// 제출 서명 검증기
+#[derive(Debug, Default)]
+pub struct Authenticator {
+    /// 허용할 공개키 -> 그 키로 제출할 수 있는 노드 ID 패턴 (None이면 TOFU)
+    trusted: Option<HashMap<XOnlyPublicKey, Vec<String>>>,
+    /// 노드 ID -> 고정 키
+    pinned: RwLock<HashMap<String, PinnedKey>>,
+}
+
+impl Authenticator {
+    /// 노드별 첫 키를 고정하는 검증기
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// 목록에 있는 (노드 ID 패턴, 키) 쌍만 허용하는 검증기 - 같은 키를 여러 노드 ID에 묶을 수 있음
+    pub fn with_trusted_keys(keys: impl IntoIterator<Item = (String, XOnlyPublicKey)>) -> Self {
+        let mut trusted: HashMap<XOnlyPublicKey, Vec<String>> = HashMap::new();
+        for (node_id, key) in keys {
+            trusted.entry(key).or_default().push(node_id);
+        }
+        Self {
+            trusted: Some(trusted),
+            pinned: RwLock::new(HashMap::new()),
+        }
+    }
+
+    /// 제출 서명 검증 - 실패 시 응답 메시지로 쓸 사유 반환
+    pub fn verify(
+        &self,
+        node_id: &str,
+        public_key: Option<&str>,
+        signature: Option<&str>,
+        digest: &[u8; 32],
+    ) -> Result<(), &'static str> {
+        let public_key = public_key.ok_or("Missing public key")?;
+        let signature = signature.ok_or("Missing signature")?;
+
+        let (key, pinned) = self.resolve(node_id, public_key)?;
+        let signature: schnorr::Signature = signature
+            .parse()
+            .map_err(|_| "Invalid signature encoding")?;
+        if !crypto::verify_schnorr(digest, &signature, &key) {
+            return Err("Invalid signature");
+        }
+
+        // 서명이 검증된 뒤에만 고정 - 잘못된 제출로 다른 노드 ID를 선점할 수 없음
+        if !pinned {
+            let mut pins = self.pinned.write().unwrap();
+            if let Some((pinned_hex, _)) = pins.get(node_id) {
+                return if pinned_hex.as_str() == public_key {
+                    Ok(())
+                } else {
+                    Err("Public key does not match the key pinned for this node")
+                };
+            }
+            if pins.len() >= MAX_PINNED_NODES {
+                return Err("Too many pinned nodes");
+            }
+            pins.insert(node_id.to_string(), (public_key.to_string(), key));
+        }
+
+        Ok(())
+    }
+
+    /// 공개키 조회 - (키, 이미 고정된 키인지)
+    fn resolve(
+        &self,
+        node_id: &str,
+        public_key: &str,
+    ) -> Result<(XOnlyPublicKey, bool), &'static str> {
+        if let Some((pinned_hex, key)) = self.pinned.read().unwrap().get(node_id) {
+            return if pinned_hex.as_str() == public_key {
+                Ok((*key, true))
+            } else {
+                Err("Public key does not match the key pinned for this node")
+            };
+        }
+
+        let key: XOnlyPublicKey = public_key.parse().map_err(|_| "Invalid public key")?;
+        if let Some(trusted) = &self.trusted {
+            let patterns = trusted.get(&key).ok_or("Untrusted public key")?;
+            if !patterns
+                .iter()
+                .any(|pattern| node_id_matches(pattern, node_id))
+            {
+                return Err("Public key is not trusted for this node");
+            }
+        }
+        Ok((key, false))
+    }
+}
+
+/// 신뢰 키 항목 파싱 - `노드ID=공개키` 또는 공개키만 (노드 기본 ID `oracle-node-<앞 8자>`에 묶음)
+pub fn parse_trusted_key(entry: &str) -> Result<(String, XOnlyPublicKey), &'static str> {
+    let (node_id, public_key) = match entry.split_once('=') {
+        Some((node_id, public_key)) => (Some(node_id.trim()), public_key.trim()),
+        None => (None, entry.trim()),
+    };
+    let key: XOnlyPublicKey = public_key.parse().map_err(|_| "Invalid public key")?;
+    match node_id {
+        Some("") => Err("Empty node ID"),
+        Some(node_id) => Ok((node_id.to_string(), key)),
+        None => Ok((crypto::default_node_id(&key), key)),
+    }
+}
+
+/// 노드 ID 패턴 일치 - 끝의 `*`는 접두사 일치
+fn node_id_matches(pattern: &str, node_id: &str) -> bool {
+    match pattern.strip_suffix('*') {
+        Some(prefix) => node_id.starts_with(prefix),
+        None => pattern == node_id,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use oracle_vm_common::crypto::{generate_signing_keypair, sign_schnorr, SubmissionDigest};
+    use oracle_vm_common::Price;
+
+    fn signed(keypair: &crypto::Keypair, node_id: &str, price: i64) -> ([u8; 32], String) {
+        let mut digest = SubmissionDigest::new(node_id);
+        digest.push(
+            "BTC/USD",
+            "binance",
+            Price::from_units(price),
+            1_700_000_000,
+            None,
+        );
+        let digest = digest.finalize();
+        (digest, sign_schnorr(&digest, keypair).to_string())
+    }
+
+    #[test]
+    fn test_first_verified_key_is_pinned() {
+        let auth = Authenticator::new();
+        let node = "node-1";
+        let keypair = generate_signing_keypair();
+        let public_key = keypair.x_only_public_key().0.to_string();
+        let (digest, signature) = signed(&keypair, "node-1", 70_000);
+
+        assert_eq!(
+            auth.verify(node, Some(&public_key), None, &digest),
+            Err("Missing signature")
+        );
+        assert!(auth
+            .verify(node, Some(&public_key), Some(&signature), &digest)
+            .is_ok());
+        // 같은 서명을 다른 내용에 쓰면 거부
+        let (other_digest, _) = signed(&keypair, "node-1", 70_001);
+        assert_eq!(
+            auth.verify(node, Some(&public_key), Some(&signature), &other_digest),
+            Err("Invalid signature")
+        );
+
+        // 고정된 노드 ID로 다른 키가 제출하면 거부
+        let intruder = generate_signing_keypair();
+        let intruder_key = intruder.x_only_public_key().0.to_string();
+        let (digest, signature) = signed(&intruder, "node-1", 70_000);
+        assert_eq!(
+            auth.verify(node, Some(&intruder_key), Some(&signature), &digest),
+            Err("Public key does not match the key pinned for this node")
+        );
+        assert!(auth
+            .verify("node-2", Some(&intruder_key), Some(&signature), &digest)
+            .is_ok());
+    }
+
+    #[test]
+    fn test_rejected_submissions_pin_nothing() {
+        let auth = Authenticator::new();
+        let keypair = generate_signing_keypair();
+        let public_key = keypair.x_only_public_key().0.to_string();
+        let (digest, _) = signed(&keypair, "node-1", 70_000);
+        let (_, other_signature) = signed(&keypair, "node-1", 70_001);
+
+        assert_eq!(
+            auth.verify("node-1", Some(&public_key), Some(&other_signature), &digest),
+            Err("Invalid signature")
+        );
+        assert_eq!(
+            auth.verify("node-1", Some("not-a-key"), Some(&other_signature), &digest),
+            Err("Invalid public key")
+        );
+        assert!(auth.pinned.read().unwrap().is_empty());
+    }
+
+    #[test]
+    fn test_trusted_keys_only() {
+        let trusted = generate_signing_keypair();
+        let auth = Authenticator::with_trusted_keys([(
+            "node-1".to_string(),
+            trusted.x_only_public_key().0,
+        )]);
+
+        let (digest, signature) = signed(&trusted, "node-1", 70_000);
+        let trusted_key = trusted.x_only_public_key().0.to_string();
+        assert!(auth
+            .verify("node-1", Some(&trusted_key), Some(&signature), &digest)
+            .is_ok());
+
+        let stranger = generate_signing_keypair();
+        let (digest, signature) = signed(&stranger, "node-2", 70_000);
+        let stranger_key = stranger.x_only_public_key().0.to_string();
+        assert_eq!(
+            auth.verify("node-2", Some(&stranger_key), Some(&signature), &digest),
+            Err("Untrusted public key")
+        );
+    }
+
+    #[test]
+    fn test_trusted_key_cannot_sign_for_other_nodes() {
+        let trusted = generate_signing_keypair();
+        let trusted_key = trusted.x_only_public_key().0.to_string();
+        let auth = Authenticator::with_trusted_keys([
+            parse_trusted_key(&trusted_key).unwrap(),
+            parse_trusted_key(&format!("load-generator-*={}", trusted_key)).unwrap(),
+        ]);
+
+        // 공개키만 준 항목은 노드 기본 ID에 묶임
+        let default_id = crypto::default_node_id(&trusted.x_only_public_key().0);
+        let (digest, signature) = signed(&trusted, &default_id, 70_000);
+        assert!(auth
+            .verify(&default_id, Some(&trusted_key), Some(&signature), &digest)
+            .is_ok());
+        let (digest, signature) = signed(&trusted, "load-generator-7-3", 70_000);
+        assert!(auth
+            .verify(
+                "load-generator-7-3",
+                Some(&trusted_key),
+                Some(&signature),
+                &digest
+            )
+            .is_ok());
+
+        // 신뢰 키라도 묶이지 않은 노드 ID로는 서명할 수 없음 (고정도 하지 않음)
+        let (digest, signature) = signed(&trusted, "oracle-node-victim", 70_000);
+        assert_eq!(
+            auth.verify(
+                "oracle-node-victim",
+                Some(&trusted_key),
+                Some(&signature),
+                &digest
+            ),
+            Err("Public key is not trusted for this node")
+        );
+        assert!(!auth
+            .pinned
+            .read()
+            .unwrap()
+            .contains_key("oracle-node-victim"));
+
+        assert_eq!(
+            parse_trusted_key(&format!("={}", trusted_key)),
+            Err("Empty node ID")
+        );
+        assert_eq!(parse_trusted_key("node-1=zz"), Err("Invalid public key"));
+    }
+}
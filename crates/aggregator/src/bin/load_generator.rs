@@ -0,0 +1,328 @@
+//! Aggregator 부하 생성기
+//!
+//! 목표 QPS로 SubmitPrice와 GetAggregatedPrice를 섞어 보내고 메서드별 지연 분위수를 출력한다.
+//! 요청은 고정 간격으로 발행(open loop)하므로 서버가 느려져도 발행률이 줄지 않는다.
+//! 동시 요청이 `--max-in-flight`에 차면 그 요청은 보내지 않고 `dropped`로 센다.
+//!
+//! 가상 노드 ID에는 실행마다 다른 접미사가 붙어, 이전 실행이 고정한 키와 충돌하지 않는다.
+//! Aggregator가 `--trusted-keys`로 실행 중이면 `load-generator-*=<공개키>`로 허용한 키를
+//! `--signing-key`로 준다 (가상 노드 ID가 모두 `load-generator-`로 시작).
+//! 거부/실패 비율이 `--max-reject-percent`를 넘으면 0이 아닌 코드로 종료한다.
+//!
+//! ```bash
+//! cargo run --release -p aggregator --bin load_generator -- --qps 5000 --duration 30
+//! ```
+
+use anyhow::{Context, Result};
+use chrono::Utc;
+use clap::Parser;
+use oracle_vm_common::crypto::{self, Keypair, SubmissionDigest};
+use oracle_vm_common::Price;
+use std::sync::Arc;
+use std::time::Duration;
+use tokio::sync::{mpsc, Semaphore};
+use tokio::time::{interval, Instant, MissedTickBehavior};
+use tonic::transport::Channel;
+use tracing::info;
+
+pub mod oracle {
+    tonic::include_proto!("oracle");
+}
+
+use oracle::oracle_service_client::OracleServiceClient;
+use oracle::{FixedPrice, GetPriceRequest, PriceRequest};
+
+/// 가상 노드가 번갈아 맡는 거래소 (Aggregator 합의 대상과 같음)
+const SOURCES: [&str; 3] = ["binance", "coinbase", "kraken"];
+
+/// Aggregator 부하 생성기 CLI 인수
+#[derive(Parser)]
+#[command(name = "load_generator")]
+#[command(about = "Drive SubmitPrice/GetAggregatedPrice at a target rate and report latency")]
+struct Args {
+    /// Aggregator URL
+    #[arg(long, default_value = "http://localhost:50051")]
+    target: String,
+
+    /// 목표 요청 수 (초당)
+    #[arg(long, default_value = "1000")]
+    qps: u64,
+
+    /// 실행 시간 (초)
+    #[arg(long, default_value = "30")]
+    duration: u64,
+
+    /// GetAggregatedPrice 비율 (%, 나머지는 SubmitPrice)
+    #[arg(long, default_value = "50")]
+    read_percent: u64,
+
+    /// gRPC 연결 수 (연결마다 HTTP/2로 요청을 다중화)
+    #[arg(long, default_value = "4")]
+    connections: usize,
+
+    /// 최대 동시 요청 수
+    #[arg(long, default_value = "1024")]
+    max_in_flight: usize,
+
+    /// 가상 노드 수 (노드마다 서명 키가 다름)
+    #[arg(long, default_value = "3")]
+    nodes: usize,
+
+    /// 자산 쌍
+    #[arg(long, default_value = "BTC/USD")]
+    pair: String,
+
+    /// 모든 가상 노드가 쓸 서명 키 (secp256k1 비밀키 hex, 없으면 노드마다 새로 생성)
+    #[arg(long)]
+    signing_key: Option<String>,
+
+    /// SubmitPrice 거부/실패 비율이 이 값(%)을 넘으면 실패로 종료
+    #[arg(long, default_value = "1.0")]
+    max_reject_percent: f64,
+}
+
+#[derive(Clone, Copy)]
+enum Method {
+    Submit,
+    Get,
+}
+
+enum Outcome {
+    Ok(Duration),
+    /// 응답은 받았지만 `success: false`
+    Rejected,
+    Failed,
+}
+
+/// 서명 키를 가진 가상 오라클 노드
+struct VirtualNode {
+    node_id: String,
+    source: &'static str,
+    keypair: Keypair,
+    public_key: String,
+}
+
+impl VirtualNode {
+    /// `run`은 실행마다 다른 접미사 - TOFU 고정은 노드 ID별이라 고정 ID는 두 번째 실행부터 거부된다
+    fn new(index: usize, run: &str, keypair: Keypair) -> Self {
+        Self {
+            node_id: format!("load-generator-{}-{}", run, index),
+            source: SOURCES[index % SOURCES.len()],
+            public_key: keypair.x_only_public_key().0.to_string(),
+            keypair,
+        }
+    }
+
+    /// 서명된 가격 제출 - 가격은 $70,000 ±0.05% 안에서 요청마다 바뀐다
+    fn price_request(&self, pair: &str, sequence: u64) -> PriceRequest {
+        let price = Price::from_cents(7_000_000 + (sequence % 71) as i64 * 100 - 3_500);
+        let timestamp = Utc::now().timestamp() as u64;
+
+        let mut digest = SubmissionDigest::new(&self.node_id);
+        digest.push(pair, self.source, price, timestamp, None);
+        let signature = crypto::sign_schnorr(&digest.finalize(), &self.keypair);
+
+        PriceRequest {
+            price: Some(FixedPrice {
+                mantissa: price.mantissa(),
+                exponent: Price::EXPONENT,
+            }),
+            timestamp,
+            source: self.source.to_string(),
+            node_id: self.node_id.clone(),
+            signature: Some(signature.to_string()),
+            pair: pair.to_string(),
+            volume: None,
+            public_key: Some(self.public_key.clone()),
+        }
+    }
+}
+
+/// 메서드별 결과
+#[derive(Default)]
+struct MethodStats {
+    latencies: Vec<Duration>,
+    rejected: u64,
+    failed: u64,
+}
+
+impl MethodStats {
+    fn record(&mut self, outcome: Outcome) {
+        match outcome {
+            Outcome::Ok(latency) => self.latencies.push(latency),
+            Outcome::Rejected => self.rejected += 1,
+            Outcome::Failed => self.failed += 1,
+        }
+    }
+
+    /// 거부/실패 비율 (%)
+    fn reject_percent(&self) -> f64 {
+        let total = self.latencies.len() as u64 + self.rejected + self.failed;
+        if total == 0 {
+            return 0.0;
+        }
+        (self.rejected + self.failed) as f64 * 100.0 / total as f64
+    }
+
+    fn report(&mut self, name: &str, elapsed: Duration) {
+        self.latencies.sort_unstable();
+        let quantile = |q: f64| match self.latencies.len() {
+            0 => Duration::ZERO,
+            len => self.latencies[((len - 1) as f64 * q).round() as usize],
+        };
+        println!(
+            "{:<18} ok {:>8} ({:>7.0}/s)  rejected {:>6}  failed {:>6}  p50 {:>9.2?}  p90 {:>9.2?}  p99 {:>9.2?}  max {:>9.2?}",
+            name,
+            self.latencies.len(),
+            self.latencies.len() as f64 / elapsed.as_secs_f64(),
+            self.rejected,
+            self.failed,
+            quantile(0.5),
+            quantile(0.9),
+            quantile(0.99),
+            quantile(1.0),
+        );
+    }
+}
+
+#[tokio::main]
+async fn main() -> Result<()> {
+    let args = Args::parse();
+    tracing_subscriber::fmt::init();
+
+    let mut clients = Vec::with_capacity(args.connections.max(1));
+    for _ in 0..args.connections.max(1) {
+        let channel = Channel::from_shared(args.target.clone())?
+            .connect()
+            .await
+            .with_context(|| format!("Failed to connect to {}", args.target))?;
+        clients.push(OracleServiceClient::new(channel));
+    }
+    let signing_key = args
+        .signing_key
+        .as_deref()
+        .map(crypto::signing_keypair_from_hex)
+        .transpose()?;
+    // 실행 ID는 새 공개키 앞부분 (무작위)
+    let run = crypto::generate_signing_keypair()
+        .x_only_public_key()
+        .0
+        .to_string()[..8]
+        .to_string();
+    let nodes: Arc<[VirtualNode]> = (0..args.nodes.max(1))
+        .map(|index| {
+            let keypair = signing_key.unwrap_or_else(crypto::generate_signing_keypair);
+            VirtualNode::new(index, &run, keypair)
+        })
+        .collect();
+    let pair: Arc<str> = Arc::from(args.pair.as_str());
+
+    info!(
+        "🔥 Driving {} at {} req/s for {}s ({}% reads, {} connections, {} nodes, run {})",
+        args.target,
+        args.qps,
+        args.duration,
+        args.read_percent,
+        clients.len(),
+        nodes.len(),
+        run
+    );
+
+    let (results_tx, mut results_rx) = mpsc::unbounded_channel::<(Method, Outcome)>();
+    let collector = tokio::spawn(async move {
+        let mut submit = MethodStats::default();
+        let mut get = MethodStats::default();
+        while let Some((method, outcome)) = results_rx.recv().await {
+            match method {
+                Method::Submit => submit.record(outcome),
+                Method::Get => get.record(outcome),
+            }
+        }
+        (submit, get)
+    });
+
+    // 타이머 해상도(1ms)보다 짧은 간격은 Burst로 밀린 tick을 몰아 발행해 평균 발행률을 맞춘다
+    let mut ticker = interval(Duration::from_secs_f64(1.0 / args.qps.max(1) as f64));
+    ticker.set_missed_tick_behavior(MissedTickBehavior::Burst);
+    let in_flight = Arc::new(Semaphore::new(args.max_in_flight.max(1)));
+    let started = Instant::now();
+    let end = started + Duration::from_secs(args.duration);
+    let mut sequence = 0u64;
+    let mut dropped = 0u64;
+
+    while ticker.tick().await < end {
+        sequence += 1;
+        let Ok(permit) = in_flight.clone().try_acquire_owned() else {
+            dropped += 1;
+            continue;
+        };
+
+        let mut client = clients[sequence as usize % clients.len()].clone();
+        let results = results_tx.clone();
+        let method = if sequence % 100 < args.read_percent {
+            Method::Get
+        } else {
+            Method::Submit
+        };
+        // 서명은 발행 루프에서 - 요청 태스크는 네트워크 대기만 측정
+        let submission = match method {
+            Method::Submit => {
+                Some(nodes[sequence as usize % nodes.len()].price_request(&pair, sequence))
+            }
+            Method::Get => None,
+        };
+        let pair = Arc::clone(&pair);
+
+        tokio::spawn(async move {
+            let sent = Instant::now();
+            let outcome = match submission {
+                Some(request) => match client.submit_price(request).await {
+                    Ok(response) if response.get_ref().success => Outcome::Ok(sent.elapsed()),
+                    Ok(_) => Outcome::Rejected,
+                    Err(_) => Outcome::Failed,
+                },
+                None => {
+                    let request = GetPriceRequest {
+                        source_filter: None,
+                        pair: Some(pair.to_string()),
+                    };
+                    match client.get_aggregated_price(request).await {
+                        Ok(response) if response.get_ref().success => Outcome::Ok(sent.elapsed()),
+                        Ok(_) => Outcome::Rejected,
+                        Err(_) => Outcome::Failed,
+                    }
+                }
+            };
+            let _ = results.send((method, outcome));
+            drop(permit);
+        });
+    }
+    let issued = Instant::now() - started;
+
+    // 진행 중인 요청이 모두 끝나면 수집기가 종료된다
+    drop(results_tx);
+    let (mut submit, mut get) = collector.await?;
+
+    println!(
+        "Issued {} requests in {:.1}s ({:.0}/s, target {}/s), dropped {} at max in-flight",
+        sequence - dropped,
+        issued.as_secs_f64(),
+        (sequence - dropped) as f64 / issued.as_secs_f64(),
+        args.qps,
+        dropped
+    );
+    submit.report("SubmitPrice", issued);
+    get.report("GetAggregatedPrice", issued);
+
+    // 제출이 대부분 거부되면 지연 수치는 의미가 없으므로 조용히 성공으로 끝내지 않음
+    let reject_percent = submit.reject_percent();
+    if reject_percent > args.max_reject_percent {
+        anyhow::bail!(
+            "{:.1}% of SubmitPrice requests were rejected or failed (limit {}%) - check the aggregator log and --trusted-keys/--allow-tofu",
+            reject_percent,
+            args.max_reject_percent
+        );
+    }
+
+    Ok(())
+}
@@ -0,0 +1,263 @@
+//! 집계기 클러스터 (libp2p gossipsub)
+//!
+//! 인스턴스마다 오라클 노드에게 직접 받은 제출을 노드 서명 그대로 가십하고, 피어에게 받은
+//! 제출은 같은 서명 검증을 거쳐 로컬 합의에 반영한다 (다시 가십하지 않음 - 전파는 gossipsub 몫).
+//! 합의는 인스턴스마다 독립적으로 계산하므로 노드는 가장 가까운 인스턴스 하나에만 제출하면 되고,
+//! 수집/조회 용량은 인스턴스를 추가하는 만큼 늘어난다.
+//!
+//! - 전송: TCP + Noise + Yamux (DNS 이름 지원)
+//! - 메시지: 노드가 서명한 `PriceBatchRequest` (단건 제출은 1개짜리 배치 - 서명 다이제스트가 같다)
+//! - 메시지 ID: 내용 해시 - 같은 제출이 여러 경로로 와도 한 번만 전달
+
+use crate::oracle::PriceBatchRequest;
+use anyhow::{anyhow, Context, Result};
+use futures::StreamExt;
+use libp2p::gossipsub::{self, IdentTopic, MessageAuthenticity, MessageId, ValidationMode};
+use libp2p::multiaddr::Protocol;
+use libp2p::swarm::{NetworkBehaviour, SwarmEvent};
+use libp2p::{connection_limits, noise, tcp, yamux, Multiaddr, Swarm, SwarmBuilder};
+use oracle_vm_common::config::NetworkConfig;
+use oracle_vm_common::crypto;
+use prost::Message;
+use std::error::Error;
+use std::net::IpAddr;
+use std::time::Duration;
+use tokio::sync::mpsc;
+use tokio::time::{interval, MissedTickBehavior};
+use tracing::{info, warn};
+
+/// 가격 관측값 토픽
+const OBSERVATIONS_TOPIC: &str = "oracle-vm/observations/1";
+/// 가십 메시지 최대 크기 (배치 하나)
+const MAX_MESSAGE_BYTES: usize = 1 << 20;
+/// 송신/수신 대기열 크기 (가득 차면 버린다 - 수집 경로와 스웜을 막지 않음)
+const QUEUE_CAPACITY: usize = 1024;
+/// gossipsub 메시 관리 주기
+const HEARTBEAT_INTERVAL: Duration = Duration::from_secs(1);
+/// 연결된 피어가 없을 때 부트스트랩 피어 재연결 간격
+const REDIAL_INTERVAL: Duration = Duration::from_secs(30);
+
+#[derive(NetworkBehaviour)]
+struct ClusterBehaviour {
+    gossipsub: gossipsub::Behaviour,
+    limits: connection_limits::Behaviour,
+}
+
+/// 로컬 제출을 클러스터로 내보내는 핸들 (복제 비용이 작다)
+#[derive(Clone)]
+pub struct ClusterHandle {
+    outbound: mpsc::Sender<Vec<u8>>,
+}
+
+impl ClusterHandle {
+    /// 노드가 서명한 배치를 가십 (네트워크 대기 없음)
+    pub fn publish(&self, batch: &PriceBatchRequest) {
+        if let Err(e) = self.outbound.try_send(batch.encode_to_vec()) {
+            warn!("⚠️ Dropped cluster gossip for {}: {}", batch.node_id, e);
+        }
+    }
+}
+
+/// 클러스터 참여 - 피어에게 받은 배치는 반환되는 수신기로 전달된다
+///
+/// `listen_address`와 `bootstrap_peers`는 multiaddr 또는 `host:port` 형식.
+pub fn join(config: &NetworkConfig) -> Result<(ClusterHandle, mpsc::Receiver<PriceBatchRequest>)> {
+    let listen = to_multiaddr(&config.listen_address)?;
+    let peers = config
+        .bootstrap_peers
+        .iter()
+        .map(|peer| to_multiaddr(peer))
+        .collect::<Result<Vec<_>>>()?;
+    let topic = IdentTopic::new(OBSERVATIONS_TOPIC);
+    let max_peers = config.max_peers as u32;
+
+    let mut swarm = SwarmBuilder::with_new_identity()
+        .with_tokio()
+        .with_tcp(
+            tcp::Config::default().nodelay(true),
+            noise::Config::new,
+            yamux::Config::default,
+        )?
+        .with_dns()?
+        .with_behaviour(|key| -> Result<_, Box<dyn Error + Send + Sync>> {
+            let gossipsub_config = gossipsub::ConfigBuilder::default()
+                .heartbeat_interval(HEARTBEAT_INTERVAL)
+                .validation_mode(ValidationMode::Strict)
+                .max_transmit_size(MAX_MESSAGE_BYTES)
+                .message_id_fn(|message| MessageId::from(crypto::sha256(&message.data).to_vec()))
+                .build()?;
+            Ok(ClusterBehaviour {
+                gossipsub: gossipsub::Behaviour::new(
+                    MessageAuthenticity::Signed(key.clone()),
+                    gossipsub_config,
+                )?,
+                limits: connection_limits::Behaviour::new(
+                    connection_limits::ConnectionLimits::default()
+                        .with_max_established(Some(max_peers)),
+                ),
+            })
+        })?
+        .with_swarm_config(|swarm| swarm.with_idle_connection_timeout(config.connection_timeout))
+        .build();
+
+    swarm
+        .behaviour_mut()
+        .gossipsub
+        .subscribe(&topic)
+        .map_err(|e| anyhow!("Failed to subscribe to {}: {:?}", OBSERVATIONS_TOPIC, e))?;
+    swarm
+        .listen_on(listen.clone())
+        .with_context(|| format!("Failed to listen on {}", listen))?;
+    dial_all(&mut swarm, &peers);
+
+    info!(
+        "🛰️ Joining aggregator cluster as {} ({} bootstrap peers)",
+        swarm.local_peer_id(),
+        peers.len()
+    );
+
+    let (outbound_tx, outbound_rx) = mpsc::channel(QUEUE_CAPACITY);
+    let (inbound_tx, inbound_rx) = mpsc::channel(QUEUE_CAPACITY);
+    tokio::spawn(run(swarm, topic, peers, outbound_rx, inbound_tx));
+
+    Ok((
+        ClusterHandle {
+            outbound: outbound_tx,
+        },
+        inbound_rx,
+    ))
+}
+
+/// 스웜 이벤트 루프 - 핸들이 모두 사라지면 종료
+async fn run(
+    mut swarm: Swarm<ClusterBehaviour>,
+    topic: IdentTopic,
+    peers: Vec<Multiaddr>,
+    mut outbound: mpsc::Receiver<Vec<u8>>,
+    inbound: mpsc::Sender<PriceBatchRequest>,
+) {
+    let mut redial = interval(REDIAL_INTERVAL);
+    redial.set_missed_tick_behavior(MissedTickBehavior::Delay);
+
+    loop {
+        tokio::select! {
+            message = outbound.recv() => {
+                let Some(message) = message else {
+                    break;
+                };
+                match swarm.behaviour_mut().gossipsub.publish(topic.clone(), message) {
+                    // 피어가 없는 구간이나 같은 제출의 재전송은 조용히 넘어간다
+                    Ok(_)
+                    | Err(gossipsub::PublishError::InsufficientPeers)
+                    | Err(gossipsub::PublishError::Duplicate) => {}
+                    Err(e) => warn!("⚠️ Failed to gossip observations: {}", e),
+                }
+            }
+            event = swarm.select_next_some() => match event {
+                SwarmEvent::Behaviour(ClusterBehaviourEvent::Gossipsub(
+                    gossipsub::Event::Message {
+                        propagation_source,
+                        message,
+                        ..
+                    },
+                )) => match PriceBatchRequest::decode(message.data.as_slice()) {
+                    Ok(batch) => {
+                        if inbound.try_send(batch).is_err() {
+                            warn!(
+                                "⚠️ Cluster inbound queue full, dropped batch from {}",
+                                propagation_source
+                            );
+                        }
+                    }
+                    Err(e) => warn!("⚠️ Invalid gossip from {}: {}", propagation_source, e),
+                },
+                SwarmEvent::NewListenAddr { address, .. } => {
+                    info!(
+                        "🛰️ Cluster listening on {}/p2p/{}",
+                        address,
+                        swarm.local_peer_id()
+                    );
+                }
+                SwarmEvent::ConnectionEstablished { peer_id, endpoint, .. } => {
+                    info!(
+                        "🤝 Cluster peer connected: {} ({})",
+                        peer_id,
+                        endpoint.get_remote_address()
+                    );
+                }
+                SwarmEvent::ConnectionClosed { peer_id, cause, .. } => {
+                    warn!("🔌 Cluster peer disconnected: {} ({:?})", peer_id, cause);
+                }
+                SwarmEvent::OutgoingConnectionError { peer_id, error, .. } => {
+                    warn!("⚠️ Failed to connect to cluster peer {:?}: {}", peer_id, error);
+                }
+                _ => {}
+            },
+            _ = redial.tick() => {
+                if swarm.connected_peers().next().is_none() {
+                    dial_all(&mut swarm, &peers);
+                }
+            }
+        }
+    }
+
+    info!("🛰️ Cluster gossip stopped");
+}
+
+fn dial_all(swarm: &mut Swarm<ClusterBehaviour>, peers: &[Multiaddr]) {
+    for peer in peers {
+        if let Err(e) = swarm.dial(peer.clone()) {
+            warn!("⚠️ Failed to dial cluster peer {}: {}", peer, e);
+        }
+    }
+}
+
+/// multiaddr 또는 `host:port`(IP 또는 DNS 이름)를 multiaddr로 변환
+fn to_multiaddr(address: &str) -> Result<Multiaddr> {
+    if address.starts_with('/') {
+        return address
+            .parse()
+            .with_context(|| format!("Invalid cluster multiaddr {}", address));
+    }
+
+    let (host, port) = address
+        .rsplit_once(':')
+        .ok_or_else(|| anyhow!("Cluster address {} must be host:port", address))?;
+    let port: u16 = port
+        .parse()
+        .with_context(|| format!("Invalid port in cluster address {}", address))?;
+    let host = host.trim_start_matches('[').trim_end_matches(']');
+    let multiaddr = match host.parse::<IpAddr>() {
+        Ok(ip) => Multiaddr::from(ip),
+        Err(_) if !host.is_empty() => Multiaddr::empty().with(Protocol::Dns(host.into())),
+        Err(_) => return Err(anyhow!("Missing host in cluster address {}", address)),
+    };
+    Ok(multiaddr.with(Protocol::Tcp(port)))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_cluster_addresses() {
+        assert_eq!(
+            to_multiaddr("0.0.0.0:9000").unwrap().to_string(),
+            "/ip4/0.0.0.0/tcp/9000"
+        );
+        assert_eq!(
+            to_multiaddr("[::1]:9000").unwrap().to_string(),
+            "/ip6/::1/tcp/9000"
+        );
+        assert_eq!(
+            to_multiaddr("aggregator-2:9000").unwrap().to_string(),
+            "/dns/aggregator-2/tcp/9000"
+        );
+        assert_eq!(
+            to_multiaddr("/ip4/10.0.0.2/tcp/9000").unwrap().to_string(),
+            "/ip4/10.0.0.2/tcp/9000"
+        );
+        assert!(to_multiaddr("aggregator-2").is_err());
+        assert!(to_multiaddr(":9000").is_err());
+    }
+}
@@ -0,0 +1,856 @@
+//! 가격 이력 영구 저장소 (RocksDB)
+//!
+//! 메모리 링 버퍼(`store` 모듈)는 거래소별 최근 데이터만 보관하고, 전체 이력은 여기에
+//! 추가 전용으로 기록한다. 재시작 시 최근 구간을 읽어 메모리 상태를 복원하며,
+//! 정산 감사용 구간 조회(GetPriceHistory)도 이 저장소에서 처리한다.
+//!
+//! 쓰기는 [`HistoryWriter`]의 전용 스레드가 맡는다. 수집 경로는 큐에 넣기만 하고,
+//! 쓰는 중인 청크는 닫힐 때(가득 참, 파티션 변경) 또는 [`FLUSH_INTERVAL`]마다 저장된다.
+//! 따라서 구간 조회와 비정상 종료 시 복원에는 최근 `FLUSH_INTERVAL` 이내 데이터가 빠질 수 있다.
+//!
+//! 키: `자산 쌍 | 0x00 | 파티션 시작 시각(u64 BE) | 거래소 | 0x00 | 청크 첫 시각(u64 BE)`
+//! - 시간 파티션이 거래소보다 앞에 있어 구간 조회는 연속된 키 범위 하나만 읽는다.
+//! - 청크의 모든 데이터는 키의 파티션에 속한다 (파티션이 바뀌면 새 청크).
+//!
+//! 값: 거래소 하나의 청크 (최대 `CHUNK_POINTS`개)를 열 단위로 인코딩
+//! - 타임스탬프: 첫 값 + delta-of-delta (zigzag varint) - 일정 간격 수집이면 대부분 1바이트
+//! - 수신 시각: 타임스탬프와의 차이
+//! - 가격: 고정소수점 가격을 청크 공통 10^k로 나눈 값, 직전 값과의 차이 (센트 단위 가격이면 k = 6)
+//! - 노드: 청크 내 노드 이름 사전의 인덱스
+//! - 거래량: 거래량이 있는 데이터 수, 있으면 데이터마다 유무 바이트 + f64 (VWAP 복원용)
+
+use crate::metrics;
+use crate::registry::{PairState, Registry, Symbols};
+use crate::store::StoredPriceData;
+use anyhow::{anyhow, bail, Context, Result};
+use oracle_vm_common::config::DatabaseConfig;
+use oracle_vm_common::intern::{PairId, SourceId};
+use oracle_vm_common::Price;
+use rocksdb::{
+    BlockBasedOptions, Cache, DBCompressionType, Direction, IteratorMode, Options, WriteBatch, DB,
+};
+use std::collections::hash_map::Entry;
+use std::collections::HashMap;
+use std::sync::mpsc::{self, RecvTimeoutError, SyncSender, TrySendError};
+use std::sync::{Arc, Mutex};
+use std::time::{Duration, Instant};
+use tracing::warn;
+
+/// 시간 파티션 크기 (초)
+pub const PARTITION_SECS: u64 = 3600;
+/// 청크 하나의 최대 데이터 수 (가득 차면 새 청크)
+const CHUNK_POINTS: usize = 128;
+/// 청크 인코딩 버전 (1: 가격을 센트로 저장, 2: 고정소수점 가격 + 청크 공통 자릿수, 3: 거래량 열 추가)
+const CHUNK_VERSION: u8 = 3;
+/// 버전 1 청크의 가격 자릿수 (센트 = 10^6 가격 단위)
+const CENTS_DIGITS: u8 = 6;
+/// 키 내 가변 길이 필드 구분자
+const KEY_SEPARATOR: u8 = 0;
+/// 쓰는 중인 청크 저장 주기
+pub const FLUSH_INTERVAL: Duration = Duration::from_secs(1);
+/// 쓰기 큐 용량 (제출 묶음 단위) - 가득 차면 수집 경로를 막지 않고 버림
+const WRITER_QUEUE_CAPACITY: usize = 4096;
+
+/// 조회/복원된 가격 데이터
+#[derive(Debug, Clone, PartialEq)]
+pub struct HistoryRecord {
+    pub price: Price,
+    pub timestamp: u64,
+    pub received_at: u64,
+    pub source: String,
+    pub node: String,
+    pub volume: Option<f64>,
+}
+
+/// 구간 조회 결과 (시간순)
+#[derive(Debug, Default)]
+pub struct HistoryRange {
+    pub records: Vec<HistoryRecord>,
+    /// 조회 한도를 넘어 뒤쪽 데이터가 잘렸는지
+    pub truncated: bool,
+}
+
+/// 거래소 하나의 데이터 청크 (열 단위)
+#[derive(Debug, Default, Clone, PartialEq)]
+struct Chunk {
+    timestamps: Vec<u64>,
+    received_at: Vec<u64>,
+    prices: Vec<Price>,
+    /// `node_names` 인덱스
+    nodes: Vec<u32>,
+    node_names: Vec<String>,
+    volumes: Vec<Option<f64>>,
+}
+
+impl Chunk {
+    fn len(&self) -> usize {
+        self.timestamps.len()
+    }
+
+    fn push(
+        &mut self,
+        timestamp: u64,
+        received_at: u64,
+        price: Price,
+        node: &str,
+        volume: Option<f64>,
+    ) {
+        let node = match self.node_names.iter().position(|name| name == node) {
+            Some(index) => index,
+            None => {
+                self.node_names.push(node.to_string());
+                self.node_names.len() - 1
+            }
+        };
+
+        self.timestamps.push(timestamp);
+        self.received_at.push(received_at);
+        self.prices.push(price);
+        self.nodes.push(node as u32);
+        self.volumes.push(volume);
+    }
+
+    fn encode(&self) -> Vec<u8> {
+        let mut out = Vec::with_capacity(16 + self.len() * 4);
+        out.push(CHUNK_VERSION);
+        write_varint(&mut out, self.len() as u64);
+        write_varint(&mut out, self.node_names.len() as u64);
+        for name in &self.node_names {
+            write_varint(&mut out, name.len() as u64);
+            out.extend_from_slice(name.as_bytes());
+        }
+
+        let mut prev_timestamp = 0u64;
+        let mut prev_delta = 0i64;
+        for (index, &timestamp) in self.timestamps.iter().enumerate() {
+            if index == 0 {
+                write_varint(&mut out, timestamp);
+            } else {
+                let delta = timestamp.wrapping_sub(prev_timestamp) as i64;
+                write_varint(&mut out, zigzag(delta.wrapping_sub(prev_delta)));
+                prev_delta = delta;
+            }
+            prev_timestamp = timestamp;
+        }
+        for (&received_at, &timestamp) in self.received_at.iter().zip(&self.timestamps) {
+            write_varint(&mut out, zigzag(received_at.wrapping_sub(timestamp) as i64));
+        }
+        // 모든 가격이 나누어떨어지는 가장 큰 10^k로 나눠 차이를 작게 유지
+        let digits = common_digits(&self.prices);
+        out.push(digits);
+        let unit = 10i64.pow(digits as u32);
+        let mut prev_units = 0i64;
+        for price in &self.prices {
+            let units = price.mantissa() / unit;
+            write_varint(&mut out, zigzag(units.wrapping_sub(prev_units)));
+            prev_units = units;
+        }
+        for &node in &self.nodes {
+            write_varint(&mut out, node as u64);
+        }
+        // 거래량을 보고하지 않는 거래소의 청크는 0 하나만 기록
+        let with_volume = self
+            .volumes
+            .iter()
+            .filter(|volume| volume.is_some())
+            .count();
+        write_varint(&mut out, with_volume as u64);
+        if with_volume > 0 {
+            for volume in &self.volumes {
+                match volume {
+                    Some(volume) => {
+                        out.push(1);
+                        out.extend_from_slice(&volume.to_le_bytes());
+                    }
+                    None => out.push(0),
+                }
+            }
+        }
+
+        out
+    }
+
+    fn decode(bytes: &[u8]) -> Result<Self> {
+        let mut reader = Reader { bytes, offset: 0 };
+        let version = reader.byte()?;
+        if version == 0 || version > CHUNK_VERSION {
+            bail!("Unsupported price chunk version: {}", version);
+        }
+        let len = reader.varint()? as usize;
+        let node_count = reader.varint()? as usize;
+        let mut node_names = Vec::with_capacity(node_count.min(len));
+        for _ in 0..node_count {
+            let name_len = reader.varint()? as usize;
+            let name = std::str::from_utf8(reader.take(name_len)?)
+                .map_err(|e| anyhow!("Invalid node name in price chunk: {}", e))?;
+            node_names.push(name.to_string());
+        }
+
+        let mut timestamps = Vec::with_capacity(len);
+        let mut prev_delta = 0i64;
+        for index in 0..len {
+            if index == 0 {
+                timestamps.push(reader.varint()?);
+            } else {
+                let delta = prev_delta.wrapping_add(unzigzag(reader.varint()?));
+                timestamps.push(timestamps[index - 1].wrapping_add(delta as u64));
+                prev_delta = delta;
+            }
+        }
+        let mut received_at = Vec::with_capacity(len);
+        for &timestamp in &timestamps {
+            received_at.push(timestamp.wrapping_add(unzigzag(reader.varint()?) as u64));
+        }
+        let digits = match version {
+            1 => CENTS_DIGITS,
+            _ => reader.byte()?,
+        };
+        if digits as u32 > Price::DECIMALS {
+            bail!("Invalid price chunk digits: {}", digits);
+        }
+        let unit = 10i64.pow(digits as u32);
+        let mut prices = Vec::with_capacity(len);
+        let mut prev_units = 0i64;
+        for _ in 0..len {
+            prev_units = prev_units.wrapping_add(unzigzag(reader.varint()?));
+            let mantissa = prev_units
+                .checked_mul(unit)
+                .ok_or_else(|| anyhow!("Price chunk value out of range"))?;
+            prices.push(Price::from_mantissa(mantissa));
+        }
+        let mut nodes = Vec::with_capacity(len);
+        for _ in 0..len {
+            let node = reader.varint()?;
+            if node as usize >= node_names.len() {
+                bail!("Price chunk node index {} out of range", node);
+            }
+            nodes.push(node as u32);
+        }
+        // 버전 3 이전 청크에는 거래량이 없음
+        let mut volumes = vec![None; len];
+        if version >= 3 && reader.varint()? > 0 {
+            for volume in &mut volumes {
+                if reader.byte()? != 0 {
+                    let bytes: [u8; 8] = reader.take(8)?.try_into().unwrap();
+                    *volume = Some(f64::from_le_bytes(bytes));
+                }
+            }
+        }
+
+        Ok(Self {
+            timestamps,
+            received_at,
+            prices,
+            nodes,
+            node_names,
+            volumes,
+        })
+    }
+}
+
+/// 쓰는 중인 청크 - 닫힐 때와 [`PriceHistoryDb::flush`] 때 같은 키에 다시 기록
+struct OpenChunk {
+    key: Vec<u8>,
+    partition: u64,
+    chunk: Chunk,
+    /// 마지막 저장 이후 추가된 데이터가 있는지
+    dirty: bool,
+}
+
+/// RocksDB 가격 이력 저장소
+pub struct PriceHistoryDb {
+    db: DB,
+    /// (자산 쌍, 거래소)별 쓰는 중인 청크
+    ///
+    /// 같은 키를 덮어쓰는 순서가 뒤바뀌지 않도록 RocksDB 쓰기도 이 락 안에서 수행한다.
+    /// 운영 중 쓰기는 [`HistoryWriter`] 스레드 하나가 하므로 수집 경로와 경합하지 않는다.
+    open: Mutex<HashMap<(PairId, SourceId), OpenChunk>>,
+}
+
+impl PriceHistoryDb {
+    /// `config.path`에 저장소 열기 (없으면 생성)
+    pub fn open(config: &DatabaseConfig) -> Result<Self> {
+        let cache = Cache::new_lru_cache(config.cache_size);
+        let mut table = BlockBasedOptions::default();
+        table.set_block_cache(&cache);
+
+        let mut options = Options::default();
+        options.create_if_missing(true);
+        options.set_write_buffer_size(config.write_buffer_size);
+        options.set_block_based_table_factory(&table);
+        options.set_compression_type(DBCompressionType::Lz4);
+
+        let db = DB::open(&options, &config.path)
+            .map_err(|e| anyhow!("Failed to open price history at {}: {}", config.path, e))?;
+
+        Ok(Self {
+            db,
+            open: Mutex::new(HashMap::new()),
+        })
+    }
+
+    /// 검증된 가격 기록 - 거래소별 쓰는 중인 청크에 추가하고, 닫히는 청크만 바로 저장
+    pub fn append(
+        &self,
+        pair: PairId,
+        pair_name: &str,
+        prices: &[StoredPriceData],
+        symbols: &Symbols,
+    ) -> Result<()> {
+        let mut open = self.open.lock().unwrap();
+
+        for data in prices {
+            let partition = partition_of(data.timestamp);
+            let source = symbols.source(data.source);
+            let slot = match open.entry((pair, data.source)) {
+                Entry::Occupied(entry) => {
+                    let slot = entry.into_mut();
+                    if slot.partition != partition || slot.chunk.len() >= CHUNK_POINTS {
+                        let key = chunk_key(pair_name, partition, source, data.timestamp);
+                        // 같은 시각으로 다시 시작하는 경우는 현재 청크에 이어서 기록
+                        if key != slot.key {
+                            // 닫는 청크는 바로 저장해 이후 같은 키 조회가 최신 내용을 보도록 함
+                            if slot.dirty {
+                                self.db.put(&slot.key, slot.chunk.encode())?;
+                            }
+                            *slot = self.open_chunk(key, partition)?;
+                        }
+                    }
+                    slot
+                }
+                Entry::Vacant(entry) => {
+                    let key = chunk_key(pair_name, partition, source, data.timestamp);
+                    entry.insert(self.open_chunk(key, partition)?)
+                }
+            };
+
+            slot.chunk.push(
+                data.timestamp,
+                data.received_at,
+                data.price,
+                symbols.node(data.node),
+                data.volume,
+            );
+            slot.dirty = true;
+        }
+
+        Ok(())
+    }
+
+    /// 마지막 저장 이후 데이터가 추가된 청크를 한 번의 WriteBatch로 저장
+    pub fn flush(&self) -> Result<()> {
+        let mut open = self.open.lock().unwrap();
+        let mut batch = WriteBatch::default();
+        for slot in open.values().filter(|slot| slot.dirty) {
+            batch.put(&slot.key, slot.chunk.encode());
+        }
+        if batch.is_empty() {
+            return Ok(());
+        }
+
+        self.db.write(batch)?;
+        for slot in open.values_mut() {
+            slot.dirty = false;
+        }
+        Ok(())
+    }
+
+    /// 새 청크 - 같은 키의 청크가 이미 있으면 (재시작 직후, 늦게 도착한 데이터) 이어서 기록
+    fn open_chunk(&self, key: Vec<u8>, partition: u64) -> Result<OpenChunk> {
+        let chunk = match self.db.get(&key)? {
+            Some(bytes) => Chunk::decode(&bytes)?,
+            None => Chunk::default(),
+        };
+        Ok(OpenChunk {
+            key,
+            partition,
+            chunk,
+            dirty: false,
+        })
+    }
+
+    /// `[from, to]` 구간 조회 (시간순, 최대 `limit`개)
+    ///
+    /// `source`가 없으면 모든 거래소. 파티션 단위로 읽으므로 한도를 채운 뒤에도
+    /// 현재 파티션까지는 읽고 정렬해, 늦게 도착한 데이터가 있어도 앞쪽 `limit`개를 돌려준다.
+    pub fn range(
+        &self,
+        pair: &str,
+        source: Option<&str>,
+        from: u64,
+        to: u64,
+        limit: usize,
+    ) -> Result<HistoryRange> {
+        let pair_prefix = pair_prefix(pair);
+        let mut start = pair_prefix.clone();
+        start.extend_from_slice(&partition_of(from).to_be_bytes());
+        let last_partition = partition_of(to);
+
+        let mut records = Vec::new();
+        let mut current_partition = None;
+        for item in self
+            .db
+            .iterator(IteratorMode::From(&start, Direction::Forward))
+        {
+            let (key, value) = item?;
+            let Some((partition, chunk_source)) = parse_key(&key, &pair_prefix) else {
+                break;
+            };
+            if partition > last_partition {
+                break;
+            }
+            if current_partition != Some(partition) {
+                if records.len() > limit {
+                    break;
+                }
+                current_partition = Some(partition);
+            }
+            if source.is_some_and(|source| source != chunk_source) {
+                continue;
+            }
+
+            let chunk = Chunk::decode(&value)?;
+            for index in 0..chunk.len() {
+                let timestamp = chunk.timestamps[index];
+                if timestamp < from || timestamp > to {
+                    continue;
+                }
+                records.push(HistoryRecord {
+                    price: chunk.prices[index],
+                    timestamp,
+                    received_at: chunk.received_at[index],
+                    source: chunk_source.to_string(),
+                    node: chunk.node_names[chunk.nodes[index] as usize].clone(),
+                    volume: chunk.volumes[index],
+                });
+            }
+        }
+
+        records.sort_by_key(|record| record.timestamp);
+        let truncated = records.len() > limit;
+        records.truncate(limit);
+
+        Ok(HistoryRange { records, truncated })
+    }
+
+    /// 저장된 자산 쌍 목록 - 자산 쌍마다 키 하나만 읽고 다음 자산 쌍으로 건너뜀
+    pub fn pairs(&self) -> Result<Vec<String>> {
+        let mut pairs = Vec::new();
+        let mut seek = Vec::new();
+        loop {
+            let Some(item) = self
+                .db
+                .iterator(IteratorMode::From(&seek, Direction::Forward))
+                .next()
+            else {
+                break;
+            };
+            let (key, _) = item?;
+            let Some(end) = key.iter().position(|&byte| byte == KEY_SEPARATOR) else {
+                break;
+            };
+            pairs.push(String::from_utf8_lossy(&key[..end]).into_owned());
+
+            // `자산 쌍 | 0x01`은 이 자산 쌍의 모든 키보다 크다
+            seek = key[..end].to_vec();
+            seek.push(KEY_SEPARATOR + 1);
+        }
+
+        Ok(pairs)
+    }
+}
+
+impl Drop for PriceHistoryDb {
+    fn drop(&mut self) {
+        if let Err(e) = self.flush() {
+            warn!("❌ Failed to flush price history on close: {}", e);
+        }
+    }
+}
+
+/// 쓰기 스레드로 보낼 제출 묶음 (자산 쌍 하나)
+struct WriteJob {
+    pair: PairId,
+    pair_name: Arc<str>,
+    prices: Vec<StoredPriceData>,
+}
+
+/// 가격 이력 쓰기 큐 - RocksDB 쓰기는 전용 스레드에서 순서대로 처리
+#[derive(Clone)]
+pub struct HistoryWriter {
+    queue: SyncSender<WriteJob>,
+}
+
+impl HistoryWriter {
+    /// 쓰기 스레드 시작 - 모든 핸들이 사라지면 남은 청크를 저장하고 종료
+    pub fn spawn(db: Arc<PriceHistoryDb>, registry: Arc<Registry>) -> Result<Self> {
+        let (queue, jobs) = mpsc::sync_channel(WRITER_QUEUE_CAPACITY);
+        std::thread::Builder::new()
+            .name("price-history-writer".into())
+            .spawn(move || {
+                let mut last_flush = Instant::now();
+                loop {
+                    let wait = FLUSH_INTERVAL.saturating_sub(last_flush.elapsed());
+                    match jobs.recv_timeout(wait) {
+                        Ok(WriteJob {
+                            pair,
+                            pair_name,
+                            prices,
+                        }) => {
+                            if let Err(e) =
+                                db.append(pair, &pair_name, &prices, &registry.symbols())
+                            {
+                                warn!("❌ Failed to persist {} prices: {}", pair_name, e);
+                            }
+                        }
+                        Err(RecvTimeoutError::Timeout) => {}
+                        Err(RecvTimeoutError::Disconnected) => break,
+                    }
+                    if last_flush.elapsed() >= FLUSH_INTERVAL {
+                        if let Err(e) = db.flush() {
+                            warn!("❌ Failed to flush price history: {}", e);
+                        }
+                        last_flush = Instant::now();
+                    }
+                }
+                if let Err(e) = db.flush() {
+                    warn!("❌ Failed to flush price history: {}", e);
+                }
+            })
+            .context("Failed to start price history writer")?;
+
+        Ok(Self { queue })
+    }
+
+    /// 쓰기 큐에 추가 - 막히지 않음 (큐가 가득 차면 버리고 지표에 기록)
+    pub fn append(&self, pair: &PairState, prices: &[StoredPriceData]) {
+        let job = WriteJob {
+            pair: pair.id,
+            pair_name: Arc::clone(&pair.name),
+            prices: prices.to_vec(),
+        };
+        match self.queue.try_send(job) {
+            Ok(()) => {}
+            Err(TrySendError::Full(job)) => {
+                warn!(
+                    "❌ Price history queue full, dropping {} {} prices",
+                    job.prices.len(),
+                    job.pair_name
+                );
+                metrics::history_dropped(job.prices.len() as u64);
+            }
+            Err(TrySendError::Disconnected(_)) => {
+                warn!(
+                    "❌ Price history writer stopped, dropping {} prices",
+                    pair.name
+                );
+            }
+        }
+    }
+}
+
+fn partition_of(timestamp: u64) -> u64 {
+    timestamp - timestamp % PARTITION_SECS
+}
+
+/// 모든 가격의 가수가 10^k로 나누어떨어지는 가장 큰 k (최대 [`Price::DECIMALS`])
+fn common_digits(prices: &[Price]) -> u8 {
+    let mut digits = Price::DECIMALS as u8;
+    for price in prices {
+        while digits > 0 && price.mantissa() % 10i64.pow(digits as u32) != 0 {
+            digits -= 1;
+        }
+    }
+    digits
+}
+
+fn pair_prefix(pair: &str) -> Vec<u8> {
+    let mut prefix = Vec::with_capacity(pair.len() + 1);
+    prefix.extend_from_slice(pair.as_bytes());
+    prefix.push(KEY_SEPARATOR);
+    prefix
+}
+
+fn chunk_key(pair: &str, partition: u64, source: &str, first_timestamp: u64) -> Vec<u8> {
+    let mut key = pair_prefix(pair);
+    key.extend_from_slice(&partition.to_be_bytes());
+    key.extend_from_slice(source.as_bytes());
+    key.push(KEY_SEPARATOR);
+    key.extend_from_slice(&first_timestamp.to_be_bytes());
+    key
+}
+
+/// 키 -> (파티션, 거래소) - 다른 자산 쌍의 키면 None
+fn parse_key<'a>(key: &'a [u8], pair_prefix: &[u8]) -> Option<(u64, &'a str)> {
+    let rest = key.strip_prefix(pair_prefix)?;
+    let partition = u64::from_be_bytes(rest.get(..8)?.try_into().ok()?);
+    let rest = &rest[8..];
+    let end = rest.iter().position(|&byte| byte == KEY_SEPARATOR)?;
+    let source = std::str::from_utf8(&rest[..end]).ok()?;
+    Some((partition, source))
+}
+
+fn zigzag(value: i64) -> u64 {
+    ((value << 1) ^ (value >> 63)) as u64
+}
+
+fn unzigzag(value: u64) -> i64 {
+    (value >> 1) as i64 ^ -((value & 1) as i64)
+}
+
+fn write_varint(out: &mut Vec<u8>, mut value: u64) {
+    while value >= 0x80 {
+        out.push(value as u8 | 0x80);
+        value >>= 7;
+    }
+    out.push(value as u8);
+}
+
+/// 청크 디코딩용 바이트 리더
+struct Reader<'a> {
+    bytes: &'a [u8],
+    offset: usize,
+}
+
+impl<'a> Reader<'a> {
+    fn byte(&mut self) -> Result<u8> {
+        let byte = *self
+            .bytes
+            .get(self.offset)
+            .ok_or_else(|| anyhow!("Truncated price chunk"))?;
+        self.offset += 1;
+        Ok(byte)
+    }
+
+    fn take(&mut self, len: usize) -> Result<&'a [u8]> {
+        let bytes = self
+            .bytes
+            .get(self.offset..self.offset + len)
+            .ok_or_else(|| anyhow!("Truncated price chunk"))?;
+        self.offset += len;
+        Ok(bytes)
+    }
+
+    fn varint(&mut self) -> Result<u64> {
+        let mut value = 0u64;
+        for shift in (0..64).step_by(7) {
+            let byte = self.byte()?;
+            value |= ((byte & 0x7f) as u64) << shift;
+            if byte & 0x80 == 0 {
+                return Ok(value);
+            }
+        }
+        bail!("Varint overflow in price chunk")
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::registry::Registry;
+
+    fn temp_config(name: &str) -> DatabaseConfig {
+        let path =
+            std::env::temp_dir().join(format!("price-history-{}-{}", name, std::process::id()));
+        let _ = std::fs::remove_dir_all(&path);
+        DatabaseConfig {
+            path: path.to_string_lossy().into_owned(),
+            cache_size: 8 * 1024 * 1024,
+            write_buffer_size: 4 * 1024 * 1024,
+        }
+    }
+
+    fn sample(registry: &Registry, source: &str, price: Price, timestamp: u64) -> StoredPriceData {
+        StoredPriceData {
+            price,
+            timestamp,
+            source: registry.register_source(source),
+            node: registry.node_key("node-1"),
+            received_at: timestamp + 2,
+            volume: Some(1.5),
+        }
+    }
+
+    #[test]
+    fn test_chunk_round_trip_is_compact() {
+        let mut chunk = Chunk::default();
+        for i in 0..100u64 {
+            let node = if i % 3 == 0 { "node-1" } else { "node-2" };
+            chunk.push(
+                1_700_000_000 + i * 60,
+                1_700_000_001 + i * 60,
+                Price::from_cents(7_000_000 + i as i64 * 37),
+                node,
+                None,
+            );
+        }
+        // 늦게 도착한 데이터 (음수 delta)
+        chunk.push(
+            1_700_000_030,
+            1_700_009_000,
+            Price::from_cents(6_999_999),
+            "node-3",
+            None,
+        );
+
+        let encoded = chunk.encode();
+        assert_eq!(Chunk::decode(&encoded).unwrap(), chunk);
+        // 일정 간격 수집이면 데이터당 약 4바이트 (타임스탬프/수신 시각/노드 1바이트 + 가격 1~2바이트)
+        assert!(encoded.len() < 101 * 6, "encoded {} bytes", encoded.len());
+        assert!(Chunk::decode(&encoded[..encoded.len() - 1]).is_err());
+
+        // 센트보다 작은 단위와 거래량도 그대로 보존
+        chunk.push(
+            1_700_009_060,
+            1_700_009_061,
+            "70000.12345678".parse().unwrap(),
+            "node-1",
+            Some(12.5),
+        );
+        let decoded = Chunk::decode(&chunk.encode()).unwrap();
+        assert_eq!(decoded, chunk);
+        assert_eq!(decoded.volumes[101], Some(12.5));
+        assert_eq!(decoded.volumes[100], None);
+    }
+
+    #[test]
+    fn test_decodes_cents_chunk_v1() {
+        // 버전 1: 가격 열이 센트 차이, 자릿수 바이트 없음
+        let mut encoded = vec![1];
+        write_varint(&mut encoded, 2);
+        write_varint(&mut encoded, 1);
+        write_varint(&mut encoded, 6);
+        encoded.extend_from_slice(b"node-1");
+        write_varint(&mut encoded, 1_700_000_000);
+        write_varint(&mut encoded, zigzag(60));
+        write_varint(&mut encoded, zigzag(1));
+        write_varint(&mut encoded, zigzag(1));
+        write_varint(&mut encoded, zigzag(7_000_050));
+        write_varint(&mut encoded, zigzag(-25));
+        write_varint(&mut encoded, 0);
+        write_varint(&mut encoded, 0);
+
+        let chunk = Chunk::decode(&encoded).unwrap();
+        assert_eq!(chunk.timestamps, vec![1_700_000_000, 1_700_000_060]);
+        assert_eq!(
+            chunk.prices,
+            vec![Price::from_cents(7_000_050), Price::from_cents(7_000_025)]
+        );
+        assert_eq!(chunk.node_names, vec!["node-1"]);
+        assert_eq!(chunk.volumes, vec![None, None]);
+    }
+
+    #[test]
+    fn test_key_layout_orders_by_partition_then_source() {
+        let prefix = pair_prefix("BTC/USD");
+        let early = chunk_key("BTC/USD", 0, "kraken", 10);
+        let late = chunk_key("BTC/USD", PARTITION_SECS, "binance", PARTITION_SECS);
+        assert!(early < late);
+        assert_eq!(parse_key(&late, &prefix), Some((PARTITION_SECS, "binance")));
+        assert_eq!(
+            parse_key(&chunk_key("BTC/USDT", 0, "kraken", 0), &prefix),
+            None
+        );
+    }
+
+    #[test]
+    fn test_range_query_and_reopen() {
+        let config = temp_config("range");
+        let registry = Registry::new();
+        let btc = registry.register_pair("BTC/USD");
+        let eth = registry.register_pair("ETH/USD");
+        let start = 10 * PARTITION_SECS - 600;
+
+        {
+            let db = PriceHistoryDb::open(&config).unwrap();
+            // 파티션 경계와 청크 크기를 모두 넘도록 기록
+            for i in 0..300u64 {
+                let prices = [
+                    sample(
+                        &registry,
+                        "binance",
+                        Price::from_units(70_000 + i as i64),
+                        start + i * 10,
+                    ),
+                    sample(
+                        &registry,
+                        "kraken",
+                        Price::from_cents(7_000_150 + i as i64 * 100),
+                        start + i * 10 + 1,
+                    ),
+                ];
+                db.append(btc.id, &btc.name, &prices, &registry.symbols())
+                    .unwrap();
+            }
+            let eth_price = [sample(
+                &registry,
+                "binance",
+                Price::from_cents(350_025),
+                start,
+            )];
+            db.append(eth.id, &eth.name, &eth_price, &registry.symbols())
+                .unwrap();
+        }
+
+        // 재시작 후에도 같은 데이터로 조회
+        let db = PriceHistoryDb::open(&config).unwrap();
+        assert_eq!(db.pairs().unwrap(), vec!["BTC/USD", "ETH/USD"]);
+
+        let all = db
+            .range("BTC/USD", None, start, start + 3000, usize::MAX)
+            .unwrap();
+        assert_eq!(all.records.len(), 600);
+        assert!(!all.truncated);
+        assert!(all
+            .records
+            .windows(2)
+            .all(|w| w[0].timestamp <= w[1].timestamp));
+        assert_eq!(all.records[1].price, Price::from_cents(7_000_150));
+        assert_eq!(all.records[1].received_at, start + 3);
+        assert_eq!(all.records[1].node, "node-1");
+        assert_eq!(all.records[1].volume, Some(1.5));
+
+        let kraken = db
+            .range(
+                "BTC/USD",
+                Some("kraken"),
+                start + 500,
+                start + 1000,
+                usize::MAX,
+            )
+            .unwrap();
+        assert_eq!(kraken.records.len(), 50);
+        assert!(kraken
+            .records
+            .iter()
+            .all(|record| record.source == "kraken"));
+
+        let limited = db.range("BTC/USD", None, start, start + 3000, 10).unwrap();
+        assert!(limited.truncated);
+        assert_eq!(limited.records, all.records[..10]);
+
+        // 재시작 직후 같은 시각으로 다시 시작해도 기존 청크를 덮어쓰지 않음
+        let late = [sample(
+            &registry,
+            "binance",
+            Price::from_units(71_000),
+            start,
+        )];
+        db.append(btc.id, &btc.name, &late, &registry.symbols())
+            .unwrap();
+        // 쓰는 중인 청크는 저장 전까지 조회에 보이지 않음
+        let first = db
+            .range("BTC/USD", Some("binance"), start, start, usize::MAX)
+            .unwrap();
+        assert_eq!(first.records.len(), 1);
+
+        db.flush().unwrap();
+        let first = db
+            .range("BTC/USD", Some("binance"), start, start, usize::MAX)
+            .unwrap();
+        assert_eq!(first.records.len(), 2);
+
+        drop(db);
+        std::fs::remove_dir_all(&config.path).unwrap();
+    }
+}
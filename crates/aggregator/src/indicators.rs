@@ -0,0 +1,402 @@
+//! 스트리밍 시장 지표 (자산 쌍 하나 기준)
+//!
+//! 이력을 다시 훑지 않고 갱신마다 O(1)(분할 상환)로 지표를 유지한다.
+//! - [`WindowedTwap`]: 집계 가격의 시간 가중 평균 (계단 함수 면적 / 구간 길이)
+//! - [`WindowedVwap`]: 거래소 가격의 거래량 가중 평균 (구간 합계 유지, 캔들당 한 번만 반영)
+//! - [`EwmaVolatility`]: 집계 가격 로그 수익률의 지수 가중 분산 -> 연율화 실현 변동성
+//!
+//! 결과는 집계 스냅샷에 실려 구독자(프리미엄 계산 등)에게 전달된다.
+
+use oracle_vm_common::intern::SourceId;
+use std::collections::{HashMap, VecDeque};
+
+/// TWAP 구간 (초)
+pub const TWAP_WINDOW_SECS: u64 = 3600;
+/// VWAP 구간 (초)
+pub const VWAP_WINDOW_SECS: u64 = 3600;
+/// 거래량을 보고하는 캔들 길이 (초) - 노드들은 1분 캔들을 수집
+pub const CANDLE_SECS: u64 = 60;
+/// 변동성 EWMA 반감기 (초)
+pub const VOLATILITY_HALF_LIFE_SECS: f64 = 6.0 * 3600.0;
+/// 변동성 표본 최소 간격 (초) - 거래소 도착마다 평균이 흔들리는 잡음을 수익률로 세지 않음
+const VOLATILITY_SAMPLE_SECS: u64 = 60;
+/// 변동성을 발행하기 위한 최소 수익률 표본 수
+const MIN_VOLATILITY_SAMPLES: u32 = 10;
+const SECONDS_PER_YEAR: f64 = 365.0 * 24.0 * 3600.0;
+
+/// 시간 가중 평균가 - 각 가격은 다음 가격이 들어올 때까지 유지된다고 본다
+#[derive(Debug)]
+pub struct WindowedTwap {
+    window: u64,
+    /// (시각, 가격) - 시각 오름차순
+    samples: VecDeque<(u64, f64)>,
+    /// 연속한 표본 사이 면적의 합 (가격 x 초)
+    area: f64,
+}
+
+impl WindowedTwap {
+    pub fn new(window: u64) -> Self {
+        Self {
+            window,
+            samples: VecDeque::new(),
+            area: 0.0,
+        }
+    }
+
+    pub fn push(&mut self, timestamp: u64, price: f64) {
+        if let Some(&(last_timestamp, last_price)) = self.samples.back() {
+            // 과거 시각 데이터는 계단 함수를 깨므로 무시
+            if timestamp < last_timestamp {
+                return;
+            }
+            self.area += last_price * (timestamp - last_timestamp) as f64;
+        }
+        self.samples.push_back((timestamp, price));
+
+        // 두 번째 표본이 구간 시작 이전이면 첫 표본은 더 이상 구간에 기여하지 않음
+        let start = timestamp.saturating_sub(self.window);
+        while self.samples.len() > 1 && self.samples[1].0 <= start {
+            let (front_timestamp, front_price) = self.samples.pop_front().unwrap();
+            self.area -= front_price * (self.samples[0].0 - front_timestamp) as f64;
+        }
+    }
+
+    /// 마지막 표본 시각 기준 `window` 구간의 TWAP
+    pub fn value(&self) -> Option<f64> {
+        let &(front_timestamp, front_price) = self.samples.front()?;
+        let &(last_timestamp, last_price) = self.samples.back()?;
+        let start = last_timestamp
+            .saturating_sub(self.window)
+            .max(front_timestamp);
+        if last_timestamp == start {
+            return Some(last_price);
+        }
+
+        // 구간 시작 이전에 걸친 첫 구간 부분은 제외
+        let area = self.area - front_price * (start - front_timestamp) as f64;
+        Some(area / (last_timestamp - start) as f64)
+    }
+}
+
+/// VWAP 표본 식별자 (거래소, 캔들 시작 시각)
+pub type CandleKey = (SourceId, u64);
+
+/// 캔들 하나의 VWAP 표본
+#[derive(Debug, Clone, Copy)]
+struct VwapSample {
+    candle: CandleKey,
+    timestamp: u64,
+    price: f64,
+    volume: f64,
+}
+
+/// 거래량 가중 평균가
+///
+/// 같은 캔들은 여러 노드가, 또 캔들이 만들어지는 동안 여러 번 보고한다.
+/// 캔들마다 표본 하나만 두고 나중 값으로 교체해 거래량을 중복해서 세지 않는다.
+#[derive(Debug)]
+pub struct WindowedVwap {
+    window: u64,
+    /// 캔들 첫 도착 순
+    samples: VecDeque<VwapSample>,
+    /// 캔들 -> 표본 순번 (`samples` 맨 앞 표본의 순번은 `front_seq`)
+    candles: HashMap<CandleKey, u64>,
+    front_seq: u64,
+    notional: f64,
+    volume: f64,
+}
+
+impl WindowedVwap {
+    pub fn new(window: u64) -> Self {
+        Self {
+            window,
+            samples: VecDeque::new(),
+            candles: HashMap::new(),
+            front_seq: 0,
+            notional: 0.0,
+            volume: 0.0,
+        }
+    }
+
+    /// 캔들 표본 반영 - 이미 있는 캔들이면 가격과 거래량을 최신 값으로 교체
+    pub fn push(&mut self, candle: CandleKey, timestamp: u64, price: f64, volume: f64) {
+        if volume <= 0.0 || !volume.is_finite() {
+            return;
+        }
+        match self.candles.get(&candle) {
+            Some(&seq) => {
+                let sample = &mut self.samples[(seq - self.front_seq) as usize];
+                self.notional += price * volume - sample.price * sample.volume;
+                self.volume += volume - sample.volume;
+                sample.price = price;
+                sample.volume = volume;
+            }
+            None => {
+                self.candles
+                    .insert(candle, self.front_seq + self.samples.len() as u64);
+                self.samples.push_back(VwapSample {
+                    candle,
+                    timestamp,
+                    price,
+                    volume,
+                });
+                self.notional += price * volume;
+                self.volume += volume;
+            }
+        }
+        self.evict(timestamp);
+    }
+
+    /// `now - window` 이전 표본 제거
+    fn evict(&mut self, now: u64) {
+        let start = now.saturating_sub(self.window);
+        while let Some(&sample) = self.samples.front() {
+            if sample.timestamp >= start {
+                break;
+            }
+            self.samples.pop_front();
+            self.candles.remove(&sample.candle);
+            self.front_seq += 1;
+            self.notional -= sample.price * sample.volume;
+            self.volume -= sample.volume;
+        }
+        // 누적 합계의 부동소수점 오차가 쌓이지 않도록 비면 초기화
+        if self.samples.is_empty() {
+            self.notional = 0.0;
+            self.volume = 0.0;
+        }
+    }
+
+    pub fn value(&self) -> Option<f64> {
+        (self.volume > 0.0).then(|| self.notional / self.volume)
+    }
+
+    /// 구간 내 거래량 합계
+    pub fn volume(&self) -> f64 {
+        self.volume
+    }
+}
+
+/// 시간 인식 EWMA 실현 변동성
+///
+/// 수익률 r을 dt초 간격으로 관측하면 초당 분산 r²/dt를 반감기 기준 가중치
+/// `1 - 2^(-dt / half_life)`로 누적한다. 표본 간격이 불규칙해도 편향되지 않는다.
+#[derive(Debug)]
+pub struct EwmaVolatility {
+    half_life: f64,
+    last: Option<(u64, f64)>,
+    /// 초당 분산
+    variance: f64,
+    samples: u32,
+}
+
+impl EwmaVolatility {
+    pub fn new(half_life: f64) -> Self {
+        Self {
+            half_life,
+            last: None,
+            variance: 0.0,
+            samples: 0,
+        }
+    }
+
+    pub fn push(&mut self, timestamp: u64, price: f64) {
+        if price <= 0.0 {
+            return;
+        }
+        let Some((last_timestamp, last_price)) = self.last else {
+            self.last = Some((timestamp, price));
+            return;
+        };
+        if timestamp < last_timestamp + VOLATILITY_SAMPLE_SECS {
+            return;
+        }
+
+        let dt = (timestamp - last_timestamp) as f64;
+        let log_return = (price / last_price).ln();
+        let observed = log_return * log_return / dt;
+        self.variance = if self.samples == 0 {
+            observed
+        } else {
+            let weight = 1.0 - (-dt / self.half_life).exp2();
+            self.variance + weight * (observed - self.variance)
+        };
+        self.samples += 1;
+        self.last = Some((timestamp, price));
+    }
+
+    /// 연율화 변동성 (표본이 부족하면 None)
+    pub fn annualized(&self) -> Option<f64> {
+        (self.samples >= MIN_VOLATILITY_SAMPLES).then(|| (self.variance * SECONDS_PER_YEAR).sqrt())
+    }
+}
+
+/// 자산 쌍 하나의 지표 묶음
+#[derive(Debug)]
+pub struct MarketIndicators {
+    twap: WindowedTwap,
+    vwap: WindowedVwap,
+    volatility: EwmaVolatility,
+}
+
+/// 발행용 지표 값
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct IndicatorValues {
+    pub twap: Option<f64>,
+    pub vwap: Option<f64>,
+    /// 연율화 실현 변동성
+    pub realized_volatility: Option<f64>,
+    /// VWAP 구간 내 거래량 합계 (기초 자산 단위)
+    pub volume: f64,
+}
+
+impl MarketIndicators {
+    pub fn new() -> Self {
+        Self {
+            twap: WindowedTwap::new(TWAP_WINDOW_SECS),
+            vwap: WindowedVwap::new(VWAP_WINDOW_SECS),
+            volatility: EwmaVolatility::new(VOLATILITY_HALF_LIFE_SECS),
+        }
+    }
+
+    /// 거래소 가격 반영 (거래량이 있는 경우만 VWAP에 기여, 같은 거래소/캔들은 한 번만)
+    pub fn record_source(
+        &mut self,
+        source: SourceId,
+        timestamp: u64,
+        price: f64,
+        volume: Option<f64>,
+    ) {
+        if let Some(volume) = volume {
+            let candle = (source, timestamp - timestamp % CANDLE_SECS);
+            self.vwap.push(candle, timestamp, price, volume);
+        }
+    }
+
+    /// 합의된 집계 가격 반영
+    pub fn record_aggregate(&mut self, timestamp: u64, price: f64) {
+        self.twap.push(timestamp, price);
+        self.volatility.push(timestamp, price);
+    }
+
+    pub fn values(&self) -> IndicatorValues {
+        IndicatorValues {
+            twap: self.twap.value(),
+            vwap: self.vwap.value(),
+            realized_volatility: self.volatility.annualized(),
+            volume: self.vwap.volume(),
+        }
+    }
+}
+
+impl Default for MarketIndicators {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_twap_weights_by_holding_time() {
+        let mut twap = WindowedTwap::new(100);
+        assert_eq!(twap.value(), None);
+        twap.push(0, 100.0);
+        assert_eq!(twap.value(), Some(100.0));
+        twap.push(30, 200.0);
+        twap.push(40, 200.0);
+        // 100 x 30s + 200 x 10s
+        assert!((twap.value().unwrap() - 5000.0 / 40.0).abs() < 1e-9);
+
+        // 구간을 넘으면 첫 가격은 걸친 부분만 반영: [50, 150] = 100 x 0 + 200 x 100
+        twap.push(150, 300.0);
+        assert!((twap.value().unwrap() - 200.0).abs() < 1e-9);
+        // 과거 시각 데이터는 무시
+        twap.push(10, 1.0);
+        assert!((twap.value().unwrap() - 200.0).abs() < 1e-9);
+    }
+
+    const BINANCE: SourceId = SourceId(0);
+    const KRAKEN: SourceId = SourceId(1);
+
+    #[test]
+    fn test_vwap_evicts_old_volume() {
+        let mut vwap = WindowedVwap::new(60);
+        vwap.push((BINANCE, 0), 0, 100.0, 1.0);
+        vwap.push((BINANCE, 30), 30, 200.0, 3.0);
+        vwap.push((BINANCE, 40), 40, 999.0, 0.0);
+        assert!((vwap.value().unwrap() - 175.0).abs() < 1e-9);
+        assert_eq!(vwap.volume(), 4.0);
+
+        vwap.push((BINANCE, 80), 80, 300.0, 1.0);
+        assert!((vwap.value().unwrap() - 225.0).abs() < 1e-9);
+        vwap.push((BINANCE, 1_000), 1_000, 50.0, 2.0);
+        assert_eq!(vwap.value(), Some(50.0));
+        assert_eq!(vwap.volume(), 2.0);
+    }
+
+    #[test]
+    fn test_vwap_counts_each_candle_once() {
+        let mut indicators = MarketIndicators::new();
+        // 두 노드가 같은 binance 캔들을 보고하고, 캔들이 만들어지는 동안 거래량이 늘어남
+        indicators.record_source(BINANCE, 120, 70_000.0, Some(2.0));
+        indicators.record_source(BINANCE, 125, 70_000.0, Some(2.0));
+        indicators.record_source(BINANCE, 150, 70_040.0, Some(3.0));
+        indicators.record_source(KRAKEN, 130, 70_100.0, Some(1.0));
+
+        let values = indicators.values();
+        assert_eq!(values.volume, 4.0);
+        assert!((values.vwap.unwrap() - (70_040.0 * 3.0 + 70_100.0) / 4.0).abs() < 1e-9);
+
+        // 다음 캔들은 새 표본, 구간을 벗어난 캔들은 빠짐
+        indicators.record_source(BINANCE, 180, 70_200.0, Some(1.0));
+        assert_eq!(indicators.values().volume, 5.0);
+        let later = 180 + VWAP_WINDOW_SECS + CANDLE_SECS;
+        indicators.record_source(BINANCE, later, 70_300.0, Some(1.0));
+        indicators.record_source(BINANCE, later + 5, 70_300.0, Some(2.0));
+        let values = indicators.values();
+        assert_eq!(values.volume, 2.0);
+        assert!((values.vwap.unwrap() - 70_300.0).abs() < 1e-6);
+    }
+
+    #[test]
+    fn test_ewma_volatility_recovers_constant_vol() {
+        // 1분마다 ±σ√dt 로그 수익률을 번갈아 주면 실현 변동성은 σ
+        let sigma = 0.6;
+        let dt = 60.0;
+        let step = sigma * (dt / SECONDS_PER_YEAR).sqrt();
+        let mut volatility = EwmaVolatility::new(VOLATILITY_HALF_LIFE_SECS);
+        let mut price = 70_000.0;
+        for i in 0..(MIN_VOLATILITY_SAMPLES as u64 - 1) {
+            volatility.push(i * 60, price);
+            let sign = if i % 2 == 0 { 1.0 } else { -1.0 };
+            price *= (sign * step).exp();
+        }
+        assert_eq!(volatility.annualized(), None);
+
+        for i in (MIN_VOLATILITY_SAMPLES as u64 - 1)..500 {
+            volatility.push(i * 60, price);
+            // 표본 간격보다 짧은 갱신은 무시
+            volatility.push(i * 60 + 5, price * 1.01);
+            let sign = if i % 2 == 0 { 1.0 } else { -1.0 };
+            price *= (sign * step).exp();
+        }
+        assert!((volatility.annualized().unwrap() - sigma).abs() < 1e-6);
+    }
+
+    #[test]
+    fn test_indicators_combine_sources_and_aggregates() {
+        let mut indicators = MarketIndicators::new();
+        indicators.record_source(BINANCE, 0, 70_000.0, Some(2.0));
+        indicators.record_source(KRAKEN, 0, 70_100.0, None);
+        indicators.record_aggregate(0, 70_050.0);
+
+        let values = indicators.values();
+        assert_eq!(values.vwap, Some(70_000.0));
+        assert_eq!(values.twap, Some(70_050.0));
+        assert_eq!(values.realized_volatility, None);
+        assert_eq!(values.volume, 2.0);
+    }
+}
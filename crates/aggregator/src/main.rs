@@ -1,9 +1,18 @@
 use anyhow::Result;
 use chrono::Utc;
-use std::collections::HashMap;
-use std::sync::{Arc, Mutex};
+use clap::Parser;
+use oracle_vm_common::config::{DatabaseConfig, NetworkConfig};
+use oracle_vm_common::consensus::{ConsensusConfig, Quorum};
+use oracle_vm_common::crypto::{SubmissionDigest, XOnlyPublicKey};
+use oracle_vm_common::intern::{NodeKey, SourceId};
+use oracle_vm_common::Price;
+use std::net::SocketAddr;
+use std::sync::Arc;
+use std::time::Duration;
+use tokio::sync::{broadcast, mpsc};
+use tokio_stream::wrappers::ReceiverStream;
 use tonic::{transport::Server, Request, Response, Status};
-use tracing::{info, warn};
+use tracing::{debug, info, warn, Level};
 
 // gRPC 서비스 정의 (tonic-build로 자동 생성됨)
 pub mod oracle {
@@ -12,102 +21,772 @@ pub mod oracle {
 
 use oracle::{
     oracle_service_server::{OracleService, OracleServiceServer},
-    AggregatedPriceUpdate, ConfigRequest, ConfigResponse, GetPriceRequest, GetPriceResponse,
-    HealthRequest, HealthResponse, PriceDataPoint, PriceRequest, PriceResponse,
+    AggregatedPriceUpdate, ConfigRequest, ConfigResponse, FixedPrice, GetPriceRequest,
+    GetPriceResponse, HealthRequest, HealthResponse, PriceBatchRequest, PriceBatchResponse,
+    PriceDataPoint, PriceHistoryRequest, PriceHistoryResponse, PricePoint, PriceRequest,
+    PriceResponse,
 };
 
+impl From<Price> for FixedPrice {
+    fn from(price: Price) -> Self {
+        Self {
+            mantissa: price.mantissa(),
+            exponent: Price::EXPONENT,
+        }
+    }
+}
+
+impl FixedPrice {
+    /// 내부 고정소수점 가격으로 변환 (다른 exponent는 재조정, 범위를 넘으면 None)
+    pub fn to_price(&self) -> Option<Price> {
+        Price::from_parts(self.mantissa, self.exponent)
+    }
+}
+
 use futures::Stream;
 use std::pin::Pin;
 
-/// 가격 데이터 저장 구조체
-#[derive(Clone, Debug)]
-struct StoredPriceData {
-    price: f64,
-    timestamp: u64,
-    source: String,
-    node_id: String,
-    received_at: u64,
+mod auth;
+mod cluster;
+mod history_db;
+mod indicators;
+mod metrics;
+mod registry;
+mod snapshot;
+mod store;
+
+use auth::Authenticator;
+use cluster::ClusterHandle;
+use history_db::{HistoryRecord, HistoryWriter, PriceHistoryDb, PARTITION_SECS};
+use indicators::MarketIndicators;
+use metrics::{CONSENSUS_SECONDS, INGEST_SECONDS};
+use registry::{PairState, Registry, Symbols};
+use snapshot::AggregateSnapshot;
+use store::{Admission, ConsensusState, StoredPriceData};
+
+/// 합의에 참여하는 거래소 목록
+const REQUIRED_EXCHANGES: [&str; 3] = ["binance", "coinbase", "kraken"];
+/// 자산 쌍을 지정하지 않은 요청의 기본값
+const DEFAULT_PAIR: &str = "BTC/USD";
+/// 기본으로 수집하는 자산 쌍 (`--pairs`로 추가)
+const DEFAULT_PAIRS: [&str; 2] = [DEFAULT_PAIR, "ETH/USD"];
+/// 합의에 사용할 데이터의 유효 시간 (초) - 1분 수집 + 1분 여유
+const FRESHNESS_WINDOW_SECS: u64 = 120;
+/// 거래소 간 합의: 2/3 정족수, 중간값에서 최대 5% (bps)
+const CONSENSUS: ConsensusConfig = ConsensusConfig::new(Quorum::TWO_THIRDS, 500);
+/// 집계 가격 브로드캐스트 채널 용량
+const UPDATE_CHANNEL_CAPACITY: usize = 64;
+/// 구독자별 전송 버퍼 (가득 차면 느린 구독자로 보고 연결 해제)
+const SUBSCRIBER_BUFFER: usize = 16;
+/// 느린 구독자에게 연결 해제 상태를 전달할 때까지 기다리는 시간
+const SLOW_SUBSCRIBER_GRACE: Duration = Duration::from_secs(5);
+/// 이력 구간 조회 한 번에 돌려줄 최대 데이터 수
+const MAX_HISTORY_POINTS: usize = 10_000;
+/// 재시작 시 메모리 상태로 복원할 최근 구간 (초)
+const RESTORE_WINDOW_SECS: u64 = 2 * PARTITION_SECS;
+
+/// 빈 자산 쌍은 기본값(BTC/USD)으로 처리 (이전 버전 노드 호환)
+fn pair_or_default(pair: &str) -> &str {
+    if pair.is_empty() {
+        DEFAULT_PAIR
+    } else {
+        pair
+    }
 }
 
 /// Aggregator 서비스 구현
-#[derive(Default)]
+#[derive(Clone)]
 pub struct AggregatorService {
-    // 메모리에 가격 데이터 저장 (실제로는 DB 사용)
-    price_data: Arc<Mutex<Vec<StoredPriceData>>>,
-    // 활성 노드 추적
-    active_nodes: Arc<Mutex<HashMap<String, u64>>>,
+    // 자산 쌍/거래소/노드 ID와 자산 쌍별 상태 (최근 데이터만 메모리에 보관)
+    registry: Arc<Registry>,
+    // 전체 가격 이력 (없으면 메모리에만 보관)
+    history_db: Option<Arc<PriceHistoryDb>>,
+    // 이력 쓰기 큐 (RocksDB 쓰기는 전용 스레드에서 처리)
+    history_writer: Option<HistoryWriter>,
+    // 제출 서명 검증
+    auth: Arc<Authenticator>,
+    // 합의에 참여하는 거래소 ID
+    required_sources: Arc<[SourceId]>,
+    // 집계 가격 구독자 브로드캐스트
+    updates: broadcast::Sender<AggregatedPriceUpdate>,
+    // 다른 집계기 인스턴스로 제출 가십 (없으면 단독 실행)
+    cluster: Option<ClusterHandle>,
+}
+
+impl Default for AggregatorService {
+    fn default() -> Self {
+        Self::new()
+    }
 }
 
 impl AggregatorService {
     pub fn new() -> Self {
+        let (updates, _) = broadcast::channel(UPDATE_CHANNEL_CAPACITY);
+        let registry = Registry::new();
+        // 설정된 거래소/자산 쌍만 등록 - 그 밖의 이름으로 들어온 제출은 거부
+        let required_sources = REQUIRED_EXCHANGES
+            .iter()
+            .map(|exchange| registry.register_source(exchange))
+            .collect();
+        for pair in DEFAULT_PAIRS {
+            registry.register_pair(pair);
+        }
+
         Self {
-            price_data: Arc::new(Mutex::new(Vec::new())),
-            active_nodes: Arc::new(Mutex::new(HashMap::new())),
+            registry: Arc::new(registry),
+            history_db: None,
+            history_writer: None,
+            auth: Arc::new(Authenticator::new()),
+            required_sources,
+            updates,
+            cluster: None,
         }
     }
 
-    /// 안전한 집계 가격 계산 (엄격한 조건 검증)
-    fn calculate_aggregated_price(&self) -> Option<f64> {
-        let price_data = self.price_data.lock().unwrap();
+    /// 가격 이력을 RocksDB에 영구 저장하는 서비스 (쓰기 스레드 시작)
+    pub fn with_history(history_db: Arc<PriceHistoryDb>) -> Result<Self> {
+        let service = Self::new();
+        let writer = HistoryWriter::spawn(Arc::clone(&history_db), Arc::clone(&service.registry))?;
+        Ok(Self {
+            history_db: Some(history_db),
+            history_writer: Some(writer),
+            ..service
+        })
+    }
+
+    /// 기본 자산 쌍 외에 수집할 자산 쌍 등록
+    pub fn with_pairs<'a>(self, pairs: impl IntoIterator<Item = &'a str>) -> Self {
+        for pair in pairs {
+            self.registry.register_pair(pair);
+        }
+        self
+    }
+
+    /// 신뢰 키 목록에 있는 노드 키의 제출만 허용 (기본은 노드 ID별 첫 키 고정)
+    pub fn with_trusted_keys(
+        mut self,
+        keys: impl IntoIterator<Item = (String, XOnlyPublicKey)>,
+    ) -> Self {
+        self.auth = Arc::new(Authenticator::with_trusted_keys(keys));
+        self
+    }
+
+    /// 노드에게 직접 받은 제출을 클러스터 피어에게 전달
+    pub fn with_cluster(mut self, cluster: ClusterHandle) -> Self {
+        self.cluster = Some(cluster);
+        self
+    }
+
+    /// 재시작 시 최근 구간 이력으로 메모리 상태(링 버퍼, 최신값 슬롯, 스냅샷) 복원
+    ///
+    /// 복원한 데이터는 다시 저장하거나 브로드캐스트하지 않는다. 복원한 데이터 수를 반환.
+    pub fn restore_from_history(&self, now: u64) -> Result<usize> {
+        let Some(history_db) = &self.history_db else {
+            return Ok(0);
+        };
+
+        let from = now.saturating_sub(RESTORE_WINDOW_SECS);
+        let mut restored = 0;
+        for pair_name in history_db.pairs()? {
+            // 설정에서 빠진 자산 쌍은 복원하지 않음
+            let Some(pair) = self.registry.lookup_pair(&pair_name) else {
+                continue;
+            };
+            let range = history_db.range(&pair_name, None, from, now, usize::MAX)?;
+            if range.records.is_empty() {
+                continue;
+            }
+
+            let mut consensus = pair.consensus.lock().unwrap();
+            let mut indicators = pair.indicators.lock().unwrap();
+            for record in &range.records {
+                let Some(source) = self.registry.source_id(&record.source) else {
+                    continue;
+                };
+                let data = StoredPriceData {
+                    price: record.price,
+                    timestamp: record.timestamp,
+                    source,
+                    node: self.registry.node_key(&record.node),
+                    received_at: record.received_at,
+                    volume: record.volume,
+                };
+                // 재시작 직후 유효 시간 안의 제출을 다시 받아들이지 않도록 마지막 제출도 복원
+                consensus.admit(&data, from);
+                pair.history.record(data);
+                consensus.update(data);
+                indicators.record_source(
+                    data.source,
+                    data.timestamp,
+                    data.price.to_f64(),
+                    data.volume,
+                );
+            }
+            let snapshot = self.build_snapshot(&pair, &consensus, &mut indicators, now);
+            pair.snapshot.store(Arc::new(snapshot));
+            restored += range.records.len();
+        }
+
+        Ok(restored)
+    }
+
+    /// 가격 데이터 수집 (SubmitPrice와 StreamPrices 공통 경로)
+    fn ingest_price(&self, price_request: PriceRequest) -> PriceResponse {
+        let _timer = INGEST_SECONDS.with_label_values(&["single"]).start_timer();
+        let pair_name = pair_or_default(&price_request.pair);
+        let Some(price) = price_request.price.as_ref().and_then(FixedPrice::to_price) else {
+            warn!(
+                "❌ Missing fixed-point price from {}",
+                price_request.node_id
+            );
+            metrics::rejected("invalid_price", 1);
+            return PriceResponse {
+                success: false,
+                message: "Price must be a fixed-point value".to_string(),
+                aggregated_price: None,
+                timestamp: Utc::now().timestamp() as u64,
+            };
+        };
+        debug!(
+            "📨 Received {} price: ${:.2} from {} (node: {})",
+            pair_name, price, price_request.source, price_request.node_id
+        );
+
+        // 서명 검증 (필수) - 검증 전에는 노드 ID를 등록하지 않음
+        let mut digest = SubmissionDigest::new(&price_request.node_id);
+        digest.push(
+            &price_request.pair,
+            &price_request.source,
+            price,
+            price_request.timestamp,
+            price_request.volume,
+        );
+        if let Err(reason) = self.auth.verify(
+            &price_request.node_id,
+            price_request.public_key.as_deref(),
+            price_request.signature.as_deref(),
+            &digest.finalize(),
+        ) {
+            warn!(
+                "🔒 Rejected price from {}: {}",
+                price_request.node_id, reason
+            );
+            metrics::rejected("signature", 1);
+            return PriceResponse {
+                success: false,
+                message: reason.to_string(),
+                aggregated_price: None,
+                timestamp: Utc::now().timestamp() as u64,
+            };
+        }
+        let node = self.registry.node_key(&price_request.node_id);
+
+        // 가격 검증
+        if !price.is_positive() {
+            warn!("❌ Invalid price: {}", price);
+            metrics::rejected("invalid_price", 1);
+            return PriceResponse {
+                success: false,
+                message: "Price must be positive".to_string(),
+                aggregated_price: None,
+                timestamp: Utc::now().timestamp() as u64,
+            };
+        }
+        // 유효 시간이 지난 가격은 거부 - 서명된 오래된 제출을 다시 보내도 최신값이 되지 않음
+        let received_at = Utc::now().timestamp() as u64;
+        if price_request.timestamp < received_at.saturating_sub(FRESHNESS_WINDOW_SECS) {
+            warn!(
+                "❌ Stale price from {} (timestamp {})",
+                price_request.source, price_request.timestamp
+            );
+            metrics::rejected("stale", 1);
+            return PriceResponse {
+                success: false,
+                message: "Price is too old".to_string(),
+                aggregated_price: None,
+                timestamp: received_at,
+            };
+        }
+
+        // 문자열은 여기서 한 번만 ID로 변환 (설정되지 않은 이름은 거부)
+        let (pair, source) = match self.resolve_symbols(pair_name, &price_request.source) {
+            Ok(ids) => ids,
+            Err(reason) => {
+                warn!(
+                    "❌ Rejected {} price from {} ({}): {}",
+                    pair_name, price_request.node_id, price_request.source, reason
+                );
+                return PriceResponse {
+                    success: false,
+                    message: reason.to_string(),
+                    aggregated_price: None,
+                    timestamp: Utc::now().timestamp() as u64,
+                };
+            }
+        };
+        let stored_data = StoredPriceData {
+            price,
+            timestamp: price_request.timestamp,
+            source,
+            node,
+            received_at,
+            volume: price_request.volume,
+        };
+
+        let (snapshot, accepted) =
+            self.apply_prices(&pair, node, &[stored_data], stored_data.received_at);
+        if accepted == 0 {
+            return PriceResponse {
+                success: false,
+                message: "Price is not newer than the last accepted submission".to_string(),
+                aggregated_price: None,
+                timestamp: Utc::now().timestamp() as u64,
+            };
+        }
+
+        // 피어에게는 1개짜리 배치로 전달 (서명 다이제스트가 같다)
+        if let Some(cluster) = &self.cluster {
+            cluster.publish(&PriceBatchRequest {
+                node_id: price_request.node_id,
+                prices: vec![PricePoint {
+                    price: price_request.price,
+                    timestamp: price_request.timestamp,
+                    source: price_request.source,
+                    pair: price_request.pair,
+                    volume: price_request.volume,
+                }],
+                signature: price_request.signature,
+                public_key: price_request.public_key,
+            });
+        }
+
+        PriceResponse {
+            success: true,
+            message: "Price data received".to_string(),
+            aggregated_price: snapshot.aggregated_price.map(Price::to_f64),
+            timestamp: Utc::now().timestamp() as u64,
+        }
+    }
+
+    /// 노드가 보낸 가격 일괄 수집 - 반영되면 클러스터 피어에게도 전달
+    fn ingest_batch(&self, batch: PriceBatchRequest) -> PriceBatchResponse {
+        let _timer = INGEST_SECONDS.with_label_values(&["batch"]).start_timer();
+        debug!(
+            "📨 Received batch of {} prices (node: {})",
+            batch.prices.len(),
+            batch.node_id
+        );
+
         let now = Utc::now().timestamp() as u64;
+        let response = self.apply_batch(&batch, now.saturating_sub(FRESHNESS_WINDOW_SECS));
+        if response.success {
+            if let Some(cluster) = &self.cluster {
+                cluster.publish(&batch);
+            }
+        }
+        response
+    }
 
-        // Step 1: 각 거래소별 최신 데이터 수집 (거래소 이름으로 그룹핑)
-        let mut latest_per_exchange: std::collections::HashMap<String, (f64, u64)> =
-            std::collections::HashMap::new();
-
-        for data in price_data.iter() {
-            // 최근 2분 내 데이터만 사용 (더 넉넉한 윈도우)
-            if now - data.received_at <= 120 {
-                // 2분 = 120초
-                latest_per_exchange
-                    .entry(data.source.clone()) // source = exchange name
-                    .and_modify(|(existing_price, existing_time)| {
-                        // 더 최신 데이터라면 업데이트
-                        if data.timestamp > *existing_time {
-                            *existing_price = data.price;
-                            *existing_time = data.timestamp;
-                        }
-                    })
-                    .or_insert((data.price, data.timestamp));
+    /// 클러스터 피어가 가십한 배치 수집 - 노드 서명을 똑같이 검증하고 다시 가십하지 않는다
+    ///
+    /// 재전송된 오래된 제출이 최신값으로 보이지 않도록 유효 시간이 지난 가격은 제외한다.
+    fn ingest_peer_batch(&self, batch: PriceBatchRequest) {
+        let _timer = INGEST_SECONDS.with_label_values(&["peer"]).start_timer();
+        let now = Utc::now().timestamp() as u64;
+        let response = self.apply_batch(&batch, now.saturating_sub(FRESHNESS_WINDOW_SECS));
+        if !response.success {
+            warn!(
+                "❌ Rejected gossiped batch from {}: {}",
+                batch.node_id, response.message
+            );
+        }
+    }
+
+    /// 가격 일괄 반영 - 자산 쌍별로 배치를 한 번에 반영하고 합의는 자산 쌍당 한 번만 계산
+    ///
+    /// `min_timestamp`보다 오래된 가격은 잘못된 항목처럼 제외한다.
+    fn apply_batch(&self, batch: &PriceBatchRequest, min_timestamp: u64) -> PriceBatchResponse {
+        let received_at = Utc::now().timestamp() as u64;
+        let total = batch.prices.len();
+
+        // 배치 전체에 대한 서명 하나만 검증 (필수)
+        let mut digest = SubmissionDigest::new(&batch.node_id);
+        let prices: Vec<Option<Price>> = batch
+            .prices
+            .iter()
+            .map(|point| point.price.as_ref().and_then(FixedPrice::to_price))
+            .collect();
+        for (point, price) in batch.prices.iter().zip(&prices) {
+            // 가격이 없는 항목은 서명하지 않았으므로 검증에 실패한다
+            digest.push(
+                &point.pair,
+                &point.source,
+                price.unwrap_or_default(),
+                point.timestamp,
+                point.volume,
+            );
+        }
+        if let Err(reason) = self.auth.verify(
+            &batch.node_id,
+            batch.public_key.as_deref(),
+            batch.signature.as_deref(),
+            &digest.finalize(),
+        ) {
+            warn!("🔒 Rejected batch from {}: {}", batch.node_id, reason);
+            metrics::rejected("signature", total as u64);
+            return PriceBatchResponse {
+                success: false,
+                message: reason.to_string(),
+                accepted: 0,
+                rejected: total as u32,
+                aggregated_price: None,
+                timestamp: Utc::now().timestamp() as u64,
+            };
+        }
+        // 검증에 성공한 노드만 등록
+        let node = self.registry.node_key(&batch.node_id);
+
+        // 가격 검증 후 자산 쌍별로 묶음 - 잘못된 항목만 제외하고 나머지는 수집
+        let mut groups: Vec<(Arc<PairState>, Vec<StoredPriceData>)> = Vec::new();
+        for (point, &price) in batch.prices.iter().zip(&prices) {
+            let Some(price) = price.filter(|price| price.is_positive()) else {
+                warn!("❌ Invalid price: {:?} from {}", point.price, point.source);
+                metrics::rejected("invalid_price", 1);
+                continue;
+            };
+            if point.timestamp < min_timestamp {
+                warn!(
+                    "❌ Stale price from {} (timestamp {})",
+                    point.source, point.timestamp
+                );
+                metrics::rejected("stale", 1);
+                continue;
+            }
+
+            let (pair, source) =
+                match self.resolve_symbols(pair_or_default(&point.pair), &point.source) {
+                    Ok(ids) => ids,
+                    Err(reason) => {
+                        warn!(
+                            "❌ Rejected price {} from {}: {}",
+                            point.pair, point.source, reason
+                        );
+                        continue;
+                    }
+                };
+            let stored = StoredPriceData {
+                price,
+                timestamp: point.timestamp,
+                source,
+                node,
+                received_at,
+                volume: point.volume,
+            };
+            match groups.iter_mut().find(|(state, _)| state.id == pair.id) {
+                Some((_, prices)) => prices.push(stored),
+                None => groups.push((pair, vec![stored])),
             }
         }
 
+        if groups.is_empty() {
+            return PriceBatchResponse {
+                success: false,
+                message: "No valid prices in batch".to_string(),
+                accepted: 0,
+                rejected: total as u32,
+                aggregated_price: None,
+                timestamp: Utc::now().timestamp() as u64,
+            };
+        }
+
+        // 응답의 집계 가격은 배치의 첫 자산 쌍 기준 (재전송된 가격은 반영되지 않고 거부로 집계)
+        let mut aggregated_price = None;
+        let mut accepted = 0;
+        for (index, (pair, prices)) in groups.iter().enumerate() {
+            let (snapshot, applied) = self.apply_prices(pair, node, prices, received_at);
+            if index == 0 {
+                aggregated_price = snapshot.aggregated_price.map(Price::to_f64);
+            }
+            accepted += applied;
+        }
+        let rejected = (total - accepted) as u32;
+
+        if accepted == 0 {
+            return PriceBatchResponse {
+                success: false,
+                message: "No new prices in batch".to_string(),
+                accepted: 0,
+                rejected,
+                aggregated_price: None,
+                timestamp: Utc::now().timestamp() as u64,
+            };
+        }
+
+        PriceBatchResponse {
+            success: true,
+            message: format!("{} prices received", accepted),
+            accepted: accepted as u32,
+            rejected,
+            aggregated_price,
+            timestamp: Utc::now().timestamp() as u64,
+        }
+    }
+
+    /// 자산 쌍/거래소 이름을 등록된 ID로 변환 - 설정되지 않은 이름은 등록하지 않고 거부
+    fn resolve_symbols(
+        &self,
+        pair: &str,
+        source: &str,
+    ) -> Result<(Arc<PairState>, SourceId), &'static str> {
+        let Some(pair) = self.registry.lookup_pair(pair) else {
+            metrics::rejected("unknown_pair", 1);
+            return Err("Unknown asset pair");
+        };
+        let Some(source) = self.registry.source_id(source) else {
+            metrics::rejected("unknown_source", 1);
+            return Err("Unknown price source");
+        };
+        Ok((pair, source))
+    }
+
+    /// 한 자산 쌍에 검증된 가격들을 반영하고 새 스냅샷 발행 (단건/일괄 수집 공통)
+    ///
+    /// 노드/거래소별 마지막 제출보다 새롭지 않은 가격(재전송)은 거부한다. 반영된 가격 수를
+    /// 함께 반환하며, 하나도 반영되지 않으면 스냅샷을 다시 발행하지 않는다.
+    fn apply_prices(
+        &self,
+        pair: &PairState,
+        node: NodeKey,
+        prices: &[StoredPriceData],
+        now: u64,
+    ) -> (Arc<AggregateSnapshot>, usize) {
+        // 재전송 판별, 최신값 갱신, 합의 계산, 스냅샷 발행을 하나의 임계 구역에서 처리해
+        // 판별과 반영 사이에 같은 제출이 끼어들지 못하고 발행 순서도 보장된다
+        let (snapshot, accepted) = {
+            let mut consensus = pair.consensus.lock().unwrap();
+            let mut fresh = Vec::with_capacity(prices.len());
+            for data in prices {
+                let admission = consensus.admit(data, now.saturating_sub(FRESHNESS_WINDOW_SECS));
+                if admission == Admission::Fresh {
+                    fresh.push(*data);
+                    continue;
+                }
+                warn!(
+                    "❌ {:?} price from {} (timestamp {})",
+                    admission,
+                    self.registry.symbols().source(data.source),
+                    data.timestamp
+                );
+                metrics::rejected("replay", 1);
+            }
+            if fresh.is_empty() {
+                return (pair.snapshot.load_full(), 0);
+            }
+
+            // 이력은 해당 거래소 샤드에만 기록 (링 버퍼, 원소 이동 없음)
+            for &data in &fresh {
+                pair.history.record(data);
+            }
+            // 전체 이력은 쓰기 스레드로 넘김 - 저장이 늦거나 실패해도 수집/합의는 막지 않음
+            if let Some(history_writer) = &self.history_writer {
+                history_writer.append(pair, &fresh);
+            }
+
+            let mut indicators = pair.indicators.lock().unwrap();
+            for &data in &fresh {
+                consensus.update(data);
+                indicators.record_source(
+                    data.source,
+                    data.timestamp,
+                    data.price.to_f64(),
+                    data.volume,
+                );
+            }
+            let snapshot = Arc::new(self.build_snapshot(pair, &consensus, &mut indicators, now));
+            pair.snapshot.store(Arc::clone(&snapshot));
+            (snapshot, fresh.len())
+        };
+
+        // 활성 노드 업데이트 (노드별 원자 변수 - 공유 락 없음)
+        self.registry.mark_node_seen(node, now);
+
+        if let Some(agg_price) = snapshot.aggregated_price {
+            debug!("📊 Aggregated {} price: ${:.2}", pair.name, agg_price);
+            self.broadcast_update(&snapshot);
+        }
+
+        (snapshot, accepted)
+    }
+
+    /// 현재 최신값 슬롯으로 합의를 계산해 불변 스냅샷 생성 (합의된 가격은 지표에도 반영)
+    fn build_snapshot(
+        &self,
+        pair: &PairState,
+        consensus: &ConsensusState,
+        indicators: &mut MarketIndicators,
+        now: u64,
+    ) -> AggregateSnapshot {
+        let symbols = self.registry.symbols();
+        let aggregated_price = self.calculate_aggregated_price(pair, consensus, now, &symbols);
+        if let Some(price) = aggregated_price {
+            indicators.record_aggregate(now, price.to_f64());
+        }
+
+        // 참여 거래소 중 가장 오래된 데이터가 만료되는 시각까지 유효
+        let valid_until = consensus
+            .latest_per_source()
+            .map(|data| data.received_at)
+            .filter(|&received_at| now.saturating_sub(received_at) <= FRESHNESS_WINDOW_SECS)
+            .min()
+            .map(|oldest| oldest + FRESHNESS_WINDOW_SECS)
+            .unwrap_or(0);
+
+        AggregateSnapshot {
+            pair: Arc::clone(&pair.name),
+            aggregated_price,
+            data_points: pair.history.data_points() as u32,
+            last_update: consensus.last_received_at(),
+            valid_until,
+            recent_prices: consensus
+                .recent()
+                .map(|data| to_data_point(data, &symbols))
+                .collect(),
+            sources: consensus
+                .latest_per_source()
+                .map(|data| to_data_point(data, &symbols))
+                .collect(),
+            indicators: indicators.values(),
+        }
+    }
+
+    /// 모든 구독자에게 집계 가격 전송
+    fn broadcast_update(&self, snapshot: &AggregateSnapshot) {
+        let aggregated_price = match snapshot.aggregated_price {
+            Some(price) if self.updates.receiver_count() > 0 => price,
+            _ => return,
+        };
+
+        let now = Utc::now().timestamp() as u64;
+        let active_nodes = self
+            .registry
+            .symbols()
+            .active_nodes(now, FRESHNESS_WINDOW_SECS)
+            .map(|(_, name)| name.to_string())
+            .collect();
+
+        let update = AggregatedPriceUpdate {
+            aggregated_price: aggregated_price.to_f64(),
+            aggregated_price_fixed: Some(aggregated_price.into()),
+            data_points: snapshot.data_points,
+            timestamp: now,
+            active_nodes,
+            sources: snapshot.sources.clone(),
+            pair: snapshot.pair.to_string(),
+            twap: snapshot.indicators.twap,
+            vwap: snapshot.indicators.vwap,
+            realized_volatility: snapshot.indicators.realized_volatility,
+            volume: snapshot.indicators.volume,
+        };
+
+        // 구독자가 없으면 Err - 무시
+        let _ = self.updates.send(update);
+    }
+
+    /// 구독자 하나에 대한 전달 태스크 시작
+    ///
+    /// 브로드캐스트에서 밀리거나(Lagged) 구독자 버퍼가 가득 차면 느린 구독자로 판단하고
+    /// `RESOURCE_EXHAUSTED` 상태를 보낸 뒤 스트림을 종료한다.
+    fn spawn_subscriber(&self) -> mpsc::Receiver<Result<AggregatedPriceUpdate, Status>> {
+        let mut updates = self.updates.subscribe();
+        let (tx, rx) = mpsc::channel(SUBSCRIBER_BUFFER);
+
+        tokio::spawn(async move {
+            loop {
+                match updates.recv().await {
+                    Ok(update) => match tx.try_send(Ok(update)) {
+                        Ok(()) => {}
+                        Err(mpsc::error::TrySendError::Full(_)) => {
+                            warn!("🐢 Dropping slow subscriber (buffer full)");
+                            disconnect_slow_subscriber(&tx, "Subscriber too slow, buffer full")
+                                .await;
+                            break;
+                        }
+                        Err(mpsc::error::TrySendError::Closed(_)) => break,
+                    },
+                    Err(broadcast::error::RecvError::Lagged(skipped)) => {
+                        warn!("🐢 Dropping slow subscriber ({} updates behind)", skipped);
+                        disconnect_slow_subscriber(&tx, "Subscriber too slow, updates dropped")
+                            .await;
+                        break;
+                    }
+                    Err(broadcast::error::RecvError::Closed) => break,
+                }
+            }
+        });
+
+        rx
+    }
+
+    /// 안전한 집계 가격 계산 (엄격한 조건 검증)
+    ///
+    /// 거래소 ID로 인덱싱된 최신값 슬롯만 확인하므로 비용은 O(거래소 수)이며,
+    /// 거래소 이름은 로그를 남길 때만 조회한다.
+    fn calculate_aggregated_price(
+        &self,
+        pair: &PairState,
+        consensus: &ConsensusState,
+        now: u64,
+        symbols: &Symbols,
+    ) -> Option<Price> {
+        let _timer = CONSENSUS_SECONDS
+            .with_label_values(&[&*pair.name])
+            .start_timer();
+
+        // Step 1: 각 거래소별 최신 데이터 (최근 2분 내 데이터만 사용)
+        let is_fresh = move |latest: &StoredPriceData| {
+            now.saturating_sub(latest.received_at) <= FRESHNESS_WINDOW_SECS
+        };
+        let fresh = || {
+            consensus
+                .latest_per_source()
+                .filter(move |latest| is_fresh(latest))
+        };
+
         // Step 2: 2/3 이상 합의 조건 검증
-        let required_exchanges = vec!["binance", "coinbase", "kraken"];
-        let total_exchanges = required_exchanges.len();
-        let min_required = (total_exchanges * 2 + 2) / 3; // ceil(2/3) = 2개 이상
+        let total_exchanges = self.required_sources.len();
+        let min_required = CONSENSUS.quorum.required(total_exchanges); // 3개 중 2개 이상
+
+        let mut participating = 0usize;
+        let mut min_timestamp = u64::MAX;
+        let mut max_timestamp = 0u64;
+        for latest in fresh() {
+            participating += 1;
+            min_timestamp = min_timestamp.min(latest.timestamp);
+            max_timestamp = max_timestamp.max(latest.timestamp);
+        }
 
         // 2.1 최소 필요 거래소 수 확인 (3개 중 2개 이상)
-        if latest_per_exchange.len() < min_required {
-            let missing: Vec<&str> = required_exchanges
+        if participating < min_required {
+            let missing: Vec<&str> = self
+                .required_sources
                 .iter()
-                .filter(|&exchange| !latest_per_exchange.contains_key(*exchange))
-                .cloned()
+                .filter(|&&source| !consensus.latest_for(source).is_some_and(is_fresh))
+                .map(|&source| symbols.source(source))
                 .collect();
             warn!(
-                "⚠️ Insufficient consensus: {} of {} exchanges (need at least {}). Missing: {:?}",
-                latest_per_exchange.len(),
-                total_exchanges,
-                min_required,
-                missing
+                "⚠️ Insufficient {} consensus: {} of {} exchanges (need at least {}). Missing: {:?}",
+                pair.name, participating, total_exchanges, min_required, missing
             );
+            metrics::consensus_failed("insufficient_sources");
             return None;
         }
 
-        info!(
+        debug!(
             "✅ Consensus achieved: {} of {} exchanges participating",
-            latest_per_exchange.len(),
-            total_exchanges
+            participating, total_exchanges
         );
 
         // 2.2 timestamp 동일성 검증 (1분 이내 차이만 허용)
-        let timestamps: Vec<u64> = latest_per_exchange
-            .values()
-            .map(|(_, timestamp)| *timestamp)
-            .collect();
-        let min_timestamp = *timestamps.iter().min().unwrap();
-        let max_timestamp = *timestamps.iter().max().unwrap();
-
         if max_timestamp - min_timestamp > 60 {
             // 1분 초과 차이
             warn!(
@@ -116,64 +795,98 @@ impl AggregatorService {
                 min_timestamp,
                 max_timestamp
             );
+            metrics::consensus_failed("timestamp_skew");
             return None;
         }
 
-        // Step 3: 가격 이상치 검증
-        let prices: Vec<f64> = latest_per_exchange
-            .values()
-            .map(|(price, _)| *price)
-            .collect();
-        let avg_price = prices.iter().sum::<f64>() / prices.len() as f64;
+        // Step 3: 중간값/MAD 기준 이상치 제외 후 정족수 재확인 (모두 정수 연산)
+        let consensus =
+            match CONSENSUS.evaluate(fresh().map(|latest| latest.price), total_exchanges) {
+                Ok(consensus) => consensus,
+                Err(e) => {
+                    warn!("⚠️ {} {}", pair.name, e);
+                    metrics::consensus_failed("no_quorum");
+                    return None;
+                }
+            };
+        let avg_price = consensus.price;
 
-        // 3.1 개별 가격이 평균에서 5% 이상 벗어나는지 확인
-        for (exchange, (price, _)) in &latest_per_exchange {
-            let deviation = ((price - avg_price) / avg_price * 100.0).abs();
-            if deviation > 5.0 {
-                // 5% 초과 편차
+        // 3.1 제외된 거래소 가격 로깅
+        for latest in fresh().filter(|latest| !consensus.accepts(latest.price)) {
+            warn!(
+                "⚠️ Price anomaly excluded: {} = ${:.2} (median ${:.2}, band ±{:.2}%)",
+                symbols.source(latest.source),
+                latest.price,
+                consensus.median,
+                consensus.band_bps() as f64 / 100.0
+            );
+        }
+
+        // 3.2 가격 범위 상식선 검증 (범위가 정의된 자산 쌍만)
+        if let Some((min_price, max_price)) = pair.bounds {
+            if avg_price < min_price || avg_price > max_price {
                 warn!(
-                    "⚠️ Price anomaly detected: {} = ${:.2} ({}% deviation from average ${:.2})",
-                    exchange, price, deviation, avg_price
+                    "⚠️ Unrealistic average {} price: ${:.2}",
+                    pair.name, avg_price
                 );
+                metrics::consensus_failed("out_of_bounds");
                 return None;
             }
         }
 
-        // 3.2 가격 범위 상식선 검증
-        if avg_price < 10000.0 || avg_price > 500000.0 {
-            warn!("⚠️ Unrealistic average price: ${:.2}", avg_price);
-            return None;
-        }
-
         // Step 4: 모든 검증 통과 시 집계 수행
-        let participating_exchanges: Vec<&String> = latest_per_exchange.keys().collect();
-        info!(
-            "✅ All validations passed. Participating exchanges: {:?}",
-            participating_exchanges
-        );
-        info!(
-            "📊 Consensus aggregated price: ${:.2} from {}/{} exchanges",
-            avg_price,
-            prices.len(),
-            total_exchanges
+        debug!(
+            "📊 Consensus aggregated {} price: ${:.2} from {}/{} exchanges",
+            pair.name, avg_price, consensus.agreeing, total_exchanges
         );
 
-        // 개별 가격 로깅
-        for (exchange, (price, timestamp)) in &latest_per_exchange {
-            info!("   {}: ${:.2} (timestamp: {})", exchange, price, timestamp);
+        // 개별 가격 로깅 (디버그 로그가 꺼져 있으면 거래소 이름 조회도 생략)
+        if tracing::enabled!(Level::DEBUG) {
+            for latest in fresh() {
+                debug!(
+                    "   {}: ${:.2} (timestamp: {})",
+                    symbols.source(latest.source),
+                    latest.price,
+                    latest.timestamp
+                );
+            }
         }
 
         Some(avg_price)
     }
+}
 
-    /// 활성 노드 업데이트
-    fn update_active_node(&self, node_id: &str) {
-        let mut active_nodes = self.active_nodes.lock().unwrap();
-        let now = Utc::now().timestamp() as u64;
-        active_nodes.insert(node_id.to_string(), now);
+/// 느린 구독자에게 `RESOURCE_EXHAUSTED` 전달
+///
+/// 버퍼에 남은 업데이트 뒤에 보내므로 자리가 날 때까지 기다리되, 끝내 읽지 않으면
+/// 상태 없이 종료한다.
+async fn disconnect_slow_subscriber(
+    tx: &mpsc::Sender<Result<AggregatedPriceUpdate, Status>>,
+    message: &'static str,
+) {
+    let status = Status::resource_exhausted(message);
+    let _ = tokio::time::timeout(SLOW_SUBSCRIBER_GRACE, tx.send(Err(status))).await;
+}
 
-        // 2분 이상 비활성 노드 제거 (1분 수집 + 1분 여유)
-        active_nodes.retain(|_, &mut last_seen| now - last_seen <= 120);
+/// 저장소에서 읽은 이력을 gRPC 데이터 포인트로 변환
+fn history_to_data_point(record: HistoryRecord) -> PriceDataPoint {
+    PriceDataPoint {
+        price: record.price.to_f64(),
+        price_fixed: Some(record.price.into()),
+        timestamp: record.timestamp,
+        source: record.source,
+        node_id: record.node,
+    }
+}
+
+/// 저장된 데이터를 gRPC 데이터 포인트로 변환 (ID -> 이름)
+fn to_data_point(data: &StoredPriceData, symbols: &Symbols) -> PriceDataPoint {
+    PriceDataPoint {
+        price: data.price.to_f64(),
+        price_fixed: Some(data.price.into()),
+        timestamp: data.timestamp,
+        source: symbols.source(data.source).to_string(),
+        node_id: symbols.node(data.node).to_string(),
     }
 }
 
@@ -187,59 +900,15 @@ impl OracleService for AggregatorService {
         &self,
         request: Request<PriceRequest>,
     ) -> Result<Response<PriceResponse>, Status> {
-        let price_request = request.into_inner();
-
-        info!(
-            "📨 Received price: ${:.2} from {} (node: {})",
-            price_request.price, price_request.source, price_request.node_id
-        );
-
-        // 가격 검증
-        if price_request.price <= 0.0 {
-            warn!("❌ Invalid price: {}", price_request.price);
-            return Ok(Response::new(PriceResponse {
-                success: false,
-                message: "Price must be positive".to_string(),
-                aggregated_price: None,
-                timestamp: Utc::now().timestamp() as u64,
-            }));
-        }
-
-        // 데이터 저장
-        let stored_data = StoredPriceData {
-            price: price_request.price,
-            timestamp: price_request.timestamp,
-            source: price_request.source,
-            node_id: price_request.node_id.clone(),
-            received_at: Utc::now().timestamp() as u64,
-        };
-
-        {
-            let mut price_data = self.price_data.lock().unwrap();
-            price_data.push(stored_data);
-
-            // 최근 100개만 보관 (메모리 절약)
-            if price_data.len() > 100 {
-                price_data.remove(0);
-            }
-        }
-
-        // 활성 노드 업데이트
-        self.update_active_node(&price_request.node_id);
-
-        // 집계 가격 계산
-        let aggregated_price = self.calculate_aggregated_price();
-
-        if let Some(agg_price) = aggregated_price {
-            info!("📊 Aggregated price: ${:.2}", agg_price);
-        }
+        Ok(Response::new(self.ingest_price(request.into_inner())))
+    }
 
-        Ok(Response::new(PriceResponse {
-            success: true,
-            message: "Price data received".to_string(),
-            aggregated_price,
-            timestamp: Utc::now().timestamp() as u64,
-        }))
+    /// 가격 데이터 일괄 제출 처리
+    async fn submit_price_batch(
+        &self,
+        request: Request<PriceBatchRequest>,
+    ) -> Result<Response<PriceBatchResponse>, Status> {
+        Ok(Response::new(self.ingest_batch(request.into_inner())))
     }
 
     /// 헬스체크 처리
@@ -249,20 +918,23 @@ impl OracleService for AggregatorService {
     ) -> Result<Response<HealthResponse>, Status> {
         let health_request = request.into_inner();
 
-        // 활성 노드 업데이트
-        self.update_active_node(&health_request.node_id);
+        // 활성 노드 업데이트 - 서명이 없는 요청이므로 이미 제출에 성공한 노드만 기록
+        // 제출 경로와 공유하는 락 없이 노드별 원자 변수만 갱신 (2분 = 1분 수집 + 1분 여유)
+        let now = Utc::now().timestamp() as u64;
+        if let Some(node) = self.registry.lookup_node(&health_request.node_id) {
+            self.registry.mark_node_seen(node, now);
+        }
 
-        let active_nodes = self.active_nodes.lock().unwrap();
-        let active_count = active_nodes.len() as u32;
+        let active_count = self.registry.active_node_count(now, FRESHNESS_WINDOW_SECS) as u32;
 
-        info!(
+        debug!(
             "💚 Health check from {} (active nodes: {})",
             health_request.node_id, active_count
         );
 
         Ok(Response::new(HealthResponse {
             healthy: true,
-            timestamp: Utc::now().timestamp() as u64,
+            timestamp: now,
             active_nodes: active_count,
             version: "1.0.0".to_string(),
         }))
@@ -271,45 +943,70 @@ impl OracleService for AggregatorService {
     /// 집계 가격 조회
     async fn get_aggregated_price(
         &self,
-        _request: Request<GetPriceRequest>,
+        request: Request<GetPriceRequest>,
     ) -> Result<Response<GetPriceResponse>, Status> {
-        let aggregated_price = self.calculate_aggregated_price();
-
-        match aggregated_price {
-            Some(price) => {
-                let price_data = self.price_data.lock().unwrap();
-                let data_points = price_data.len() as u32;
-                let last_update = price_data.last().map(|data| data.received_at).unwrap_or(0);
-
-                // 최근 5개 데이터 포함
-                let recent_prices: Vec<PriceDataPoint> = price_data
-                    .iter()
-                    .rev()
-                    .take(5)
-                    .map(|data| PriceDataPoint {
-                        price: data.price,
-                        timestamp: data.timestamp,
-                        source: data.source.clone(),
-                        node_id: data.node_id.clone(),
-                    })
-                    .collect();
-
-                Ok(Response::new(GetPriceResponse {
-                    success: true,
-                    aggregated_price: price,
-                    data_points,
-                    last_update,
-                    recent_prices,
-                }))
-            }
-            None => Ok(Response::new(GetPriceResponse {
-                success: false,
-                aggregated_price: 0.0,
-                data_points: 0,
-                last_update: 0,
-                recent_prices: vec![],
-            })),
+        let price_request = request.into_inner();
+        let pair_name = pair_or_default(price_request.pair.as_deref().unwrap_or(DEFAULT_PAIR));
+        let now = Utc::now().timestamp() as u64;
+
+        // 락 없이 마지막으로 발행된 스냅샷만 읽음 (제출 트래픽과 독립)
+        let response = match self.registry.lookup_pair(pair_name) {
+            Some(pair) => pair.snapshot.load().to_response(now),
+            None => AggregateSnapshot::empty(Arc::from(pair_name)).to_response(now),
+        };
+
+        Ok(Response::new(response))
+    }
+
+    /// 가격 이력 구간 조회
+    async fn get_price_history(
+        &self,
+        request: Request<PriceHistoryRequest>,
+    ) -> Result<Response<PriceHistoryResponse>, Status> {
+        let history_request = request.into_inner();
+        let Some(history_db) = &self.history_db else {
+            return Err(Status::unavailable("Price history is not persisted"));
+        };
+        if history_request.from_timestamp > history_request.to_timestamp {
+            return Err(Status::invalid_argument(
+                "from_timestamp must not be after to_timestamp",
+            ));
         }
+
+        let pair = pair_or_default(&history_request.pair).to_string();
+        let limit = history_request
+            .limit
+            .map(|limit| limit as usize)
+            .filter(|&limit| limit > 0)
+            .unwrap_or(MAX_HISTORY_POINTS)
+            .min(MAX_HISTORY_POINTS);
+
+        // RocksDB 읽기는 블로킹 - 런타임 워커를 막지 않도록 분리
+        let history_db = Arc::clone(history_db);
+        let query_pair = pair.clone();
+        let range = tokio::task::spawn_blocking(move || {
+            history_db.range(
+                &query_pair,
+                history_request.source.as_deref(),
+                history_request.from_timestamp,
+                history_request.to_timestamp,
+                limit,
+            )
+        })
+        .await
+        .map_err(|e| Status::internal(e.to_string()))?
+        .map_err(|e| Status::internal(format!("Failed to read price history: {}", e)))?;
+
+        Ok(Response::new(PriceHistoryResponse {
+            success: true,
+            pair,
+            points: range
+                .records
+                .into_iter()
+                .map(history_to_data_point)
+                .collect(),
+            truncated: range.truncated,
+        }))
     }
 
     /// 설정 업데이트 (미구현)
@@ -324,30 +1021,184 @@ impl OracleService for AggregatorService {
         }))
     }
 
-    /// 스트림 처리 (미구현)
+    /// 실시간 가격 스트림 (양방향)
+    ///
+    /// 클라이언트 스트림으로 들어오는 가격은 SubmitPrice와 같은 경로로 수집하고,
+    /// 합의된 집계 가격은 모든 구독자에게 브로드캐스트한다.
     async fn stream_prices(
         &self,
-        _request: Request<tonic::Streaming<PriceRequest>>,
+        request: Request<tonic::Streaming<PriceRequest>>,
     ) -> Result<Response<Self::StreamPricesStream>, Status> {
-        Err(Status::unimplemented("Stream prices not implemented yet"))
+        let mut inbound = request.into_inner();
+
+        // 수신 측: 연결이 유지되는 동안 가격 수집
+        let service = self.clone();
+        tokio::spawn(async move {
+            loop {
+                match inbound.message().await {
+                    Ok(Some(price_request)) => {
+                        let response = service.ingest_price(price_request);
+                        if !response.success {
+                            warn!("❌ Stream price rejected: {}", response.message);
+                        }
+                    }
+                    Ok(None) => break,
+                    Err(status) => {
+                        warn!("❌ Price stream error: {}", status);
+                        break;
+                    }
+                }
+            }
+        });
+
+        // 송신 측: 구독자별 제한된 버퍼
+        let outbound = ReceiverStream::new(self.spawn_subscriber());
+        info!(
+            "📡 New price stream subscriber (total: {})",
+            self.updates.receiver_count()
+        );
+
+        Ok(Response::new(Box::pin(outbound) as Self::StreamPricesStream))
     }
 }
 
+/// Aggregator CLI 인수
+#[derive(Parser)]
+#[command(name = "aggregator")]
+#[command(about = "BTCFi Oracle price aggregator")]
+struct Args {
+    /// 가격 이력 저장소 경로 (RocksDB)
+    #[arg(long, default_value = "./data/aggregator")]
+    db_path: String,
+
+    /// 가격 이력을 저장하지 않고 메모리에만 보관
+    #[arg(long)]
+    no_history: bool,
+
+    /// 허용할 노드 키 (`노드ID=공개키`, 쉼표 구분) - `--allow-tofu` 없이는 필수
+    ///
+    /// 각 키는 묶인 노드 ID로만 제출할 수 있다. 공개키(x-only hex)만 주면 노드 기본 ID
+    /// (`oracle-node-<공개키 앞 8자>`)에 묶이고, 노드 ID 끝의 `*`는 접두사 일치.
+    #[arg(long, value_delimiter = ',')]
+    trusted_keys: Vec<String>,
+
+    /// 신뢰 키 목록 없이 노드 ID별 첫 키를 고정 (개발용 - 누구나 새 노드 ID를 고정할 수 있음)
+    #[arg(long)]
+    allow_tofu: bool,
+
+    /// 기본(BTC/USD, ETH/USD) 외에 수집할 자산 쌍 (쉼표 구분) - 목록에 없는 자산 쌍은 거부
+    #[arg(long, value_delimiter = ',')]
+    pairs: Vec<String>,
+
+    /// gRPC 수신 주소
+    #[arg(long, default_value = "0.0.0.0:50051")]
+    listen: String,
+
+    /// 클러스터 가십 수신 주소 (host:port 또는 multiaddr) - 없으면 단독 실행
+    #[arg(long)]
+    cluster_listen: Option<String>,
+
+    /// 클러스터 피어 주소 (host:port 또는 multiaddr, 쉼표 구분)
+    #[arg(long, value_delimiter = ',')]
+    peers: Vec<String>,
+
+    /// 최대 클러스터 피어 연결 수
+    #[arg(long, default_value = "50")]
+    max_peers: usize,
+
+    /// Prometheus 지표 엔드포인트 주소 (예: 0.0.0.0:9100, 없으면 비활성)
+    #[arg(long)]
+    metrics_listen: Option<SocketAddr>,
+}
+
 #[tokio::main]
 async fn main() -> Result<()> {
+    let args = Args::parse();
+
     // 로깅 초기화
     tracing_subscriber::fmt::init();
 
-    info!("🚀 Starting gRPC Aggregator on port 50051...");
+    info!("🚀 Starting gRPC Aggregator on {}...", args.listen);
 
-    let addr = "0.0.0.0:50051".parse().unwrap();
-    let aggregator_service = AggregatorService::new();
+    if let Some(metrics_addr) = args.metrics_listen {
+        tokio::spawn(async move {
+            if let Err(e) = metrics::serve(metrics_addr).await {
+                warn!("❌ Metrics endpoint stopped: {}", e);
+            }
+        });
+    }
+
+    let addr = args
+        .listen
+        .parse()
+        .map_err(|e| anyhow::anyhow!("Invalid listen address {}: {}", args.listen, e))?;
+    let aggregator_service = if args.no_history {
+        AggregatorService::new().with_pairs(args.pairs.iter().map(String::as_str))
+    } else {
+        let config = DatabaseConfig {
+            path: args.db_path,
+            ..DatabaseConfig::default()
+        };
+        let service = AggregatorService::with_history(Arc::new(PriceHistoryDb::open(&config)?))?
+            .with_pairs(args.pairs.iter().map(String::as_str));
+        let restored = service.restore_from_history(Utc::now().timestamp() as u64)?;
+        info!("💾 Restored {} price points from {}", restored, config.path);
+        service
+    };
+    let aggregator_service = if args.trusted_keys.is_empty() {
+        if !args.allow_tofu {
+            anyhow::bail!(
+                "--trusted-keys is required (pass --allow-tofu to pin the first key of each node instead)"
+            );
+        }
+        warn!("🔓 No trusted keys: pinning the first verified key of each node (development only)");
+        aggregator_service
+    } else {
+        let keys = args
+            .trusted_keys
+            .iter()
+            .map(|entry| {
+                auth::parse_trusted_key(entry)
+                    .map_err(|e| anyhow::anyhow!("Invalid trusted key {}: {}", entry, e))
+            })
+            .collect::<Result<Vec<_>>>()?;
+        info!("🔒 Accepting submissions from {} trusted keys", keys.len());
+        aggregator_service.with_trusted_keys(keys)
+    };
+
+    // 클러스터: 피어가 가십한 제출을 로컬 합의에 반영
+    let aggregator_service = match args.cluster_listen {
+        Some(listen_address) => {
+            let config = NetworkConfig {
+                listen_address,
+                bootstrap_peers: args.peers,
+                max_peers: args.max_peers,
+                ..NetworkConfig::default()
+            };
+            let (cluster, mut gossiped) = cluster::join(&config)?;
+            let service = aggregator_service.with_cluster(cluster);
+            let peer_service = service.clone();
+            tokio::spawn(async move {
+                while let Some(batch) = gossiped.recv().await {
+                    peer_service.ingest_peer_batch(batch);
+                }
+            });
+            service
+        }
+        None => {
+            info!("🧍 Running without an aggregator cluster");
+            aggregator_service
+        }
+    };
 
     info!("🔗 gRPC Aggregator listening on {}", addr);
     info!("📋 Available gRPC methods:");
     info!("   - SubmitPrice: 가격 데이터 제출");
+    info!("   - SubmitPriceBatch: 가격 데이터 일괄 제출");
     info!("   - HealthCheck: 상태체크");
     info!("   - GetAggregatedPrice: 집계 가격 조회");
+    info!("   - GetPriceHistory: 가격 이력 구간 조회");
+    info!("   - StreamPrices: 실시간 집계 가격 스트림");
 
     Server::builder()
         .add_service(OracleServiceServer::new(aggregator_service))
@@ -356,3 +1207,331 @@ async fn main() -> Result<()> {
 
     Ok(())
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use oracle_vm_common::crypto::{generate_signing_keypair, sign_schnorr, Keypair};
+
+    fn point(pair: &str, source: &str, price: Option<Price>, timestamp: u64) -> PricePoint {
+        PricePoint {
+            price: price.map(FixedPrice::from),
+            timestamp,
+            source: source.to_string(),
+            pair: pair.to_string(),
+            volume: None,
+        }
+    }
+
+    /// 노드와 같은 방식으로 배치 전체에 서명 (가격이 없는 항목은 0으로 다이제스트)
+    fn signed_batch(
+        keypair: &Keypair,
+        node_id: &str,
+        prices: Vec<PricePoint>,
+    ) -> PriceBatchRequest {
+        let mut digest = SubmissionDigest::new(node_id);
+        for point in &prices {
+            digest.push(
+                &point.pair,
+                &point.source,
+                point
+                    .price
+                    .as_ref()
+                    .and_then(FixedPrice::to_price)
+                    .unwrap_or_default(),
+                point.timestamp,
+                point.volume,
+            );
+        }
+        PriceBatchRequest {
+            node_id: node_id.to_string(),
+            prices,
+            signature: Some(sign_schnorr(&digest.finalize(), keypair).to_string()),
+            public_key: Some(keypair.x_only_public_key().0.to_string()),
+        }
+    }
+
+    fn now() -> u64 {
+        Utc::now().timestamp() as u64
+    }
+
+    #[test]
+    fn test_batch_rejects_only_invalid_points() {
+        let service = AggregatorService::new();
+        let keypair = generate_signing_keypair();
+        let now = now();
+        let batch = signed_batch(
+            &keypair,
+            "oracle-node-1",
+            vec![
+                point("BTC/USD", "binance", Some(Price::from_units(70_000)), now),
+                point("BTC/USD", "coinbase", Some(Price::from_units(-1)), now),
+                point("BTC/USD", "kraken", None, now),
+                point(
+                    "BTC/USD",
+                    "kraken",
+                    Some(Price::from_units(70_010)),
+                    now - 600,
+                ),
+                point("BTC/USD", "coinbase", Some(Price::from_units(70_020)), now),
+            ],
+        );
+
+        let response = service.apply_batch(&batch, now - FRESHNESS_WINDOW_SECS);
+        assert!(response.success);
+        assert_eq!((response.accepted, response.rejected), (2, 3));
+
+        // 유효한 두 거래소만 반영 - 2/3 정족수로 합의
+        let pair = service.registry.lookup_pair("BTC/USD").unwrap();
+        let snapshot = pair.snapshot.load();
+        assert_eq!(snapshot.sources.len(), 2);
+        assert!(snapshot.aggregated_price.is_some());
+        assert_eq!(
+            response.aggregated_price,
+            snapshot.aggregated_price.map(Price::to_f64)
+        );
+    }
+
+    #[test]
+    fn test_batch_without_valid_points_fails() {
+        let service = AggregatorService::new();
+        let keypair = generate_signing_keypair();
+        let now = now();
+        let batch = signed_batch(
+            &keypair,
+            "oracle-node-1",
+            vec![
+                point("BTC/USD", "binance", None, now),
+                point("BTC/USD", "kraken", Some(Price::ZERO), now),
+            ],
+        );
+
+        let response = service.ingest_batch(batch);
+        assert!(!response.success);
+        assert_eq!((response.accepted, response.rejected), (0, 2));
+        assert!(service
+            .registry
+            .lookup_pair("BTC/USD")
+            .unwrap()
+            .snapshot
+            .load()
+            .sources
+            .is_empty());
+    }
+
+    #[test]
+    fn test_batch_with_bad_signature_rejects_everything() {
+        let service = AggregatorService::new();
+        let keypair = generate_signing_keypair();
+        let now = now();
+        let mut batch = signed_batch(
+            &keypair,
+            "oracle-node-1",
+            vec![point(
+                "BTC/USD",
+                "binance",
+                Some(Price::from_units(70_000)),
+                now,
+            )],
+        );
+        // 서명 후 내용 변경
+        batch.prices[0].price = Some(Price::from_units(80_000).into());
+
+        let response = service.ingest_batch(batch);
+        assert!(!response.success);
+        assert_eq!((response.accepted, response.rejected), (0, 1));
+        // 검증에 실패한 노드 ID는 등록되지 않음
+        assert!(service.registry.lookup_node("oracle-node-1").is_none());
+    }
+
+    #[test]
+    fn test_direct_submissions_reject_stale_prices() {
+        let service = AggregatorService::new();
+        let keypair = generate_signing_keypair();
+        let stale = now() - FRESHNESS_WINDOW_SECS - 60;
+
+        let batch = signed_batch(
+            &keypair,
+            "oracle-node-1",
+            vec![point(
+                "BTC/USD",
+                "binance",
+                Some(Price::from_units(70_000)),
+                stale,
+            )],
+        );
+        let response = service.ingest_batch(batch);
+        assert!(!response.success);
+        assert_eq!((response.accepted, response.rejected), (0, 1));
+
+        // 단건 제출도 같은 기준
+        let price = Price::from_units(70_000);
+        let mut digest = SubmissionDigest::new("oracle-node-1");
+        digest.push("BTC/USD", "binance", price, stale, None);
+        let response = service.ingest_price(PriceRequest {
+            timestamp: stale,
+            source: "binance".to_string(),
+            node_id: "oracle-node-1".to_string(),
+            signature: Some(sign_schnorr(&digest.finalize(), &keypair).to_string()),
+            pair: "BTC/USD".to_string(),
+            volume: None,
+            public_key: Some(keypair.x_only_public_key().0.to_string()),
+            price: Some(price.into()),
+        });
+        assert!(!response.success);
+        assert_eq!(response.message, "Price is too old");
+        assert!(service
+            .registry
+            .lookup_pair("BTC/USD")
+            .unwrap()
+            .snapshot
+            .load()
+            .sources
+            .is_empty());
+    }
+
+    #[test]
+    fn test_replayed_submissions_are_rejected() {
+        let service = AggregatorService::new();
+        let keypair = generate_signing_keypair();
+        let now = now();
+        let batch = signed_batch(
+            &keypair,
+            "oracle-node-1",
+            vec![point(
+                "BTC/USD",
+                "binance",
+                Some(Price::from_units(70_000)),
+                now - 30,
+            )],
+        );
+        assert!(service.ingest_batch(batch.clone()).success);
+
+        // 유효 시간 안에 같은 서명 배치를 다시 보내도 반영되지 않음
+        let response = service.ingest_batch(batch);
+        assert!(!response.success);
+        assert_eq!((response.accepted, response.rejected), (0, 1));
+
+        // 단건 제출로 같은 가격을 다시 보내거나 더 오래된 가격을 보내도 거부
+        for (price, timestamp) in [(70_000, now - 30), (71_000, now - 40)] {
+            let price = Price::from_units(price);
+            let mut digest = SubmissionDigest::new("oracle-node-1");
+            digest.push("BTC/USD", "binance", price, timestamp, None);
+            let response = service.ingest_price(PriceRequest {
+                timestamp,
+                source: "binance".to_string(),
+                node_id: "oracle-node-1".to_string(),
+                signature: Some(sign_schnorr(&digest.finalize(), &keypair).to_string()),
+                pair: "BTC/USD".to_string(),
+                volume: None,
+                public_key: Some(keypair.x_only_public_key().0.to_string()),
+                price: Some(price.into()),
+            });
+            assert!(!response.success);
+            assert_eq!(
+                response.message,
+                "Price is not newer than the last accepted submission"
+            );
+        }
+
+        // 최신값 슬롯은 처음 받은 제출 그대로
+        let pair = service.registry.lookup_pair("BTC/USD").unwrap();
+        let latest = *pair
+            .consensus
+            .lock()
+            .unwrap()
+            .latest_for(service.registry.source_id("binance").unwrap())
+            .unwrap();
+        assert_eq!(
+            (latest.price, latest.timestamp),
+            (Price::from_units(70_000), now - 30)
+        );
+
+        // 더 새 가격은 허용
+        let batch = signed_batch(
+            &keypair,
+            "oracle-node-1",
+            vec![point(
+                "BTC/USD",
+                "binance",
+                Some(Price::from_units(70_100)),
+                now,
+            )],
+        );
+        assert_eq!(service.ingest_batch(batch).accepted, 1);
+    }
+
+    #[test]
+    fn test_unknown_pairs_and_sources_are_not_registered() {
+        let service = AggregatorService::new();
+        let keypair = generate_signing_keypair();
+        let now = now();
+        let batch = signed_batch(
+            &keypair,
+            "oracle-node-1",
+            vec![
+                point("BTC/USD", "binance", Some(Price::from_units(70_000)), now),
+                point("DOGE/USD", "binance", Some(Price::from_units(1)), now),
+                point(
+                    "BTC/USD",
+                    "exchange-1",
+                    Some(Price::from_units(70_000)),
+                    now,
+                ),
+            ],
+        );
+
+        let response = service.ingest_batch(batch);
+        assert_eq!((response.accepted, response.rejected), (1, 2));
+        assert!(service.registry.lookup_pair("DOGE/USD").is_none());
+        assert!(service.registry.source_id("exchange-1").is_none());
+        assert_eq!(service.registry.pairs().len(), DEFAULT_PAIRS.len());
+
+        // 설정에 추가한 자산 쌍만 허용
+        let service = AggregatorService::new().with_pairs(["SOL/USD"]);
+        assert!(service.registry.lookup_pair("SOL/USD").is_some());
+    }
+
+    #[test]
+    fn test_batch_computes_consensus_once_per_pair() {
+        let service = AggregatorService::new();
+        let mut updates = service.updates.subscribe();
+        let keypair = generate_signing_keypair();
+        let now = now();
+        let mut prices = Vec::new();
+        for (index, source) in REQUIRED_EXCHANGES.iter().enumerate() {
+            let offset = index as i64 * 10;
+            prices.push(point(
+                "BTC/USD",
+                source,
+                Some(Price::from_units(70_000 + offset)),
+                now,
+            ));
+            prices.push(point(
+                "ETH/USD",
+                source,
+                Some(Price::from_units(3_500 + offset)),
+                now,
+            ));
+        }
+
+        let response = service.ingest_batch(signed_batch(&keypair, "oracle-node-1", prices));
+        assert!(response.success);
+        assert_eq!((response.accepted, response.rejected), (6, 0));
+        // 응답은 배치의 첫 자산 쌍 기준
+        assert_eq!(response.aggregated_price, Some(70_010.0));
+
+        // 자산 쌍마다 모든 가격을 반영한 뒤 한 번씩만 합의 - 업데이트도 자산 쌍당 하나
+        let mut published: Vec<(String, f64)> = std::iter::from_fn(|| updates.try_recv().ok())
+            .map(|update| (update.pair, update.aggregated_price))
+            .collect();
+        published.sort_by(|a, b| a.0.cmp(&b.0));
+        assert_eq!(
+            published,
+            vec![
+                ("BTC/USD".to_string(), 70_010.0),
+                ("ETH/USD".to_string(), 3_510.0)
+            ]
+        );
+    }
+}
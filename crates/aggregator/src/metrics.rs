@@ -0,0 +1,92 @@
+//! Prometheus 지표
+//!
+//! - `aggregator_ingest_seconds{origin}`: 제출 처리 시간 (`single` / `batch` / `peer`)
+//! - `aggregator_consensus_seconds{pair}`: 합의 계산 시간
+//! - `aggregator_consensus_failures_total{reason}`: 합의 실패
+//!   (`insufficient_sources` / `timestamp_skew` / `no_quorum` / `out_of_bounds`)
+//! - `aggregator_rejected_prices_total{reason}`: 거부된 제출
+//!   (`signature` / `invalid_price` / `stale` / `replay` / `unknown_pair` / `unknown_source`)
+//! - `aggregator_history_dropped_total`: 쓰기 큐가 가득 차 저장하지 못한 가격
+//!
+//! `pair` 레이블은 시작 시 설정한 자산 쌍만 가지므로 카디널리티가 고정된다.
+
+use anyhow::{Context, Result};
+use axum::http::header;
+use axum::routing::get;
+use axum::Router;
+use oracle_vm_common::metrics::{self, HistogramVec, IntCounterVec};
+use std::net::SocketAddr;
+use std::sync::LazyLock;
+use tracing::info;
+
+pub static INGEST_SECONDS: LazyLock<HistogramVec> = LazyLock::new(|| {
+    metrics::latency_histogram(
+        "aggregator_ingest_seconds",
+        "Submission handling latency",
+        &["origin"],
+    )
+});
+
+pub static CONSENSUS_SECONDS: LazyLock<HistogramVec> = LazyLock::new(|| {
+    metrics::latency_histogram(
+        "aggregator_consensus_seconds",
+        "Consensus evaluation latency",
+        &["pair"],
+    )
+});
+
+pub static CONSENSUS_FAILURES: LazyLock<IntCounterVec> = LazyLock::new(|| {
+    metrics::counter(
+        "aggregator_consensus_failures_total",
+        "Consensus evaluations that produced no price",
+        &["reason"],
+    )
+});
+
+pub static REJECTED_PRICES: LazyLock<IntCounterVec> = LazyLock::new(|| {
+    metrics::counter(
+        "aggregator_rejected_prices_total",
+        "Submitted prices rejected before consensus",
+        &["reason"],
+    )
+});
+
+pub static HISTORY_DROPPED: LazyLock<IntCounterVec> = LazyLock::new(|| {
+    metrics::counter(
+        "aggregator_history_dropped_total",
+        "Accepted prices dropped because the history writer queue was full",
+        &[],
+    )
+});
+
+pub fn consensus_failed(reason: &str) {
+    CONSENSUS_FAILURES.with_label_values(&[reason]).inc();
+}
+
+pub fn rejected(reason: &str, count: u64) {
+    REJECTED_PRICES.with_label_values(&[reason]).inc_by(count);
+}
+
+pub fn history_dropped(count: u64) {
+    HISTORY_DROPPED.with_label_values(&[]).inc_by(count);
+}
+
+/// `/metrics` 엔드포인트 실행
+pub async fn serve(addr: SocketAddr) -> Result<()> {
+    let app = Router::new().route(
+        "/metrics",
+        get(|| async {
+            (
+                [(header::CONTENT_TYPE, metrics::CONTENT_TYPE)],
+                metrics::render(),
+            )
+        }),
+    );
+    let listener = tokio::net::TcpListener::bind(addr)
+        .await
+        .with_context(|| format!("Failed to bind metrics listener on {}", addr))?;
+
+    info!("📈 Metrics listening on http://{}/metrics", addr);
+    axum::serve(listener, app).await?;
+    Ok(())
+}
@@ -0,0 +1,258 @@
+//! 자산 쌍/거래소/노드 식별자 관리
+//!
+//! 요청에 들어온 문자열은 여기서 한 번만 인턴되고, 이후 수집/합의 경로는 정수 ID만 사용한다.
+//! 자산 쌍별 상태는 `PairId`로 인덱싱되는 테이블에 있으며, 테이블은 새 자산 쌍이
+//! 등록될 때만 교체되므로 조회는 락 없이 이루어진다.
+//!
+//! 자산 쌍과 거래소는 시작할 때 설정한 것만 등록한다. 요청 경로는 조회만 하므로
+//! 클라이언트가 보낸 이름으로 테이블이나 지표 레이블이 늘어나지 않는다.
+//!
+//! 노드마다 마지막으로 확인된 시각을 원자 변수로 두므로, 헬스체크와 제출 경로는
+//! 이름 테이블 읽기 락만 잡고 활성 시각을 갱신한다.
+
+use crate::indicators::MarketIndicators;
+use crate::snapshot::AggregateSnapshot;
+use crate::store::{ConsensusState, HistoryStore};
+use arc_swap::ArcSwap;
+use oracle_vm_common::intern::{InternId, Interner, NodeKey, PairId, SourceId};
+use oracle_vm_common::Price;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, Mutex, RwLock, RwLockReadGuard};
+
+/// 자산 쌍별 가격 상식선 (USD) - 정의되지 않은 자산 쌍은 범위 검증 생략
+const PRICE_BOUNDS: [(&str, Price, Price); 2] = [
+    (
+        "BTC/USD",
+        Price::from_units(10_000),
+        Price::from_units(500_000),
+    ),
+    ("ETH/USD", Price::from_units(100), Price::from_units(50_000)),
+];
+
+/// 자산 쌍 하나의 수집/합의 상태
+pub struct PairState {
+    pub id: PairId,
+    pub name: Arc<str>,
+    /// 집계 가격 허용 범위 (min, max)
+    pub bounds: Option<(Price, Price)>,
+    /// 거래소별 이력 (거래소 ID로 샤딩)
+    pub history: HistoryStore,
+    /// 거래소별 최신값 슬롯 (쓰기 경로 전용)
+    pub consensus: Mutex<ConsensusState>,
+    /// TWAP/VWAP/실현 변동성 - `consensus` 락을 잡은 상태에서만 잠금
+    pub indicators: Mutex<MarketIndicators>,
+    /// 마지막 집계 결과 - 읽기 경로는 락 없이 로드
+    pub snapshot: ArcSwap<AggregateSnapshot>,
+}
+
+impl PairState {
+    fn new(id: PairId, name: Arc<str>) -> Self {
+        Self {
+            id,
+            snapshot: ArcSwap::from_pointee(AggregateSnapshot::empty(Arc::clone(&name))),
+            bounds: PRICE_BOUNDS
+                .iter()
+                .find(|(pair, _, _)| **pair == *name)
+                .map(|&(_, min, max)| (min, max)),
+            name,
+            history: HistoryStore::new(),
+            consensus: Mutex::new(ConsensusState::new()),
+            indicators: Mutex::new(MarketIndicators::new()),
+        }
+    }
+}
+
+/// 자산 쌍 테이블 (불변, 등록 시 복사 후 교체)
+#[derive(Default)]
+struct PairTable {
+    names: Interner<PairId>,
+    /// `PairId`로 인덱싱
+    states: Vec<Arc<PairState>>,
+}
+
+/// 거래소/노드 이름 테이블
+#[derive(Default)]
+pub struct Symbols {
+    sources: Interner<SourceId>,
+    nodes: Interner<NodeKey>,
+    /// 노드별 마지막 확인 시각 (unix 초, `NodeKey`로 인덱싱)
+    node_seen: Vec<AtomicU64>,
+}
+
+impl Symbols {
+    pub fn source(&self, id: SourceId) -> &str {
+        self.sources.resolve(id)
+    }
+
+    pub fn node(&self, id: NodeKey) -> &str {
+        self.nodes.resolve(id)
+    }
+
+    /// `now` 기준 `window`초 안에 확인된 노드 (ID 순)
+    pub fn active_nodes(&self, now: u64, window: u64) -> impl Iterator<Item = (NodeKey, &str)> {
+        self.nodes.iter().filter(move |(id, _)| {
+            let seen = self.node_seen[id.index()].load(Ordering::Relaxed);
+            seen != 0 && now.saturating_sub(seen) <= window
+        })
+    }
+}
+
+/// 식별자 레지스트리
+#[derive(Default)]
+pub struct Registry {
+    symbols: RwLock<Symbols>,
+    pairs: ArcSwap<PairTable>,
+    /// 자산 쌍 등록 직렬화
+    register_lock: Mutex<()>,
+}
+
+impl Registry {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// 자산 쌍 등록 (시작 시 설정용) - 이미 등록된 자산 쌍이면 기존 상태
+    pub fn register_pair(&self, name: &str) -> Arc<PairState> {
+        if let Some(state) = self.lookup_pair(name) {
+            return state;
+        }
+
+        let _guard = self.register_lock.lock().unwrap();
+        let current = self.pairs.load();
+        if let Some(id) = current.names.get(name) {
+            return Arc::clone(&current.states[id.index()]);
+        }
+
+        let mut names = current.names.clone();
+        let id = names.intern(name);
+        let state = Arc::new(PairState::new(id, names.resolve_shared(id)));
+        let mut states = current.states.clone();
+        states.push(Arc::clone(&state));
+        self.pairs.store(Arc::new(PairTable { names, states }));
+
+        state
+    }
+
+    /// 등록된 자산 쌍 조회 (락 없음, 등록하지 않음)
+    pub fn lookup_pair(&self, name: &str) -> Option<Arc<PairState>> {
+        let table = self.pairs.load();
+        table
+            .names
+            .get(name)
+            .map(|id| Arc::clone(&table.states[id.index()]))
+    }
+
+    /// 등록된 모든 자산 쌍 (ID 순)
+    pub fn pairs(&self) -> Vec<Arc<PairState>> {
+        self.pairs.load().states.clone()
+    }
+
+    /// 거래소 등록 (시작 시 설정용)
+    pub fn register_source(&self, name: &str) -> SourceId {
+        if let Some(id) = self.source_id(name) {
+            return id;
+        }
+        self.symbols.write().unwrap().sources.intern(name)
+    }
+
+    /// 등록된 거래소 ID 조회 (등록하지 않음)
+    pub fn source_id(&self, name: &str) -> Option<SourceId> {
+        self.symbols.read().unwrap().sources.get(name)
+    }
+
+    /// 노드 ID - 이미 등록된 이름은 읽기 락만 사용
+    pub fn node_key(&self, name: &str) -> NodeKey {
+        if let Some(id) = self.symbols.read().unwrap().nodes.get(name) {
+            return id;
+        }
+        let mut symbols = self.symbols.write().unwrap();
+        let id = symbols.nodes.intern(name);
+        if symbols.node_seen.len() <= id.index() {
+            symbols.node_seen.push(AtomicU64::new(0));
+        }
+        id
+    }
+
+    /// 노드 활성 시각 기록 (읽기 락 + 원자 변수, 더 이른 시각으로는 되돌리지 않음)
+    pub fn mark_node_seen(&self, node: NodeKey, now: u64) {
+        self.symbols.read().unwrap().node_seen[node.index()].fetch_max(now, Ordering::Relaxed);
+    }
+
+    /// `now` 기준 `window`초 안에 확인된 노드 수
+    pub fn active_node_count(&self, now: u64, window: u64) -> usize {
+        self.symbols
+            .read()
+            .unwrap()
+            .active_nodes(now, window)
+            .count()
+    }
+
+    /// 등록된 노드 ID 조회 (등록하지 않음)
+    pub fn lookup_node(&self, name: &str) -> Option<NodeKey> {
+        self.symbols.read().unwrap().nodes.get(name)
+    }
+
+    /// 이름 테이블 읽기 (응답/로그용 이름 변환)
+    pub fn symbols(&self) -> RwLockReadGuard<'_, Symbols> {
+        self.symbols.read().unwrap()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_pairs_registered_once_and_indexed_by_id() {
+        let registry = Registry::new();
+
+        let btc = registry.register_pair("BTC/USD");
+        let eth = registry.register_pair("ETH/USD");
+        assert_eq!(btc.id, PairId(0));
+        assert_eq!(eth.id, PairId(1));
+        assert!(Arc::ptr_eq(&registry.register_pair("BTC/USD"), &btc));
+        assert!(Arc::ptr_eq(&registry.lookup_pair("BTC/USD").unwrap(), &btc));
+
+        assert!(registry.lookup_pair("SOL/USD").is_none());
+        assert_eq!(registry.pairs().len(), 2);
+        assert_eq!(&*eth.name, "ETH/USD");
+    }
+
+    #[test]
+    fn test_source_and_node_ids_resolve_back() {
+        let registry = Registry::new();
+
+        let binance = registry.register_source("binance");
+        let node = registry.node_key("oracle-node-1");
+        assert_eq!(registry.source_id("binance"), Some(binance));
+        assert_eq!(registry.source_id("bithumb"), None);
+        assert_eq!(registry.lookup_node("oracle-node-1"), Some(node));
+        assert_eq!(registry.lookup_node("oracle-node-2"), None);
+
+        let symbols = registry.symbols();
+        assert_eq!(symbols.source(binance), "binance");
+        assert_eq!(symbols.node(node), "oracle-node-1");
+    }
+
+    #[test]
+    fn test_active_nodes_expire_after_window() {
+        let registry = Registry::new();
+        let first = registry.node_key("oracle-node-1");
+        let second = registry.node_key("oracle-node-2");
+        // 등록만 되고 확인된 적 없는 노드는 활성이 아님
+        assert_eq!(registry.active_node_count(1_000, 120), 0);
+
+        registry.mark_node_seen(first, 1_000);
+        registry.mark_node_seen(second, 1_100);
+        // 늦게 도착한 이전 시각은 무시
+        registry.mark_node_seen(second, 900);
+        assert_eq!(registry.active_node_count(1_100, 120), 2);
+
+        let symbols = registry.symbols();
+        let active: Vec<&str> = symbols
+            .active_nodes(1_200, 120)
+            .map(|(_, name)| name)
+            .collect();
+        assert_eq!(active, vec!["oracle-node-2"]);
+    }
+}
@@ -0,0 +1,121 @@
+//! 집계 결과 스냅샷
+//!
+//! 쓰기 경로가 합의를 계산할 때마다 불변 스냅샷을 만들어 발행하고,
+//! 읽기 경로(GetAggregatedPrice 등)는 락 없이 최신 스냅샷 포인터만 읽는다 (RCU 방식).
+
+use crate::indicators::IndicatorValues;
+use crate::oracle::{GetPriceResponse, PriceDataPoint};
+use oracle_vm_common::Price;
+use std::sync::Arc;
+
+/// 자산 쌍 하나의 마지막 집계 결과 (발행 후 변경되지 않음)
+#[derive(Debug)]
+pub struct AggregateSnapshot {
+    /// 자산 쌍 이름
+    pub pair: Arc<str>,
+    /// 검증된 집계 가격 (합의 실패 시 None)
+    pub aggregated_price: Option<Price>,
+    /// 보관 중인 데이터 포인트 수
+    pub data_points: u32,
+    /// 마지막 데이터 수신 시각
+    pub last_update: u64,
+    /// 이 시각이 지나면 참여 거래소 데이터가 만료되어 집계 가격을 사용할 수 없음
+    pub valid_until: u64,
+    /// 최근 수신 데이터 (최신순)
+    pub recent_prices: Vec<PriceDataPoint>,
+    /// 거래소별 최신 데이터
+    pub sources: Vec<PriceDataPoint>,
+    /// 스트리밍 시장 지표 (TWAP/VWAP/실현 변동성)
+    pub indicators: IndicatorValues,
+}
+
+impl AggregateSnapshot {
+    /// 아직 집계된 적 없는 자산 쌍
+    pub fn empty(pair: Arc<str>) -> Self {
+        Self {
+            pair,
+            aggregated_price: None,
+            data_points: 0,
+            last_update: 0,
+            valid_until: 0,
+            recent_prices: vec![],
+            sources: vec![],
+            indicators: IndicatorValues::default(),
+        }
+    }
+
+    /// 주어진 시각에 유효한 집계 가격
+    pub fn price_at(&self, now: u64) -> Option<Price> {
+        self.aggregated_price.filter(|_| now <= self.valid_until)
+    }
+
+    /// GetAggregatedPrice 응답으로 변환
+    pub fn to_response(&self, now: u64) -> GetPriceResponse {
+        match self.price_at(now) {
+            Some(price) => GetPriceResponse {
+                success: true,
+                aggregated_price: price.to_f64(),
+                aggregated_price_fixed: Some(price.into()),
+                data_points: self.data_points,
+                last_update: self.last_update,
+                recent_prices: self.recent_prices.clone(),
+                pair: self.pair.to_string(),
+                twap: self.indicators.twap,
+                vwap: self.indicators.vwap,
+                realized_volatility: self.indicators.realized_volatility,
+                volume: self.indicators.volume,
+            },
+            None => GetPriceResponse {
+                success: false,
+                aggregated_price: 0.0,
+                aggregated_price_fixed: None,
+                data_points: 0,
+                last_update: 0,
+                recent_prices: vec![],
+                pair: self.pair.to_string(),
+                twap: None,
+                vwap: None,
+                realized_volatility: None,
+                volume: 0.0,
+            },
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_snapshot_expires() {
+        let snapshot = AggregateSnapshot {
+            pair: Arc::from("BTC/USD"),
+            aggregated_price: Some(Price::from_units(70_000)),
+            data_points: 3,
+            last_update: 1_000,
+            valid_until: 1_120,
+            recent_prices: vec![],
+            sources: vec![],
+            indicators: IndicatorValues::default(),
+        };
+
+        let response = snapshot.to_response(1_100);
+        assert!(response.success);
+        assert_eq!(response.aggregated_price, 70000.0);
+        assert_eq!(
+            response
+                .aggregated_price_fixed
+                .and_then(|fixed| fixed.to_price()),
+            Some(Price::from_units(70_000))
+        );
+        assert_eq!(snapshot.price_at(1_120), Some(Price::from_units(70_000)));
+        assert!(!snapshot.to_response(1_121).success);
+    }
+
+    #[test]
+    fn test_empty_snapshot_has_no_price() {
+        let snapshot = AggregateSnapshot::empty(Arc::from("ETH/USD"));
+        assert_eq!(snapshot.price_at(0), None);
+        assert_eq!(snapshot.to_response(0).pair, "ETH/USD");
+    }
+}
@@ -0,0 +1,402 @@
+//! 거래소별 가격 저장소 (자산 쌍 하나 기준)
+//!
+//! 쓰기 경로는 두 부분으로 나뉜다.
+//! - [`HistoryStore`]: 거래소(source)별 고정 크기 링 버퍼. 거래소 ID로 샤딩되어
+//!   서로 다른 거래소의 제출은 같은 락을 잡지 않는다.
+//! - [`ConsensusState`]: "거래소별 최신값" 슬롯. 거래소 ID로 인덱싱되며 제자리에서
+//!   갱신되고, 합의 계산은 전체 이력이 아닌 거래소 수에만 비례한다. 노드/거래소별로
+//!   마지막으로 받은 제출도 기억해 재전송된 서명 제출을 거른다.
+//!
+//! 거래소/노드는 문자열 대신 인턴된 ID로 저장되므로 항목 하나는 힙 할당 없는 `Copy` 값이다.
+//! 읽기 경로는 이 구조체들을 건드리지 않고 발행된 스냅샷만 읽는다 (`snapshot` 모듈).
+
+use oracle_vm_common::intern::{InternId, NodeKey, SourceId};
+use oracle_vm_common::Price;
+use std::collections::HashMap;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::Mutex;
+
+/// 거래소별 보관할 이력 개수
+pub const HISTORY_PER_SOURCE: usize = 100;
+/// 조회 응답에 포함할 최근 데이터 개수
+pub const RECENT_PRICES: usize = 5;
+/// 이력 저장소 샤드 수
+const SHARD_COUNT: usize = 16;
+/// 마지막 제출 기록을 정리하기 시작하는 최소 항목 수
+const MIN_ACCEPTED_PRUNE: usize = 64;
+
+/// 가격 데이터 저장 구조체
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub struct StoredPriceData {
+    pub price: Price,
+    pub timestamp: u64,
+    pub source: SourceId,
+    pub node: NodeKey,
+    pub received_at: u64,
+    /// 캔들 거래량 (보고한 거래소만, VWAP용)
+    pub volume: Option<f64>,
+}
+
+/// 고정 용량 링 버퍼 (가득 차면 가장 오래된 항목을 덮어씀)
+#[derive(Debug)]
+pub struct RingBuffer<T> {
+    buf: Vec<T>,
+    capacity: usize,
+    /// 다음에 쓸 위치
+    head: usize,
+}
+
+impl<T> RingBuffer<T> {
+    pub fn with_capacity(capacity: usize) -> Self {
+        assert!(capacity > 0, "RingBuffer capacity must be positive");
+        Self {
+            buf: Vec::with_capacity(capacity),
+            capacity,
+            head: 0,
+        }
+    }
+
+    /// 항목 추가 - O(1), 원소 이동 없음
+    pub fn push(&mut self, item: T) {
+        if self.buf.len() < self.capacity {
+            self.buf.push(item);
+        } else {
+            self.buf[self.head] = item;
+        }
+        self.head = (self.head + 1) % self.capacity;
+    }
+
+    pub fn len(&self) -> usize {
+        self.buf.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.buf.is_empty()
+    }
+
+    pub fn is_full(&self) -> bool {
+        self.buf.len() == self.capacity
+    }
+
+    /// 가장 최근에 추가된 항목
+    pub fn latest(&self) -> Option<&T> {
+        if self.buf.is_empty() {
+            return None;
+        }
+        let idx = (self.head + self.capacity - 1) % self.capacity;
+        self.buf.get(idx)
+    }
+
+    /// 최신 항목부터 역순으로 순회
+    pub fn iter_recent(&self) -> impl Iterator<Item = &T> {
+        let len = self.buf.len();
+        let head = self.head;
+        (0..len).map(move |i| {
+            let idx = (head + len - 1 - i) % len;
+            &self.buf[idx]
+        })
+    }
+}
+
+/// 샤드 하나 - 샤드 내 거래소 순번으로 인덱싱 (`source / SHARD_COUNT`)
+type HistoryShard = Vec<Option<RingBuffer<StoredPriceData>>>;
+
+/// 거래소별 이력 저장소 (거래소 ID로 샤딩)
+#[derive(Debug)]
+pub struct HistoryStore {
+    shards: Box<[Mutex<HistoryShard>]>,
+    /// 보관 중인 전체 데이터 포인트 수
+    data_points: AtomicUsize,
+}
+
+impl HistoryStore {
+    pub fn new() -> Self {
+        Self {
+            shards: (0..SHARD_COUNT).map(|_| Mutex::new(Vec::new())).collect(),
+            data_points: AtomicUsize::new(0),
+        }
+    }
+
+    /// 거래소 ID -> (샤드, 샤드 내 위치)
+    fn locate(source: SourceId) -> (usize, usize) {
+        let index = source.index();
+        (index % SHARD_COUNT, index / SHARD_COUNT)
+    }
+
+    /// 가격 데이터 기록 - 해당 거래소 샤드만 잠금, O(1)
+    pub fn record(&self, data: StoredPriceData) {
+        let (shard, slot) = Self::locate(data.source);
+        let mut shard = self.shards[shard].lock().unwrap();
+        if shard.len() <= slot {
+            shard.resize_with(slot + 1, || None);
+        }
+
+        let history =
+            shard[slot].get_or_insert_with(|| RingBuffer::with_capacity(HISTORY_PER_SOURCE));
+        let grew = !history.is_full();
+        history.push(data);
+
+        if grew {
+            self.data_points.fetch_add(1, Ordering::Relaxed);
+        }
+    }
+
+    /// 특정 거래소의 이력 복사본 (최신순)
+    pub fn history_for(&self, source: SourceId) -> Vec<StoredPriceData> {
+        let (shard, slot) = Self::locate(source);
+        let shard = self.shards[shard].lock().unwrap();
+        shard
+            .get(slot)
+            .and_then(Option::as_ref)
+            .map(|history| history.iter_recent().copied().collect())
+            .unwrap_or_default()
+    }
+
+    /// 보관 중인 전체 데이터 포인트 수
+    pub fn data_points(&self) -> usize {
+        self.data_points.load(Ordering::Relaxed)
+    }
+}
+
+impl Default for HistoryStore {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// 노드/거래소별 마지막으로 받은 제출과 비교한 결과
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum Admission {
+    /// 마지막으로 받은 제출보다 새 가격
+    Fresh,
+    /// 이미 받은 제출과 같은 내용 (재전송)
+    Duplicate,
+    /// 마지막으로 받은 제출보다 새롭지 않은 다른 가격
+    NotNewer,
+}
+
+/// 합의 계산용 거래소별 최신값 슬롯 (쓰기 경로 전용)
+#[derive(Debug)]
+pub struct ConsensusState {
+    /// 거래소 ID로 인덱싱
+    latest: Vec<Option<StoredPriceData>>,
+    /// 전체 거래소 기준 최근 데이터 (조회 응답용)
+    recent: RingBuffer<StoredPriceData>,
+    /// (노드, 거래소)별 마지막으로 받은 제출 - 시각과 내용(가격, 거래량)으로 재전송 판별
+    accepted: HashMap<(NodeKey, SourceId), StoredPriceData>,
+    /// 이 항목 수에 도달하면 오래된 제출 기록을 정리
+    prune_at: usize,
+}
+
+impl ConsensusState {
+    pub fn new() -> Self {
+        Self {
+            latest: Vec::new(),
+            recent: RingBuffer::with_capacity(RECENT_PRICES),
+            accepted: HashMap::new(),
+            prune_at: MIN_ACCEPTED_PRUNE,
+        }
+    }
+
+    /// 노드/거래소별 마지막 제출보다 새 가격인지 확인하고, 새 가격이면 기록
+    ///
+    /// 같은 노드가 같은 거래소 가격을 다시 보내면 타임스탬프가 더 커야 한다. 따라서 유효 시간
+    /// 안에 서명된 제출을 재전송해도 최신값 슬롯이나 노드 활성 시각이 갱신되지 않는다.
+    /// `min_timestamp`보다 오래된 기록은 유효 시간 검사에서 이미 거부되므로 정리해도 된다.
+    pub fn admit(&mut self, data: &StoredPriceData, min_timestamp: u64) -> Admission {
+        let key = (data.node, data.source);
+        if let Some(last) = self.accepted.get(&key) {
+            if data.timestamp < last.timestamp {
+                return Admission::NotNewer;
+            }
+            if data.timestamp == last.timestamp {
+                let same = data.price == last.price && data.volume == last.volume;
+                return if same {
+                    Admission::Duplicate
+                } else {
+                    Admission::NotNewer
+                };
+            }
+        }
+
+        // 노드가 바뀌어도 기록이 쌓이지 않도록 크기가 두 배가 될 때마다 정리 (분할 상환 O(1))
+        if self.accepted.len() >= self.prune_at {
+            self.accepted
+                .retain(|_, last| last.timestamp >= min_timestamp);
+            self.prune_at = (self.accepted.len() * 2).max(MIN_ACCEPTED_PRUNE);
+        }
+        self.accepted.insert(key, *data);
+        Admission::Fresh
+    }
+
+    /// 최신값 슬롯 갱신 - 할당 없이 제자리에서 덮어씀
+    pub fn update(&mut self, data: StoredPriceData) {
+        self.recent.push(data);
+
+        let index = data.source.index();
+        if self.latest.len() <= index {
+            self.latest.resize(index + 1, None);
+        }
+
+        match &mut self.latest[index] {
+            // 늦게 도착한 과거 데이터는 최신값을 덮어쓰지 않음
+            Some(slot) if data.timestamp < slot.timestamp => {}
+            slot => *slot = Some(data),
+        }
+    }
+
+    /// 거래소별 최신값 순회 - O(거래소 수)
+    pub fn latest_per_source(&self) -> impl Iterator<Item = &StoredPriceData> {
+        self.latest.iter().flatten()
+    }
+
+    /// 특정 거래소의 최신값
+    pub fn latest_for(&self, source: SourceId) -> Option<&StoredPriceData> {
+        self.latest.get(source.index()).and_then(Option::as_ref)
+    }
+
+    /// 전체 거래소 기준 최근 데이터 (최신순)
+    pub fn recent(&self) -> impl Iterator<Item = &StoredPriceData> {
+        self.recent.iter_recent()
+    }
+
+    /// 가장 최근 수신 시각
+    pub fn last_received_at(&self) -> u64 {
+        self.recent
+            .latest()
+            .map(|data| data.received_at)
+            .unwrap_or(0)
+    }
+}
+
+impl Default for ConsensusState {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const BINANCE: SourceId = SourceId(0);
+    const COINBASE: SourceId = SourceId(1);
+    const KRAKEN: SourceId = SourceId(2);
+
+    fn sample(source: SourceId, price: i64, timestamp: u64) -> StoredPriceData {
+        StoredPriceData {
+            price: Price::from_units(price),
+            timestamp,
+            source,
+            node: NodeKey(0),
+            received_at: timestamp,
+            volume: None,
+        }
+    }
+
+    #[test]
+    fn test_ring_buffer_overwrites_oldest() {
+        let mut ring = RingBuffer::with_capacity(3);
+        for i in 0..5 {
+            ring.push(i);
+        }
+
+        assert_eq!(ring.len(), 3);
+        assert_eq!(ring.latest(), Some(&4));
+        let recent: Vec<i32> = ring.iter_recent().copied().collect();
+        assert_eq!(recent, vec![4, 3, 2]);
+    }
+
+    #[test]
+    fn test_latest_slot_updated_in_place() {
+        let mut state = ConsensusState::new();
+        state.update(sample(BINANCE, 70_000, 100));
+        state.update(sample(BINANCE, 70_100, 160));
+        // 늦게 도착한 과거 데이터는 최신값을 덮어쓰지 않음
+        state.update(sample(BINANCE, 69_000, 130));
+        state.update(sample(KRAKEN, 70_050, 160));
+
+        assert_eq!(state.latest_per_source().count(), 2);
+        assert_eq!(
+            state.latest_for(BINANCE).unwrap().price,
+            Price::from_units(70_100)
+        );
+        assert!(state.latest_for(COINBASE).is_none());
+        assert_eq!(state.last_received_at(), 160);
+    }
+
+    #[test]
+    fn test_replayed_submissions_are_not_admitted() {
+        let mut state = ConsensusState::new();
+        let first = sample(BINANCE, 70_000, 100);
+        assert_eq!(state.admit(&first, 0), Admission::Fresh);
+
+        // 같은 제출 재전송, 같은 시각의 다른 가격, 과거 가격은 모두 거부
+        assert_eq!(state.admit(&first, 0), Admission::Duplicate);
+        let conflicting = sample(BINANCE, 70_500, 100);
+        assert_eq!(state.admit(&conflicting, 0), Admission::NotNewer);
+        assert_eq!(
+            state.admit(&sample(BINANCE, 69_000, 90), 0),
+            Admission::NotNewer
+        );
+
+        // 다른 거래소, 다른 노드, 더 새 가격은 허용
+        assert_eq!(
+            state.admit(&sample(KRAKEN, 70_000, 100), 0),
+            Admission::Fresh
+        );
+        let other_node = StoredPriceData {
+            node: NodeKey(1),
+            ..first
+        };
+        assert_eq!(state.admit(&other_node, 0), Admission::Fresh);
+        assert_eq!(
+            state.admit(&sample(BINANCE, 70_100, 160), 0),
+            Admission::Fresh
+        );
+    }
+
+    #[test]
+    fn test_accepted_submissions_are_pruned() {
+        let mut state = ConsensusState::new();
+        for node in 0..(MIN_ACCEPTED_PRUNE as u32 * 4) {
+            let data = StoredPriceData {
+                node: NodeKey(node),
+                ..sample(BINANCE, 70_000, node as u64)
+            };
+            state.admit(&data, node as u64);
+        }
+
+        // 유효 시간이 지난 기록만 정리되어 크기가 제한됨
+        assert!(state.accepted.len() <= MIN_ACCEPTED_PRUNE * 2);
+        let newest = NodeKey(MIN_ACCEPTED_PRUNE as u32 * 4 - 1);
+        assert!(state.accepted.contains_key(&(newest, BINANCE)));
+    }
+
+    #[test]
+    fn test_history_is_bounded_per_source() {
+        let history = HistoryStore::new();
+        let mut state = ConsensusState::new();
+        for i in 0..(HISTORY_PER_SOURCE as u64 + 50) {
+            let data = sample(COINBASE, 70_000 + i as i64, i);
+            state.update(data);
+            history.record(data);
+        }
+        history.record(sample(KRAKEN, 70_000, 1));
+        // 샤드 수보다 큰 ID도 같은 방식으로 저장
+        history.record(sample(SourceId(SHARD_COUNT as u32 + 1), 70_000, 1));
+
+        assert_eq!(history.data_points(), HISTORY_PER_SOURCE + 2);
+        assert_eq!(history.history_for(COINBASE).len(), HISTORY_PER_SOURCE);
+        assert_eq!(
+            history.history_for(SourceId(1 + SHARD_COUNT as u32)).len(),
+            1
+        );
+        assert!(history.history_for(BINANCE).is_empty());
+        assert_eq!(state.recent().count(), RECENT_PRICES);
+        assert_eq!(
+            state.recent().next().unwrap().timestamp,
+            HISTORY_PER_SOURCE as u64 + 49
+        );
+    }
+}
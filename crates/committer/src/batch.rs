@@ -0,0 +1,192 @@
+//! 집계 틱 배치
+//!
+//! 구독한 집계 가격(틱)을 순서대로 Merkle 누적기에 넣고, N개가 모이거나
+//! 배치가 너무 오래 열려 있으면 루트를 확정(seal)한다.
+//! 누적기는 추가마다 O(log n)이므로 배치를 닫을 때 트리를 다시 만들지 않는다.
+
+use oracle_vm_common::crypto::{sha256, MerkleTree};
+use oracle_vm_common::Price;
+use serde::Serialize;
+use std::time::{Duration, Instant};
+
+/// 틱 리프 해시 도메인 태그
+const TICK_LEAF_TAG: &[u8] = b"oracle-vm/tick/v2";
+
+/// 커밋 대상 집계 틱
+#[derive(Debug, Clone, PartialEq, Serialize)]
+pub struct Tick {
+    pub pair: String,
+    pub price: Price,
+    /// 집계 시각 (unix 초)
+    pub timestamp: u64,
+    pub data_points: u32,
+}
+
+impl Tick {
+    /// Merkle 리프 - `sha256(tag | pair 길이 | pair | price 가수 | timestamp | data_points)` (BE)
+    ///
+    /// 가격은 고정소수점 가수(i64, 10^-8 단위) 그대로 넣어 검증 측이 같은 값을 정확히 재현할 수 있다.
+    pub fn leaf(&self) -> [u8; 32] {
+        let mut bytes = Vec::with_capacity(TICK_LEAF_TAG.len() + 4 + self.pair.len() + 20);
+        bytes.extend_from_slice(TICK_LEAF_TAG);
+        bytes.extend_from_slice(&(self.pair.len() as u32).to_be_bytes());
+        bytes.extend_from_slice(self.pair.as_bytes());
+        bytes.extend_from_slice(&self.price.mantissa().to_be_bytes());
+        bytes.extend_from_slice(&self.timestamp.to_be_bytes());
+        bytes.extend_from_slice(&self.data_points.to_be_bytes());
+        sha256(&bytes)
+    }
+}
+
+/// 루트가 확정된 배치
+#[derive(Debug, Clone)]
+pub struct SealedBatch {
+    /// 배치 순번 (0부터)
+    pub sequence: u64,
+    pub root: [u8; 32],
+    pub ticks: Vec<Tick>,
+}
+
+impl SealedBatch {
+    pub fn len(&self) -> usize {
+        self.ticks.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.ticks.is_empty()
+    }
+}
+
+/// 틱 배치기
+#[derive(Debug)]
+pub struct TickBatcher {
+    max_ticks: usize,
+    max_age: Duration,
+    sequence: u64,
+    tree: MerkleTree,
+    ticks: Vec<Tick>,
+    /// 현재 배치의 첫 틱 도착 시각
+    opened_at: Option<Instant>,
+}
+
+impl TickBatcher {
+    /// `max_ticks`개마다, 또는 첫 틱 이후 `max_age`가 지나면 배치를 닫는다
+    pub fn new(max_ticks: usize, max_age: Duration) -> Self {
+        Self {
+            max_ticks: max_ticks.max(1),
+            max_age,
+            sequence: 0,
+            tree: MerkleTree::default(),
+            ticks: Vec::with_capacity(max_ticks),
+            opened_at: None,
+        }
+    }
+
+    /// 다음에 닫을 배치의 순번부터 시작 (재시작 시 이어 붙이기)
+    pub fn with_start_sequence(mut self, sequence: u64) -> Self {
+        self.sequence = sequence;
+        self
+    }
+
+    /// 현재 배치의 틱 수
+    pub fn pending(&self) -> usize {
+        self.ticks.len()
+    }
+
+    /// 틱 추가 - 배치가 가득 차면 닫힌 배치 반환
+    pub fn push(&mut self, tick: Tick, now: Instant) -> Option<SealedBatch> {
+        self.opened_at.get_or_insert(now);
+        self.tree.push(tick.leaf());
+        self.ticks.push(tick);
+
+        if self.ticks.len() >= self.max_ticks {
+            self.seal()
+        } else {
+            None
+        }
+    }
+
+    /// 열린 배치가 `max_age`를 넘겼는지
+    pub fn is_due(&self, now: Instant) -> bool {
+        self.opened_at
+            .is_some_and(|opened_at| now.duration_since(opened_at) >= self.max_age)
+    }
+
+    /// 현재 배치 닫기 (비어 있으면 None)
+    pub fn seal(&mut self) -> Option<SealedBatch> {
+        if self.ticks.is_empty() {
+            return None;
+        }
+
+        let tree = std::mem::take(&mut self.tree);
+        let batch = SealedBatch {
+            sequence: self.sequence,
+            root: tree.root(),
+            ticks: std::mem::replace(&mut self.ticks, Vec::with_capacity(self.max_ticks)),
+        };
+        self.sequence += 1;
+        self.opened_at = None;
+        Some(batch)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn tick(i: u64) -> Tick {
+        Tick {
+            pair: "BTC/USD".to_string(),
+            price: Price::from_cents(7_000_000 + i as i64 * 25),
+            timestamp: 1_700_000_000 + i,
+            data_points: 3,
+        }
+    }
+
+    #[test]
+    fn test_batches_seal_every_n_ticks() {
+        let now = Instant::now();
+        let mut batcher = TickBatcher::new(4, Duration::from_secs(60)).with_start_sequence(7);
+
+        let sealed: Vec<SealedBatch> = (0..10).filter_map(|i| batcher.push(tick(i), now)).collect();
+        assert_eq!(sealed.len(), 2);
+        assert_eq!(sealed[0].sequence, 7);
+        assert_eq!(sealed[1].sequence, 8);
+        assert_eq!(batcher.pending(), 2);
+
+        // 루트는 배치 틱만으로 다시 만든 트리와 같다
+        let leaves = sealed[1].ticks.iter().map(Tick::leaf).collect();
+        assert_eq!(sealed[1].root, MerkleTree::new(leaves).root());
+        assert_eq!(sealed[1].ticks[0], tick(4));
+    }
+
+    #[test]
+    fn test_partial_batch_seals_after_max_age() {
+        let start = Instant::now();
+        let mut batcher = TickBatcher::new(100, Duration::from_secs(5));
+        assert!(!batcher.is_due(start + Duration::from_secs(60)));
+        assert!(batcher.seal().is_none());
+
+        batcher.push(tick(0), start);
+        batcher.push(tick(1), start + Duration::from_secs(3));
+        assert!(!batcher.is_due(start + Duration::from_secs(4)));
+        assert!(batcher.is_due(start + Duration::from_secs(5)));
+
+        let batch = batcher.seal().unwrap();
+        assert_eq!(batch.len(), 2);
+        assert_eq!(batch.sequence, 0);
+        assert!(!batcher.is_due(start + Duration::from_secs(60)));
+    }
+
+    #[test]
+    fn test_leaf_commits_to_every_field() {
+        let base = tick(0);
+        let mut changed = base.clone();
+        changed.price = Price::from_mantissa(base.price.mantissa() + 1);
+        assert_ne!(base.leaf(), changed.leaf());
+
+        let mut changed = base.clone();
+        changed.pair = "ETH/USD".to_string();
+        assert_ne!(base.leaf(), changed.leaf());
+    }
+}
@@ -0,0 +1,370 @@
+//! 커밋 트랜잭션 전파/컨펌 확인
+//!
+//! - [`BitcoindRpc`]: bitcoind JSON-RPC (`sendrawtransaction`, 블록 조회)
+//! - [`DryRun`]: 노드 없이 파이프라인을 돌릴 때 - 전파하지 않고 바로 컨펌된 것으로 본다
+//!
+//! `-txindex`가 없는 노드는 컨펌된 트랜잭션을 txid만으로 찾지 못한다 (`getrawtransaction` 실패).
+//! 잔액 출력도 다음 커밋이 바로 쓰므로 `gettxout`으로도 알 수 없다. 그래서 전파 시점의 블록
+//! 높이부터 새 블록을 훑어 커밋이 포함된 블록을 찾고, 이후에는 그 블록 헤더로 컨펌 수를 센다.
+
+use anyhow::{anyhow, Context, Result};
+use async_trait::async_trait;
+use bitcoin::consensus::encode::serialize_hex;
+use bitcoin::{BlockHash, Transaction, Txid};
+use serde_json::{json, Value};
+use std::collections::HashMap;
+use std::str::FromStr;
+use std::sync::Mutex;
+use tracing::{info, warn};
+
+/// 전파 높이를 모르는 트랜잭션을 찾을 때 되짚어 볼 최대 블록 수 (약 하루)
+const MAX_SCAN_BLOCKS: u64 = 144;
+
+/// 체인 백엔드
+#[async_trait]
+pub trait ChainBackend: Send + Sync {
+    /// 트랜잭션 전파
+    async fn broadcast(&self, tx: &Transaction) -> Result<Txid>;
+
+    /// 컨펌 수 (멤풀에 있으면 0)
+    async fn confirmations(&self, txid: &Txid) -> Result<u32>;
+
+    /// 확정되어 더 조회하지 않을 트랜잭션 - 추적 상태 정리
+    fn forget(&self, _txid: &Txid) {}
+}
+
+/// JSON-RPC 호출 (테스트에서 bitcoind 대신 끼울 수 있도록 분리)
+#[async_trait]
+pub trait RpcTransport: Send + Sync {
+    async fn call(&self, method: &str, params: Value) -> Result<Value>;
+}
+
+/// HTTP JSON-RPC (basic auth)
+struct HttpTransport {
+    client: reqwest::Client,
+    url: String,
+    user: String,
+    password: String,
+}
+
+#[async_trait]
+impl RpcTransport for HttpTransport {
+    async fn call(&self, method: &str, params: Value) -> Result<Value> {
+        let body = json!({
+            "jsonrpc": "1.0",
+            "id": "committer",
+            "method": method,
+            "params": params,
+        });
+
+        let response: Value = self
+            .client
+            .post(&self.url)
+            .basic_auth(&self.user, Some(&self.password))
+            .json(&body)
+            .send()
+            .await
+            .with_context(|| format!("Failed to call bitcoind {}", method))?
+            .json()
+            .await
+            .with_context(|| format!("Invalid bitcoind {} response", method))?;
+
+        // bitcoind는 RPC 오류도 본문의 error 필드로 돌려준다 (HTTP 500과 함께)
+        match &response["error"] {
+            Value::Null => Ok(response["result"].clone()),
+            error => Err(anyhow!("bitcoind {} failed: {}", method, error)),
+        }
+    }
+}
+
+/// 전파한 커밋의 추적 상태
+#[derive(Debug, Clone, Copy)]
+enum Tracked {
+    /// 아직 블록에서 찾지 못함 - 이 높이까지 훑었다
+    Pending { scanned: u64 },
+    /// 커밋이 포함된 블록
+    Mined { block: BlockHash, height: u64 },
+}
+
+/// bitcoind JSON-RPC 클라이언트 (`-txindex` 불필요)
+pub struct BitcoindRpc {
+    transport: Box<dyn RpcTransport>,
+    tracked: Mutex<HashMap<Txid, Tracked>>,
+}
+
+impl BitcoindRpc {
+    pub fn new(
+        url: impl Into<String>,
+        user: impl Into<String>,
+        password: impl Into<String>,
+    ) -> Self {
+        Self::with_transport(HttpTransport {
+            client: reqwest::Client::new(),
+            url: url.into(),
+            user: user.into(),
+            password: password.into(),
+        })
+    }
+
+    pub fn with_transport(transport: impl RpcTransport + 'static) -> Self {
+        Self {
+            transport: Box::new(transport),
+            tracked: Mutex::new(HashMap::new()),
+        }
+    }
+
+    async fn call(&self, method: &str, params: Value) -> Result<Value> {
+        self.transport.call(method, params).await
+    }
+
+    async fn block_count(&self) -> Result<u64> {
+        let result = self.call("getblockcount", json!([])).await?;
+        result
+            .as_u64()
+            .ok_or_else(|| anyhow!("getblockcount returned no height"))
+    }
+
+    /// `scanned` 다음 블록부터 `tip`까지 훑어 트랜잭션이 포함된 블록 찾기
+    async fn find_block(
+        &self,
+        txid: &Txid,
+        scanned: u64,
+        tip: u64,
+    ) -> Result<Option<(BlockHash, u64)>> {
+        let txid = txid.to_string();
+        for height in scanned + 1..=tip {
+            let hash = self.call("getblockhash", json!([height])).await?;
+            let hash = hash
+                .as_str()
+                .ok_or_else(|| anyhow!("getblockhash returned no hash for {}", height))?;
+            // verbosity 1: 블록의 txid 목록만
+            let block = self.call("getblock", json!([hash, 1])).await?;
+            let found = block["tx"]
+                .as_array()
+                .is_some_and(|txs| txs.iter().any(|tx| tx.as_str() == Some(txid.as_str())));
+            if found {
+                let hash = BlockHash::from_str(hash)
+                    .map_err(|e| anyhow!("Invalid block hash {}: {}", hash, e))?;
+                return Ok(Some((hash, height)));
+            }
+        }
+        Ok(None)
+    }
+}
+
+#[async_trait]
+impl ChainBackend for BitcoindRpc {
+    async fn broadcast(&self, tx: &Transaction) -> Result<Txid> {
+        // 이 높이 다음 블록부터 커밋을 찾는다
+        let height = self.block_count().await?;
+        let result = self
+            .call("sendrawtransaction", json!([serialize_hex(tx)]))
+            .await?;
+        let txid = result
+            .as_str()
+            .ok_or_else(|| anyhow!("sendrawtransaction returned no txid"))?;
+        let txid = Txid::from_str(txid).map_err(|e| anyhow!("Invalid txid {}: {}", txid, e))?;
+        self.tracked
+            .lock()
+            .unwrap()
+            .entry(txid)
+            .or_insert(Tracked::Pending { scanned: height });
+        Ok(txid)
+    }
+
+    async fn confirmations(&self, txid: &Txid) -> Result<u32> {
+        let tracked = self.tracked.lock().unwrap().get(txid).copied();
+        let scanned = match tracked {
+            Some(Tracked::Mined { block, height }) => {
+                // 재구성으로 블록이 메인 체인에서 빠지면 confirmations가 -1
+                let header = self
+                    .call("getblockheader", json!([block.to_string()]))
+                    .await?;
+                match header["confirmations"].as_i64() {
+                    Some(confirmations) if confirmations > 0 => return Ok(confirmations as u32),
+                    _ => {
+                        warn!(
+                            "⚠️ Block {} with commitment {} left the main chain",
+                            block, txid
+                        );
+                        height.saturating_sub(1)
+                    }
+                }
+            }
+            Some(Tracked::Pending { scanned }) => scanned,
+            None => self.block_count().await?.saturating_sub(MAX_SCAN_BLOCKS),
+        };
+
+        let tip = self.block_count().await?;
+        let found = self.find_block(txid, scanned.min(tip), tip).await?;
+        let tracked = match found {
+            Some((block, height)) => Tracked::Mined { block, height },
+            None => Tracked::Pending { scanned: tip },
+        };
+        self.tracked.lock().unwrap().insert(*txid, tracked);
+
+        match found {
+            Some((_, height)) => Ok((tip - height + 1) as u32),
+            None => {
+                // 블록에도 멤풀에도 없으면 밀려났거나 충돌한 것 - 기다려도 컨펌되지 않는다
+                self.call("getmempoolentry", json!([txid.to_string()]))
+                    .await
+                    .with_context(|| format!("Commitment {} is not in the mempool", txid))?;
+                Ok(0)
+            }
+        }
+    }
+
+    fn forget(&self, txid: &Txid) {
+        self.tracked.lock().unwrap().remove(txid);
+    }
+}
+
+/// 전파하지 않는 백엔드
+#[derive(Debug, Default)]
+pub struct DryRun;
+
+#[async_trait]
+impl ChainBackend for DryRun {
+    async fn broadcast(&self, tx: &Transaction) -> Result<Txid> {
+        let txid = tx.compute_txid();
+        info!(
+            "🧪 [dry-run] {} ({} vB): {}",
+            txid,
+            tx.vsize(),
+            serialize_hex(tx)
+        );
+        Ok(txid)
+    }
+
+    async fn confirmations(&self, _txid: &Txid) -> Result<u32> {
+        Ok(u32::MAX)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use bitcoin::hashes::Hash;
+    use std::sync::Arc;
+
+    /// `-txindex` 없는 bitcoind 흉내 - 컨펌된 트랜잭션은 txid만으로 조회할 수 없다
+    #[derive(Clone, Default)]
+    struct NoTxIndex {
+        chain: Arc<Mutex<NoTxIndexChain>>,
+    }
+
+    #[derive(Default)]
+    struct NoTxIndexChain {
+        mempool: Vec<Txid>,
+        /// 높이 1부터의 블록 (해시, txid 목록)
+        blocks: Vec<(BlockHash, Vec<Txid>)>,
+        /// 훑은 블록 높이
+        scanned: Vec<usize>,
+    }
+
+    impl NoTxIndex {
+        /// 멤풀의 트랜잭션을 모두 새 블록에 포함
+        fn mine(&self) {
+            let mut chain = self.chain.lock().unwrap();
+            let height = chain.blocks.len() as u8 + 1;
+            let txs = std::mem::take(&mut chain.mempool);
+            chain
+                .blocks
+                .push((BlockHash::from_byte_array([height; 32]), txs));
+        }
+    }
+
+    impl NoTxIndexChain {
+        fn height_of(&self, hash: &Value) -> usize {
+            let hash = hash.as_str().unwrap();
+            self.blocks
+                .iter()
+                .position(|(block, _)| block.to_string() == hash)
+                .unwrap()
+                + 1
+        }
+    }
+
+    #[async_trait]
+    impl RpcTransport for NoTxIndex {
+        async fn call(&self, method: &str, params: Value) -> Result<Value> {
+            let mut chain = self.chain.lock().unwrap();
+            let tip = chain.blocks.len();
+            match method {
+                "getblockcount" => Ok(json!(tip)),
+                "sendrawtransaction" => {
+                    let tx: Transaction =
+                        bitcoin::consensus::encode::deserialize_hex(params[0].as_str().unwrap())?;
+                    chain.mempool.push(tx.compute_txid());
+                    Ok(json!(tx.compute_txid().to_string()))
+                }
+                "getmempoolentry" => {
+                    let txid = Txid::from_str(params[0].as_str().unwrap())?;
+                    if chain.mempool.contains(&txid) {
+                        Ok(json!({}))
+                    } else {
+                        Err(anyhow!("Transaction not in mempool"))
+                    }
+                }
+                "getblockhash" => {
+                    let height = params[0].as_u64().unwrap() as usize;
+                    Ok(json!(chain.blocks[height - 1].0.to_string()))
+                }
+                "getblock" => {
+                    let height = chain.height_of(&params[0]);
+                    chain.scanned.push(height);
+                    let txs: Vec<String> = chain.blocks[height - 1]
+                        .1
+                        .iter()
+                        .map(Txid::to_string)
+                        .collect();
+                    Ok(json!({ "tx": txs }))
+                }
+                "getblockheader" => {
+                    let height = chain.height_of(&params[0]);
+                    Ok(json!({ "confirmations": tip - height + 1 }))
+                }
+                // 컨펌된 트랜잭션은 -txindex 없이 찾을 수 없다
+                "getrawtransaction" => Err(anyhow!(
+                    "No such mempool transaction. Use -txindex or provide a block hash"
+                )),
+                _ => Err(anyhow!("Unexpected method {}", method)),
+            }
+        }
+    }
+
+    fn transaction(lock_time: u32) -> Transaction {
+        Transaction {
+            version: bitcoin::transaction::Version::TWO,
+            lock_time: bitcoin::absolute::LockTime::from_consensus(lock_time),
+            input: vec![bitcoin::TxIn::default()],
+            output: vec![bitcoin::TxOut::NULL],
+        }
+    }
+
+    #[tokio::test]
+    async fn test_confirmations_without_txindex() {
+        let node = NoTxIndex::default();
+        node.mine();
+        let rpc = BitcoindRpc::with_transport(node.clone());
+
+        let txid = rpc.broadcast(&transaction(1)).await.unwrap();
+        assert_eq!(rpc.confirmations(&txid).await.unwrap(), 0);
+
+        node.mine();
+        assert_eq!(rpc.confirmations(&txid).await.unwrap(), 1);
+        node.mine();
+        node.mine();
+        assert_eq!(rpc.confirmations(&txid).await.unwrap(), 3);
+        // 전파 이전 블록은 훑지 않고, 찾은 뒤에는 블록 헤더만 조회
+        assert_eq!(node.chain.lock().unwrap().scanned, vec![2]);
+
+        // 블록에도 멤풀에도 없는 트랜잭션은 오류
+        let dropped = transaction(2).compute_txid();
+        assert!(rpc.confirmations(&dropped).await.is_err());
+
+        rpc.forget(&txid);
+        assert!(rpc.tracked.lock().unwrap().get(&txid).is_none());
+    }
+}
@@ -0,0 +1,284 @@
+//! 커밋 트랜잭션 생성
+//!
+//! 배치 하나당 트랜잭션 하나: 직전 커밋의 잔액 출력을 쓰고(입력 1개),
+//! OP_RETURN으로 배치 루트를 기록하고, 남은 금액을 같은 키의 P2TR 출력으로 돌려받는다.
+//! 잔액 출력의 outpoint는 서명 직후 알 수 있으므로 다음 배치는 컨펌을 기다리지 않고 만들 수 있다.
+//!
+//! OP_RETURN 형식: `magic "OVMC" | version: u8 | sequence: u64 | leaf_count: u32 | root: [u8; 32]` (BE)
+
+use crate::batch::SealedBatch;
+use anyhow::{anyhow, bail, Result};
+use bitcoin::hashes::Hash;
+use bitcoin::key::TapTweak;
+use bitcoin::script::PushBytesBuf;
+use bitcoin::sighash::{Prevouts, SighashCache, TapSighashType};
+use bitcoin::{
+    absolute::LockTime, transaction, Amount, OutPoint, ScriptBuf, Sequence, Transaction, TxIn,
+    TxOut, Witness,
+};
+use oracle_vm_common::crypto::{self, Keypair};
+
+pub const COMMITMENT_MAGIC: [u8; 4] = *b"OVMC";
+pub const COMMITMENT_VERSION: u8 = 1;
+pub const COMMITMENT_PAYLOAD_LEN: usize = 4 + 1 + 8 + 4 + 32;
+/// P2TR 출력 dust 한도 (sats)
+const P2TR_DUST_LIMIT: u64 = 330;
+
+/// OP_RETURN에서 읽은 커밋 내용
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct Commitment {
+    pub sequence: u64,
+    pub leaf_count: u32,
+    pub root: [u8; 32],
+}
+
+impl Commitment {
+    pub fn payload(&self) -> [u8; COMMITMENT_PAYLOAD_LEN] {
+        let mut payload = [0u8; COMMITMENT_PAYLOAD_LEN];
+        payload[..4].copy_from_slice(&COMMITMENT_MAGIC);
+        payload[4] = COMMITMENT_VERSION;
+        payload[5..13].copy_from_slice(&self.sequence.to_be_bytes());
+        payload[13..17].copy_from_slice(&self.leaf_count.to_be_bytes());
+        payload[17..].copy_from_slice(&self.root);
+        payload
+    }
+
+    pub fn from_payload(payload: &[u8]) -> Option<Self> {
+        if payload.len() != COMMITMENT_PAYLOAD_LEN
+            || payload[..4] != COMMITMENT_MAGIC
+            || payload[4] != COMMITMENT_VERSION
+        {
+            return None;
+        }
+
+        Some(Self {
+            sequence: u64::from_be_bytes(payload[5..13].try_into().unwrap()),
+            leaf_count: u32::from_be_bytes(payload[13..17].try_into().unwrap()),
+            root: payload[17..].try_into().unwrap(),
+        })
+    }
+
+    /// 커밋 트랜잭션의 OP_RETURN 출력에서 읽기
+    pub fn from_transaction(tx: &Transaction) -> Option<Self> {
+        tx.output.iter().find_map(|output| {
+            let script = output.script_pubkey.as_bytes();
+            // OP_RETURN OP_PUSHBYTES_49 <payload>
+            if output.script_pubkey.is_op_return()
+                && script.len() == 2 + COMMITMENT_PAYLOAD_LEN
+                && script[1] as usize == COMMITMENT_PAYLOAD_LEN
+            {
+                Self::from_payload(&script[2..])
+            } else {
+                None
+            }
+        })
+    }
+}
+
+impl From<&SealedBatch> for Commitment {
+    fn from(batch: &SealedBatch) -> Self {
+        Self {
+            sequence: batch.sequence,
+            leaf_count: batch.len() as u32,
+            root: batch.root,
+        }
+    }
+}
+
+/// 커밋 트랜잭션 생성기 - 잔액 UTXO를 체인으로 이어 쓴다
+pub struct CommitmentBuilder {
+    /// key-path 지출용으로 tweak된 키
+    tweaked: Keypair,
+    /// 잔액 출력 스크립트 (P2TR, 스크립트 경로 없음)
+    script_pubkey: ScriptBuf,
+    /// 다음 커밋이 쓸 UTXO
+    utxo: OutPoint,
+    value: Amount,
+    /// 수수료율 (sat/vB)
+    fee_rate: u64,
+}
+
+impl CommitmentBuilder {
+    /// `utxo`는 `keypair`의 P2TR 주소로 받은 출력이어야 한다
+    pub fn new(keypair: Keypair, utxo: OutPoint, value: Amount, fee_rate: u64) -> Self {
+        let secp = crypto::secp();
+        let (internal_key, _) = keypair.x_only_public_key();
+
+        Self {
+            tweaked: keypair.tap_tweak(secp, None).to_inner(),
+            script_pubkey: ScriptBuf::new_p2tr(secp, internal_key, None),
+            utxo,
+            value,
+            fee_rate,
+        }
+    }
+
+    /// 다음 커밋이 쓸 UTXO와 금액
+    pub fn utxo(&self) -> (OutPoint, Amount) {
+        (self.utxo, self.value)
+    }
+
+    pub fn script_pubkey(&self) -> &ScriptBuf {
+        &self.script_pubkey
+    }
+
+    /// 배치 커밋 트랜잭션 생성 및 서명 - 성공하면 잔액 출력이 다음 UTXO가 된다
+    pub fn build(&mut self, batch: &SealedBatch) -> Result<Transaction> {
+        let payload = PushBytesBuf::try_from(Commitment::from(batch).payload().to_vec())
+            .map_err(|_| anyhow!("Commitment payload too large"))?;
+
+        let mut tx = Transaction {
+            version: transaction::Version::TWO,
+            lock_time: LockTime::ZERO,
+            input: vec![TxIn {
+                previous_output: self.utxo,
+                script_sig: ScriptBuf::new(),
+                sequence: Sequence::ENABLE_RBF_NO_LOCKTIME,
+                // 크기 계산용 자리 표시 (SIGHASH_DEFAULT 서명 64 bytes)
+                witness: Witness::from_slice(&[[0u8; 64]]),
+            }],
+            output: vec![
+                TxOut {
+                    value: Amount::ZERO,
+                    script_pubkey: ScriptBuf::new_op_return(&payload),
+                },
+                TxOut {
+                    value: self.value,
+                    script_pubkey: self.script_pubkey.clone(),
+                },
+            ],
+        };
+
+        let fee = Amount::from_sat(tx.vsize() as u64 * self.fee_rate);
+        let change = self.value.checked_sub(fee).unwrap_or(Amount::ZERO);
+        if change.to_sat() < P2TR_DUST_LIMIT {
+            bail!(
+                "Commitment UTXO exhausted: {} left, fee {} (batch {})",
+                self.value,
+                fee,
+                batch.sequence
+            );
+        }
+        tx.output[1].value = change;
+
+        let prevout = TxOut {
+            value: self.value,
+            script_pubkey: self.script_pubkey.clone(),
+        };
+        let sighash = SighashCache::new(&tx)
+            .taproot_key_spend_signature_hash(
+                0,
+                &Prevouts::All(&[prevout]),
+                TapSighashType::Default,
+            )
+            .map_err(|e| anyhow!("Failed to compute sighash: {}", e))?;
+        let signature = bitcoin::taproot::Signature {
+            signature: crypto::sign_schnorr(&sighash.to_byte_array(), &self.tweaked),
+            sighash_type: TapSighashType::Default,
+        };
+        tx.input[0].witness = Witness::p2tr_key_spend(&signature);
+
+        self.utxo = OutPoint::new(tx.compute_txid(), 1);
+        self.value = change;
+        Ok(tx)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::batch::Tick;
+    use bitcoin::Txid;
+    use oracle_vm_common::Price;
+    use std::str::FromStr;
+
+    fn batch(sequence: u64) -> SealedBatch {
+        SealedBatch {
+            sequence,
+            root: [sequence as u8; 32],
+            ticks: vec![
+                Tick {
+                    pair: "BTC/USD".to_string(),
+                    price: Price::from_units(70_000),
+                    timestamp: 1_700_000_000,
+                    data_points: 3,
+                };
+                5
+            ],
+        }
+    }
+
+    fn funding() -> OutPoint {
+        let txid =
+            Txid::from_str("4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b")
+                .unwrap();
+        OutPoint::new(txid, 0)
+    }
+
+    #[test]
+    fn test_commitments_chain_through_change_output() {
+        let keypair = crypto::generate_signing_keypair();
+        let mut builder = CommitmentBuilder::new(keypair, funding(), Amount::from_sat(100_000), 2);
+
+        let first = builder.build(&batch(0)).unwrap();
+        let second = builder.build(&batch(1)).unwrap();
+
+        assert_eq!(first.input[0].previous_output, funding());
+        assert_eq!(
+            second.input[0].previous_output,
+            OutPoint::new(first.compute_txid(), 1)
+        );
+        assert_eq!(
+            Commitment::from_transaction(&second),
+            Some(Commitment {
+                sequence: 1,
+                leaf_count: 5,
+                root: [1u8; 32],
+            })
+        );
+
+        // 수수료 = vsize x 수수료율
+        let fee = 100_000 - first.output[1].value.to_sat();
+        assert_eq!(fee, first.vsize() as u64 * 2);
+        assert_eq!(builder.utxo().1, second.output[1].value);
+    }
+
+    #[test]
+    fn test_key_spend_signature_verifies() {
+        let keypair = crypto::generate_signing_keypair();
+        let mut builder = CommitmentBuilder::new(keypair, funding(), Amount::from_sat(50_000), 1);
+        let prevout = TxOut {
+            value: Amount::from_sat(50_000),
+            script_pubkey: builder.script_pubkey().clone(),
+        };
+        let tx = builder.build(&batch(0)).unwrap();
+
+        let sighash = SighashCache::new(&tx)
+            .taproot_key_spend_signature_hash(
+                0,
+                &Prevouts::All(&[prevout]),
+                TapSighashType::Default,
+            )
+            .unwrap();
+        let signature = bitcoin::taproot::Signature::from_slice(&tx.input[0].witness[0]).unwrap();
+        let output_key = keypair
+            .x_only_public_key()
+            .0
+            .tap_tweak(crypto::secp(), None)
+            .0;
+        assert!(crypto::verify_schnorr(
+            &sighash.to_byte_array(),
+            &signature.signature,
+            &output_key.to_inner()
+        ));
+    }
+
+    #[test]
+    fn test_exhausted_utxo_is_rejected() {
+        let keypair = crypto::generate_signing_keypair();
+        let mut builder = CommitmentBuilder::new(keypair, funding(), Amount::from_sat(500), 2);
+        assert!(builder.build(&batch(0)).is_err());
+        // 실패한 배치는 UTXO를 바꾸지 않는다
+        assert_eq!(builder.utxo(), (funding(), Amount::from_sat(500)));
+    }
+}
@@ -1,3 +1,259 @@
-fn main() {
-    println!("Committer - TODO: Implement");
+use anyhow::{anyhow, Context, Result};
+use bitcoin::hex::DisplayHex;
+use bitcoin::{Amount, OutPoint};
+use clap::Parser;
+use oracle_vm_common::crypto;
+use oracle_vm_common::Price;
+use serde::Serialize;
+use std::fs::{self, File, OpenOptions};
+use std::io::{BufWriter, Write};
+use std::path::Path;
+use std::str::FromStr;
+use std::sync::Arc;
+use std::time::Duration;
+use tokio::sync::mpsc;
+use tokio::time::sleep;
+use tonic::Request;
+use tracing::{info, warn};
+
+// gRPC 클라이언트 코드 (tonic-build로 자동 생성됨)
+pub mod oracle {
+    tonic::include_proto!("oracle");
+}
+
+use oracle::{oracle_service_client::OracleServiceClient, AggregatedPriceUpdate, PriceRequest};
+
+mod batch;
+mod chain;
+mod commitment;
+mod pipeline;
+
+use batch::Tick;
+use chain::{BitcoindRpc, ChainBackend, DryRun};
+use commitment::CommitmentBuilder;
+use pipeline::{CommittedBatch, PipelineConfig};
+
+/// 구독이 끊겼을 때 재연결 대기 시간
+const RECONNECT_DELAY: Duration = Duration::from_secs(5);
+/// 구독과 배치 단계 사이 틱 버퍼 (배치 단계가 밀려도 구독 스트림은 계속 읽음)
+const TICK_BUFFER: usize = 1024;
+
+/// Committer CLI 인수
+#[derive(Parser)]
+#[command(name = "committer")]
+#[command(about = "Commits batches of aggregated prices to Bitcoin")]
+struct Args {
+    /// Aggregator gRPC 주소
+    #[arg(long, default_value = "http://127.0.0.1:50051")]
+    aggregator_url: String,
+
+    /// 커밋할 자산 쌍 (없으면 전체)
+    #[arg(long)]
+    pair: Option<String>,
+
+    /// 배치당 최대 틱 수
+    #[arg(long, default_value_t = 60)]
+    batch_size: usize,
+
+    /// 첫 틱 이후 배치를 닫기까지 최대 시간 (초)
+    #[arg(long, default_value_t = 600)]
+    max_batch_age_secs: u64,
+
+    /// 컨펌되지 않은 커밋 최대 개수 (멤풀 체인 한도 25 미만)
+    #[arg(long, default_value_t = 12)]
+    max_in_flight: usize,
+
+    /// 확정으로 볼 컨펌 수
+    #[arg(long, default_value_t = 1)]
+    confirmations: u32,
+
+    /// 첫 배치 순번 (재시작 시 마지막 커밋 다음 번호)
+    #[arg(long, default_value_t = 0)]
+    start_sequence: u64,
+
+    /// 커밋 서명 키 (hex) - 잔액 출력은 이 키의 P2TR 주소로 돌아온다
+    #[arg(long)]
+    commit_key: String,
+
+    /// 첫 커밋이 쓸 UTXO (txid:vout, 커밋 키의 P2TR 주소로 받은 출력)
+    #[arg(long)]
+    funding_outpoint: String,
+
+    /// 첫 UTXO 금액 (sats)
+    #[arg(long)]
+    funding_amount: u64,
+
+    /// 수수료율 (sat/vB)
+    #[arg(long, default_value_t = 2)]
+    fee_rate: u64,
+
+    /// bitcoind RPC 주소 (없으면 전파하지 않는 dry-run)
+    #[arg(long)]
+    bitcoind_url: Option<String>,
+
+    #[arg(long, default_value = "")]
+    rpc_user: String,
+
+    #[arg(long, default_value = "")]
+    rpc_password: String,
+
+    /// 컨펌된 배치 기록 (JSON lines - 증명 생성에 필요한 틱 포함)
+    #[arg(long, default_value = "./data/committer/batches.jsonl")]
+    journal: String,
+}
+
+/// 배치 기록 한 줄
+#[derive(Serialize)]
+struct JournalEntry<'a> {
+    sequence: u64,
+    txid: String,
+    root: String,
+    confirmations: u32,
+    ticks: &'a [Tick],
+}
+
+/// 고정소수점 가격이 없는 업데이트(이전 버전 Aggregator)는 커밋하지 않는다
+fn to_tick(update: AggregatedPriceUpdate) -> Option<Tick> {
+    let fixed = update.aggregated_price_fixed?;
+    Some(Tick {
+        pair: update.pair,
+        price: Price::from_parts(fixed.mantissa, fixed.exponent)?,
+        timestamp: update.timestamp,
+        data_points: update.data_points,
+    })
+}
+
+/// 집계 가격 구독 - 끊기면 재연결, 틱 수신 측이 닫히면 종료
+async fn subscribe(url: String, pair: Option<String>, ticks: mpsc::Sender<Tick>) {
+    loop {
+        match stream_updates(&url, pair.as_deref(), &ticks).await {
+            Ok(()) => warn!("📡 Aggregator stream closed"),
+            Err(e) => warn!("📡 Aggregator stream failed: {}", e),
+        }
+        if ticks.is_closed() {
+            return;
+        }
+        sleep(RECONNECT_DELAY).await;
+    }
+}
+
+async fn stream_updates(url: &str, pair: Option<&str>, ticks: &mpsc::Sender<Tick>) -> Result<()> {
+    let mut client = OracleServiceClient::connect(url.to_string())
+        .await
+        .context("Failed to connect to Aggregator via gRPC")?;
+
+    // 가격은 보내지 않고 집계 가격만 구독
+    let outbound = futures::stream::pending::<PriceRequest>();
+    let mut updates = client
+        .stream_prices(Request::new(outbound))
+        .await?
+        .into_inner();
+    info!("📡 Subscribed to aggregated prices at {}", url);
+
+    while let Some(update) = updates.message().await? {
+        if pair.is_some_and(|pair| pair != update.pair) {
+            continue;
+        }
+        let Some(tick) = to_tick(update) else {
+            warn!("⚠️ Skipping update without a fixed-point price");
+            continue;
+        };
+        if ticks.send(tick).await.is_err() {
+            break;
+        }
+    }
+    Ok(())
+}
+
+/// 컨펌된 배치를 기록
+fn write_journal(journal: &mut BufWriter<File>, committed: &CommittedBatch) -> Result<()> {
+    let entry = JournalEntry {
+        sequence: committed.batch.sequence,
+        txid: committed.txid.to_string(),
+        root: committed.batch.root.as_slice().to_lower_hex_string(),
+        confirmations: committed.confirmations,
+        ticks: &committed.batch.ticks,
+    };
+    serde_json::to_writer(&mut *journal, &entry)?;
+    journal.write_all(b"\n")?;
+    journal.flush()?;
+    Ok(())
+}
+
+fn open_journal(path: &str) -> Result<BufWriter<File>> {
+    if let Some(dir) = Path::new(path).parent() {
+        fs::create_dir_all(dir)?;
+    }
+    let file = OpenOptions::new()
+        .create(true)
+        .append(true)
+        .open(path)
+        .with_context(|| format!("Failed to open journal {}", path))?;
+    Ok(BufWriter::new(file))
+}
+
+#[tokio::main]
+async fn main() -> Result<()> {
+    let args = Args::parse();
+
+    // 로깅 초기화
+    tracing_subscriber::fmt::init();
+
+    let keypair = crypto::signing_keypair_from_hex(&args.commit_key)?;
+    let funding = OutPoint::from_str(&args.funding_outpoint)
+        .map_err(|e| anyhow!("Invalid funding outpoint {}: {}", args.funding_outpoint, e))?;
+    let builder = CommitmentBuilder::new(
+        keypair,
+        funding,
+        Amount::from_sat(args.funding_amount),
+        args.fee_rate,
+    );
+
+    let backend: Arc<dyn ChainBackend> = match &args.bitcoind_url {
+        Some(url) => {
+            info!("⛓️ Broadcasting commitments through bitcoind at {}", url);
+            Arc::new(BitcoindRpc::new(url, &args.rpc_user, &args.rpc_password))
+        }
+        None => {
+            warn!("🧪 No bitcoind URL given - commitments will not be broadcast");
+            Arc::new(DryRun)
+        }
+    };
+
+    let config = PipelineConfig {
+        batch_size: args.batch_size,
+        max_batch_age: Duration::from_secs(args.max_batch_age_secs),
+        max_in_flight: args.max_in_flight,
+        confirmations: args.confirmations,
+        start_sequence: args.start_sequence,
+        ..PipelineConfig::default()
+    };
+    info!(
+        "🚀 Starting committer: {} ticks per batch, up to {} commitments in flight",
+        config.batch_size, config.max_in_flight
+    );
+
+    let mut journal = open_journal(&args.journal)?;
+    let (tick_tx, tick_rx) = mpsc::channel(TICK_BUFFER);
+    let (committed_tx, mut committed_rx) = mpsc::channel(config.max_in_flight.max(1));
+
+    tokio::spawn(subscribe(args.aggregator_url, args.pair, tick_tx));
+    let pipeline = tokio::spawn(pipeline::run(
+        config,
+        builder,
+        backend,
+        tick_rx,
+        committed_tx,
+    ));
+
+    while let Some(committed) = committed_rx.recv().await {
+        if let Err(e) = write_journal(&mut journal, &committed) {
+            warn!(
+                "⚠️ Failed to record batch {}: {}",
+                committed.batch.sequence, e
+            );
+        }
+    }
+
+    pipeline.await?
 }
@@ -0,0 +1,430 @@
+//! 배치 커밋 파이프라인
+//!
+//! 세 단계가 채널로 이어져 동시에 돈다.
+//! 1. 배치: 틱을 모아 Merkle 루트 확정
+//! 2. 생성: 커밋 트랜잭션 서명 (직전 커밋의 잔액 출력을 바로 이어 씀)
+//! 3. 전파/컨펌: 전파 후 컨펌될 때까지 추적
+//!
+//! 배치 k가 전파/컨펌 대기 중인 동안 배치 k+1을 모으고 서명한다.
+//! 미컨펌 체인 길이는 `max_in_flight`로 제한한다 (멤풀 조상/자손 한도 25).
+//! 컨펌 확인이 연달아 실패하면 미컨펌 슬롯이 풀리지 않아 멈추므로 오류로 종료한다.
+
+use crate::batch::{SealedBatch, Tick, TickBatcher};
+use crate::chain::ChainBackend;
+use crate::commitment::CommitmentBuilder;
+use anyhow::{anyhow, Result};
+use bitcoin::{Transaction, Txid};
+use std::collections::VecDeque;
+use std::sync::Arc;
+use std::time::Duration;
+use tokio::sync::{mpsc, OwnedSemaphorePermit, Semaphore};
+use tokio::time::{interval, sleep, Instant, MissedTickBehavior};
+use tracing::{info, warn};
+
+/// 전파 재시도 횟수
+const BROADCAST_ATTEMPTS: u32 = 3;
+/// 전파 재시도 간격 (시도마다 두 배)
+const BROADCAST_BACKOFF: Duration = Duration::from_millis(500);
+/// 컨펌 확인이 이 횟수만큼 연달아 실패하면 파이프라인 중단
+const CONFIRMATION_CHECK_ATTEMPTS: u32 = 10;
+
+/// 파이프라인 설정
+#[derive(Debug, Clone)]
+pub struct PipelineConfig {
+    /// 배치당 최대 틱 수
+    pub batch_size: usize,
+    /// 배치를 첫 틱 이후 최대 얼마나 열어 둘지
+    pub max_batch_age: Duration,
+    /// 컨펌되지 않은 커밋 최대 개수
+    pub max_in_flight: usize,
+    /// 확정으로 볼 컨펌 수
+    pub confirmations: u32,
+    /// 첫 배치 순번 (재시작 시 마지막 커밋 다음 번호)
+    pub start_sequence: u64,
+    /// 컨펌 확인 간격
+    pub poll_interval: Duration,
+}
+
+impl Default for PipelineConfig {
+    fn default() -> Self {
+        Self {
+            batch_size: 60,
+            max_batch_age: Duration::from_secs(600),
+            max_in_flight: 12,
+            confirmations: 1,
+            start_sequence: 0,
+            poll_interval: Duration::from_secs(30),
+        }
+    }
+}
+
+/// 컨펌된 배치
+#[derive(Debug, Clone)]
+pub struct CommittedBatch {
+    pub batch: SealedBatch,
+    pub txid: Txid,
+    pub confirmations: u32,
+}
+
+/// 서명된 커밋 - 컨펌될 때까지 미컨펌 슬롯(permit)을 잡고 있는다
+struct SignedCommitment {
+    batch: SealedBatch,
+    tx: Transaction,
+    _permit: OwnedSemaphorePermit,
+}
+
+/// `ticks`가 닫히면 남은 틱을 배치로 커밋하고, 모든 커밋이 컨펌되면 종료
+pub async fn run(
+    config: PipelineConfig,
+    builder: CommitmentBuilder,
+    backend: Arc<dyn ChainBackend>,
+    ticks: mpsc::Receiver<Tick>,
+    committed: mpsc::Sender<CommittedBatch>,
+) -> Result<()> {
+    let max_in_flight = config.max_in_flight.max(1);
+    let (sealed_tx, sealed_rx) = mpsc::channel(max_in_flight);
+    let (signed_tx, signed_rx) = mpsc::channel(max_in_flight);
+    let permits = Arc::new(Semaphore::new(max_in_flight));
+    let batcher = TickBatcher::new(config.batch_size, config.max_batch_age)
+        .with_start_sequence(config.start_sequence);
+
+    tokio::try_join!(
+        batch_stage(&config, batcher, ticks, sealed_tx),
+        build_stage(builder, permits, sealed_rx, signed_tx),
+        submit_stage(&config, backend, signed_rx, committed),
+    )?;
+    Ok(())
+}
+
+/// 1단계: 틱 -> 배치
+async fn batch_stage(
+    config: &PipelineConfig,
+    mut batcher: TickBatcher,
+    mut ticks: mpsc::Receiver<Tick>,
+    sealed: mpsc::Sender<SealedBatch>,
+) -> Result<()> {
+    // 배치 최대 유지 시간의 1/4마다 확인 - 최대 1.25배까지 늦게 닫힘
+    let mut age_check = interval((config.max_batch_age / 4).max(Duration::from_millis(1)));
+    age_check.set_missed_tick_behavior(MissedTickBehavior::Delay);
+
+    loop {
+        let batch = tokio::select! {
+            tick = ticks.recv() => match tick {
+                Some(tick) => batcher.push(tick, Instant::now().into_std()),
+                None => {
+                    if let Some(batch) = batcher.seal() {
+                        send(&sealed, batch).await?;
+                    }
+                    return Ok(());
+                }
+            },
+            _ = age_check.tick() => {
+                if batcher.is_due(Instant::now().into_std()) {
+                    batcher.seal()
+                } else {
+                    None
+                }
+            }
+        };
+
+        if let Some(batch) = batch {
+            send(&sealed, batch).await?;
+        }
+    }
+}
+
+/// 2단계: 배치 -> 서명된 커밋 트랜잭션
+async fn build_stage(
+    mut builder: CommitmentBuilder,
+    permits: Arc<Semaphore>,
+    mut sealed: mpsc::Receiver<SealedBatch>,
+    signed: mpsc::Sender<SignedCommitment>,
+) -> Result<()> {
+    while let Some(batch) = sealed.recv().await {
+        // 미컨펌 커밋이 한도에 차면 여기서 대기 (틱 수집은 계속됨)
+        let permit = permits.clone().acquire_owned().await?;
+        let tx = builder.build(&batch)?;
+        info!(
+            "🧾 Built commitment for batch {} ({} ticks, {} vB)",
+            batch.sequence,
+            batch.len(),
+            tx.vsize()
+        );
+        send(
+            &signed,
+            SignedCommitment {
+                batch,
+                tx,
+                _permit: permit,
+            },
+        )
+        .await?;
+    }
+    Ok(())
+}
+
+/// 3단계: 전파 후 컨펌 추적
+async fn submit_stage(
+    config: &PipelineConfig,
+    backend: Arc<dyn ChainBackend>,
+    mut signed: mpsc::Receiver<SignedCommitment>,
+    committed: mpsc::Sender<CommittedBatch>,
+) -> Result<()> {
+    let mut in_flight: VecDeque<(SignedCommitment, Txid)> = VecDeque::new();
+    let mut poll = interval(config.poll_interval);
+    poll.set_missed_tick_behavior(MissedTickBehavior::Delay);
+    let mut open = true;
+    // 맨 앞 커밋의 컨펌 확인 연속 실패 횟수
+    let mut check_failures = 0;
+
+    while open || !in_flight.is_empty() {
+        tokio::select! {
+            commitment = signed.recv(), if open => match commitment {
+                Some(commitment) => {
+                    let txid = broadcast(backend.as_ref(), &commitment).await?;
+                    info!("📤 Broadcast batch {} commitment {}", commitment.batch.sequence, txid);
+                    in_flight.push_back((commitment, txid));
+                }
+                None => open = false,
+            },
+            _ = poll.tick(), if !in_flight.is_empty() => {
+                // 잔액 출력으로 이어진 체인이므로 앞에서부터 순서대로 컨펌된다
+                while let Some((commitment, txid)) = in_flight.front() {
+                    let confirmations = match backend.confirmations(txid).await {
+                        Ok(confirmations) => confirmations,
+                        Err(e) if check_failures + 1 < CONFIRMATION_CHECK_ATTEMPTS => {
+                            check_failures += 1;
+                            warn!(
+                                "⚠️ Failed to check commitment {} (attempt {}): {}",
+                                txid, check_failures, e
+                            );
+                            break;
+                        }
+                        // 이대로면 미컨펌 슬롯이 풀리지 않아 다음 배치도 서명할 수 없다
+                        Err(e) => {
+                            return Err(anyhow!(
+                                "Failed to check batch {} commitment {}: {}",
+                                commitment.batch.sequence,
+                                txid,
+                                e
+                            ))
+                        }
+                    };
+                    check_failures = 0;
+                    if confirmations < config.confirmations {
+                        break;
+                    }
+
+                    info!(
+                        "✅ Batch {} committed in {} ({} confirmations)",
+                        commitment.batch.sequence, txid, confirmations
+                    );
+                    let (commitment, txid) = in_flight.pop_front().unwrap();
+                    backend.forget(&txid);
+                    // 수신 측이 없어도 커밋은 계속
+                    let _ = committed
+                        .send(CommittedBatch {
+                            batch: commitment.batch,
+                            txid,
+                            confirmations,
+                        })
+                        .await;
+                }
+            }
+        }
+    }
+    Ok(())
+}
+
+/// 전파 (일시적 오류는 재시도)
+async fn broadcast(backend: &dyn ChainBackend, commitment: &SignedCommitment) -> Result<Txid> {
+    let mut backoff = BROADCAST_BACKOFF;
+    let mut attempt = 1;
+    loop {
+        match backend.broadcast(&commitment.tx).await {
+            Ok(txid) => return Ok(txid),
+            Err(e) if attempt < BROADCAST_ATTEMPTS => {
+                warn!(
+                    "⚠️ Broadcast of batch {} failed (attempt {}): {}",
+                    commitment.batch.sequence, attempt, e
+                );
+                sleep(backoff).await;
+                backoff *= 2;
+                attempt += 1;
+            }
+            // 이후 커밋은 모두 이 트랜잭션의 출력을 쓰므로 더 진행할 수 없다
+            Err(e) => {
+                return Err(anyhow!(
+                    "Failed to broadcast batch {} commitment: {}",
+                    commitment.batch.sequence,
+                    e
+                ))
+            }
+        }
+    }
+}
+
+async fn send<T>(channel: &mpsc::Sender<T>, value: T) -> Result<()> {
+    channel
+        .send(value)
+        .await
+        .map_err(|_| anyhow!("Commitment pipeline stage stopped"))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::commitment::Commitment;
+    use async_trait::async_trait;
+    use bitcoin::{Amount, OutPoint};
+    use oracle_vm_common::crypto;
+    use oracle_vm_common::Price;
+    use std::sync::Mutex;
+
+    /// 전파한 트랜잭션을 기록하고, 컨펌 조회 `delay`번째부터 컨펌된 것으로 보는 백엔드
+    #[derive(Default)]
+    struct MockChain {
+        broadcast: Mutex<Vec<Transaction>>,
+        polls: Mutex<Vec<Txid>>,
+        delay: usize,
+    }
+
+    #[async_trait]
+    impl ChainBackend for MockChain {
+        async fn broadcast(&self, tx: &Transaction) -> Result<Txid> {
+            self.broadcast.lock().unwrap().push(tx.clone());
+            Ok(tx.compute_txid())
+        }
+
+        async fn confirmations(&self, txid: &Txid) -> Result<u32> {
+            let mut polls = self.polls.lock().unwrap();
+            polls.push(*txid);
+            let seen = polls.iter().filter(|polled| *polled == txid).count();
+            Ok((seen >= self.delay) as u32)
+        }
+    }
+
+    /// 멤풀에 있는 동안은 조회되다가 컨펌되면 조회에 실패하는 백엔드
+    /// (`-txindex` 없는 노드의 `getrawtransaction`처럼)
+    #[derive(Default)]
+    struct FailsOnceConfirmed {
+        polls: Mutex<usize>,
+    }
+
+    #[async_trait]
+    impl ChainBackend for FailsOnceConfirmed {
+        async fn broadcast(&self, tx: &Transaction) -> Result<Txid> {
+            Ok(tx.compute_txid())
+        }
+
+        async fn confirmations(&self, _txid: &Txid) -> Result<u32> {
+            let mut polls = self.polls.lock().unwrap();
+            *polls += 1;
+            if *polls == 1 {
+                Ok(0)
+            } else {
+                Err(anyhow!("No such mempool transaction. Use -txindex"))
+            }
+        }
+    }
+
+    fn builder() -> CommitmentBuilder {
+        CommitmentBuilder::new(
+            crypto::generate_signing_keypair(),
+            OutPoint::null(),
+            Amount::from_sat(1_000_000),
+            1,
+        )
+    }
+
+    fn tick(i: u64) -> Tick {
+        Tick {
+            pair: "BTC/USD".to_string(),
+            price: Price::from_units(70_000 + i as i64),
+            timestamp: 1_700_000_000 + i,
+            data_points: 3,
+        }
+    }
+
+    #[tokio::test]
+    async fn test_pipeline_commits_every_batch_in_order() {
+        let config = PipelineConfig {
+            batch_size: 4,
+            max_batch_age: Duration::from_secs(60),
+            max_in_flight: 2,
+            confirmations: 1,
+            start_sequence: 0,
+            poll_interval: Duration::from_millis(5),
+        };
+        let chain = Arc::new(MockChain {
+            delay: 3,
+            ..MockChain::default()
+        });
+
+        let (tick_tx, tick_rx) = mpsc::channel(64);
+        let (committed_tx, mut committed_rx) = mpsc::channel(64);
+        let pipeline = tokio::spawn(run(config, builder(), chain.clone(), tick_rx, committed_tx));
+
+        for i in 0..18 {
+            tick_tx.send(tick(i)).await.unwrap();
+        }
+        drop(tick_tx);
+        pipeline.await.unwrap().unwrap();
+
+        let mut committed = Vec::new();
+        while let Some(batch) = committed_rx.recv().await {
+            committed.push(batch);
+        }
+        // 4 x 4 + 남은 2개
+        let sizes: Vec<usize> = committed.iter().map(|c| c.batch.len()).collect();
+        assert_eq!(sizes, vec![4, 4, 4, 4, 2]);
+
+        let broadcast = chain.broadcast.lock().unwrap();
+        assert_eq!(broadcast.len(), 5);
+        for (index, (tx, batch)) in broadcast.iter().zip(&committed).enumerate() {
+            assert_eq!(tx.compute_txid(), batch.txid);
+            let commitment = Commitment::from_transaction(tx).unwrap();
+            assert_eq!(commitment.sequence, index as u64);
+            assert_eq!(commitment.root, batch.batch.root);
+            if index > 0 {
+                assert_eq!(
+                    tx.input[0].previous_output,
+                    OutPoint::new(broadcast[index - 1].compute_txid(), 1)
+                );
+            }
+        }
+    }
+
+    #[tokio::test]
+    async fn test_pipeline_fails_when_confirmations_cannot_be_checked() {
+        let config = PipelineConfig {
+            batch_size: 1,
+            max_in_flight: 1,
+            poll_interval: Duration::from_millis(1),
+            ..PipelineConfig::default()
+        };
+        let (tick_tx, tick_rx) = mpsc::channel(64);
+        let (committed_tx, mut committed_rx) = mpsc::channel(64);
+        let pipeline = tokio::spawn(run(
+            config,
+            builder(),
+            Arc::new(FailsOnceConfirmed::default()),
+            tick_rx,
+            committed_tx,
+        ));
+
+        // 미컨펌 슬롯이 풀리지 않은 채 멈춰 있지 않고 오류로 끝남
+        for i in 0..3 {
+            let _ = tick_tx.send(tick(i)).await;
+        }
+        let result = tokio::time::timeout(Duration::from_secs(5), pipeline)
+            .await
+            .expect("pipeline stalled")
+            .unwrap();
+        assert!(result
+            .unwrap_err()
+            .to_string()
+            .contains("Failed to check batch 0 commitment"));
+        assert!(committed_rx.recv().await.is_none());
+    }
+}
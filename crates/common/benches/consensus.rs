@@ -0,0 +1,64 @@
+//! Consensus engine throughput at oracle-node, aggregator and cluster scale
+//!
+//! `cargo bench -p oracle-vm-common --bench consensus`
+
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use oracle_vm_common::consensus::{ConsensusConfig, Quorum};
+use oracle_vm_common::Price;
+use rand::rngs::StdRng;
+use rand::{Rng, SeedableRng};
+
+/// Aggregator settings (`calculate_aggregated_price` step 3)
+const AGGREGATOR: ConsensusConfig = ConsensusConfig::new(Quorum::TWO_THIRDS, 500);
+
+/// Quotes within ±0.1% of $70,000, with one outlier per ten sources
+fn quotes(sources: usize) -> Vec<Price> {
+    let mut rng = StdRng::seed_from_u64(sources as u64);
+    (0..sources)
+        .map(|i| {
+            let cents = if i % 10 == 9 {
+                7_500_000
+            } else {
+                7_000_000 + rng.gen_range(-7_000..=7_000)
+            };
+            Price::from_cents(cents)
+        })
+        .collect()
+}
+
+fn bench_evaluate(c: &mut Criterion) {
+    let mut group = c.benchmark_group("consensus/evaluate");
+    for sources in [3, 30, 300] {
+        let prices = quotes(sources);
+        group.throughput(Throughput::Elements(sources as u64));
+        group.bench_with_input(
+            BenchmarkId::from_parameter(sources),
+            &prices,
+            |b, prices| {
+                b.iter(|| AGGREGATOR.evaluate(black_box(prices).iter().copied(), sources));
+            },
+        );
+    }
+    group.finish();
+}
+
+fn bench_fixed_band(c: &mut Criterion) {
+    // MAD disabled: median only, band from max_deviation_bps
+    let config = AGGREGATOR.with_mad(0, 0);
+    let mut group = c.benchmark_group("consensus/evaluate_fixed_band");
+    for sources in [3, 30, 300] {
+        let prices = quotes(sources);
+        group.throughput(Throughput::Elements(sources as u64));
+        group.bench_with_input(
+            BenchmarkId::from_parameter(sources),
+            &prices,
+            |b, prices| {
+                b.iter(|| config.evaluate(black_box(prices).iter().copied(), sources));
+            },
+        );
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_evaluate, bench_fixed_band);
+criterion_main!(benches);
@@ -0,0 +1,88 @@
+//! Merkle tree build, append and proof cost from 1k to 1M leaves
+//!
+//! `cargo bench -p oracle-vm-common --bench merkle`
+
+use criterion::{
+    black_box, criterion_group, criterion_main, BatchSize, BenchmarkId, Criterion, Throughput,
+};
+use oracle_vm_common::crypto::{self, MerkleTree};
+use std::time::{Duration, Instant};
+
+const SIZES: [usize; 4] = [1_000, 10_000, 100_000, 1_000_000];
+
+fn leaves(count: usize) -> Vec<[u8; 32]> {
+    (0..count as u64)
+        .map(|i| crypto::sha256(&i.to_le_bytes()))
+        .collect()
+}
+
+/// Build from all leaves, then read the root
+fn bench_build_root(c: &mut Criterion) {
+    let mut group = c.benchmark_group("merkle/build_root");
+    group.sample_size(10);
+    for size in SIZES {
+        let leaves = leaves(size);
+        group.throughput(Throughput::Elements(size as u64));
+        group.bench_with_input(BenchmarkId::from_parameter(size), &leaves, |b, leaves| {
+            b.iter_batched(
+                || leaves.clone(),
+                |leaves| MerkleTree::new(leaves).root(),
+                BatchSize::LargeInput,
+            );
+        });
+    }
+    group.finish();
+}
+
+/// Append one leaf to a tree of `size` leaves, then read the new root
+///
+/// The tree is cloned untimed once per `size` appends, so it stays between
+/// `size` and `2 * size` leaves while being measured.
+fn bench_push_root(c: &mut Criterion) {
+    let mut group = c.benchmark_group("merkle/push_root");
+    for size in SIZES {
+        let tree = MerkleTree::new(leaves(size));
+        let leaf = crypto::sha256(b"next");
+        group.bench_with_input(BenchmarkId::from_parameter(size), &tree, |b, base| {
+            b.iter_custom(|iters| {
+                let mut elapsed = Duration::ZERO;
+                let mut remaining = iters;
+                while remaining > 0 {
+                    let mut tree = base.clone();
+                    let appends = remaining.min(size as u64);
+                    let started = Instant::now();
+                    for _ in 0..appends {
+                        tree.push(leaf);
+                        black_box(tree.root());
+                    }
+                    elapsed += started.elapsed();
+                    remaining -= appends;
+                }
+                elapsed
+            });
+        });
+    }
+    group.finish();
+}
+
+/// Sibling path of a leaf (root already cached), reusing the output buffer
+fn bench_proof(c: &mut Criterion) {
+    let mut group = c.benchmark_group("merkle/proof");
+    for size in SIZES {
+        let tree = MerkleTree::new(leaves(size));
+        tree.root();
+        let mut proof = Vec::new();
+        let mut index = 0usize;
+        group.bench_with_input(BenchmarkId::from_parameter(size), &tree, |b, tree| {
+            b.iter(|| {
+                // Walk leaves with a stride so successive proofs touch different paths
+                index = (index + 7_919) % size;
+                tree.proof_into(black_box(index), &mut proof)
+            });
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, bench_build_root, bench_push_root, bench_proof);
+criterion_main!(benches);
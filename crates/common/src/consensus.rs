@@ -0,0 +1,283 @@
+//! Consensus price selection
+//!
+//! One engine shared by oracle nodes (across exchanges), the aggregator
+//! (across sources) and any quorum of aggregators:
+//!
+//! 1. Take the median of every submitted price.
+//! 2. Drop outliers. A price is kept if it lies within the band around the
+//!    median: `mad_multiplier` × MAD (median absolute deviation), no
+//!    narrower than `min_deviation_bps` and no wider than `max_deviation_bps`.
+//! 3. Require the agreeing prices to reach the [`Quorum`] of the expected
+//!    source count, then return their mean.
+//!
+//! Both medians use `select_nth_unstable` instead of a sort. Prices are
+//! copied into a [`SmallVec`] that stays on the stack up to
+//! [`INLINE_PRICES`] sources, so every step is O(n) and allocation-free for
+//! realistic source counts.
+
+use crate::{OracleVmError, Price};
+use smallvec::SmallVec;
+use thiserror::Error;
+
+/// Source count evaluated without touching the heap
+pub const INLINE_PRICES: usize = 16;
+
+/// Required share of the expected sources, as a fraction
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct Quorum {
+    pub numerator: usize,
+    pub denominator: usize,
+}
+
+impl Quorum {
+    pub const TWO_THIRDS: Self = Self::new(2, 3);
+
+    pub const fn new(numerator: usize, denominator: usize) -> Self {
+        assert!(denominator > 0 && numerator <= denominator);
+        Self {
+            numerator,
+            denominator,
+        }
+    }
+
+    /// Agreeing sources needed out of `expected` (rounded up, at least one)
+    pub fn required(self, expected: usize) -> usize {
+        (expected * self.numerator)
+            .div_ceil(self.denominator)
+            .max(1)
+    }
+}
+
+/// Consensus parameters
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct ConsensusConfig {
+    pub quorum: Quorum,
+    /// Widest accepted distance from the median (bps)
+    pub max_deviation_bps: u64,
+    /// Narrowest band, so identical quotes do not reject every tick (bps)
+    pub min_deviation_bps: u64,
+    /// Band width in MADs (`0` always uses `max_deviation_bps`)
+    pub mad_multiplier: u64,
+}
+
+impl ConsensusConfig {
+    pub const fn new(quorum: Quorum, max_deviation_bps: u64) -> Self {
+        Self {
+            quorum,
+            max_deviation_bps,
+            min_deviation_bps: 25,
+            mad_multiplier: 5,
+        }
+    }
+
+    pub const fn with_mad(mut self, mad_multiplier: u64, min_deviation_bps: u64) -> Self {
+        self.mad_multiplier = mad_multiplier;
+        self.min_deviation_bps = min_deviation_bps;
+        self
+    }
+
+    /// Evaluate `prices` against a quorum of `expected` sources
+    ///
+    /// `expected` is the number of sources that should have reported (for
+    /// example the configured exchanges). If more prices than that arrive,
+    /// the quorum is taken over the prices instead.
+    pub fn evaluate(
+        &self,
+        prices: impl IntoIterator<Item = Price>,
+        expected: usize,
+    ) -> Result<Consensus, ConsensusError> {
+        let consensus = self.select(prices).ok_or(ConsensusError::Empty)?;
+        let expected = expected.max(consensus.total);
+        let required = self.quorum.required(expected);
+        if consensus.agreeing < required {
+            return Err(ConsensusError::NoQuorum {
+                agreeing: consensus.agreeing,
+                required,
+                expected,
+            });
+        }
+        Ok(consensus)
+    }
+
+    /// Median, outlier band and mean of the agreeing prices, without a
+    /// quorum check (`None` if empty)
+    pub fn select(&self, prices: impl IntoIterator<Item = Price>) -> Option<Consensus> {
+        let mut prices: SmallVec<[Price; INLINE_PRICES]> = prices.into_iter().collect();
+        let median = Price::median(&mut prices)?;
+        let band = self.band(&prices, median);
+        let accepted = || {
+            prices
+                .iter()
+                .copied()
+                .filter(move |price| price.abs_diff(median) <= band)
+        };
+
+        Some(Consensus {
+            // The median is always accepted, so the mean exists
+            price: Price::mean(accepted()).unwrap_or(median),
+            median,
+            band,
+            agreeing: accepted().count(),
+            total: prices.len(),
+        })
+    }
+
+    /// Accepted distance from the median in mantissa units
+    fn band(&self, prices: &[Price], median: Price) -> u64 {
+        let reference = median.mantissa().unsigned_abs() as u128;
+        let from_bps = |bps: u64| (reference * bps as u128 / 10_000).min(u64::MAX as u128) as u64;
+        let widest = from_bps(self.max_deviation_bps);
+        if self.mad_multiplier == 0 {
+            return widest;
+        }
+
+        let mut deviations: SmallVec<[u64; INLINE_PRICES]> =
+            prices.iter().map(|price| price.abs_diff(median)).collect();
+        // Upper median for even counts: the wider of the two middle values
+        let middle = deviations.len() / 2;
+        let (_, &mut mad, _) = deviations.select_nth_unstable(middle);
+
+        mad.saturating_mul(self.mad_multiplier)
+            .max(from_bps(self.min_deviation_bps))
+            .min(widest)
+    }
+}
+
+impl Default for ConsensusConfig {
+    fn default() -> Self {
+        Self::new(Quorum::TWO_THIRDS, 200)
+    }
+}
+
+/// Agreed price
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct Consensus {
+    /// Mean of the agreeing prices
+    pub price: Price,
+    pub median: Price,
+    /// Widest accepted distance from the median (mantissa units)
+    pub band: u64,
+    /// Prices inside the band
+    pub agreeing: usize,
+    /// Prices evaluated
+    pub total: usize,
+}
+
+impl Consensus {
+    /// Whether `price` was inside the band (false means it was an outlier)
+    pub fn accepts(&self, price: Price) -> bool {
+        price.abs_diff(self.median) <= self.band
+    }
+
+    /// Band width in basis points of the median
+    pub fn band_bps(&self) -> u64 {
+        match self.median.mantissa().unsigned_abs() {
+            0 => 0,
+            reference => (self.band as u128 * 10_000 / reference as u128) as u64,
+        }
+    }
+}
+
+#[derive(Error, Debug, Clone, Copy, PartialEq, Eq)]
+pub enum ConsensusError {
+    #[error("No prices to evaluate")]
+    Empty,
+
+    #[error("Consensus not reached: {agreeing} of {expected} sources agree (need {required})")]
+    NoQuorum {
+        agreeing: usize,
+        required: usize,
+        expected: usize,
+    },
+}
+
+impl From<ConsensusError> for OracleVmError {
+    fn from(error: ConsensusError) -> Self {
+        OracleVmError::Aggregation(error.to_string())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn units(values: &[i64]) -> Vec<Price> {
+        values
+            .iter()
+            .map(|&value| Price::from_units(value))
+            .collect()
+    }
+
+    #[test]
+    fn test_quorum_rounds_up() {
+        assert_eq!(Quorum::TWO_THIRDS.required(3), 2);
+        assert_eq!(Quorum::TWO_THIRDS.required(4), 3);
+        assert_eq!(Quorum::TWO_THIRDS.required(0), 1);
+        assert_eq!(Quorum::new(1, 2).required(5), 3);
+    }
+
+    #[test]
+    fn test_outlier_is_excluded_from_mean() {
+        let config = ConsensusConfig::default();
+        let consensus = config
+            .evaluate(units(&[70_000, 70_100, 75_000]), 3)
+            .unwrap();
+
+        assert_eq!(consensus.median, Price::from_units(70_100));
+        assert_eq!(consensus.price, Price::from_units(70_050));
+        assert_eq!((consensus.agreeing, consensus.total), (2, 3));
+        assert!(!consensus.accepts(Price::from_units(75_000)));
+        // MAD = 100 -> 5 MADs, inside the 2% cap
+        assert_eq!(consensus.band, Price::from_units(500).mantissa() as u64);
+    }
+
+    #[test]
+    fn test_identical_quotes_keep_minimum_band() {
+        let config = ConsensusConfig::default();
+        let mut prices = units(&[70_000; 4]);
+        prices.push(Price::from_units(70_100));
+
+        // MAD = 0, but the 0.25% floor (175) still accepts a $100 difference
+        let consensus = config.select(prices).unwrap();
+        assert_eq!(consensus.agreeing, 5);
+        assert_eq!(consensus.band_bps(), 25);
+    }
+
+    #[test]
+    fn test_band_is_capped_by_max_deviation() {
+        // Widely spread quotes: MAD filtering alone would accept all of them
+        let config = ConsensusConfig::default();
+        let result = config.evaluate(units(&[70_000, 75_000, 80_000]), 3);
+        assert_eq!(
+            result,
+            Err(ConsensusError::NoQuorum {
+                agreeing: 1,
+                required: 2,
+                expected: 3,
+            })
+        );
+
+        let without_mad = ConsensusConfig::new(Quorum::TWO_THIRDS, 1_000).with_mad(0, 0);
+        let consensus = without_mad
+            .evaluate(units(&[70_000, 75_000, 80_000]), 3)
+            .unwrap();
+        assert_eq!(consensus.agreeing, 3);
+    }
+
+    #[test]
+    fn test_missing_sources_count_against_quorum() {
+        let config = ConsensusConfig::default();
+        assert!(config.evaluate(units(&[70_000, 70_010]), 3).is_ok());
+        assert!(config.evaluate(units(&[70_000]), 3).is_err());
+        assert_eq!(config.evaluate(Vec::new(), 3), Err(ConsensusError::Empty));
+    }
+
+    #[test]
+    fn test_many_sources_spill_to_heap() {
+        let mut prices: Vec<Price> = (0..40).map(|i| Price::from_units(70_000 + i)).collect();
+        prices.push(Price::from_units(1));
+        let consensus = ConsensusConfig::default().evaluate(prices, 41).unwrap();
+        assert_eq!((consensus.agreeing, consensus.total), (40, 41));
+        assert_eq!(consensus.median, Price::from_units(70_019));
+    }
+}
@@ -1,17 +1,31 @@
 //! Cryptographic utilities for Oracle VM
 
-use crate::{OracleVmError, Result};
-use bitcoin::secp256k1::{ecdsa::Signature, Message, PublicKey, Secp256k1, SecretKey};
+use crate::{OracleVmError, Price, Result};
+use bitcoin::secp256k1::{ecdsa::Signature, All, Message, PublicKey, Secp256k1, SecretKey};
 use sha2::{Digest, Sha256};
+use std::sync::OnceLock;
+
+pub use bitcoin::secp256k1::{schnorr, Keypair, XOnlyPublicKey};
+
+/// Domain tag mixed into every price submission digest
+const SUBMISSION_TAG: &[u8] = b"oracle-vm/price-submission/v2";
+
+/// Process-wide secp256k1 context
+///
+/// Creating a context precomputes large multiplication tables, so it is built
+/// once and shared by every signing and verification call.
+pub fn secp() -> &'static Secp256k1<All> {
+    static SECP: OnceLock<Secp256k1<All>> = OnceLock::new();
+    SECP.get_or_init(Secp256k1::new)
+}
 
 /// Sign data with a private key
 pub fn sign_data(data: &[u8], secret_key: &SecretKey) -> Result<Signature> {
-    let secp = Secp256k1::new();
     let hash = Sha256::digest(data);
     let message = Message::from_digest_slice(&hash)
         .map_err(|e| OracleVmError::Crypto(format!("Invalid message: {}", e)))?;
 
-    Ok(secp.sign_ecdsa(&message, secret_key))
+    Ok(secp().sign_ecdsa(&message, secret_key))
 }
 
 /// Verify signature
@@ -20,12 +34,11 @@ pub fn verify_signature(
     signature: &Signature,
     public_key: &PublicKey,
 ) -> Result<bool> {
-    let secp = Secp256k1::new();
     let hash = Sha256::digest(data);
     let message = Message::from_digest_slice(&hash)
         .map_err(|e| OracleVmError::Crypto(format!("Invalid message: {}", e)))?;
 
-    match secp.verify_ecdsa(&message, signature, public_key) {
+    match secp().verify_ecdsa(&message, signature, public_key) {
         Ok(()) => Ok(true),
         Err(_) => Ok(false),
     }
@@ -33,8 +46,98 @@ pub fn verify_signature(
 
 /// Generate key pair
 pub fn generate_keypair() -> (SecretKey, PublicKey) {
-    let secp = Secp256k1::new();
-    secp.generate_keypair(&mut rand::thread_rng())
+    secp().generate_keypair(&mut rand::thread_rng())
+}
+
+/// Generate a BIP340 signing key pair
+pub fn generate_signing_keypair() -> Keypair {
+    let (secret_key, _) = generate_keypair();
+    Keypair::from_secret_key(secp(), &secret_key)
+}
+
+/// Parse a BIP340 signing key pair from a hex-encoded secret key
+pub fn signing_keypair_from_hex(secret_key: &str) -> Result<Keypair> {
+    Keypair::from_seckey_str(secp(), secret_key)
+        .map_err(|e| OracleVmError::Crypto(format!("Invalid secret key: {}", e)))
+}
+
+/// Node ID derived from a node's public key - the same key always yields the same ID
+///
+/// Oracle nodes use it when no node ID is configured, and the aggregator binds a bare
+/// trusted key to it.
+pub fn default_node_id(public_key: &XOnlyPublicKey) -> String {
+    format!("oracle-node-{}", &public_key.to_string()[..8])
+}
+
+/// BIP340 Schnorr signature over a 32-byte digest
+pub fn sign_schnorr(digest: &[u8; 32], keypair: &Keypair) -> schnorr::Signature {
+    let message = Message::from_digest(*digest);
+    secp().sign_schnorr_with_aux_rand(&message, keypair, &rand::random())
+}
+
+/// Verify a BIP340 Schnorr signature over a 32-byte digest
+pub fn verify_schnorr(
+    digest: &[u8; 32],
+    signature: &schnorr::Signature,
+    public_key: &XOnlyPublicKey,
+) -> bool {
+    let message = Message::from_digest(*digest);
+    secp()
+        .verify_schnorr(signature, &message, public_key)
+        .is_ok()
+}
+
+/// Digest a node signs over when submitting prices
+///
+/// A single price and a batch use the same encoding: the node ID followed by
+/// each price in submission order. Strings are length-prefixed, prices are
+/// hashed by their fixed-point mantissa and volumes by their bit pattern, so
+/// the digest does not depend on how the values are formatted on the wire.
+pub struct SubmissionDigest {
+    hasher: Sha256,
+}
+
+impl SubmissionDigest {
+    pub fn new(node_id: &str) -> Self {
+        let mut digest = Self {
+            hasher: Sha256::new(),
+        };
+        digest.hasher.update(SUBMISSION_TAG);
+        digest.update_str(node_id);
+        digest
+    }
+
+    /// Append one price
+    pub fn push(
+        &mut self,
+        pair: &str,
+        source: &str,
+        price: Price,
+        timestamp: u64,
+        volume: Option<f64>,
+    ) -> &mut Self {
+        self.update_str(pair);
+        self.update_str(source);
+        self.hasher.update(price.mantissa().to_le_bytes());
+        self.hasher.update(timestamp.to_le_bytes());
+        match volume {
+            Some(volume) => {
+                self.hasher.update([1]);
+                self.hasher.update(volume.to_bits().to_le_bytes());
+            }
+            None => self.hasher.update([0]),
+        }
+        self
+    }
+
+    pub fn finalize(self) -> [u8; 32] {
+        self.hasher.finalize().into()
+    }
+
+    fn update_str(&mut self, value: &str) {
+        self.hasher.update((value.len() as u32).to_le_bytes());
+        self.hasher.update(value.as_bytes());
+    }
 }
 
 /// Hash data with SHA256
@@ -42,82 +145,181 @@ pub fn sha256(data: &[u8]) -> [u8; 32] {
     Sha256::digest(data).into()
 }
 
-/// Merkle tree implementation
+/// Hash two child nodes into their parent
+fn hash_pair(left: &[u8; 32], right: &[u8; 32]) -> [u8; 32] {
+    let mut hasher = Sha256::new();
+    hasher.update(left);
+    hasher.update(right);
+    hasher.finalize().into()
+}
+
+/// Append-only Merkle accumulator
+///
+/// Pairs are hashed as `sha256(left || right)`. A node without a sibling is
+/// promoted to the next level unchanged.
+///
+/// `levels[k]` caches every node whose subtree is a complete group of `2^k`
+/// leaves, so appending a leaf hashes at most one node per level. The
+/// partially filled right edge ("tails") is derived from the cached levels
+/// on demand and kept until the next append. Root and proofs then read
+/// cached nodes only.
+#[derive(Debug, Clone, Default)]
 pub struct MerkleTree {
-    leaves: Vec<[u8; 32]>,
+    levels: Vec<Vec<[u8; 32]>>,
+    /// `tails[k]`: promoted right-edge node at level `k`, if any
+    tails: OnceLock<Vec<Option<[u8; 32]>>>,
 }
 
 impl MerkleTree {
     pub fn new(leaves: Vec<[u8; 32]>) -> Self {
-        Self { leaves }
-    }
+        let mut levels = Vec::new();
+        let mut current = leaves;
+        while current.len() > 1 {
+            let next = current
+                .chunks_exact(2)
+                .map(|pair| hash_pair(&pair[0], &pair[1]))
+                .collect();
+            levels.push(current);
+            current = next;
+        }
+        if !current.is_empty() {
+            levels.push(current);
+        }
 
-    pub fn root(&self) -> [u8; 32] {
-        if self.leaves.is_empty() {
-            return [0u8; 32];
+        Self {
+            levels,
+            tails: OnceLock::new(),
         }
+    }
 
-        let mut current_level = self.leaves.clone();
+    /// Number of leaves
+    pub fn len(&self) -> usize {
+        self.levels.first().map_or(0, Vec::len)
+    }
 
-        while current_level.len() > 1 {
-            let mut next_level = Vec::new();
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
 
-            for chunk in current_level.chunks(2) {
-                let hash = if chunk.len() == 2 {
-                    let mut hasher = Sha256::new();
-                    hasher.update(chunk[0]);
-                    hasher.update(chunk[1]);
-                    hasher.finalize().into()
-                } else {
-                    chunk[0]
-                };
-                next_level.push(hash);
-            }
+    pub fn leaves(&self) -> &[[u8; 32]] {
+        self.levels.first().map_or(&[], Vec::as_slice)
+    }
 
-            current_level = next_level;
+    /// Append a leaf - O(log n) hashes, returns its index
+    pub fn push(&mut self, leaf: [u8; 32]) -> usize {
+        let index = self.len();
+        let mut node = leaf;
+        let mut level = 0;
+        loop {
+            if self.levels.len() == level {
+                self.levels.push(Vec::new());
+            }
+            let nodes = &mut self.levels[level];
+            nodes.push(node);
+            if nodes.len() % 2 == 1 {
+                break;
+            }
+            node = hash_pair(&nodes[nodes.len() - 2], &nodes[nodes.len() - 1]);
+            level += 1;
         }
 
-        current_level[0]
+        self.tails.take();
+        index
+    }
+
+    /// Right-edge nodes, one slot per level plus the root slot
+    fn tails(&self) -> &[Option<[u8; 32]>] {
+        self.tails.get_or_init(|| {
+            let mut tails = Vec::with_capacity(self.levels.len() + 1);
+            let mut tail = None;
+            tails.push(tail);
+            for nodes in &self.levels {
+                if let Some(last) = nodes.last().filter(|_| nodes.len() % 2 == 1) {
+                    tail = Some(match tail {
+                        None => *last,
+                        Some(right) => hash_pair(last, &right),
+                    });
+                }
+                tails.push(tail);
+            }
+            tails
+        })
+    }
+
+    pub fn root(&self) -> [u8; 32] {
+        self.tails().last().copied().flatten().unwrap_or([0u8; 32])
     }
 
     pub fn proof(&self, index: usize) -> Option<Vec<[u8; 32]>> {
-        if index >= self.leaves.len() {
-            return None;
+        let mut proof = Vec::new();
+        self.proof_into(index, &mut proof).then_some(proof)
+    }
+
+    /// Proofs for several leaves, sharing the right-edge computation
+    pub fn proofs(&self, indices: &[usize]) -> Vec<Option<Vec<[u8; 32]>>> {
+        indices.iter().map(|&index| self.proof(index)).collect()
+    }
+
+    /// Write the sibling path of `index` into `proof` (cleared first) - false if out of range
+    pub fn proof_into(&self, index: usize, proof: &mut Vec<[u8; 32]>) -> bool {
+        proof.clear();
+        if index >= self.len() {
+            return false;
         }
 
-        let mut proof = Vec::new();
-        let mut current_level = self.leaves.clone();
-        let mut current_index = index;
-
-        while current_level.len() > 1 {
-            let sibling_index = if current_index % 2 == 0 {
-                current_index + 1
-            } else {
-                current_index - 1
-            };
-
-            if sibling_index < current_level.len() {
-                proof.push(current_level[sibling_index]);
+        let tails = self.tails();
+        let mut index = index;
+        for (level, nodes) in self.levels.iter().enumerate() {
+            let width = nodes.len() + tails[level].is_some() as usize;
+            if width <= 1 {
+                break;
             }
 
-            let mut next_level = Vec::new();
-            for chunk in current_level.chunks(2) {
-                let hash = if chunk.len() == 2 {
-                    let mut hasher = Sha256::new();
-                    hasher.update(chunk[0]);
-                    hasher.update(chunk[1]);
-                    hasher.finalize().into()
+            let sibling = index ^ 1;
+            if sibling < nodes.len() {
+                proof.push(nodes[sibling]);
+            } else if let Some(tail) = tails[level].filter(|_| sibling == nodes.len()) {
+                proof.push(tail);
+            }
+            index /= 2;
+        }
+
+        true
+    }
+
+    /// Check a proof produced by [`MerkleTree::proof`] for a tree of `leaf_count` leaves
+    pub fn verify_proof(
+        root: &[u8; 32],
+        leaf: &[u8; 32],
+        index: usize,
+        leaf_count: usize,
+        proof: &[[u8; 32]],
+    ) -> bool {
+        if index >= leaf_count {
+            return false;
+        }
+
+        let mut node = *leaf;
+        let mut index = index;
+        let mut width = leaf_count;
+        let mut siblings = proof.iter();
+        while width > 1 {
+            let sibling = index ^ 1;
+            if sibling < width {
+                let Some(sibling_node) = siblings.next() else {
+                    return false;
+                };
+                node = if index % 2 == 0 {
+                    hash_pair(&node, sibling_node)
                 } else {
-                    chunk[0]
+                    hash_pair(sibling_node, &node)
                 };
-                next_level.push(hash);
             }
-
-            current_level = next_level;
-            current_index /= 2;
+            index /= 2;
+            width = width.div_ceil(2);
         }
 
-        Some(proof)
+        siblings.next().is_none() && node == *root
     }
 }
 
@@ -136,6 +338,70 @@ mod tests {
         assert!(is_valid);
     }
 
+    #[test]
+    fn test_schnorr_submission_signature() {
+        let keypair = generate_signing_keypair();
+        let (public_key, _) = keypair.x_only_public_key();
+
+        let mut digest = SubmissionDigest::new("oracle-node-1");
+        digest
+            .push(
+                "BTC/USD",
+                "binance",
+                Price::from_cents(7_000_050),
+                1_700_000_000,
+                Some(1.25),
+            )
+            .push(
+                "BTC/USD",
+                "kraken",
+                Price::from_units(70_001),
+                1_700_000_000,
+                None,
+            );
+        let digest = digest.finalize();
+
+        let signature = sign_schnorr(&digest, &keypair);
+        assert!(verify_schnorr(&digest, &signature, &public_key));
+
+        // Any change to the submission invalidates the signature
+        let mut tampered = SubmissionDigest::new("oracle-node-1");
+        tampered
+            .push(
+                "BTC/USD",
+                "binance",
+                Price::from_cents(7_000_050),
+                1_700_000_000,
+                Some(1.25),
+            )
+            .push(
+                "BTC/USD",
+                "kraken",
+                Price::from_cents(7_000_150),
+                1_700_000_000,
+                None,
+            );
+        assert!(!verify_schnorr(
+            &tampered.finalize(),
+            &signature,
+            &public_key
+        ));
+
+        let other_node = SubmissionDigest::new("oracle-node-2").finalize();
+        assert_ne!(
+            other_node,
+            SubmissionDigest::new("oracle-node-1").finalize()
+        );
+    }
+
+    #[test]
+    fn test_signing_keypair_from_hex() {
+        let secret = "0000000000000000000000000000000000000000000000000000000000000003";
+        let keypair = signing_keypair_from_hex(secret).unwrap();
+        assert_eq!(keypair.display_secret().to_string(), secret);
+        assert!(signing_keypair_from_hex("not-hex").is_err());
+    }
+
     #[test]
     fn test_merkle_tree() {
         let leaves = vec![
@@ -152,4 +418,78 @@ mod tests {
         let proof = tree.proof(0).unwrap();
         assert!(!proof.is_empty());
     }
+
+    /// Reference implementation: rebuild every level from the leaves
+    fn naive_root(leaves: &[[u8; 32]]) -> [u8; 32] {
+        if leaves.is_empty() {
+            return [0u8; 32];
+        }
+        let mut level = leaves.to_vec();
+        while level.len() > 1 {
+            level = level
+                .chunks(2)
+                .map(|pair| match pair {
+                    [left, right] => hash_pair(left, right),
+                    [single] => *single,
+                    _ => unreachable!(),
+                })
+                .collect();
+        }
+        level[0]
+    }
+
+    #[test]
+    fn test_incremental_tree_matches_rebuild() {
+        let leaves: Vec<[u8; 32]> = (0u32..40).map(|i| sha256(&i.to_le_bytes())).collect();
+        let mut tree = MerkleTree::default();
+        assert_eq!(tree.root(), [0u8; 32]);
+
+        for (count, leaf) in leaves.iter().enumerate() {
+            assert_eq!(tree.push(*leaf), count);
+            let prefix = &leaves[..=count];
+            let root = tree.root();
+            assert_eq!(root, naive_root(prefix));
+            assert_eq!(MerkleTree::new(prefix.to_vec()).root(), root);
+
+            for index in 0..=count {
+                let proof = tree.proof(index).unwrap();
+                assert!(MerkleTree::verify_proof(
+                    &root,
+                    &leaves[index],
+                    index,
+                    count + 1,
+                    &proof
+                ));
+                assert!(!MerkleTree::verify_proof(
+                    &root,
+                    &leaves[(index + 1) % leaves.len()],
+                    index,
+                    count + 1,
+                    &proof
+                ));
+            }
+        }
+        assert_eq!(tree.len(), 40);
+        assert!(tree.proof(40).is_none());
+    }
+
+    #[test]
+    fn test_batch_proofs() {
+        let leaves: Vec<[u8; 32]> = (0u32..13).map(|i| sha256(&i.to_le_bytes())).collect();
+        let tree = MerkleTree::new(leaves.clone());
+        let proofs = tree.proofs(&[0, 6, 12, 13]);
+
+        assert_eq!(proofs.len(), 4);
+        assert!(proofs[3].is_none());
+        for (&index, proof) in [0usize, 6, 12].iter().zip(&proofs) {
+            assert_eq!(proof.as_ref(), tree.proof(index).as_ref());
+            assert!(MerkleTree::verify_proof(
+                &tree.root(),
+                &leaves[index],
+                index,
+                leaves.len(),
+                proof.as_ref().unwrap()
+            ));
+        }
+    }
 }
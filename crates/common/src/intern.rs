@@ -0,0 +1,151 @@
+//! String interning for hot-path identifiers
+//!
+//! Asset pairs, price sources and oracle nodes are interned once at the edge
+//! (e.g. when a gRPC request arrives) into compact integer IDs. Per-pair and
+//! per-source state can then be indexed by ID instead of hashed and cloned by
+//! string on every update.
+
+use std::collections::HashMap;
+use std::sync::Arc;
+
+/// Compact identifier handed out by an [`Interner`]
+pub trait InternId: Copy {
+    fn from_index(index: usize) -> Self;
+    fn index(self) -> usize;
+}
+
+macro_rules! define_id {
+    ($(#[$meta:meta])* $name:ident) => {
+        $(#[$meta])*
+        #[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, PartialOrd, Ord)]
+        pub struct $name(pub u32);
+
+        impl InternId for $name {
+            fn from_index(index: usize) -> Self {
+                Self(index as u32)
+            }
+
+            fn index(self) -> usize {
+                self.0 as usize
+            }
+        }
+    };
+}
+
+define_id!(
+    /// Interned asset pair (e.g. "BTC/USD")
+    PairId
+);
+define_id!(
+    /// Interned price source (e.g. "binance")
+    SourceId
+);
+define_id!(
+    /// Interned oracle node identifier
+    NodeKey
+);
+
+/// Bidirectional name <-> ID table
+///
+/// IDs are dense and assigned in first-seen order, so they can index `Vec`s
+/// directly. Names are never removed.
+#[derive(Debug, Clone)]
+pub struct Interner<I> {
+    ids: HashMap<Arc<str>, I>,
+    names: Vec<Arc<str>>,
+}
+
+impl<I: InternId> Interner<I> {
+    pub fn new() -> Self {
+        Self {
+            ids: HashMap::new(),
+            names: Vec::new(),
+        }
+    }
+
+    /// Look up an already interned name (no allocation)
+    pub fn get(&self, name: &str) -> Option<I> {
+        self.ids.get(name).copied()
+    }
+
+    /// Intern a name, allocating only the first time it is seen
+    pub fn intern(&mut self, name: &str) -> I {
+        if let Some(id) = self.get(name) {
+            return id;
+        }
+
+        assert!(
+            self.names.len() < u32::MAX as usize,
+            "interner capacity exceeded"
+        );
+        let id = I::from_index(self.names.len());
+        let name: Arc<str> = Arc::from(name);
+        self.names.push(Arc::clone(&name));
+        self.ids.insert(name, id);
+        id
+    }
+
+    /// Name of an ID handed out by this interner
+    pub fn resolve(&self, id: I) -> &str {
+        &self.names[id.index()]
+    }
+
+    /// Shared handle to the name (cheap to clone into long-lived state)
+    pub fn resolve_shared(&self, id: I) -> Arc<str> {
+        Arc::clone(&self.names[id.index()])
+    }
+
+    pub fn len(&self) -> usize {
+        self.names.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.names.is_empty()
+    }
+
+    /// Iterate over `(id, name)` in ID order
+    pub fn iter(&self) -> impl Iterator<Item = (I, &str)> {
+        self.names
+            .iter()
+            .enumerate()
+            .map(|(index, name)| (I::from_index(index), &**name))
+    }
+}
+
+impl<I: InternId> Default for Interner<I> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_intern_is_stable_and_dense() {
+        let mut sources: Interner<SourceId> = Interner::new();
+
+        let binance = sources.intern("binance");
+        let kraken = sources.intern("kraken");
+        assert_eq!(binance, SourceId(0));
+        assert_eq!(kraken, SourceId(1));
+        assert_eq!(sources.intern("binance"), binance);
+        assert_eq!(sources.len(), 2);
+
+        assert_eq!(sources.get("kraken"), Some(kraken));
+        assert_eq!(sources.get("coinbase"), None);
+        assert_eq!(sources.resolve(kraken), "kraken");
+        assert_eq!(&*sources.resolve_shared(binance), "binance");
+    }
+
+    #[test]
+    fn test_iter_in_id_order() {
+        let mut pairs: Interner<PairId> = Interner::new();
+        pairs.intern("BTC/USD");
+        pairs.intern("ETH/USD");
+
+        let names: Vec<(PairId, &str)> = pairs.iter().collect();
+        assert_eq!(names, vec![(PairId(0), "BTC/USD"), (PairId(1), "ETH/USD")]);
+    }
+}
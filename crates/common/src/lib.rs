@@ -1,9 +1,14 @@
 //! Common types and utilities shared across Oracle VM components
 
 pub mod config;
+pub mod consensus;
 pub mod crypto;
 pub mod error;
+pub mod intern;
+pub mod metrics;
+pub mod price;
 pub mod types;
 
 pub use error::*;
+pub use price::Price;
 pub use types::*;
@@ -0,0 +1,71 @@
+//! Prometheus metrics shared by the service binaries
+//!
+//! Each metric registers itself in the process-wide default registry the
+//! first time its static is used. [`render`] encodes that registry in the
+//! text exposition format for a `/metrics` endpoint.
+
+use prometheus::{Encoder, HistogramOpts, Opts, TextEncoder};
+
+pub use prometheus::{HistogramVec, IntCounterVec};
+
+/// `Content-Type` of [`render`] output
+pub const CONTENT_TYPE: &str = prometheus::TEXT_FORMAT;
+
+/// Latency buckets in seconds (100µs to 30s)
+pub const LATENCY_BUCKETS: [f64; 16] = [
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5,
+    10.0, 30.0,
+];
+
+/// Register a latency histogram (seconds) with [`LATENCY_BUCKETS`]
+///
+/// Panics if the name is already registered, so keep each metric in a
+/// single `static`.
+pub fn latency_histogram(name: &str, help: &str, labels: &[&str]) -> HistogramVec {
+    let histogram = HistogramVec::new(
+        HistogramOpts::new(name, help).buckets(LATENCY_BUCKETS.to_vec()),
+        labels,
+    )
+    .expect("invalid histogram definition");
+    prometheus::register(Box::new(histogram.clone())).expect("metric registered twice");
+    histogram
+}
+
+/// Register a counter
+///
+/// Panics if the name is already registered, so keep each metric in a
+/// single `static`.
+pub fn counter(name: &str, help: &str, labels: &[&str]) -> IntCounterVec {
+    let counter =
+        IntCounterVec::new(Opts::new(name, help), labels).expect("invalid counter definition");
+    prometheus::register(Box::new(counter.clone())).expect("metric registered twice");
+    counter
+}
+
+/// Encode every registered metric in the text exposition format
+pub fn render() -> String {
+    let mut buffer = Vec::new();
+    TextEncoder::new()
+        .encode(&prometheus::gather(), &mut buffer)
+        .expect("text encoding cannot fail for gathered metrics");
+    String::from_utf8(buffer).expect("text encoding is UTF-8")
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_render_exposes_registered_metrics() {
+        let histogram = latency_histogram("test_stage_seconds", "Stage latency", &["stage"]);
+        let failures = counter("test_failures_total", "Failures", &["reason"]);
+
+        histogram.with_label_values(&["fetch"]).observe(0.003);
+        failures.with_label_values(&["no_quorum"]).inc();
+
+        let text = render();
+        assert!(text.contains("test_stage_seconds_bucket{stage=\"fetch\",le=\"0.005\"} 1"));
+        assert!(text.contains("test_stage_seconds_count{stage=\"fetch\"} 1"));
+        assert!(text.contains("test_failures_total{reason=\"no_quorum\"} 1"));
+    }
+}
@@ -0,0 +1,376 @@
+//! Fixed-point prices
+//!
+//! A [`Price`] is a signed 64-bit mantissa with the fixed decimal exponent
+//! [`Price::EXPONENT`] (`value = mantissa × 10^-8`), so one unit is the same
+//! "satoshi" of the quote currency used by settlement code. Exchange strings
+//! are parsed straight into the mantissa and consensus math (median, mean,
+//! deviation) stays in integers; `f64` conversions exist only for analytics
+//! and display at the edges.
+
+use crate::OracleVmError;
+use serde::{Deserialize, Serialize};
+use std::fmt;
+use std::str::FromStr;
+
+/// Mantissa units per whole quote-currency unit
+const SCALE: i64 = 100_000_000;
+/// Mantissa units per cent
+const CENTS_SCALE: i64 = SCALE / 100;
+
+/// Fixed-point price (`mantissa × 10^-8`)
+#[derive(
+    Debug, Clone, Copy, Default, PartialEq, Eq, PartialOrd, Ord, Hash, Serialize, Deserialize,
+)]
+#[serde(transparent)]
+pub struct Price(i64);
+
+impl Price {
+    /// Decimal exponent of the mantissa
+    pub const EXPONENT: i32 = -8;
+    /// Number of fractional digits the mantissa carries
+    pub const DECIMALS: u32 = 8;
+    pub const ZERO: Self = Self(0);
+
+    pub const fn from_mantissa(mantissa: i64) -> Self {
+        Self(mantissa)
+    }
+
+    pub const fn mantissa(self) -> i64 {
+        self.0
+    }
+
+    /// Price from whole cents (panics on overflow, meant for constants)
+    pub const fn from_cents(cents: i64) -> Self {
+        match cents.checked_mul(CENTS_SCALE) {
+            Some(mantissa) => Self(mantissa),
+            None => panic!("price overflow"),
+        }
+    }
+
+    /// Price from whole quote-currency units (panics on overflow, meant for constants)
+    pub const fn from_units(units: i64) -> Self {
+        match units.checked_mul(SCALE) {
+            Some(mantissa) => Self(mantissa),
+            None => panic!("price overflow"),
+        }
+    }
+
+    /// `mantissa × 10^exponent` rescaled to [`Price::EXPONENT`]
+    ///
+    /// Digits below the price resolution are rounded half away from zero.
+    /// Returns `None` if the value does not fit.
+    pub fn from_parts(mantissa: i64, exponent: i32) -> Option<Self> {
+        let shift = exponent.checked_sub(Self::EXPONENT)?;
+        if shift >= 0 {
+            let factor = 10i64.checked_pow(shift as u32)?;
+            return mantissa.checked_mul(factor).map(Self);
+        }
+
+        match 10i128.checked_pow(shift.unsigned_abs()) {
+            Some(divisor) => Some(Self(div_round(mantissa as i128, divisor) as i64)),
+            // Divisor larger than any mantissa
+            None => Some(Self::ZERO),
+        }
+    }
+
+    /// Price in cents, rounded half away from zero
+    pub fn to_cents(self) -> i64 {
+        div_round(self.0 as i128, CENTS_SCALE as i128) as i64
+    }
+
+    /// Convert from `f64` (rounded to the price resolution)
+    ///
+    /// Only for sources that publish numbers rather than decimal strings.
+    pub fn from_f64(value: f64) -> Option<Self> {
+        let mantissa = (value * SCALE as f64).round();
+        (mantissa.is_finite() && mantissa >= i64::MIN as f64 && mantissa < i64::MAX as f64)
+            .then_some(Self(mantissa as i64))
+    }
+
+    /// Lossy conversion for analytics and display
+    pub fn to_f64(self) -> f64 {
+        self.0 as f64 / SCALE as f64
+    }
+
+    pub fn is_positive(self) -> bool {
+        self.0 > 0
+    }
+
+    pub fn checked_add(self, other: Self) -> Option<Self> {
+        self.0.checked_add(other.0).map(Self)
+    }
+
+    pub fn checked_sub(self, other: Self) -> Option<Self> {
+        self.0.checked_sub(other.0).map(Self)
+    }
+
+    /// Absolute difference in mantissa units
+    pub fn abs_diff(self, other: Self) -> u64 {
+        self.0.abs_diff(other.0)
+    }
+
+    /// Deviation from `reference` in basis points (rounded down)
+    ///
+    /// Returns `None` for a zero reference.
+    pub fn deviation_bps(self, reference: Self) -> Option<u64> {
+        if reference.0 == 0 {
+            return None;
+        }
+        let bps = self.abs_diff(reference) as u128 * 10_000 / reference.0.unsigned_abs() as u128;
+        Some(bps.min(u64::MAX as u128) as u64)
+    }
+
+    /// Arithmetic mean, rounded half away from zero (`None` if empty)
+    ///
+    /// The sum is accumulated in `i128`, so it cannot overflow.
+    pub fn mean(prices: impl IntoIterator<Item = Self>) -> Option<Self> {
+        let (sum, count) = prices
+            .into_iter()
+            .fold((0i128, 0i128), |(sum, count), price| {
+                (sum + price.0 as i128, count + 1)
+            });
+        (count > 0).then(|| Self(div_round(sum, count) as i64))
+    }
+
+    /// Median (`None` if empty)
+    ///
+    /// Uses selection instead of a full sort and reorders `prices`. For an
+    /// even count the two middle values are averaged.
+    pub fn median(prices: &mut [Self]) -> Option<Self> {
+        if prices.is_empty() {
+            return None;
+        }
+
+        let len = prices.len();
+        let (lower, &mut upper, _) = prices.select_nth_unstable(len / 2);
+        if len % 2 == 1 {
+            return Some(upper);
+        }
+        let lower = lower.iter().copied().max().unwrap_or(upper);
+        Some(Self(div_round(lower.0 as i128 + upper.0 as i128, 2) as i64))
+    }
+}
+
+/// Integer division rounding half away from zero (`divisor > 0`)
+fn div_round(value: i128, divisor: i128) -> i128 {
+    let quotient = value / divisor;
+    let remainder = value % divisor;
+    if remainder.abs() * 2 >= divisor {
+        quotient + value.signum()
+    } else {
+        quotient
+    }
+}
+
+impl FromStr for Price {
+    type Err = OracleVmError;
+
+    /// Parse a decimal string (e.g. "67321.45000000")
+    ///
+    /// Digits beyond [`Price::DECIMALS`] are rounded half away from zero.
+    fn from_str(s: &str) -> Result<Self, Self::Err> {
+        let invalid = || OracleVmError::InvalidData(format!("Invalid price '{}'", s));
+
+        let (negative, digits) = match s.strip_prefix('-') {
+            Some(rest) => (true, rest),
+            None => (false, s),
+        };
+        let (whole, fraction) = digits.split_once('.').unwrap_or((digits, ""));
+        if whole.is_empty() && fraction.is_empty() {
+            return Err(invalid());
+        }
+
+        let mut mantissa: i64 = 0;
+        for byte in whole.bytes() {
+            mantissa = mantissa
+                .checked_mul(10)
+                .and_then(|m| m.checked_add(digit(byte)?))
+                .ok_or_else(invalid)?;
+        }
+
+        let mut fraction = fraction.bytes();
+        for _ in 0..Self::DECIMALS {
+            let value = match fraction.next() {
+                Some(byte) => digit(byte).ok_or_else(invalid)?,
+                None => 0,
+            };
+            mantissa = mantissa
+                .checked_mul(10)
+                .and_then(|m| m.checked_add(value))
+                .ok_or_else(invalid)?;
+        }
+
+        let round_up = match fraction.next() {
+            Some(byte) => digit(byte).ok_or_else(invalid)? >= 5,
+            None => false,
+        };
+        if !fraction.all(|byte| byte.is_ascii_digit()) {
+            return Err(invalid());
+        }
+        mantissa = mantissa.checked_add(round_up as i64).ok_or_else(invalid)?;
+
+        Ok(Self(if negative { -mantissa } else { mantissa }))
+    }
+}
+
+fn digit(byte: u8) -> Option<i64> {
+    byte.is_ascii_digit().then(|| (byte - b'0') as i64)
+}
+
+impl fmt::Display for Price {
+    /// Honors a precision (`{:.2}` rounds to cents); without one, prints
+    /// every significant fractional digit.
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        let decimals = f
+            .precision()
+            .map_or(Self::DECIMALS, |p| (p as u32).min(Self::DECIMALS));
+        let value = div_round(self.0 as i128, 10i128.pow(Self::DECIMALS - decimals));
+        let unit = 10i128.pow(decimals);
+        let sign = if value < 0 { "-" } else { "" };
+        let (whole, fraction) = (value.abs() / unit, value.abs() % unit);
+
+        if f.precision().is_some() {
+            return match decimals {
+                0 => write!(f, "{}{}", sign, whole),
+                _ => write!(
+                    f,
+                    "{}{}.{:0width$}",
+                    sign,
+                    whole,
+                    fraction,
+                    width = decimals as usize
+                ),
+            };
+        }
+
+        let fraction = format!("{:0width$}", fraction, width = decimals as usize);
+        match fraction.trim_end_matches('0') {
+            "" => write!(f, "{}{}", sign, whole),
+            fraction => write!(f, "{}{}.{}", sign, whole, fraction),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn parse(s: &str) -> Option<Price> {
+        s.parse().ok()
+    }
+
+    #[test]
+    fn test_parse_decimal_string() {
+        assert_eq!(parse("67321.45000000"), Some(Price::from_cents(6_732_145)));
+        assert_eq!(parse("0.29"), Some(Price::from_cents(29)));
+        assert_eq!(parse("100"), Some(Price::from_units(100)));
+        assert_eq!(parse(".5"), Some(Price::from_cents(50)));
+        assert_eq!(parse("-1.5"), Some(Price::from_cents(-150)));
+        assert_eq!(parse("0.000000015"), Some(Price::from_mantissa(2)));
+        assert_eq!(parse("0.0000000149"), Some(Price::from_mantissa(1)));
+
+        assert_eq!(parse(""), None);
+        assert_eq!(parse("."), None);
+        assert_eq!(parse("1.2x"), None);
+        assert_eq!(parse("1.234567891a"), None);
+        assert_eq!(parse("99999999999999999999"), None);
+    }
+
+    #[test]
+    fn test_rescale_parts() {
+        let price = Price::from_cents(7_000_012);
+        assert_eq!(Price::from_parts(7_000_012, -2), Some(price));
+        assert_eq!(
+            Price::from_parts(price.mantissa(), Price::EXPONENT),
+            Some(price)
+        );
+        assert_eq!(
+            Price::from_parts(70_000_125, -3),
+            Some(Price::from_mantissa(7_000_012_500_000))
+        );
+        assert_eq!(Price::from_parts(15, -9), Some(Price::from_mantissa(2)));
+        assert_eq!(Price::from_parts(-15, -9), Some(Price::from_mantissa(-2)));
+        assert_eq!(Price::from_parts(1, -60), Some(Price::ZERO));
+        assert_eq!(Price::from_parts(1, 20), None);
+
+        assert_eq!(parse("67321.455").unwrap().to_cents(), 6_732_146);
+        assert_eq!(parse("67321.454999").unwrap().to_cents(), 6_732_145);
+    }
+
+    #[test]
+    fn test_f64_edges() {
+        // 0.29 * 1e8 is not exact in f64 but rounds back to the same price
+        assert_eq!(Price::from_f64(0.29), Some(Price::from_cents(29)));
+        assert_eq!(
+            Price::from_f64(67321.45),
+            Some(Price::from_cents(6_732_145))
+        );
+        assert_eq!(Price::from_f64(f64::NAN), None);
+        assert_eq!(Price::from_f64(1e300), None);
+        assert_eq!(Price::from_cents(7_000_050).to_f64(), 70000.5);
+    }
+
+    #[test]
+    fn test_median_and_mean() {
+        let mut odd = [
+            Price::from_units(70_100),
+            Price::from_units(70_000),
+            Price::from_units(75_000),
+        ];
+        assert_eq!(Price::median(&mut odd), Some(Price::from_units(70_100)));
+
+        let mut even = [
+            Price::from_mantissa(3),
+            Price::from_mantissa(1),
+            Price::from_mantissa(10),
+            Price::from_mantissa(2),
+        ];
+        // (2 + 3) / 2 = 2.5 -> 3
+        assert_eq!(Price::median(&mut even), Some(Price::from_mantissa(3)));
+        assert_eq!(Price::median(&mut []), None);
+
+        let prices = [Price::from_units(70_000), Price::from_units(70_001)];
+        assert_eq!(Price::mean(prices), Some(Price::from_cents(7_000_050)));
+        // Sum exceeds i64 but the mean does not
+        assert_eq!(
+            Price::mean([Price::from_mantissa(i64::MAX); 3]),
+            Some(Price::from_mantissa(i64::MAX))
+        );
+        assert_eq!(Price::mean([]), None);
+    }
+
+    #[test]
+    fn test_deviation_bps() {
+        let reference = Price::from_units(70_000);
+        assert_eq!(
+            Price::from_units(70_700).deviation_bps(reference),
+            Some(100)
+        );
+        assert_eq!(
+            Price::from_units(65_100).deviation_bps(reference),
+            Some(700)
+        );
+        assert_eq!(reference.deviation_bps(Price::ZERO), None);
+    }
+
+    #[test]
+    fn test_display() {
+        let price = parse("70000.12345678").unwrap();
+        assert_eq!(price.to_string(), "70000.12345678");
+        assert_eq!(format!("{:.2}", price), "70000.12");
+        assert_eq!(format!("{:.0}", price), "70000");
+        assert_eq!(Price::from_units(70_000).to_string(), "70000");
+        assert_eq!(Price::from_cents(-150).to_string(), "-1.5");
+        assert_eq!(format!("{:.2}", Price::from_mantissa(-499_999)), "0.00");
+    }
+
+    #[test]
+    fn test_serde_is_transparent() {
+        let price = Price::from_cents(7_000_012);
+        assert_eq!(serde_json::to_string(&price).unwrap(), "7000012000000");
+        assert_eq!(
+            serde_json::from_str::<Price>("7000012000000").unwrap(),
+            price
+        );
+    }
+}
@@ -1,8 +1,11 @@
 //! Common types for Oracle VM
 
+use crate::{OracleVmError, Price};
 use bitcoin::PublicKey;
 use chrono::{DateTime, Utc};
 use serde::{Deserialize, Serialize};
+use std::fmt;
+use std::str::FromStr;
 
 /// Option type
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Serialize, Deserialize)]
@@ -16,6 +19,11 @@ pub enum OptionType {
 pub struct AssetPair(pub String);
 
 impl AssetPair {
+    /// Build a pair from base and quote symbols (normalized to upper case)
+    pub fn new(base: &str, quote: &str) -> Self {
+        Self(format!("{}/{}", base.to_uppercase(), quote.to_uppercase()))
+    }
+
     pub fn btc_usd() -> Self {
         Self("BTC/USD".to_string())
     }
@@ -23,15 +31,53 @@ impl AssetPair {
     pub fn as_str(&self) -> &str {
         &self.0
     }
+
+    /// Base asset symbol (e.g. "BTC")
+    pub fn base(&self) -> &str {
+        self.0
+            .split_once('/')
+            .map(|(base, _)| base)
+            .unwrap_or(&self.0)
+    }
+
+    /// Quote asset symbol (e.g. "USD")
+    pub fn quote(&self) -> &str {
+        self.0.split_once('/').map(|(_, quote)| quote).unwrap_or("")
+    }
+}
+
+impl FromStr for AssetPair {
+    type Err = OracleVmError;
+
+    /// Parse "BASE/QUOTE" (e.g. "eth/usd" -> "ETH/USD")
+    fn from_str(s: &str) -> Result<Self, Self::Err> {
+        match s.trim().split_once('/') {
+            Some((base, quote))
+                if !base.is_empty() && !quote.is_empty() && !quote.contains('/') =>
+            {
+                Ok(Self::new(base, quote))
+            }
+            _ => Err(OracleVmError::InvalidData(format!(
+                "Invalid asset pair '{}', expected BASE/QUOTE",
+                s
+            ))),
+        }
+    }
+}
+
+impl fmt::Display for AssetPair {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.write_str(&self.0)
+    }
 }
 
 /// Price data from an oracle source
 #[derive(Debug, Clone, Serialize, Deserialize)]
 pub struct PriceData {
     pub pair: AssetPair,
-    pub price: u64, // Price in cents (for USD pairs)
+    pub price: Price,
     pub timestamp: DateTime<Utc>,
-    pub volume: Option<u64>, // 24h volume
+    pub volume: Option<f64>, // Base-asset volume of the sampled candle
     pub source: String,      // Exchange name
 }
 
@@ -47,8 +93,8 @@ pub struct SignedPriceData {
 #[derive(Debug, Clone, Serialize, Deserialize)]
 pub struct AggregatedPrice {
     pub pair: AssetPair,
-    pub median_price: u64,
-    pub mean_price: u64,
+    pub median_price: Price,
+    pub mean_price: Price,
     pub timestamp: DateTime<Utc>,
     pub sources: Vec<String>,
     pub confidence: f64, // 0.0 to 1.0
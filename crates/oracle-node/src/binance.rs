@@ -1,39 +1,89 @@
+use crate::http::{self, CandleQuote};
 use crate::price_provider::PriceProvider;
 use oracle_vm_common::types::{PriceData, AssetPair};
+use oracle_vm_common::Price;
 use anyhow::{Context, Result};
 use async_trait::async_trait;
 use chrono::{DateTime, Timelike};
 use reqwest::Client;
+use serde::de::IgnoredAny;
+use serde::Deserialize;
 use std::time::Duration;
 use tokio::time::sleep;
-use tracing::{error, info, warn};
+use tracing::{debug, error, warn};
 
 /// 바이낸스 K-line API 주소 (1분 캔들스틱)
 const BINANCE_API_URL: &str = "https://api.binance.com/api/v3/klines";
 /// 최대 재시도 횟수
 const MAX_RETRIES: u32 = 3;
-/// HTTP 요청 타임아웃 (초)
-const REQUEST_TIMEOUT: u64 = 10;
 
-/// 바이낸스에서 받아오는 K-line 데이터 구조
+/// 바이낸스 K-line 하나 - 쓰는 필드만 읽고(문자열은 응답 본문에서 빌림) 나머지는 건너뜀
 /// [open_time, open, high, low, close, volume, close_time, quote_volume, count, taker_buy_volume, taker_buy_quote_volume, ignore]
-type BinanceKlineResponse = Vec<[serde_json::Value; 12]>;
+#[derive(Debug, Deserialize)]
+struct BinanceKline<'a>(
+    u64,
+    IgnoredAny,
+    IgnoredAny,
+    IgnoredAny,
+    &'a str,
+    &'a str,
+    IgnoredAny,
+    IgnoredAny,
+    IgnoredAny,
+    IgnoredAny,
+    IgnoredAny,
+    IgnoredAny,
+);
+
+/// K-line 응답 본문 -> 첫 캔들의 종가/거래량
+fn parse_klines(body: &[u8]) -> Result<CandleQuote> {
+    let klines: Vec<BinanceKline> =
+        serde_json::from_slice(body).context("Failed to parse Binance JSON response")?;
+    let kline = klines
+        .first()
+        .ok_or_else(|| anyhow::anyhow!("No K-line data received from Binance"))?;
+
+    let close = kline.4
+        .parse::<Price>()
+        .with_context(|| format!("Failed to parse close price from Binance: {}", kline.4))?;
+
+    Ok(CandleQuote {
+        open_time: kline.0 / 1000,
+        close,
+        // 거래량은 없어도 가격은 사용
+        volume: kline.5.parse::<f64>().ok(),
+    })
+}
 
 /// 바이낸스와 통신하는 클라이언트
 pub struct BinanceClient {
     client: Client, // HTTP 요청을 보내는 도구
+    pair: AssetPair,
+    symbol: String, // 바이낸스 심볼 (예: BTCUSDT)
+}
+
+/// 자산 쌍을 바이낸스 심볼로 변환 (USD 시세는 USDT 마켓 사용)
+pub(crate) fn binance_symbol(pair: &AssetPair) -> String {
+    let quote = match pair.quote() {
+        "USD" => "USDT",
+        quote => quote,
+    };
+    format!("{}{}", pair.base(), quote)
 }
 
 impl BinanceClient {
-    /// 새로운 바이낸스 클라이언트를 만듭니다
+    /// 새로운 바이낸스 클라이언트를 만듭니다 (BTC/USD)
     pub fn new() -> Self {
-        let client = Client::builder()
-            .timeout(Duration::from_secs(REQUEST_TIMEOUT)) // 10초 후 타임아웃
-            .user_agent("OracleVM/1.0") // 우리가 누구인지 알려줌
-            .build()
-            .expect("Failed to create HTTP client");
+        Self::with_pair(AssetPair::btc_usd())
+    }
 
-        Self { client }
+    /// 지정한 자산 쌍을 조회하는 클라이언트를 만듭니다 (공유 연결 풀 사용)
+    pub fn with_pair(pair: AssetPair) -> Self {
+        Self {
+            client: http::shared_client(),
+            symbol: binance_symbol(&pair),
+            pair,
+        }
     }
 
     /// 비트코인 가격을 가져옵니다 (재시도 포함)
@@ -44,14 +94,17 @@ impl BinanceClient {
     /// 재시도 로직이 포함된 가격 가져오기
     async fn fetch_btc_price_with_retry(&self, max_retries: u32) -> Result<PriceData> {
         for attempt in 1..=max_retries {
-            info!(
-                "Fetching BTC price from Binance (attempt {}/{})",
-                attempt, max_retries
+            debug!(
+                "Fetching {} price from Binance (attempt {}/{})",
+                self.pair, attempt, max_retries
             );
 
             match self.fetch_btc_price_once().await {
                 Ok(price_data) => {
-                    info!("Successfully fetched BTC price: ${:.2}", price_data.price);
+                    debug!(
+                        "Successfully fetched {} price: ${:.2}",
+                        self.pair, price_data.price
+                    );
                     return Ok(price_data);
                 }
                 Err(e) if attempt < max_retries => {
@@ -87,15 +140,16 @@ impl BinanceClient {
         let start_time = target_minute_start.timestamp() * 1000; // 밀리초 단위
         let end_time = current_minute_start.timestamp() * 1000;
 
-        info!(
-            "🎯 Binance: Requesting K-line for {} UTC",
+        debug!(
+            "🎯 Binance: Requesting {} K-line for {} UTC",
+            self.symbol,
             target_minute_start.format("%H:%M:%S")
         );
 
         // 1. 특정 시점의 1분 K-line 데이터 요청
         let url = format!(
-            "{}?symbol=BTCUSDT&interval=1m&startTime={}&endTime={}&limit=1",
-            BINANCE_API_URL, start_time, end_time
+            "{}?symbol={}&interval=1m&startTime={}&endTime={}&limit=1",
+            BINANCE_API_URL, self.symbol, start_time, end_time
         );
 
         // 2. 바이낸스에 HTTP 요청 보내기
@@ -111,61 +165,36 @@ impl BinanceClient {
             return self.handle_http_error(response.status().as_u16());
         }
 
-        // 4. JSON 응답을 K-line 배열로 변환
-        let klines: BinanceKlineResponse = response
-            .json()
+        // 4. 본문을 받아 첫 K-line의 종가/거래량만 읽기 (index 4 = close, 5 = volume)
+        let body = response
+            .bytes()
             .await
-            .context("Failed to parse Binance JSON response")?;
-
-        if klines.is_empty() {
-            anyhow::bail!("No K-line data received from Binance");
-        }
-
-        // 5. 가장 최근 K-line의 종가 사용 (index 4 = close price)
-        let latest_kline = &klines[0];
-
-        // K-line 시간 정보 추출
-        let open_time = latest_kline[0]
-            .as_u64()
-            .ok_or_else(|| anyhow::anyhow!("Failed to get open time from Binance K-line"))?;
-        let close_time = latest_kline[6]
-            .as_u64()
-            .ok_or_else(|| anyhow::anyhow!("Failed to get close time from Binance K-line"))?;
-
-        let close_price_str = latest_kline[4]
-            .as_str()
-            .ok_or_else(|| anyhow::anyhow!("Failed to get close price from Binance K-line"))?;
-
-        let price = close_price_str
-            .parse::<f64>()
-            .context("Failed to parse close price as number")?;
+            .context("Failed to read Binance response")?;
+        let quote = parse_klines(&body)?;
 
         // K-line 시간 정보 로깅
         let open_time_dt =
-            chrono::DateTime::from_timestamp(open_time as i64 / 1000, 0).unwrap_or_default();
-        let close_time_dt =
-            chrono::DateTime::from_timestamp(close_time as i64 / 1000, 0).unwrap_or_default();
-
-        info!(
-            "📊 Binance K-line: {:.2} USD (period: {} ~ {})",
-            price,
-            open_time_dt.format("%H:%M:%S"),
-            close_time_dt.format("%H:%M:%S")
+            chrono::DateTime::from_timestamp(quote.open_time as i64, 0).unwrap_or_default();
+
+        debug!(
+            "📊 Binance K-line: {:.2} USD (period: {} ~ +1m)",
+            quote.close_price(),
+            open_time_dt.format("%H:%M:%S")
         );
 
         // 6. 가격이 말이 되는지 검증
-        self.validate_price(price)?;
+        self.validate_price(quote.close_price())?;
 
         // 7. 현재 시간 기록
         let timestamp = chrono::Utc::now().timestamp() as u64;
 
         // 8. 최종 결과 반환
         Ok(PriceData {
-            pair: AssetPair::btc_usd(),
-            price: (price * 100.0) as u64, // Convert to cents
+            pair: self.pair.clone(),
+            price: quote.close,
             timestamp: DateTime::from_timestamp(timestamp as i64, 0)
                 .unwrap_or_else(chrono::Utc::now),
-            volume: None,
+            volume: quote.volume,
             source: "binance".to_string(),
         })
     }
@@ -176,7 +205,7 @@ impl BinanceClient {
             400 => anyhow::bail!("Bad request - Check API parameters"),
             401 => anyhow::bail!("Unauthorized - API key issue"),
             403 => anyhow::bail!("Forbidden - Access denied"),
-            404 => anyhow::bail!("Not found - Check symbol/interval (BTCUSDT/1m)"),
+            404 => anyhow::bail!("Not found - Check symbol/interval ({}/1m)", self.symbol),
             429 => anyhow::bail!("Rate limit exceeded - Too many requests"),
             500..=599 => anyhow::bail!("Binance server error - Try again later"),
             _ => anyhow::bail!("HTTP error: {}", status_code),
@@ -189,11 +218,12 @@ impl BinanceClient {
             anyhow::bail!("Invalid price: must be positive, got {}", price);
         }
 
-        if price < 1000.0 {
+        // 상식선 경고는 BTC 시세에만 적용
+        if self.pair.base() == "BTC" && price < 1000.0 {
             warn!("Unusually low BTC price: ${:.2}", price);
         }
 
-        if price > 1_000_000.0 {
+        if self.pair.base() == "BTC" && price > 1_000_000.0 {
             warn!("Unusually high BTC price: ${:.2}", price);
         }
 
@@ -224,6 +254,25 @@ mod tests {
         assert!(client.validate_price(-100.0).is_err());
     }
 
+    #[test]
+    fn test_symbol_mapping() {
+        assert_eq!(binance_symbol(&AssetPair::btc_usd()), "BTCUSDT");
+        assert_eq!(binance_symbol(&AssetPair::new("eth", "usd")), "ETHUSDT");
+        assert_eq!(binance_symbol(&AssetPair::new("ETH", "BTC")), "ETHBTC");
+    }
+
+    #[test]
+    fn test_kline_parsing() {
+        let body = br#"[[1700000000000,"67300.01","67350.00","67290.00","67321.45000000","12.34500000",1700000059999,"830000.0",1234,"6.0","400000.0","0"]]"#;
+        let quote = parse_klines(body).unwrap();
+        assert_eq!(quote.open_time, 1_700_000_000);
+        assert_eq!(quote.close, Price::from_cents(6_732_145));
+        assert_eq!(quote.volume, Some(12.345));
+
+        assert!(parse_klines(b"[]").is_err());
+        assert!(parse_klines(br#"[[1700000000000,"1","1","1","abc","1",1,"1",1,"1","1","0"]]"#).is_err());
+    }
+
     #[test]
     fn test_http_error_handling() {
         let client = BinanceClient::new();
@@ -243,7 +292,7 @@ mod tests {
 
         match result {
             Ok(price_data) => {
-                assert!(price_data.price > 0.0);
+                assert!(price_data.price.is_positive());
                 assert_eq!(price_data.source, "binance");
                 println!("Real BTC price: ${:.2}", price_data.price);
             }
@@ -259,6 +308,11 @@ impl PriceProvider for BinanceClient {
     async fn fetch_btc_price(&self) -> Result<PriceData> {
         self.fetch_btc_price_with_retry(MAX_RETRIES).await
     }
+
+    async fn fetch_btc_price_once(&self) -> Result<PriceData> {
+        // 고유 메서드 호출 (재시도 없음)
+        self.fetch_btc_price_once().await
+    }
     
     fn name(&self) -> &str {
         "binance"
@@ -1,39 +1,76 @@
+use crate::http::{self, CandleQuote};
 use crate::price_provider::PriceProvider;
 use oracle_vm_common::types::{PriceData, AssetPair};
+use oracle_vm_common::Price;
 use anyhow::{Context, Result};
 use async_trait::async_trait;
 use chrono::DateTime;
 use reqwest::Client;
+use serde::de::IgnoredAny;
+use serde::Deserialize;
 use std::time::Duration;
 use tokio::time::sleep;
-use tracing::{error, info, warn};
+use tracing::{debug, error, warn};
 
-/// Coinbase Pro API URL
-const COINBASE_API_URL: &str = "https://api.exchange.coinbase.com/products/BTC-USD/candles";
+/// Coinbase Pro API URL (상품 목록)
+const COINBASE_PRODUCTS_URL: &str = "https://api.exchange.coinbase.com/products";
 /// 최대 재시도 횟수
 const MAX_RETRIES: u32 = 3;
-/// HTTP 요청 타임아웃 (초)
-const REQUEST_TIMEOUT: u64 = 10;
 
-/// Coinbase에서 받아오는 캔들스틱 데이터 구조
+/// Coinbase 캔들 하나 - 쓰는 필드만 읽고 나머지는 건너뜀
 /// [timestamp, low, high, open, close, volume]
-type CoinbaseCandleResponse = Vec<[f64; 6]>;
+#[derive(Debug, Deserialize)]
+struct CoinbaseCandle(u64, IgnoredAny, IgnoredAny, IgnoredAny, f64, f64);
+
+/// 캔들 응답 본문 -> 가장 최근 캔들(첫 번째 요소)의 종가/거래량
+fn parse_candles(body: &[u8]) -> Result<CandleQuote> {
+    let candles: Vec<CoinbaseCandle> =
+        serde_json::from_slice(body).context("Failed to parse Coinbase response")?;
+    let candle = candles
+        .first()
+        .ok_or_else(|| anyhow::anyhow!("No candle data received from Coinbase"))?;
+
+    // Coinbase는 가격을 숫자로 준다
+    let close = Price::from_f64(candle.4)
+        .filter(|price| price.is_positive())
+        .ok_or_else(|| anyhow::anyhow!("Invalid price from Coinbase: {}", candle.4))?;
+
+    Ok(CandleQuote {
+        open_time: candle.0,
+        close,
+        volume: Some(candle.5),
+    })
+}
 
 /// Coinbase Pro와 통신하는 클라이언트
 pub struct CoinbaseClient {
     client: Client,
+    pair: AssetPair,
+    candles_url: String, // 예: .../products/BTC-USD/candles
+}
+
+/// 자산 쌍을 Coinbase 상품 ID로 변환 (예: BTC-USD)
+pub(crate) fn coinbase_product_id(pair: &AssetPair) -> String {
+    format!("{}-{}", pair.base(), pair.quote())
 }
 
 impl CoinbaseClient {
-    /// 새로운 Coinbase 클라이언트를 만듭니다
+    /// 새로운 Coinbase 클라이언트를 만듭니다 (BTC/USD)
     pub fn new() -> Self {
-        let client = Client::builder()
-            .timeout(Duration::from_secs(REQUEST_TIMEOUT))
-            .user_agent("OracleVM/1.0")
-            .build()
-            .expect("Failed to create HTTP client");
+        Self::with_pair(AssetPair::btc_usd())
+    }
 
-        Self { client }
+    /// 지정한 자산 쌍을 조회하는 클라이언트를 만듭니다 (공유 연결 풀 사용)
+    pub fn with_pair(pair: AssetPair) -> Self {
+        Self {
+            client: http::shared_client(),
+            candles_url: format!(
+                "{}/{}/candles",
+                COINBASE_PRODUCTS_URL,
+                coinbase_product_id(&pair)
+            ),
+            pair,
+        }
     }
 
     /// 비트코인 가격을 가져옵니다 (재시도 포함)
@@ -44,16 +81,16 @@ impl CoinbaseClient {
     /// 재시도 로직이 포함된 가격 가져오기
     async fn fetch_btc_price_with_retry(&self, max_retries: u32) -> Result<PriceData> {
         for attempt in 1..=max_retries {
-            info!(
-                "Fetching BTC price from Coinbase (attempt {}/{})",
-                attempt, max_retries
+            debug!(
+                "Fetching {} price from Coinbase (attempt {}/{})",
+                self.pair, attempt, max_retries
             );
 
             match self.fetch_btc_price_once().await {
                 Ok(price_data) => {
-                    info!(
-                        "✅ Successfully fetched BTC price from Coinbase: ${:.2}",
-                        price_data.price
+                    debug!(
+                        "✅ Successfully fetched {} price from Coinbase: ${:.2}",
+                        self.pair, price_data.price
                     );
                     return Ok(price_data);
                 }
@@ -83,11 +120,11 @@ impl CoinbaseClient {
             ("limit", "2"),           // 최근 2개
         ];
 
-        info!("🌐 Calling Coinbase API: {}", COINBASE_API_URL);
+        debug!("🌐 Calling Coinbase API: {}", self.candles_url);
 
         let response = self
             .client
-            .get(COINBASE_API_URL)
+            .get(&self.candles_url)
             .query(&params)
             .send()
             .await
@@ -101,33 +138,21 @@ impl CoinbaseClient {
             );
         }
 
-        let candles: CoinbaseCandleResponse = response
-            .json()
+        let body = response
+            .bytes()
             .await
-            .context("Failed to parse Coinbase response")?;
-
-        if candles.is_empty() {
-            anyhow::bail!("No candle data received from Coinbase");
-        }
-
-        // 가장 최근 캔들 선택 (첫 번째 요소)
-        let latest_candle = &candles[0];
-        let close_price = latest_candle[4]; // close price
-        let timestamp = latest_candle[0] as u64; // timestamp
+            .context("Failed to read Coinbase response")?;
+        let quote = parse_candles(&body)?;
+        let timestamp = quote.open_time;
 
         // 타임스탬프 로깅
         let dt = chrono::DateTime::from_timestamp(timestamp as i64, 0).unwrap_or_default();
-        info!(
+        debug!(
             "📊 Coinbase candle: {:.2} USD (time: {})",
-            close_price,
+            quote.close_price(),
             dt.format("%Y-%m-%d %H:%M:%S UTC")
         );
 
-        // 2/3 합의 시스템 추가 전까지 간단한 검증
-        if close_price <= 0.0 {
-            anyhow::bail!("Invalid price from Coinbase: {}", close_price);
-        }
-
         // timestamp가 10분 이상 오래된 경우 경고
         let now = chrono::Utc::now().timestamp() as u64;
         if now > timestamp + 600 {
@@ -138,11 +163,11 @@ impl CoinbaseClient {
         }
 
         Ok(PriceData {
-            pair: AssetPair::btc_usd(),
-            price: (close_price * 100.0) as u64, // Convert to cents
+            pair: self.pair.clone(),
+            price: quote.close,
             timestamp: DateTime::from_timestamp(timestamp as i64, 0)
                 .unwrap_or_else(chrono::Utc::now),
-            volume: None,
+            volume: quote.volume,
             source: "coinbase".to_string(),
         })
     }
@@ -167,6 +192,11 @@ impl PriceProvider for CoinbaseClient {
     async fn fetch_btc_price(&self) -> Result<PriceData> {
         self.fetch_btc_price_with_retry(MAX_RETRIES).await
     }
+
+    async fn fetch_btc_price_once(&self) -> Result<PriceData> {
+        // 고유 메서드 호출 (재시도 없음)
+        self.fetch_btc_price_once().await
+    }
     
     fn name(&self) -> &str {
         "coinbase"
@@ -184,6 +214,24 @@ mod tests {
         assert_eq!(client.name(), "coinbase");
     }
 
+    #[test]
+    fn test_product_id_mapping() {
+        assert_eq!(coinbase_product_id(&AssetPair::btc_usd()), "BTC-USD");
+        assert_eq!(coinbase_product_id(&AssetPair::new("eth", "usd")), "ETH-USD");
+    }
+
+    #[test]
+    fn test_candle_parsing() {
+        let body = br#"[[1700000040,67290.0,67350.5,67300.01,67321.45,12.345],[1700000000,67200.0,67310.0,67250.0,67300.01,8.5]]"#;
+        let quote = parse_candles(body).unwrap();
+        assert_eq!(quote.open_time, 1_700_000_040);
+        assert_eq!(quote.close, Price::from_cents(6_732_145));
+        assert_eq!(quote.volume, Some(12.345));
+
+        assert!(parse_candles(b"[]").is_err());
+        assert!(parse_candles(br#"[[1700000040,1.0,1.0,1.0,0.0,1.0]]"#).is_err());
+    }
+
     #[test]
     fn test_price_formatting() {
         let price = 12345.67;
@@ -214,7 +262,7 @@ mod tests {
         
         match result {
             Ok(price_data) => {
-                assert!(price_data.price > 0.0);
+                assert!(price_data.price.is_positive());
                 assert_eq!(price_data.source, "coinbase");
                 println!("Real BTC price from Coinbase: ${:.2}", price_data.price);
             }
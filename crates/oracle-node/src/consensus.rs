@@ -1,78 +1,43 @@
+use oracle_vm_common::consensus::{ConsensusConfig, Quorum};
 use oracle_vm_common::types::PriceData;
+use oracle_vm_common::Price;
 use anyhow::Result;
 use tracing::{info, warn};
 
-/// 2/3 합의를 위한 ConsensusManager
+/// 2/3 합의를 위한 ConsensusManager (거래소 간 합의, 공통 합의 엔진 사용)
 pub struct ConsensusManager {
-    /// 최소 합의 비율 (예: 0.67 = 2/3)
-    min_consensus_ratio: f64,
-    /// 가격 편차 허용 범위 (예: 0.02 = 2%)
-    max_price_deviation: f64,
+    /// 정족수 2/3, 중간값에서 최대 2% (MAD 기준으로 더 좁아질 수 있음)
+    config: ConsensusConfig,
 }
 
 impl ConsensusManager {
     pub fn new() -> Self {
         Self {
-            min_consensus_ratio: 0.66, // 2/3 (실제로는 0.666...)
-            max_price_deviation: 0.02,  // 2%
+            config: ConsensusConfig::new(Quorum::TWO_THIRDS, 200),
         }
     }
     
     /// 여러 거래소의 가격 데이터를 받아서 합의된 가격을 반환
-    pub fn get_consensus_price(&self, prices: Vec<PriceData>) -> Result<f64> {
-        if prices.is_empty() {
-            anyhow::bail!("No price data available");
-        }
-        
-        // 가격만 추출 (cents를 다시 달러로 변환)
-        let mut price_values: Vec<f64> = prices.iter().map(|p| p.price as f64 / 100.0).collect();
-        price_values.sort_by(|a, b| a.partial_cmp(b).unwrap());
-        
-        // 중간값 계산
-        let median = if price_values.len() % 2 == 0 {
-            let mid = price_values.len() / 2;
-            (price_values[mid - 1] + price_values[mid]) / 2.0
-        } else {
-            price_values[price_values.len() / 2]
-        };
-        
-        // 중간값에서 허용 범위 내의 가격들만 필터링
-        let valid_prices: Vec<f64> = price_values
-            .into_iter()
-            .filter(|&price| {
-                let deviation = ((price - median) / median).abs();
-                deviation <= self.max_price_deviation
-            })
-            .collect();
-        
-        // 2/3 이상이 유효한지 확인
-        let consensus_count = valid_prices.len();
-        let total_count = prices.len();
-        let consensus_ratio = consensus_count as f64 / total_count as f64;
-        
-        if consensus_ratio < self.min_consensus_ratio {
-            warn!(
-                "Consensus not reached: {}/{} ({:.1}% < {:.1}% required)",
-                consensus_count,
-                total_count,
-                consensus_ratio * 100.0,
-                self.min_consensus_ratio * 100.0
-            );
-            anyhow::bail!("Consensus not reached");
-        }
-        
-        // 유효한 가격들의 평균 반환
-        let consensus_price = valid_prices.iter().sum::<f64>() / valid_prices.len() as f64;
+    ///
+    /// 중간값에서 허용 범위 안에 든 가격들의 평균 (모두 고정소수점 정수 연산)
+    pub fn get_consensus_price(&self, prices: Vec<PriceData>) -> Result<Price> {
+        let consensus = self
+            .config
+            .evaluate(prices.iter().map(|p| p.price), prices.len())
+            .map_err(|e| {
+                warn!("{}", e);
+                anyhow::anyhow!(e)
+            })?;
         
         info!(
-            "✅ Consensus reached: {}/{} exchanges agree on price ${:.2} (±{:.1}%)",
-            consensus_count,
-            total_count,
-            consensus_price,
-            self.max_price_deviation * 100.0
+            "✅ Consensus reached: {}/{} exchanges agree on price ${:.2} (±{:.2}%)",
+            consensus.agreeing,
+            consensus.total,
+            consensus.price,
+            consensus.band_bps() as f64 / 100.0
         );
         
-        Ok(consensus_price)
+        Ok(consensus.price)
     }
     
     /// 아웃라이어 감지
@@ -81,23 +46,14 @@ impl ConsensusManager {
             return vec![];
         }
         
-        let mut price_values: Vec<f64> = prices.iter().map(|p| p.price as f64 / 100.0).collect();
-        price_values.sort_by(|a, b| a.partial_cmp(b).unwrap());
-        
-        let median = if price_values.len() % 2 == 0 {
-            let mid = price_values.len() / 2;
-            (price_values[mid - 1] + price_values[mid]) / 2.0
-        } else {
-            price_values[price_values.len() / 2]
+        // 정족수와 무관하게 허용 범위만 본다
+        let Some(consensus) = self.config.select(prices.iter().map(|p| p.price)) else {
+            return vec![];
         };
         
         prices
             .iter()
-            .filter(|p| {
-                let price_usd = p.price as f64 / 100.0;
-                let deviation = ((price_usd - median) / median).abs();
-                deviation > self.max_price_deviation
-            })
+            .filter(|p| !consensus.accepts(p.price))
             .map(|p| p.source.clone())
             .collect()
     }
@@ -122,21 +78,21 @@ mod tests {
         let prices = vec![
             PriceData {
                 pair: AssetPair::btc_usd(),
-                price: 7000000, // $70,000 in cents
+                price: Price::from_units(70_000), // $70,000
                 timestamp: DateTime::from_timestamp(1700000000, 0).unwrap(),
                 volume: None,
                 source: "binance".to_string(),
             },
             PriceData {
                 pair: AssetPair::btc_usd(),
-                price: 7010000, // $70,100 in cents
+                price: Price::from_units(70_100), // $70,100
                 timestamp: DateTime::from_timestamp(1700000000, 0).unwrap(),
                 volume: None,
                 source: "coinbase".to_string(),
             },
             PriceData {
                 pair: AssetPair::btc_usd(),
-                price: 7005000, // $70,050 in cents
+                price: Price::from_units(70_050), // $70,050
                 timestamp: DateTime::from_timestamp(1700000000, 0).unwrap(),
                 volume: None,
                 source: "kraken".to_string(),
@@ -147,7 +103,7 @@ mod tests {
         assert!(result.is_ok());
         
         let consensus_price = result.unwrap();
-        assert!((consensus_price - 70050.0).abs() < 100.0);
+        assert_eq!(consensus_price, Price::from_units(70_050));
     }
     
     #[test]
@@ -157,21 +113,21 @@ mod tests {
         let prices = vec![
             PriceData {
                 pair: AssetPair::btc_usd(),
-                price: 7000000, // $70,000 in cents
+                price: Price::from_units(70_000), // $70,000
                 timestamp: DateTime::from_timestamp(1700000000, 0).unwrap(),
                 volume: None,
                 source: "binance".to_string(),
             },
             PriceData {
                 pair: AssetPair::btc_usd(),
-                price: 7010000, // $70,100 in cents
+                price: Price::from_units(70_100), // $70,100
                 timestamp: DateTime::from_timestamp(1700000000, 0).unwrap(),
                 volume: None,
                 source: "coinbase".to_string(),
             },
             PriceData {
                 pair: AssetPair::btc_usd(),
-                price: 7500000, // $75,000 in cents - Outlier (>7% deviation)
+                price: Price::from_units(75_000), // $75,000 - Outlier (>7% deviation)
                 timestamp: DateTime::from_timestamp(1700000000, 0).unwrap(),
                 volume: None,
                 source: "kraken".to_string(),
@@ -192,7 +148,7 @@ mod tests {
         assert!(result.is_ok());
         
         let consensus_price = result.unwrap();
-        assert!((consensus_price - 70050.0).abs() < 100.0);
+        assert_eq!(consensus_price, Price::from_units(70_050));
     }
     
     #[test]
@@ -202,21 +158,21 @@ mod tests {
         let prices = vec![
             PriceData {
                 pair: AssetPair::btc_usd(),
-                price: 7000000, // $70,000 in cents
+                price: Price::from_units(70_000), // $70,000
                 timestamp: DateTime::from_timestamp(1700000000, 0).unwrap(),
                 volume: None,
                 source: "binance".to_string(),
             },
             PriceData {
                 pair: AssetPair::btc_usd(),
-                price: 7500000, // $75,000 in cents - Too different
+                price: Price::from_units(75_000), // $75,000 - Too different
                 timestamp: DateTime::from_timestamp(1700000000, 0).unwrap(),
                 volume: None,
                 source: "coinbase".to_string(),
             },
             PriceData {
                 pair: AssetPair::btc_usd(),
-                price: 8000000, // $80,000 in cents - Too different
+                price: Price::from_units(80_000), // $80,000 - Too different
                 timestamp: DateTime::from_timestamp(1700000000, 0).unwrap(),
                 volume: None,
                 source: "kraken".to_string(),
@@ -234,21 +190,21 @@ mod tests {
         let prices = vec![
             PriceData {
                 pair: AssetPair::btc_usd(),
-                price: 7000000, // $70,000 in cents
+                price: Price::from_units(70_000), // $70,000
                 timestamp: DateTime::from_timestamp(1700000000, 0).unwrap(),
                 volume: None,
                 source: "binance".to_string(),
             },
             PriceData {
                 pair: AssetPair::btc_usd(),
-                price: 7010000, // $70,100 in cents
+                price: Price::from_units(70_100), // $70,100
                 timestamp: DateTime::from_timestamp(1700000000, 0).unwrap(),
                 volume: None,
                 source: "coinbase".to_string(),
             },
             PriceData {
                 pair: AssetPair::btc_usd(),
-                price: 7500000, // $75,000 in cents - Outlier
+                price: Price::from_units(75_000), // $75,000 - Outlier
                 timestamp: DateTime::from_timestamp(1700000000, 0).unwrap(),
                 volume: None,
                 source: "kraken".to_string(),
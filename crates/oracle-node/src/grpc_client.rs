@@ -1,77 +1,146 @@
+use crate::metrics::{self, SUBMIT_SECONDS};
+use oracle_vm_common::crypto::{self, Keypair, SubmissionDigest};
 use oracle_vm_common::types::PriceData;
+use oracle_vm_common::Price;
 use anyhow::{Context, Result};
+use std::time::{Duration, Instant};
 use tonic::transport::Channel;
 use tonic::Request;
-use tracing::{error, info, warn};
+use tracing::{debug, error, info, warn};
 
 // gRPC 클라이언트 코드 (tonic-build로 자동 생성됨)
 pub mod oracle {
     tonic::include_proto!("oracle");
 }
 
-use oracle::{oracle_service_client::OracleServiceClient, HealthRequest, PriceRequest};
+use oracle::{
+    oracle_service_client::OracleServiceClient, FixedPrice, HealthRequest, PriceBatchRequest,
+    PricePoint, PriceRequest,
+};
+
+impl From<Price> for FixedPrice {
+    fn from(price: Price) -> Self {
+        Self {
+            mantissa: price.mantissa(),
+            exponent: Price::EXPONENT,
+        }
+    }
+}
+
+/// 후보 Aggregator 하나의 연결 + 헬스체크 응답 제한 시간
+const PROBE_TIMEOUT: Duration = Duration::from_secs(3);
+
+/// 공개키에서 노드 ID 유도 - 같은 키로 실행하면 항상 같은 ID
+pub fn default_node_id(keypair: &Keypair) -> String {
+    crypto::default_node_id(&keypair.x_only_public_key().0)
+}
 
 /// gRPC를 사용한 Aggregator 클라이언트
+///
+/// Aggregator 클러스터의 후보 인스턴스 중 헬스체크 왕복 시간이 가장 짧은 곳에 제출하고,
+/// 전송이 실패하면 다음 제출 전에 다시 가장 가까운 인스턴스를 고른다.
+/// 인스턴스끼리 제출을 가십하므로 어느 인스턴스에 보내도 모든 인스턴스의 합의에 반영된다.
 pub struct GrpcAggregatorClient {
     client: OracleServiceClient<Channel>,
+    // 후보 Aggregator URL과 현재 연결된 URL
+    endpoints: Vec<String>,
+    endpoint: String,
     node_id: String,
+    // 제출 서명 키 (BIP340)
+    keypair: Keypair,
+    // x-only 공개키 hex (요청마다 다시 인코딩하지 않음)
+    public_key: String,
+    // 이번 수집 주기에 모아둔 가격 (flush 시 한 번에 전송)
+    pending: Vec<PricePoint>,
+    // 모아둔 가격의 서명 다이제스트 (대기열에 넣을 때 함께 갱신)
+    pending_digest: SubmissionDigest,
 }
 
 impl GrpcAggregatorClient {
-    /// 새로운 gRPC Aggregator 클라이언트 생성
-    pub async fn new(aggregator_url: &str) -> Result<Self> {
-        // Oracle Node 고유 ID 생성
-        let node_id = format!(
-            "oracle-node-{}",
-            uuid::Uuid::new_v4().to_string()[..8].to_string()
-        );
-
-        // gRPC 채널 생성
-        let channel = Channel::from_shared(aggregator_url.to_string())
-            .context("Invalid aggregator URL")?
-            .connect()
-            .await
-            .context("Failed to connect to Aggregator via gRPC")?;
+    /// 새로운 gRPC Aggregator 클라이언트 생성 (서명 키는 새로 생성)
+    pub async fn new(aggregator_urls: &[String]) -> Result<Self> {
+        let keypair = crypto::generate_signing_keypair();
+        Self::with_keypair(aggregator_urls, default_node_id(&keypair), keypair).await
+    }
 
-        let client = OracleServiceClient::new(channel);
+    /// 지정한 노드 ID와 서명 키로 gRPC Aggregator 클라이언트 생성 (후보 중 가장 가까운 인스턴스에 연결)
+    pub async fn with_keypair(
+        aggregator_urls: &[String],
+        node_id: String,
+        keypair: Keypair,
+    ) -> Result<Self> {
+        if aggregator_urls.is_empty() {
+            anyhow::bail!("No aggregator URL configured");
+        }
+        let (endpoint, client) = connect_nearest(aggregator_urls, &node_id).await?;
 
+        let public_key = keypair.x_only_public_key().0.to_string();
         info!(
-            "🔗 Created gRPC Aggregator client with node_id: {}",
-            node_id
+            "🔗 Created gRPC Aggregator client with node_id: {} (public key: {})",
+            node_id, public_key
         );
 
-        Ok(Self { client, node_id })
+        Ok(Self {
+            client,
+            endpoints: aggregator_urls.to_vec(),
+            endpoint,
+            pending_digest: SubmissionDigest::new(&node_id),
+            node_id,
+            keypair,
+            public_key,
+            pending: Vec::new(),
+        })
     }
 
     /// 가격 데이터를 gRPC로 Aggregator에 전송
     pub async fn submit_price(&mut self, price_data: &PriceData) -> Result<()> {
-        // Convert cents to dollars for gRPC
-        let price_usd = price_data.price as f64 / 100.0;
-        
+        let timestamp = price_data.timestamp.timestamp() as u64;
+
+        let mut digest = SubmissionDigest::new(&self.node_id);
+        digest.push(
+            &price_data.pair.0,
+            &price_data.source,
+            price_data.price,
+            timestamp,
+            price_data.volume,
+        );
+        let signature = crypto::sign_schnorr(&digest.finalize(), &self.keypair);
+
         let request = Request::new(PriceRequest {
-            price: price_usd,
-            timestamp: price_data.timestamp.timestamp() as u64,
+            price: Some(price_data.price.into()),
+            timestamp,
             source: price_data.source.clone(),
             node_id: self.node_id.clone(),
-            signature: None, // 나중에 보안용으로 추가
+            signature: Some(signature.to_string()),
+            pair: price_data.pair.0.clone(),
+            volume: price_data.volume,
+            public_key: Some(self.public_key.clone()),
         });
 
-        info!(
+        debug!(
             "📤 Sending price ${:.2} to Aggregator via gRPC...",
-            price_usd
+            price_data.price
+        );
+
+        let started = Instant::now();
+        let result = self.client.submit_price(request).await;
+        metrics::observe(
+            &SUBMIT_SECONDS,
+            &["submit_price", metrics::outcome(&result)],
+            started,
         );
 
-        match self.client.submit_price(request).await {
+        match result {
             Ok(response) => {
                 let response = response.into_inner();
                 if response.success {
                     if let Some(aggregated_price) = response.aggregated_price {
-                        info!(
+                        debug!(
                             "✅ gRPC: Price sent successfully! Aggregated price: ${:.2}",
                             aggregated_price
                         );
                     } else {
-                        info!("✅ gRPC: Price sent successfully! {}", response.message);
+                        debug!("✅ gRPC: Price sent successfully! {}", response.message);
                     }
                 } else {
                     warn!("❌ gRPC: Failed to submit price: {}", response.message);
@@ -80,6 +149,7 @@ impl GrpcAggregatorClient {
             }
             Err(e) => {
                 error!("❌ gRPC: Failed to send price: {}", e);
+                self.reconnect().await;
                 anyhow::bail!("gRPC communication error: {}", e);
             }
         }
@@ -87,6 +157,99 @@ impl GrpcAggregatorClient {
         Ok(())
     }
 
+    /// 가격을 전송 대기열에 추가 (네트워크 요청 없음)
+    pub fn queue_price(&mut self, price_data: &PriceData) {
+        let timestamp = price_data.timestamp.timestamp() as u64;
+        self.pending_digest.push(
+            &price_data.pair.0,
+            &price_data.source,
+            price_data.price,
+            timestamp,
+            price_data.volume,
+        );
+        self.pending.push(PricePoint {
+            price: Some(price_data.price.into()),
+            timestamp,
+            source: price_data.source.clone(),
+            pair: price_data.pair.0.clone(),
+            volume: price_data.volume,
+        });
+    }
+
+    /// 대기 중인 가격 수
+    pub fn pending_len(&self) -> usize {
+        self.pending.len()
+    }
+
+    /// 대기 중인 가격을 SubmitPriceBatch 한 번으로 전송 - 수집된 가격 수 반환
+    pub async fn flush(&mut self) -> Result<u32> {
+        if self.pending.is_empty() {
+            return Ok(0);
+        }
+
+        let prices = std::mem::take(&mut self.pending);
+        let count = prices.len();
+
+        // 배치 전체에 서명 하나 - Aggregator도 배치당 한 번만 검증
+        let digest = std::mem::replace(
+            &mut self.pending_digest,
+            SubmissionDigest::new(&self.node_id),
+        );
+        let signature = crypto::sign_schnorr(&digest.finalize(), &self.keypair);
+
+        let request = Request::new(PriceBatchRequest {
+            node_id: self.node_id.clone(),
+            prices,
+            signature: Some(signature.to_string()),
+            public_key: Some(self.public_key.clone()),
+        });
+
+        debug!(
+            "📤 Sending {} prices to Aggregator via gRPC batch...",
+            count
+        );
+
+        let started = Instant::now();
+        let result = self.client.submit_price_batch(request).await;
+        metrics::observe(
+            &SUBMIT_SECONDS,
+            &["submit_price_batch", metrics::outcome(&result)],
+            started,
+        );
+
+        match result {
+            Ok(response) => {
+                let response = response.into_inner();
+                if !response.success {
+                    warn!("❌ gRPC: Batch rejected: {}", response.message);
+                    anyhow::bail!("Aggregator rejected batch: {}", response.message);
+                }
+                if response.rejected > 0 {
+                    warn!(
+                        "⚠️ gRPC: {} of {} prices rejected by Aggregator",
+                        response.rejected, count
+                    );
+                }
+                match response.aggregated_price {
+                    Some(aggregated_price) => debug!(
+                        "✅ gRPC: {} prices sent! Aggregated price: ${:.2}",
+                        response.accepted, aggregated_price
+                    ),
+                    None => debug!(
+                        "✅ gRPC: {} prices sent! {}",
+                        response.accepted, response.message
+                    ),
+                }
+                Ok(response.accepted)
+            }
+            Err(e) => {
+                error!("❌ gRPC: Failed to send price batch: {}", e);
+                self.reconnect().await;
+                anyhow::bail!("gRPC communication error: {}", e);
+            }
+        }
+    }
+
     /// gRPC를 통한 Aggregator 헬스체크
     pub async fn check_health(&mut self) -> Result<bool> {
         let request = Request::new(HealthRequest {
@@ -118,6 +281,81 @@ impl GrpcAggregatorClient {
     pub fn node_id(&self) -> &str {
         &self.node_id
     }
+
+    /// 현재 제출 중인 Aggregator URL
+    pub fn endpoint(&self) -> &str {
+        &self.endpoint
+    }
+
+    /// 전송 실패 후 가장 가까운 인스턴스를 다시 선택 (모두 응답이 없으면 현재 연결 유지)
+    async fn reconnect(&mut self) {
+        if self.endpoints.len() < 2 {
+            return;
+        }
+        match connect_nearest(&self.endpoints, &self.node_id).await {
+            Ok((endpoint, client)) => {
+                if endpoint != self.endpoint {
+                    info!("🔀 Switched aggregator: {} -> {}", self.endpoint, endpoint);
+                }
+                self.endpoint = endpoint;
+                self.client = client;
+            }
+            Err(e) => warn!("⚠️ No aggregator reachable, keeping {}: {}", self.endpoint, e),
+        }
+    }
+}
+
+/// 후보 Aggregator에 동시에 헬스체크를 보내 왕복 시간이 가장 짧은 인스턴스에 연결
+async fn connect_nearest(
+    endpoints: &[String],
+    node_id: &str,
+) -> Result<(String, OracleServiceClient<Channel>)> {
+    let probes = endpoints.iter().map(|endpoint| async move {
+        let probe = async {
+            let channel = Channel::from_shared(endpoint.clone())
+                .context("Invalid aggregator URL")?
+                .connect()
+                .await
+                .context("Failed to connect to Aggregator via gRPC")?;
+            let mut client = OracleServiceClient::new(channel);
+
+            // 연결 수립(TCP/TLS)은 빼고 요청 왕복 시간만 잰다
+            let started = Instant::now();
+            let response = client
+                .health_check(Request::new(HealthRequest {
+                    node_id: node_id.to_string(),
+                }))
+                .await
+                .context("Health check failed")?
+                .into_inner();
+            if !response.healthy {
+                anyhow::bail!("Aggregator reported unhealthy");
+            }
+            Ok::<_, anyhow::Error>((started.elapsed(), client))
+        };
+        let result = tokio::time::timeout(PROBE_TIMEOUT, probe)
+            .await
+            .unwrap_or_else(|_| Err(anyhow::anyhow!("Timed out")));
+        (endpoint, result)
+    });
+
+    let mut nearest: Option<(Duration, &String, OracleServiceClient<Channel>)> = None;
+    for (endpoint, result) in futures::future::join_all(probes).await {
+        match result {
+            Ok((rtt, client)) => {
+                info!("📡 Aggregator {} RTT {:?}", endpoint, rtt);
+                if nearest.as_ref().map_or(true, |(best, _, _)| rtt < *best) {
+                    nearest = Some((rtt, endpoint, client));
+                }
+            }
+            Err(e) => warn!("⚠️ Aggregator {} unavailable: {:#}", endpoint, e),
+        }
+    }
+
+    let (rtt, endpoint, client) =
+        nearest.ok_or_else(|| anyhow::anyhow!("No aggregator reachable among {:?}", endpoints))?;
+    info!("🔗 Using aggregator {} (RTT {:?})", endpoint, rtt);
+    Ok((endpoint.clone(), client))
 }
 
 #[cfg(test)]
@@ -127,7 +365,7 @@ mod tests {
     #[tokio::test]
     #[ignore] // 실제 gRPC 서버 필요
     async fn test_grpc_connection() {
-        let result = GrpcAggregatorClient::new("http://localhost:50051").await;
+        let result = GrpcAggregatorClient::new(&["http://localhost:50051".to_string()]).await;
         // 연결 테스트는 서버가 실행 중일 때만 가능
         match result {
             Ok(_) => println!("gRPC connection successful"),
@@ -0,0 +1,61 @@
+//! 거래소 REST 클라이언트 공통 HTTP 계층
+//!
+//! - 모든 거래소 클라이언트(자산 쌍별)가 연결 풀 하나를 공유한다: 같은 호스트로 가는 요청은
+//!   keep-alive 연결(ALPN으로 협상되면 HTTP/2 다중화)을 재사용해 TLS 핸드셰이크를 반복하지 않는다.
+//! - DNS 조회는 캐시하는 리졸버(trust-dns)를 쓴다.
+//! - 응답 본문은 바이트 그대로 받아 필요한 필드만 빌린 `&str`로 역직렬화하고, 가격 문자열은
+//!   f64를 거치지 않고 바로 고정소수점 [`Price`]로 변환한다.
+
+use oracle_vm_common::Price;
+use reqwest::Client;
+use std::sync::OnceLock;
+use std::time::Duration;
+
+/// HTTP 요청 타임아웃
+const REQUEST_TIMEOUT: Duration = Duration::from_secs(10);
+/// 연결 수립 타임아웃
+const CONNECT_TIMEOUT: Duration = Duration::from_secs(5);
+/// 유휴 연결 유지 시간 (수집 주기 1분보다 길게)
+const POOL_IDLE_TIMEOUT: Duration = Duration::from_secs(90);
+/// 호스트별 유휴 연결 최대 수 (자산 쌍별 동시 요청 + 헤지 요청)
+const POOL_MAX_IDLE_PER_HOST: usize = 16;
+/// TCP keep-alive 간격
+const TCP_KEEPALIVE: Duration = Duration::from_secs(30);
+
+/// 프로세스 전역 HTTP 클라이언트 (내부가 Arc라 복제 비용이 작다)
+pub fn shared_client() -> Client {
+    static CLIENT: OnceLock<Client> = OnceLock::new();
+    CLIENT
+        .get_or_init(|| {
+            Client::builder()
+                .timeout(REQUEST_TIMEOUT)
+                .connect_timeout(CONNECT_TIMEOUT)
+                .pool_idle_timeout(POOL_IDLE_TIMEOUT)
+                .pool_max_idle_per_host(POOL_MAX_IDLE_PER_HOST)
+                .tcp_keepalive(TCP_KEEPALIVE)
+                .tcp_nodelay(true)
+                .http2_adaptive_window(true)
+                .trust_dns(true)
+                .user_agent("OracleVM/1.0")
+                .build()
+                .expect("Failed to create HTTP client")
+        })
+        .clone()
+}
+
+/// 캔들 응답에서 뽑은 값
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct CandleQuote {
+    /// 캔들 시작 시각 (unix 초)
+    pub open_time: u64,
+    /// 종가
+    pub close: Price,
+    pub volume: Option<f64>,
+}
+
+impl CandleQuote {
+    /// 종가 (f64, 표시/검증용)
+    pub fn close_price(&self) -> f64 {
+        self.close.to_f64()
+    }
+}
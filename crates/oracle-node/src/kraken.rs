@@ -1,53 +1,149 @@
+use crate::http::{self, CandleQuote};
 use crate::price_provider::PriceProvider;
 use oracle_vm_common::types::{PriceData, AssetPair};
+use oracle_vm_common::Price;
 use anyhow::{Context, Result};
 use async_trait::async_trait;
 use chrono::{DateTime, Timelike};
 use reqwest::Client;
+use serde::de::{self, Deserializer, IgnoredAny, MapAccess, Visitor};
 use serde::Deserialize;
+use std::borrow::Cow;
+use std::fmt;
 use std::time::Duration;
 use tokio::time::sleep;
-use tracing::{error, info, warn};
+use tracing::{debug, error, warn};
 
 /// Kraken API URL
 const KRAKEN_API_URL: &str = "https://api.kraken.com/0/public/OHLC";
 /// 최대 재시도 횟수
 const MAX_RETRIES: u32 = 3;
-/// HTTP 요청 타임아웃 (초)
-const REQUEST_TIMEOUT: u64 = 10;
 
-/// Kraken에서 받아오는 OHLC 데이터 구조
+/// Kraken에서 받아오는 OHLC 데이터 구조 (문자열은 응답 본문에서 빌림)
 #[derive(Debug, Deserialize)]
-struct KrakenOHLCResponse {
-    error: Vec<String>,
-    result: Option<KrakenResult>,
+struct KrakenOHLCResponse<'a> {
+    #[serde(borrow)]
+    error: Vec<Cow<'a, str>>,
+    #[serde(borrow)]
+    result: Option<KrakenResult<'a>>,
 }
 
-#[derive(Debug, Deserialize)]
-struct KrakenResult {
-    #[serde(rename = "XXBTZUSD")]
-    btc_usd: Vec<KrakenOHLC>,
+/// `result`에는 `last`와 함께 Kraken 내부 자산 쌍 이름(예: XXBTZUSD)을 키로 한 OHLC 배열이 들어온다
+///
+/// 한 자산 쌍만 요청하므로 `last`가 아닌 첫 키의 배열을 OHLC로 읽는다.
+/// (`#[serde(flatten)]` + HashMap은 값 전체를 중간 버퍼에 복사하므로 직접 방문한다)
+#[derive(Debug)]
+struct KrakenResult<'a> {
     last: u64,
+    ohlc: Vec<KrakenOHLC<'a>>,
 }
 
+/// [timestamp, open, high, low, close, vwap, volume, count] - 쓰는 필드만 읽음
 #[derive(Debug, Deserialize)]
-struct KrakenOHLC(u64, String, String, String, String, String, String, u32); // [timestamp, open, high, low, close, vwap, volume, count]
+struct KrakenOHLC<'a>(
+    u64,
+    IgnoredAny,
+    IgnoredAny,
+    IgnoredAny,
+    &'a str,
+    IgnoredAny,
+    &'a str,
+    IgnoredAny,
+);
+
+impl<'de: 'a, 'a> Deserialize<'de> for KrakenResult<'a> {
+    fn deserialize<D: Deserializer<'de>>(deserializer: D) -> Result<Self, D::Error> {
+        struct ResultVisitor<'a>(std::marker::PhantomData<&'a ()>);
+
+        impl<'de: 'a, 'a> Visitor<'de> for ResultVisitor<'a> {
+            type Value = KrakenResult<'a>;
+
+            fn expecting(&self, f: &mut fmt::Formatter) -> fmt::Result {
+                f.write_str("a Kraken OHLC result object")
+            }
+
+            fn visit_map<M: MapAccess<'de>>(self, mut map: M) -> Result<Self::Value, M::Error> {
+                let mut last = None;
+                let mut ohlc = None;
+                while let Some(key) = map.next_key::<&'de str>()? {
+                    if key == "last" {
+                        last = Some(map.next_value()?);
+                    } else if ohlc.is_none() {
+                        ohlc = Some(map.next_value()?);
+                    } else {
+                        map.next_value::<IgnoredAny>()?;
+                    }
+                }
+
+                Ok(KrakenResult {
+                    last: last.ok_or_else(|| de::Error::missing_field("last"))?,
+                    ohlc: ohlc.unwrap_or_default(),
+                })
+            }
+        }
+
+        deserializer.deserialize_map(ResultVisitor(std::marker::PhantomData))
+    }
+}
+
+/// OHLC 응답 본문 -> 가장 최근 캔들의 종가/거래량
+fn parse_ohlc(body: &[u8]) -> Result<CandleQuote> {
+    let response: KrakenOHLCResponse =
+        serde_json::from_slice(body).context("Failed to parse Kraken JSON response")?;
+
+    // API 에러 확인
+    if !response.error.is_empty() {
+        anyhow::bail!("Kraken API error: {:?}", response.error);
+    }
+
+    let result = response
+        .result
+        .ok_or_else(|| anyhow::anyhow!("No result data from Kraken"))?;
+    let latest = result
+        .ohlc
+        .last()
+        .ok_or_else(|| anyhow::anyhow!("No OHLC data received from Kraken"))?;
+
+    let close = latest.4
+        .parse::<Price>()
+        .with_context(|| format!("Failed to parse close price from Kraken: {}", latest.4))?;
+
+    Ok(CandleQuote {
+        open_time: latest.0,
+        close,
+        // 거래량은 없어도 가격은 사용
+        volume: latest.6.parse::<f64>().ok(),
+    })
+}
 
 /// Kraken과 통신하는 클라이언트
 pub struct KrakenClient {
     client: Client,
+    pair: AssetPair,
+    kraken_pair: String, // Kraken 자산 쌍 이름 (예: XBTUSD)
+}
+
+/// Kraken 자산 코드 (BTC는 XBT로 표기)
+pub(crate) fn kraken_asset(asset: &str) -> &str {
+    match asset {
+        "BTC" => "XBT",
+        asset => asset,
+    }
 }
 
 impl KrakenClient {
-    /// 새로운 Kraken 클라이언트를 만듭니다
+    /// 새로운 Kraken 클라이언트를 만듭니다 (BTC/USD)
     pub fn new() -> Self {
-        let client = Client::builder()
-            .timeout(Duration::from_secs(REQUEST_TIMEOUT))
-            .user_agent("OracleVM/1.0")
-            .build()
-            .expect("Failed to create HTTP client");
+        Self::with_pair(AssetPair::btc_usd())
+    }
 
-        Self { client }
+    /// 지정한 자산 쌍을 조회하는 클라이언트를 만듭니다 (공유 연결 풀 사용)
+    pub fn with_pair(pair: AssetPair) -> Self {
+        Self {
+            client: http::shared_client(),
+            kraken_pair: format!("{}{}", kraken_asset(pair.base()), pair.quote()),
+            pair,
+        }
     }
 
     /// 비트코인 가격을 가져옵니다 (재시도 포함)
@@ -58,16 +154,16 @@ impl KrakenClient {
     /// 재시도 로직이 포함된 가격 가져오기
     async fn fetch_btc_price_with_retry(&self, max_retries: u32) -> Result<PriceData> {
         for attempt in 1..=max_retries {
-            info!(
-                "Fetching BTC price from Kraken (attempt {}/{})",
-                attempt, max_retries
+            debug!(
+                "Fetching {} price from Kraken (attempt {}/{})",
+                self.pair, attempt, max_retries
             );
 
             match self.fetch_btc_price_once().await {
                 Ok(price_data) => {
-                    info!(
-                        "Successfully fetched BTC price from Kraken: ${:.2}",
-                        price_data.price
+                    debug!(
+                        "Successfully fetched {} price from Kraken: ${:.2}",
+                        self.pair, price_data.price
                     );
                     return Ok(price_data);
                 }
@@ -103,15 +199,15 @@ impl KrakenClient {
 
         let since_timestamp = target_minute_start.timestamp();
 
-        info!(
+        debug!(
             "🎯 Kraken: Requesting OHLC since {} UTC",
             target_minute_start.format("%H:%M:%S")
         );
 
         // 1분 OHLC 데이터 요청 (특정 시점부터)
         let url = format!(
-            "{}?pair=XBTUSD&interval=1&since={}",
-            KRAKEN_API_URL, since_timestamp
+            "{}?pair={}&interval=1&since={}",
+            KRAKEN_API_URL, self.kraken_pair, since_timestamp
         );
 
         let response = self
@@ -125,52 +221,33 @@ impl KrakenClient {
             return self.handle_http_error(response.status().as_u16());
         }
 
-        let kraken_response: KrakenOHLCResponse = response
-            .json()
+        let body = response
+            .bytes()
             .await
-            .context("Failed to parse Kraken JSON response")?;
-
-        // API 에러 확인
-        if !kraken_response.error.is_empty() {
-            anyhow::bail!("Kraken API error: {:?}", kraken_response.error);
-        }
-
-        let result = kraken_response
-            .result
-            .ok_or_else(|| anyhow::anyhow!("No result data from Kraken"))?;
-
-        if result.btc_usd.is_empty() {
-            anyhow::bail!("No OHLC data received from Kraken");
-        }
-
-        // 가장 최근 OHLC의 종가 사용
-        let latest_ohlc = &result.btc_usd[result.btc_usd.len() - 1];
-        let timestamp = latest_ohlc.0; // timestamp
-        let close_price = latest_ohlc
-            .4
-            .parse::<f64>()
-            .context("Failed to parse close price from Kraken")?;
+            .context("Failed to read Kraken response")?;
+        let quote = parse_ohlc(&body)?;
 
         // OHLC 시간 정보 로깅
-        let ohlc_time = chrono::DateTime::from_timestamp(timestamp as i64, 0).unwrap_or_default();
+        let ohlc_time =
+            chrono::DateTime::from_timestamp(quote.open_time as i64, 0).unwrap_or_default();
 
-        info!(
+        debug!(
             "📊 Kraken OHLC: {:.2} USD (time: {})",
-            close_price,
+            quote.close_price(),
             ohlc_time.format("%H:%M:%S")
         );
 
         // 가격 검증
-        self.validate_price(close_price)?;
+        self.validate_price(quote.close_price())?;
 
         let timestamp = chrono::Utc::now().timestamp() as u64;
 
         Ok(PriceData {
-            pair: AssetPair::btc_usd(),
-            price: (close_price * 100.0) as u64, // Convert to cents
+            pair: self.pair.clone(),
+            price: quote.close,
             timestamp: DateTime::from_timestamp(timestamp as i64, 0)
                 .unwrap_or_else(chrono::Utc::now),
-            volume: None,
+            volume: quote.volume,
             source: "kraken".to_string(),
         })
     }
@@ -181,7 +258,7 @@ impl KrakenClient {
             400 => anyhow::bail!("Bad request - Check API parameters"),
             401 => anyhow::bail!("Unauthorized - API key issue"),
             403 => anyhow::bail!("Forbidden - Access denied"),
-            404 => anyhow::bail!("Not found - Check pair (XBTUSD)"),
+            404 => anyhow::bail!("Not found - Check pair ({})", self.kraken_pair),
             429 => anyhow::bail!("Rate limit exceeded - Too many requests"),
             500..=599 => anyhow::bail!("Kraken server error - Try again later"),
             _ => anyhow::bail!("HTTP error: {}", status_code),
@@ -194,11 +271,12 @@ impl KrakenClient {
             anyhow::bail!("Invalid price: must be positive, got {}", price);
         }
 
-        if price < 1000.0 {
+        // 상식선 경고는 BTC 시세에만 적용
+        if self.pair.base() == "BTC" && price < 1000.0 {
             warn!("Unusually low BTC price from Kraken: ${:.2}", price);
         }
 
-        if price > 1_000_000.0 {
+        if self.pair.base() == "BTC" && price > 1_000_000.0 {
             warn!("Unusually high BTC price from Kraken: ${:.2}", price);
         }
 
@@ -228,6 +306,29 @@ mod tests {
         assert!(client.validate_price(-100.0).is_err());
     }
 
+    #[test]
+    fn test_result_parses_any_pair_key() {
+        let body = br#"{"error":[],"result":{"XETHZUSD":[[1699999940,"1990.0","2000.0","1980.0","1995.0","1992.0","3.0",7],[1700000000,"2000.0","2010.0","1990.0","2005.5","2001.0","12.5",42]],"last":1700000000}}"#;
+        let response: KrakenOHLCResponse = serde_json::from_slice(body).unwrap();
+        let result = response.result.unwrap();
+        assert_eq!(result.last, 1700000000);
+        assert_eq!(result.ohlc.len(), 2);
+
+        // 가장 최근(마지막) 캔들 사용
+        let quote = parse_ohlc(body).unwrap();
+        assert_eq!(quote.open_time, 1_700_000_000);
+        assert_eq!(quote.close, Price::from_cents(200_550));
+        assert_eq!(quote.volume, Some(12.5));
+        assert_eq!(KrakenClient::with_pair(AssetPair::btc_usd()).kraken_pair, "XBTUSD");
+    }
+
+    #[test]
+    fn test_api_error_is_reported() {
+        let body = br#"{"error":["EQuery:Unknown asset pair"]}"#;
+        let error = parse_ohlc(body).unwrap_err().to_string();
+        assert!(error.contains("Unknown asset pair"));
+    }
+
     #[tokio::test]
     #[ignore] // cargo test --ignored 로만 실행
     async fn test_real_api_call() {
@@ -236,7 +337,7 @@ mod tests {
 
         match result {
             Ok(price_data) => {
-                assert!(price_data.price > 0.0);
+                assert!(price_data.price.is_positive());
                 assert_eq!(price_data.source, "kraken");
                 println!("Real BTC price from Kraken: ${:.2}", price_data.price);
             }
@@ -252,6 +353,11 @@ impl PriceProvider for KrakenClient {
     async fn fetch_btc_price(&self) -> Result<PriceData> {
         self.fetch_btc_price_with_retry(MAX_RETRIES).await
     }
+
+    async fn fetch_btc_price_once(&self) -> Result<PriceData> {
+        // 고유 메서드 호출 (재시도 없음)
+        self.fetch_btc_price_once().await
+    }
     
     fn name(&self) -> &str {
         "kraken"
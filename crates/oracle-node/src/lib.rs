@@ -1,9 +1,12 @@
 pub mod binance;
 pub mod coinbase;
 pub mod grpc_client;
+pub mod http;
 pub mod kraken;
+pub mod metrics;
 pub mod safe_price;
 pub mod price_provider;
+pub mod streaming;
 pub mod consensus;
 
 use anyhow::Result;
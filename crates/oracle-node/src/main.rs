@@ -1,32 +1,51 @@
-use anyhow::Result;
+use anyhow::{Context, Result};
 use chrono::{Timelike, Utc};
 use clap::Parser;
+use oracle_vm_common::crypto::{self, Keypair};
+use std::io::Write;
+use std::net::SocketAddr;
+use std::path::Path;
+use std::str::FromStr;
 use std::time::Duration;
 use tokio::time::interval;
-use tracing::{error, info};
+use tracing::{debug, error, info, warn};
 
 mod binance;
 mod coinbase;
 mod grpc_client;
+mod http;
 mod kraken;
+mod metrics;
 mod safe_price;
 mod price_provider;
+mod streaming;
 
 use binance::BinanceClient;
 use coinbase::CoinbaseClient;
-use grpc_client::GrpcAggregatorClient;
+use grpc_client::{default_node_id, GrpcAggregatorClient};
 use kraken::KrakenClient;
-use price_provider::PriceProvider;
+use price_provider::{FetchPolicy, MultiExchangePriceProvider, PriceProvider};
+use streaming::StreamingPriceProvider;
 
 // PriceData는 oracle_vm_common::types에서 가져옴
-use oracle_vm_common::types::PriceData;
+use oracle_vm_common::types::{AssetPair, PriceData};
 
 /// 거래소 클라이언트 생성 헬퍼
-fn create_exchange_provider(exchange: &str) -> Result<Box<dyn PriceProvider>> {
-    match exchange.to_lowercase().as_str() {
-        "binance" => Ok(Box::new(BinanceClient::new())),
-        "coinbase" => Ok(Box::new(CoinbaseClient::new())),
-        "kraken" => Ok(Box::new(KrakenClient::new())),
+///
+/// `streaming`이면 웹소켓 피드를 구독하는 제공자를, 아니면 REST 클라이언트를 만든다.
+fn create_exchange_provider(
+    exchange: &str,
+    pair: &AssetPair,
+    streaming: bool,
+) -> Result<Box<dyn PriceProvider>> {
+    let pair = pair.clone();
+    match (exchange.to_lowercase().as_str(), streaming) {
+        ("binance", false) => Ok(Box::new(BinanceClient::with_pair(pair))),
+        ("coinbase", false) => Ok(Box::new(CoinbaseClient::with_pair(pair))),
+        ("kraken", false) => Ok(Box::new(KrakenClient::with_pair(pair))),
+        ("binance", true) => Ok(Box::new(StreamingPriceProvider::binance(pair))),
+        ("coinbase", true) => Ok(Box::new(StreamingPriceProvider::coinbase(pair))),
+        ("kraken", true) => Ok(Box::new(StreamingPriceProvider::kraken(pair))),
         _ => anyhow::bail!(
             "Unsupported exchange: {}. Supported: binance, coinbase, kraken",
             exchange
@@ -34,6 +53,42 @@ fn create_exchange_provider(exchange: &str) -> Result<Box<dyn PriceProvider>> {
     }
 }
 
+/// 서명 키 로드 - `--signing-key`가 없으면 키 파일을 읽고, 파일이 없으면 새로 만들어 저장
+///
+/// Aggregator는 노드 ID별로 키를 고정하거나 신뢰 키 목록으로 검증하므로 키가 실행마다 바뀌면 안 된다.
+fn load_signing_key(signing_key: Option<&str>, key_file: &str) -> Result<Keypair> {
+    if let Some(secret_key) = signing_key {
+        return Ok(crypto::signing_keypair_from_hex(secret_key)?);
+    }
+
+    match std::fs::read_to_string(key_file) {
+        Ok(secret_key) => crypto::signing_keypair_from_hex(secret_key.trim())
+            .with_context(|| format!("Invalid signing key in {}", key_file)),
+        Err(e) if e.kind() == std::io::ErrorKind::NotFound => {
+            if let Some(dir) = Path::new(key_file).parent() {
+                std::fs::create_dir_all(dir)
+                    .with_context(|| format!("Failed to create {}", dir.display()))?;
+            }
+            let mut options = std::fs::OpenOptions::new();
+            options.write(true).create_new(true);
+            #[cfg(unix)]
+            {
+                use std::os::unix::fs::OpenOptionsExt;
+                options.mode(0o600);
+            }
+            let mut file = options
+                .open(key_file)
+                .with_context(|| format!("Failed to create signing key file {}", key_file))?;
+
+            let keypair = crypto::generate_signing_keypair();
+            writeln!(file, "{}", keypair.display_secret())?;
+            info!("🔑 Generated a new signing key at {}", key_file);
+            Ok(keypair)
+        }
+        Err(e) => Err(e).with_context(|| format!("Failed to read signing key file {}", key_file)),
+    }
+}
+
 /// Oracle Node CLI 인수
 #[derive(Parser)]
 #[command(name = "oracle-node")]
@@ -43,21 +98,54 @@ struct Args {
     #[arg(short, long, default_value = "config/oracle-node.toml")]
     config: String,
 
-    /// Node ID (설정 파일보다 우선)
+    /// Node ID (설정 파일보다 우선, 없으면 서명 공개키에서 유도)
     #[arg(long)]
     node_id: Option<String>,
 
-    /// Aggregator URL (설정 파일보다 우선)
-    #[arg(long, default_value = "http://localhost:50051")]
-    aggregator_url: String,
+    /// Aggregator URL (설정 파일보다 우선, 쉼표 구분 - 클러스터면 가장 가까운 인스턴스에 제출)
+    #[arg(long, value_delimiter = ',', default_value = "http://localhost:50051")]
+    aggregator_url: Vec<String>,
 
     /// 가격 수집 간격 (초)
     #[arg(long, default_value = "60")]
     interval: u64,
 
-    /// 거래소 선택 (binance, coinbase, kraken)
-    #[arg(long, default_value = "binance")]
-    exchange: String,
+    /// 수집할 거래소 목록 (쉼표 구분: binance, coinbase, kraken)
+    #[arg(
+        long,
+        alias = "exchange",
+        value_delimiter = ',',
+        default_value = "binance,coinbase,kraken"
+    )]
+    exchanges: Vec<String>,
+
+    /// 수집할 자산 쌍 목록 (쉼표 구분, 예: BTC/USD,ETH/USD)
+    #[arg(long, value_delimiter = ',', default_value = "BTC/USD")]
+    pairs: Vec<String>,
+
+    /// 거래소별 응답 마감 시간 (수집 시각 기준, 초)
+    #[arg(long, default_value = "20")]
+    fetch_deadline: u64,
+
+    /// 응답이 없을 때 헤지 요청을 보내기까지의 대기 시간 (밀리초)
+    #[arg(long, default_value = "2000")]
+    hedge_delay_ms: u64,
+
+    /// REST 대신 웹소켓 피드 사용 (수집 간격을 초 단위로 줄일 때)
+    #[arg(long)]
+    streaming: bool,
+
+    /// 제출 서명 키 (secp256k1 비밀키 hex, 없으면 `--key-file` 사용)
+    #[arg(long)]
+    signing_key: Option<String>,
+
+    /// 서명 키 파일 - 없으면 새 키를 만들어 저장하고 다음 실행부터 같은 키 사용
+    #[arg(long, default_value = "./data/oracle-node.key")]
+    key_file: String,
+
+    /// Prometheus 지표 엔드포인트 주소 (예: 0.0.0.0:9100, 없으면 비활성)
+    #[arg(long)]
+    metrics_listen: Option<SocketAddr>,
 }
 
 #[tokio::main]
@@ -69,15 +157,58 @@ async fn main() -> Result<()> {
     tracing_subscriber::fmt::init();
 
     info!("Starting Oracle Node with config: {}", args.config);
-    info!("Aggregator URL: {}", args.aggregator_url);
-    info!("Exchange: {}", args.exchange);
+    info!("Aggregator URLs: {}", args.aggregator_url.join(", "));
+    info!("Exchanges: {}", args.exchanges.join(", "));
+    info!("Pairs: {}", args.pairs.join(", "));
     info!("Fetch interval: {}s", args.interval);
+    info!(
+        "Price source: {}",
+        if args.streaming { "websocket" } else { "REST" }
+    );
+
+    if let Some(addr) = args.metrics_listen {
+        tokio::spawn(async move {
+            if let Err(e) = metrics::serve(addr).await {
+                error!("❌ Metrics endpoint stopped: {}", e);
+            }
+        });
+    }
+
+    // 마감 시간은 다음 수집 시각을 넘지 않도록 제한
+    let policy = FetchPolicy {
+        deadline: Duration::from_secs(args.fetch_deadline.min(args.interval)),
+        hedge_delay: Duration::from_millis(args.hedge_delay_ms),
+        ..FetchPolicy::default()
+    };
+    info!(
+        "Per-exchange deadline: {}s, hedge delay: {}ms",
+        policy.deadline.as_secs(),
+        args.hedge_delay_ms
+    );
 
-    // Create exchange provider based on CLI argument
-    let exchange_provider = create_exchange_provider(&args.exchange)?;
+    // Create exchange providers based on CLI argument (자산 쌍 x 거래소 조합을 한 프로세스에서 수집)
+    let pairs = args
+        .pairs
+        .iter()
+        .map(|pair| AssetPair::from_str(pair.trim()))
+        .collect::<Result<Vec<_>, _>>()?;
+    let mut providers = Vec::with_capacity(pairs.len() * args.exchanges.len());
+    for pair in &pairs {
+        for exchange in &args.exchanges {
+            providers.push(create_exchange_provider(exchange.trim(), pair, args.streaming)?);
+        }
+    }
+    let exchange_provider = MultiExchangePriceProvider::with_policy(providers, policy);
 
     // Create gRPC Aggregator client
-    let mut grpc_client = GrpcAggregatorClient::new(&args.aggregator_url).await?;
+    // 노드 ID와 서명 키는 실행마다 같아야 Aggregator의 키 고정/신뢰 키 목록과 맞는다
+    let keypair = load_signing_key(args.signing_key.as_deref(), &args.key_file)?;
+    let node_id = args
+        .node_id
+        .clone()
+        .unwrap_or_else(|| default_node_id(&keypair));
+    let mut grpc_client =
+        GrpcAggregatorClient::with_keypair(&args.aggregator_url, node_id, keypair).await?;
 
     // Check if gRPC Aggregator is healthy
     match grpc_client.check_health().await {
@@ -85,7 +216,7 @@ async fn main() -> Result<()> {
         Ok(false) => info!("⚠️ gRPC Aggregator is unhealthy, but continuing..."),
         Err(e) => {
             error!("❌ Cannot connect to gRPC Aggregator: {}", e);
-            info!("💡 Make sure to run: cargo run -p aggregator");
+            info!("💡 Make sure to run: cargo run -p aggregator -- --allow-tofu");
             return Err(e);
         }
     }
@@ -106,13 +237,13 @@ async fn main() -> Result<()> {
     // Wait until the next minute boundary (XX:XX:00)
     tokio::time::sleep(Duration::from_secs(seconds_to_wait as u64)).await;
 
-    // Create interval for subsequent collections
+    // Create interval for subsequent collections (첫 tick은 분 경계에서 즉시 발생)
     let mut interval = interval(Duration::from_secs(args.interval));
 
-    // Skip the first tick (which would fire immediately)
-    interval.tick().await;
-
     loop {
+        // Wait for next interval
+        let tick = interval.tick().await;
+
         // Collect price at synchronized time
         let collection_time = Utc::now();
         info!(
@@ -122,25 +253,45 @@ async fn main() -> Result<()> {
             collection_time.second()
         );
 
-        match exchange_provider.fetch_btc_price().await {
-            Ok(price_data) => {
-                info!(
-                    "Fetched BTC price: ${:.2} at timestamp: {}",
-                    price_data.price, price_data.timestamp
-                );
-
-                // Send to gRPC aggregator
-                match grpc_client.submit_price(&price_data).await {
-                    Ok(_) => info!("✅ Successfully sent price to gRPC aggregator"),
-                    Err(e) => error!("❌ Failed to send price to gRPC aggregator: {}", e),
+        // 모든 거래소 동시 조회 - 마감 시간은 분 경계 tick 기준
+        let results = exchange_provider
+            .fetch_all_prices_until(tick + policy.deadline)
+            .await;
+        info!(
+            "Collected {} exchanges in {}ms",
+            results.len(),
+            tick.elapsed().as_millis()
+        );
+
+        for (exchange, result) in results {
+            match result {
+                Ok(price_data) => {
+                    debug!(
+                        "Fetched {} price from {}: ${:.2} at timestamp: {}",
+                        price_data.pair,
+                        exchange,
+                        price_data.price,
+                        price_data.timestamp
+                    );
+
+                    // 이번 tick의 가격은 모아서 한 번에 전송
+                    grpc_client.queue_price(&price_data);
+                }
+                Err(e) => {
+                    warn!("Failed to fetch price from {}: {}", exchange, e);
                 }
-            }
-            Err(e) => {
-                error!("Failed to fetch price: {}", e);
             }
         }
 
-        // Wait for next interval
-        interval.tick().await;
+        // Send to gRPC aggregator (SubmitPriceBatch 한 번)
+        let queued = grpc_client.pending_len();
+        match grpc_client.flush().await {
+            Ok(0) if queued == 0 => warn!("No prices collected this tick"),
+            Ok(accepted) => info!(
+                "✅ Successfully sent {}/{} prices to gRPC aggregator",
+                accepted, queued
+            ),
+            Err(e) => error!("❌ Failed to send prices to gRPC aggregator: {}", e),
+        }
     }
 }
@@ -0,0 +1,80 @@
+//! Prometheus 지표
+//!
+//! - `oracle_exchange_fetch_seconds{exchange, outcome}`: 거래소 조회 (헤지 재시도 포함)
+//! - `oracle_submit_seconds{method, outcome}`: Aggregator 제출 왕복 시간
+
+use anyhow::{Context, Result};
+use axum::http::header;
+use axum::routing::get;
+use axum::Router;
+use oracle_vm_common::metrics::{self, HistogramVec};
+use std::net::SocketAddr;
+use std::sync::LazyLock;
+use std::time::Instant;
+use tracing::info;
+
+pub static EXCHANGE_FETCH_SECONDS: LazyLock<HistogramVec> = LazyLock::new(|| {
+    metrics::latency_histogram(
+        "oracle_exchange_fetch_seconds",
+        "Exchange price fetch latency including hedged attempts",
+        &["exchange", "outcome"],
+    )
+});
+
+pub static SUBMIT_SECONDS: LazyLock<HistogramVec> = LazyLock::new(|| {
+    metrics::latency_histogram(
+        "oracle_submit_seconds",
+        "Aggregator submission round trip",
+        &["method", "outcome"],
+    )
+});
+
+/// 결과 레이블 (`ok` / `error`)
+pub fn outcome<T, E>(result: &Result<T, E>) -> &'static str {
+    if result.is_ok() {
+        "ok"
+    } else {
+        "error"
+    }
+}
+
+/// `started` 이후 경과 시간을 기록
+pub fn observe(histogram: &HistogramVec, labels: &[&str], started: Instant) {
+    histogram
+        .with_label_values(labels)
+        .observe(started.elapsed().as_secs_f64());
+}
+
+/// `/metrics` 엔드포인트 실행
+pub async fn serve(addr: SocketAddr) -> Result<()> {
+    let app = Router::new().route(
+        "/metrics",
+        get(|| async {
+            (
+                [(header::CONTENT_TYPE, metrics::CONTENT_TYPE)],
+                metrics::render(),
+            )
+        }),
+    );
+    let listener = tokio::net::TcpListener::bind(addr)
+        .await
+        .with_context(|| format!("Failed to bind metrics listener on {}", addr))?;
+
+    info!("📈 Metrics listening on http://{}/metrics", addr);
+    axum::serve(listener, app).await?;
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_fetch_latency_is_exported() {
+        observe(&EXCHANGE_FETCH_SECONDS, &["binance", "ok"], Instant::now());
+        let text = metrics::render();
+        assert!(text.contains(
+            "oracle_exchange_fetch_seconds_count{exchange=\"binance\",outcome=\"ok\"} 1"
+        ));
+    }
+}
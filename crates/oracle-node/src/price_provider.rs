@@ -1,44 +1,112 @@
+use crate::metrics::{self, EXCHANGE_FETCH_SECONDS};
 use anyhow::Result;
 use async_trait::async_trait;
+use futures::future::join_all;
+use futures::stream::{FuturesUnordered, StreamExt};
 use oracle_vm_common::types::PriceData;
+use std::time::Duration;
+use tokio::time::{sleep, sleep_until, Instant};
+use tracing::warn;
+
+/// 거래소별 응답 마감 시간 기본값 (수집 시작 시점 기준)
+pub const DEFAULT_FETCH_DEADLINE: Duration = Duration::from_secs(20);
+/// 응답이 없을 때 추가 요청을 보내기까지의 대기 시간 기본값
+pub const DEFAULT_HEDGE_DELAY: Duration = Duration::from_secs(2);
+/// 거래소별 최대 동시 요청 수 기본값
+pub const DEFAULT_MAX_ATTEMPTS: usize = 3;
 
 /// Price provider trait for different exchanges
 #[async_trait]
 pub trait PriceProvider: Send + Sync {
     /// Fetch the current BTC price
     async fn fetch_btc_price(&self) -> Result<PriceData>;
-    
+
+    /// Fetch the current BTC price once, without internal retries
+    ///
+    /// 재시도는 호출 측(MultiExchangePriceProvider)이 헤지 요청으로 처리한다.
+    async fn fetch_btc_price_once(&self) -> Result<PriceData> {
+        self.fetch_btc_price().await
+    }
+
     /// Get the name of the exchange
     fn name(&self) -> &str;
 }
 
+/// 거래소별 수집 정책 (마감 시간 + 헤지 재시도)
+#[derive(Debug, Clone, Copy)]
+pub struct FetchPolicy {
+    /// 수집 시작 후 거래소별 응답 마감 시간
+    pub deadline: Duration,
+    /// 진행 중인 요청이 이 시간 안에 응답하지 않으면 추가 요청 발송
+    pub hedge_delay: Duration,
+    /// 거래소별 최대 요청 수 (최초 요청 포함)
+    pub max_attempts: usize,
+}
+
+impl Default for FetchPolicy {
+    fn default() -> Self {
+        Self {
+            deadline: DEFAULT_FETCH_DEADLINE,
+            hedge_delay: DEFAULT_HEDGE_DELAY,
+            max_attempts: DEFAULT_MAX_ATTEMPTS,
+        }
+    }
+}
+
 /// Multi-exchange price provider that can aggregate prices
 pub struct MultiExchangePriceProvider {
     providers: Vec<Box<dyn PriceProvider>>,
+    policy: FetchPolicy,
 }
 
 impl MultiExchangePriceProvider {
     pub fn new(providers: Vec<Box<dyn PriceProvider>>) -> Self {
-        Self { providers }
+        Self::with_policy(providers, FetchPolicy::default())
     }
-    
+
+    pub fn with_policy(providers: Vec<Box<dyn PriceProvider>>, policy: FetchPolicy) -> Self {
+        Self { providers, policy }
+    }
+
+    /// 등록된 거래소 이름 목록
+    pub fn provider_names(&self) -> Vec<&str> {
+        self.providers
+            .iter()
+            .map(|provider| provider.name())
+            .collect()
+    }
+
     /// Fetch prices from all providers
     pub async fn fetch_all_prices(&self) -> Vec<(String, Result<PriceData>)> {
-        let mut results = Vec::new();
-        
-        for provider in &self.providers {
-            let name = provider.name().to_string();
-            let result = provider.fetch_btc_price().await;
-            results.push((name, result));
-        }
-        
-        results
+        self.fetch_all_prices_until(Instant::now() + self.policy.deadline)
+            .await
+    }
+
+    /// 모든 거래소를 동시에 조회 - 소요 시간은 가장 느린 거래소 하나 (최대 `deadline`까지)
+    ///
+    /// 결과는 등록 순서를 유지하며, 마감 시간을 넘긴 거래소는 에러로 반환된다.
+    pub async fn fetch_all_prices_until(
+        &self,
+        deadline: Instant,
+    ) -> Vec<(String, Result<PriceData>)> {
+        let fetches = self.providers.iter().map(|provider| async move {
+            let started = std::time::Instant::now();
+            let result = fetch_hedged(provider.as_ref(), &self.policy, deadline).await;
+            metrics::observe(
+                &EXCHANGE_FETCH_SECONDS,
+                &[provider.name(), metrics::outcome(&result)],
+                started,
+            );
+            (provider.name().to_string(), result)
+        });
+
+        join_all(fetches).await
     }
-    
+
     /// Fetch prices and return only successful ones
     pub async fn fetch_valid_prices(&self) -> Vec<PriceData> {
         let results = self.fetch_all_prices().await;
-        
+
         results
             .into_iter()
             .filter_map(|(_, result)| result.ok())
@@ -46,89 +114,251 @@ impl MultiExchangePriceProvider {
     }
 }
 
+/// 헤지 재시도로 거래소 하나를 조회
+///
+/// 진행 중인 요청이 `hedge_delay` 안에 응답하지 않거나 실패하면 대기 없이 추가 요청을
+/// 보내고, 가장 먼저 성공한 응답을 사용한다. 남은 요청은 반환 시 취소된다.
+async fn fetch_hedged(
+    provider: &dyn PriceProvider,
+    policy: &FetchPolicy,
+    deadline: Instant,
+) -> Result<PriceData> {
+    let max_attempts = policy.max_attempts.max(1);
+    let mut in_flight = FuturesUnordered::new();
+    in_flight.push(provider.fetch_btc_price_once());
+    let mut launched = 1;
+
+    let deadline_reached = sleep_until(deadline);
+    tokio::pin!(deadline_reached);
+
+    loop {
+        tokio::select! {
+            biased;
+            Some(result) = in_flight.next() => match result {
+                Ok(price_data) => return Ok(price_data),
+                Err(e) => {
+                    warn!(
+                        "Failed to fetch price from {} (attempt {}/{}): {}",
+                        provider.name(), launched, max_attempts, e
+                    );
+                    if launched < max_attempts {
+                        in_flight.push(provider.fetch_btc_price_once());
+                        launched += 1;
+                    } else if in_flight.is_empty() {
+                        // 모든 요청 실패 - 마지막 에러 반환
+                        return Err(e);
+                    }
+                }
+            },
+            _ = sleep(policy.hedge_delay), if launched < max_attempts => {
+                warn!(
+                    "{} slow to respond, sending hedged request ({}/{})",
+                    provider.name(), launched + 1, max_attempts
+                );
+                in_flight.push(provider.fetch_btc_price_once());
+                launched += 1;
+            }
+            _ = &mut deadline_reached => {
+                anyhow::bail!("{} missed collection deadline", provider.name());
+            }
+        }
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
+    use chrono::DateTime;
     use mockall::{mock, predicate::*};
-    
+    use oracle_vm_common::types::AssetPair;
+    use oracle_vm_common::Price;
+    use std::collections::VecDeque;
+    use std::sync::atomic::{AtomicUsize, Ordering};
+    use std::sync::Mutex;
+
     mock! {
         Provider {}
-        
+
         #[async_trait]
         impl PriceProvider for Provider {
             async fn fetch_btc_price(&self) -> Result<PriceData>;
             fn name(&self) -> &str;
         }
     }
-    
+
+    fn sample_price(source: &str, cents: i64) -> PriceData {
+        PriceData {
+            pair: AssetPair::btc_usd(),
+            price: Price::from_cents(cents),
+            timestamp: DateTime::from_timestamp(1700000000, 0).unwrap(),
+            volume: None,
+            source: source.to_string(),
+        }
+    }
+
+    /// 호출마다 지정된 지연 후 응답하는 테스트용 거래소
+    struct DelayedProvider {
+        name: &'static str,
+        delays: Mutex<VecDeque<Duration>>,
+        calls: AtomicUsize,
+    }
+
+    impl DelayedProvider {
+        fn new(name: &'static str, delays_ms: &[u64]) -> Self {
+            Self {
+                name,
+                delays: Mutex::new(
+                    delays_ms
+                        .iter()
+                        .map(|&ms| Duration::from_millis(ms))
+                        .collect(),
+                ),
+                calls: AtomicUsize::new(0),
+            }
+        }
+    }
+
+    #[async_trait]
+    impl PriceProvider for DelayedProvider {
+        async fn fetch_btc_price(&self) -> Result<PriceData> {
+            self.calls.fetch_add(1, Ordering::SeqCst);
+            let delay = {
+                let mut delays = self.delays.lock().unwrap();
+                if delays.len() > 1 {
+                    delays.pop_front().unwrap()
+                } else {
+                    delays[0]
+                }
+            };
+            sleep(delay).await;
+            Ok(sample_price(self.name, 7_000_000))
+        }
+
+        fn name(&self) -> &str {
+            self.name
+        }
+    }
+
     #[tokio::test]
     async fn test_multi_exchange_fetches_all_prices() {
         // Given
         let mut mock1 = MockProvider::new();
         let mut mock2 = MockProvider::new();
-        
+
         mock1.expect_name().return_const("Exchange1".to_string());
-        mock1.expect_fetch_btc_price()
+        mock1
+            .expect_fetch_btc_price()
             .times(1)
-            .returning(|| Ok(PriceData {
-                price: 70000.0,
-                timestamp: 1700000000,
-                source: "Exchange1".to_string(),
-            }));
-            
+            .returning(|| Ok(sample_price("Exchange1", 7_000_000)));
+
         mock2.expect_name().return_const("Exchange2".to_string());
-        mock2.expect_fetch_btc_price()
+        mock2
+            .expect_fetch_btc_price()
             .times(1)
-            .returning(|| Ok(PriceData {
-                price: 70100.0,
-                timestamp: 1700000001,
-                source: "Exchange2".to_string(),
-            }));
-        
-        let provider = MultiExchangePriceProvider::new(vec![
-            Box::new(mock1),
-            Box::new(mock2),
-        ]);
-        
+            .returning(|| Ok(sample_price("Exchange2", 7_010_000)));
+
+        let provider = MultiExchangePriceProvider::new(vec![Box::new(mock1), Box::new(mock2)]);
+
         // When
         let prices = provider.fetch_valid_prices().await;
-        
+
         // Then
         assert_eq!(prices.len(), 2);
-        assert_eq!(prices[0].price, 70000.0);
-        assert_eq!(prices[1].price, 70100.0);
+        assert_eq!(prices[0].price, Price::from_cents(7_000_000));
+        assert_eq!(prices[1].price, Price::from_cents(7_010_000));
     }
-    
+
     #[tokio::test]
     async fn test_multi_exchange_handles_failures() {
         // Given
         let mut mock1 = MockProvider::new();
         let mut mock2 = MockProvider::new();
-        
+
         mock1.expect_name().return_const("Exchange1".to_string());
-        mock1.expect_fetch_btc_price()
-            .times(1)
+        mock1
+            .expect_fetch_btc_price()
+            .times(DEFAULT_MAX_ATTEMPTS)
             .returning(|| Err(anyhow::anyhow!("Network error")));
-            
+
         mock2.expect_name().return_const("Exchange2".to_string());
-        mock2.expect_fetch_btc_price()
+        mock2
+            .expect_fetch_btc_price()
             .times(1)
-            .returning(|| Ok(PriceData {
-                price: 70100.0,
-                timestamp: 1700000001,
-                source: "Exchange2".to_string(),
-            }));
-        
-        let provider = MultiExchangePriceProvider::new(vec![
-            Box::new(mock1),
-            Box::new(mock2),
-        ]);
-        
+            .returning(|| Ok(sample_price("Exchange2", 7_010_000)));
+
+        let provider = MultiExchangePriceProvider::new(vec![Box::new(mock1), Box::new(mock2)]);
+
         // When
         let prices = provider.fetch_valid_prices().await;
-        
+
         // Then - Only successful price is returned
         assert_eq!(prices.len(), 1);
-        assert_eq!(prices[0].price, 70100.0);
+        assert_eq!(prices[0].price, Price::from_cents(7_010_000));
+    }
+
+    #[tokio::test]
+    async fn test_fetches_run_concurrently() {
+        // Given - 각각 200ms 걸리는 거래소 3개
+        let provider = MultiExchangePriceProvider::new(vec![
+            Box::new(DelayedProvider::new("binance", &[200])),
+            Box::new(DelayedProvider::new("coinbase", &[200])),
+            Box::new(DelayedProvider::new("kraken", &[200])),
+        ]);
+
+        // When
+        let started = Instant::now();
+        let prices = provider.fetch_valid_prices().await;
+
+        // Then - 합이 아니라 가장 느린 거래소 하나만큼 걸림
+        assert_eq!(prices.len(), 3);
+        assert!(started.elapsed() < Duration::from_millis(500));
     }
-}
\ No newline at end of file
+
+    #[tokio::test]
+    async fn test_hedged_request_beats_stalled_attempt() {
+        // Given - 첫 요청은 멈추고 두 번째 요청은 바로 응답
+        let policy = FetchPolicy {
+            deadline: Duration::from_secs(5),
+            hedge_delay: Duration::from_millis(50),
+            max_attempts: 3,
+        };
+        let stalled = DelayedProvider::new("binance", &[10_000, 10]);
+
+        // When
+        let started = Instant::now();
+        let result = fetch_hedged(&stalled, &policy, Instant::now() + policy.deadline).await;
+
+        // Then
+        assert!(result.is_ok());
+        assert_eq!(stalled.calls.load(Ordering::SeqCst), 2);
+        assert!(started.elapsed() < Duration::from_secs(1));
+    }
+
+    #[tokio::test]
+    async fn test_deadline_bounds_slow_exchange() {
+        // Given - 마감 시간보다 느린 거래소
+        let policy = FetchPolicy {
+            deadline: Duration::from_millis(100),
+            hedge_delay: Duration::from_secs(10),
+            max_attempts: 1,
+        };
+        let provider = MultiExchangePriceProvider::with_policy(
+            vec![
+                Box::new(DelayedProvider::new("binance", &[10])),
+                Box::new(DelayedProvider::new("kraken", &[10_000])),
+            ],
+            policy,
+        );
+
+        // When
+        let started = Instant::now();
+        let results = provider.fetch_all_prices().await;
+
+        // Then - 빠른 거래소 결과는 유지되고 느린 거래소만 실패
+        assert!(started.elapsed() < Duration::from_secs(1));
+        assert_eq!(results[0].0, "binance");
+        assert!(results[0].1.is_ok());
+        assert_eq!(results[1].0, "kraken");
+        assert!(results[1].1.is_err());
+    }
+}
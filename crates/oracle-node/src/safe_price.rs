@@ -4,6 +4,7 @@ use rust_decimal::Decimal;
 use serde::{Deserialize, Serialize};
 use std::str::FromStr;
 use oracle_vm_common::types::PriceData;
+use oracle_vm_common::Price;
 
 /// 안전한 BTC 가격 처리를 위한 래퍼 타입
 #[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Serialize, Deserialize)]
@@ -37,6 +38,13 @@ impl SafeBtcPrice {
         Ok(Self { satoshis })
     }
 
+    /// 고정소수점 가격에서 생성 (같은 10^-8 단위라 값 그대로 사용)
+    pub fn from_fixed(price: Price) -> Result<Self> {
+        let satoshis = u64::try_from(price.mantissa())
+            .map_err(|_| anyhow::anyhow!("BTC price cannot be negative"))?;
+        Ok(Self { satoshis })
+    }
+
     /// f64에서 생성 (권장하지 않음, 정밀도 손실 가능)
     #[deprecated(note = "Use from_btc_str for precise conversion")]
     pub fn from_f64(btc: f64) -> Result<Self> {
@@ -206,10 +214,7 @@ pub struct SafePriceData {
 impl SafePriceData {
     /// 기존 PriceData에서 변환
     pub fn from_price_data(data: &PriceData) -> Result<Self> {
-        // Convert cents to dollars
-        let price_usd = data.price as f64 / 100.0;
-        #[allow(deprecated)]
-        let safe_price = SafeBtcPrice::from_f64(price_usd)?;
+        let safe_price = SafeBtcPrice::from_fixed(data.price)?;
 
         Ok(Self {
             price: safe_price,
@@ -265,4 +270,12 @@ mod tests {
         // satoshi 변환은 8자리까지만 정확 (BTC의 최소 단위)
         assert_eq!(price.to_btc_string(), "65432.12345678");
     }
+
+    #[test]
+    fn test_from_fixed_price() {
+        let fixed: Price = "65432.12345678".parse().unwrap();
+        let price = SafeBtcPrice::from_fixed(fixed).unwrap();
+        assert_eq!(price, SafeBtcPrice::from_btc_str("65432.12345678").unwrap());
+        assert!(SafeBtcPrice::from_fixed(Price::from_cents(-1)).is_err());
+    }
 }
@@ -0,0 +1,661 @@
+//! 웹소켓 기반 실시간 가격 제공자
+//!
+//! 거래소 웹소켓 캔들/티커 피드를 구독해 최신 가격을 메모리에 캐시한다.
+//! `fetch_btc_price`는 네트워크 요청 없이 캐시만 읽으므로 수집 간격을 초 단위로 줄여도
+//! REST 요청 제한에 걸리지 않는다. 연결이 끊기면 백그라운드 태스크가 자동으로 재연결한다.
+//!
+//! 캐시는 가격과 함께 진행 중인 1분 캔들의 거래량도 보관한다. 캔들 피드(Binance, Kraken)는
+//! 누적 거래량을 그대로 쓰고, 체결 티커 피드(Coinbase)는 체결 수량을 분 단위로 합산한다.
+
+use crate::binance::binance_symbol;
+use crate::coinbase::coinbase_product_id;
+use crate::kraken::kraken_asset;
+use crate::price_provider::PriceProvider;
+use anyhow::{Context, Result};
+use async_trait::async_trait;
+use chrono::DateTime;
+use futures::{SinkExt, StreamExt};
+use oracle_vm_common::types::{AssetPair, PriceData};
+use oracle_vm_common::Price;
+use serde::Deserialize;
+use std::sync::{Arc, RwLock};
+use std::time::Duration;
+use tokio::task::JoinHandle;
+use tokio::time::{sleep, timeout, Instant};
+use tokio_tungstenite::{connect_async, tungstenite::Message};
+use tracing::{info, warn};
+
+/// 바이낸스 웹소켓 스트림 (뒤에 `<symbol>@kline_1m`)
+const BINANCE_WS_URL: &str = "wss://stream.binance.com:9443/ws";
+/// Coinbase 웹소켓 피드
+const COINBASE_WS_URL: &str = "wss://ws-feed.exchange.coinbase.com";
+/// Kraken 웹소켓 피드 (v1)
+const KRAKEN_WS_URL: &str = "wss://ws.kraken.com";
+
+/// 캐시된 가격이 이 시간보다 오래되면 사용하지 않음
+pub const DEFAULT_MAX_STALENESS: Duration = Duration::from_secs(120);
+/// 이 시간 동안 메시지가 없으면 연결이 끊긴 것으로 보고 재연결
+const IDLE_TIMEOUT: Duration = Duration::from_secs(30);
+/// 거래량 집계 단위 (초) - 1분 캔들
+const CANDLE_SECS: i64 = 60;
+/// 재연결 대기 시간 (지수적 백오프)
+const RECONNECT_DELAY_MIN: Duration = Duration::from_secs(1);
+const RECONNECT_DELAY_MAX: Duration = Duration::from_secs(30);
+
+/// 피드에서 받은 거래량
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub enum TickVolume {
+    /// 진행 중인 1분 캔들의 누적 거래량 (기준 자산 단위)
+    Candle(f64),
+    /// 체결 한 건의 수량 - 캐시에서 같은 분의 체결끼리 합산
+    Trade(f64),
+}
+
+/// 피드에서 받은 가격 갱신
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct PriceTick {
+    /// 진행 중인 캔들의 종가 (= 현재가)
+    pub price: Price,
+    /// 거래소 기준 이벤트 시각 (unix 초)
+    pub event_time: i64,
+    /// 거래량 (피드가 보내지 않으면 None)
+    pub volume: Option<TickVolume>,
+}
+
+/// 거래소별 웹소켓 프로토콜
+pub trait ExchangeFeed: Send + Sync + 'static {
+    /// 거래소 이름 (PriceData.source)
+    fn name(&self) -> &'static str;
+
+    /// 구독할 자산 쌍 (PriceData.pair)
+    fn pair(&self) -> &AssetPair;
+
+    /// 웹소켓 주소
+    fn url(&self) -> &str;
+
+    /// 연결 직후 보낼 구독 메시지 (URL로 구독하는 거래소는 None)
+    fn subscribe_message(&self) -> Option<String>;
+
+    /// 텍스트 메시지 파싱 - 가격과 무관한 메시지(하트비트, 구독 확인 등)는 Ok(None)
+    fn parse(&self, text: &str) -> Result<Option<PriceTick>>;
+}
+
+/// 캐시 슬롯 - 마지막 가격, 진행 중인 캔들의 거래량, 수신 시각
+#[derive(Debug, Clone, Copy)]
+struct CachedTick {
+    tick: PriceTick,
+    volume: Option<f64>,
+    received_at: Instant,
+}
+
+impl CachedTick {
+    /// 새 가격 반영 - 체결 수량은 같은 분에 받은 이전 거래량에 더한다
+    ///
+    /// 연결 직후의 첫 분은 그 뒤에 받은 체결만 합산된다.
+    fn update(previous: Option<CachedTick>, tick: PriceTick, received_at: Instant) -> Self {
+        let minute = tick.event_time.div_euclid(CANDLE_SECS);
+        let volume = match tick.volume {
+            Some(TickVolume::Candle(volume)) => Some(volume),
+            Some(TickVolume::Trade(size)) => {
+                let carried = previous
+                    .filter(|previous| previous.tick.event_time.div_euclid(CANDLE_SECS) == minute)
+                    .and_then(|previous| previous.volume)
+                    .unwrap_or(0.0);
+                Some(carried + size)
+            }
+            None => None,
+        };
+
+        Self {
+            tick,
+            volume,
+            received_at,
+        }
+    }
+}
+
+type TickCache = Arc<RwLock<Option<CachedTick>>>;
+
+/// 웹소켓 피드를 구독하는 가격 제공자
+pub struct StreamingPriceProvider {
+    name: &'static str,
+    pair: AssetPair,
+    cache: TickCache,
+    max_staleness: Duration,
+    task: JoinHandle<()>,
+}
+
+impl StreamingPriceProvider {
+    /// 피드 구독 태스크를 시작 (tokio 런타임 안에서 호출)
+    pub fn spawn<F: ExchangeFeed>(feed: F) -> Self {
+        let name = feed.name();
+        let pair = feed.pair().clone();
+        let cache: TickCache = Arc::new(RwLock::new(None));
+        let task = tokio::spawn(run_feed(feed, Arc::clone(&cache)));
+
+        Self {
+            name,
+            pair,
+            cache,
+            max_staleness: DEFAULT_MAX_STALENESS,
+            task,
+        }
+    }
+
+    pub fn binance(pair: AssetPair) -> Self {
+        Self::spawn(BinanceKlineFeed::new(pair))
+    }
+
+    pub fn coinbase(pair: AssetPair) -> Self {
+        Self::spawn(CoinbaseTickerFeed::new(pair))
+    }
+
+    pub fn kraken(pair: AssetPair) -> Self {
+        Self::spawn(KrakenOhlcFeed::new(pair))
+    }
+
+    /// 캐시 유효 시간 설정
+    pub fn with_max_staleness(mut self, max_staleness: Duration) -> Self {
+        self.max_staleness = max_staleness;
+        self
+    }
+}
+
+impl Drop for StreamingPriceProvider {
+    fn drop(&mut self) {
+        self.task.abort();
+    }
+}
+
+#[async_trait]
+impl PriceProvider for StreamingPriceProvider {
+    /// 캐시에서 최신 가격 읽기 (네트워크 요청 없음)
+    async fn fetch_btc_price(&self) -> Result<PriceData> {
+        let cached = *self.cache.read().unwrap();
+        price_from_cache(self.name, &self.pair, cached, self.max_staleness)
+    }
+
+    fn name(&self) -> &str {
+        self.name
+    }
+}
+
+/// 캐시 슬롯을 PriceData로 변환 (비어 있거나 오래된 경우 에러)
+fn price_from_cache(
+    source: &str,
+    pair: &AssetPair,
+    cached: Option<CachedTick>,
+    max_staleness: Duration,
+) -> Result<PriceData> {
+    let cached =
+        cached.ok_or_else(|| anyhow::anyhow!("No {} websocket data received yet", source))?;
+
+    let age = cached.received_at.elapsed();
+    if age > max_staleness {
+        anyhow::bail!(
+            "{} websocket data is stale ({}s old), feed may be disconnected",
+            source,
+            age.as_secs()
+        );
+    }
+
+    Ok(PriceData {
+        pair: pair.clone(),
+        price: cached.tick.price,
+        timestamp: DateTime::from_timestamp(cached.tick.event_time, 0)
+            .unwrap_or_else(chrono::Utc::now),
+        volume: cached.volume,
+        source: source.to_string(),
+    })
+}
+
+/// 구독 태스크 - 연결이 끊기면 지수적 백오프로 재연결
+async fn run_feed<F: ExchangeFeed>(feed: F, cache: TickCache) {
+    let mut reconnect_delay = RECONNECT_DELAY_MIN;
+
+    loop {
+        match stream_once(&feed, &cache, &mut reconnect_delay).await {
+            Ok(()) => warn!("🔌 {} websocket closed by server", feed.name()),
+            Err(e) => warn!("🔌 {} websocket error: {:#}", feed.name(), e),
+        }
+
+        info!(
+            "Reconnecting to {} websocket in {}s...",
+            feed.name(),
+            reconnect_delay.as_secs()
+        );
+        sleep(reconnect_delay).await;
+        reconnect_delay = (reconnect_delay * 2).min(RECONNECT_DELAY_MAX);
+    }
+}
+
+/// 연결 하나를 끊길 때까지 읽음 - 가격을 받으면 재연결 대기 시간을 초기화
+async fn stream_once<F: ExchangeFeed>(
+    feed: &F,
+    cache: &TickCache,
+    reconnect_delay: &mut Duration,
+) -> Result<()> {
+    let (mut ws, _) = connect_async(feed.url())
+        .await
+        .with_context(|| format!("Failed to connect to {} websocket", feed.name()))?;
+    info!(
+        "🔌 Connected to {} websocket ({})",
+        feed.name(),
+        feed.pair()
+    );
+
+    if let Some(subscribe) = feed.subscribe_message() {
+        ws.send(Message::Text(subscribe))
+            .await
+            .context("Failed to send subscribe message")?;
+    }
+
+    loop {
+        // Ping에 대한 Pong은 tungstenite가 자동으로 응답
+        let message = match timeout(IDLE_TIMEOUT, ws.next()).await {
+            Err(_) => anyhow::bail!("No message for {}s", IDLE_TIMEOUT.as_secs()),
+            Ok(None) => return Ok(()),
+            Ok(Some(message)) => message.context("Failed to read websocket message")?,
+        };
+
+        match message {
+            Message::Text(text) => match feed.parse(&text) {
+                Ok(Some(tick)) => {
+                    let mut slot = cache.write().unwrap();
+                    *slot = Some(CachedTick::update(*slot, tick, Instant::now()));
+                    *reconnect_delay = RECONNECT_DELAY_MIN;
+                }
+                Ok(None) => {}
+                Err(e) => warn!("Failed to parse {} message: {}", feed.name(), e),
+            },
+            Message::Close(_) => return Ok(()),
+            _ => {}
+        }
+    }
+}
+
+/// 문자열 가격 파싱 + 검증 (f64를 거치지 않고 고정소수점으로)
+fn parse_price(value: &str, source: &str) -> Result<Price> {
+    let price = value
+        .parse::<Price>()
+        .with_context(|| format!("Failed to parse {} price: {}", source, value))?;
+    if !price.is_positive() {
+        anyhow::bail!("Invalid price from {}: {}", source, price);
+    }
+    Ok(price)
+}
+
+/// 거래량 문자열 파싱 (잘못된 값은 거래량 없음으로 처리)
+fn parse_volume(value: &str) -> Option<f64> {
+    value
+        .parse::<f64>()
+        .ok()
+        .filter(|volume| volume.is_finite() && *volume >= 0.0)
+}
+
+/// 바이낸스 kline 이벤트
+#[derive(Debug, Deserialize)]
+struct BinanceKlineEvent {
+    #[serde(rename = "e")]
+    event_type: String,
+    #[serde(rename = "E")]
+    event_time_ms: i64,
+    #[serde(rename = "k")]
+    kline: BinanceKline,
+}
+
+#[derive(Debug, Deserialize)]
+struct BinanceKline {
+    #[serde(rename = "c")]
+    close: String,
+    #[serde(rename = "v")]
+    volume: String,
+}
+
+/// 바이낸스 1분 K-line 스트림 (URL로 구독)
+pub struct BinanceKlineFeed {
+    pair: AssetPair,
+    url: String,
+}
+
+impl BinanceKlineFeed {
+    pub fn new(pair: AssetPair) -> Self {
+        let url = format!(
+            "{}/{}@kline_1m",
+            BINANCE_WS_URL,
+            binance_symbol(&pair).to_lowercase()
+        );
+        Self { pair, url }
+    }
+}
+
+impl ExchangeFeed for BinanceKlineFeed {
+    fn name(&self) -> &'static str {
+        "binance"
+    }
+
+    fn pair(&self) -> &AssetPair {
+        &self.pair
+    }
+
+    fn url(&self) -> &str {
+        &self.url
+    }
+
+    fn subscribe_message(&self) -> Option<String> {
+        None
+    }
+
+    fn parse(&self, text: &str) -> Result<Option<PriceTick>> {
+        let event: BinanceKlineEvent =
+            serde_json::from_str(text).context("Failed to parse Binance kline event")?;
+        if event.event_type != "kline" {
+            return Ok(None);
+        }
+
+        Ok(Some(PriceTick {
+            price: parse_price(&event.kline.close, "binance")?,
+            event_time: event.event_time_ms / 1000,
+            volume: parse_volume(&event.kline.volume).map(TickVolume::Candle),
+        }))
+    }
+}
+
+/// Coinbase 피드 메시지 (ticker 외 필드는 선택)
+#[derive(Debug, Deserialize)]
+struct CoinbaseMessage {
+    #[serde(rename = "type")]
+    message_type: String,
+    price: Option<String>,
+    /// 이 체결의 수량
+    last_size: Option<String>,
+    time: Option<String>,
+    message: Option<String>,
+}
+
+/// Coinbase ticker 채널 (캔들 채널이 없어 체결 티커 사용)
+pub struct CoinbaseTickerFeed {
+    pair: AssetPair,
+}
+
+impl CoinbaseTickerFeed {
+    pub fn new(pair: AssetPair) -> Self {
+        Self { pair }
+    }
+}
+
+impl ExchangeFeed for CoinbaseTickerFeed {
+    fn name(&self) -> &'static str {
+        "coinbase"
+    }
+
+    fn pair(&self) -> &AssetPair {
+        &self.pair
+    }
+
+    fn url(&self) -> &str {
+        COINBASE_WS_URL
+    }
+
+    fn subscribe_message(&self) -> Option<String> {
+        Some(
+            serde_json::json!({
+                "type": "subscribe",
+                "product_ids": [coinbase_product_id(&self.pair)],
+                "channels": ["ticker", "heartbeat"],
+            })
+            .to_string(),
+        )
+    }
+
+    fn parse(&self, text: &str) -> Result<Option<PriceTick>> {
+        let message: CoinbaseMessage =
+            serde_json::from_str(text).context("Failed to parse Coinbase message")?;
+
+        match message.message_type.as_str() {
+            "ticker" => {
+                let price = message
+                    .price
+                    .ok_or_else(|| anyhow::anyhow!("Coinbase ticker without price"))?;
+                let event_time = message
+                    .time
+                    .and_then(|time| DateTime::parse_from_rfc3339(&time).ok())
+                    .map(|time| time.timestamp())
+                    .unwrap_or_else(|| chrono::Utc::now().timestamp());
+
+                Ok(Some(PriceTick {
+                    price: parse_price(&price, "coinbase")?,
+                    event_time,
+                    volume: message
+                        .last_size
+                        .as_deref()
+                        .and_then(parse_volume)
+                        .map(TickVolume::Trade),
+                }))
+            }
+            "error" => anyhow::bail!(
+                "Coinbase websocket error: {}",
+                message.message.unwrap_or_default()
+            ),
+            _ => Ok(None),
+        }
+    }
+}
+
+/// Kraken OHLC 항목 [time, etime, open, high, low, close, vwap, volume, count]
+#[derive(Debug, Deserialize)]
+struct KrakenWsOhlc(
+    String,
+    String,
+    String,
+    String,
+    String,
+    String,
+    String,
+    String,
+    u64,
+);
+
+/// Kraken 이벤트 메시지 (하트비트, 구독 상태 등)
+#[derive(Debug, Deserialize)]
+struct KrakenEvent {
+    event: String,
+    status: Option<String>,
+    #[serde(rename = "errorMessage")]
+    error_message: Option<String>,
+}
+
+/// Kraken 1분 OHLC 채널
+pub struct KrakenOhlcFeed {
+    pair: AssetPair,
+}
+
+impl KrakenOhlcFeed {
+    pub fn new(pair: AssetPair) -> Self {
+        Self { pair }
+    }
+}
+
+impl ExchangeFeed for KrakenOhlcFeed {
+    fn name(&self) -> &'static str {
+        "kraken"
+    }
+
+    fn pair(&self) -> &AssetPair {
+        &self.pair
+    }
+
+    fn url(&self) -> &str {
+        KRAKEN_WS_URL
+    }
+
+    fn subscribe_message(&self) -> Option<String> {
+        let pair = format!("{}/{}", kraken_asset(self.pair.base()), self.pair.quote());
+        Some(
+            serde_json::json!({
+                "event": "subscribe",
+                "pair": [pair],
+                "subscription": { "name": "ohlc", "interval": 1 },
+            })
+            .to_string(),
+        )
+    }
+
+    fn parse(&self, text: &str) -> Result<Option<PriceTick>> {
+        // 채널 데이터는 배열, 이벤트는 객체
+        if !text.trim_start().starts_with('[') {
+            let event: KrakenEvent =
+                serde_json::from_str(text).context("Failed to parse Kraken event")?;
+            if event.event == "subscriptionStatus" && event.status.as_deref() == Some("error") {
+                anyhow::bail!(
+                    "Kraken subscription failed: {}",
+                    event.error_message.unwrap_or_default()
+                );
+            }
+            return Ok(None);
+        }
+
+        let (_channel_id, ohlc, _channel_name, _pair): (u64, KrakenWsOhlc, String, String) =
+            serde_json::from_str(text).context("Failed to parse Kraken OHLC message")?;
+        let event_time = ohlc
+            .0
+            .parse::<f64>()
+            .context("Failed to parse Kraken OHLC time")? as i64;
+
+        Ok(Some(PriceTick {
+            price: parse_price(&ohlc.5, "kraken")?,
+            event_time,
+            volume: parse_volume(&ohlc.7).map(TickVolume::Candle),
+        }))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_binance_kline_parsing() {
+        let text = r#"{"e":"kline","E":1700000012345,"s":"BTCUSDT","k":{"t":1700000000000,"T":1700000059999,"s":"BTCUSDT","i":"1m","o":"69990.00","c":"70012.34","h":"70020.00","l":"69980.00","v":"12.5","x":false}}"#;
+
+        let feed = BinanceKlineFeed::new(AssetPair::btc_usd());
+        let tick = feed.parse(text).unwrap().unwrap();
+        assert_eq!(tick.price, Price::from_cents(7_001_234));
+        assert_eq!(tick.event_time, 1700000012);
+        assert_eq!(tick.volume, Some(TickVolume::Candle(12.5)));
+    }
+
+    #[test]
+    fn test_feeds_subscribe_configured_pair() {
+        let eth = AssetPair::new("ETH", "USD");
+
+        assert_eq!(
+            BinanceKlineFeed::new(eth.clone()).url(),
+            "wss://stream.binance.com:9443/ws/ethusdt@kline_1m"
+        );
+        assert!(CoinbaseTickerFeed::new(eth.clone())
+            .subscribe_message()
+            .unwrap()
+            .contains(r#""product_ids":["ETH-USD"]"#));
+        assert!(KrakenOhlcFeed::new(AssetPair::btc_usd())
+            .subscribe_message()
+            .unwrap()
+            .contains(r#""pair":["XBT/USD"]"#));
+    }
+
+    #[test]
+    fn test_coinbase_ticker_parsing() {
+        let feed = CoinbaseTickerFeed::new(AssetPair::btc_usd());
+        let ticker = r#"{"type":"ticker","sequence":1,"product_id":"BTC-USD","price":"70001.50","last_size":"0.25","time":"2023-11-14T22:13:20.000000Z"}"#;
+
+        let tick = feed.parse(ticker).unwrap().unwrap();
+        assert_eq!(tick.price, Price::from_cents(7_000_150));
+        assert_eq!(tick.event_time, 1700000000);
+        assert_eq!(tick.volume, Some(TickVolume::Trade(0.25)));
+
+        // 구독 확인, 하트비트는 무시
+        assert!(feed
+            .parse(r#"{"type":"subscriptions","channels":[]}"#)
+            .unwrap()
+            .is_none());
+        assert!(feed
+            .parse(r#"{"type":"heartbeat","product_id":"BTC-USD"}"#)
+            .unwrap()
+            .is_none());
+        assert!(feed
+            .parse(r#"{"type":"error","message":"Failed to subscribe"}"#)
+            .is_err());
+    }
+
+    #[test]
+    fn test_kraken_ohlc_parsing() {
+        let feed = KrakenOhlcFeed::new(AssetPair::btc_usd());
+        let ohlc = r#"[343,["1700000005.123456","1700000060.000000","69995.0","70010.0","69990.0","70005.5","70000.1","1.25",42],"ohlc-1","XBT/USD"]"#;
+
+        let tick = feed.parse(ohlc).unwrap().unwrap();
+        assert_eq!(tick.price, Price::from_cents(7_000_550));
+        assert_eq!(tick.event_time, 1700000005);
+        assert_eq!(tick.volume, Some(TickVolume::Candle(1.25)));
+
+        assert!(feed.parse(r#"{"event":"heartbeat"}"#).unwrap().is_none());
+        assert!(feed
+            .parse(r#"{"event":"subscriptionStatus","status":"error","errorMessage":"Currency pair not supported"}"#)
+            .is_err());
+    }
+
+    #[test]
+    fn test_cache_rejects_missing_and_stale_data() {
+        let tick = PriceTick {
+            price: Price::from_units(70_000),
+            event_time: 1700000000,
+            volume: Some(TickVolume::Candle(3.5)),
+        };
+        let fresh = CachedTick::update(None, tick, Instant::now());
+
+        let pair = AssetPair::btc_usd();
+
+        assert!(price_from_cache("binance", &pair, None, DEFAULT_MAX_STALENESS).is_err());
+
+        let price_data =
+            price_from_cache("binance", &pair, Some(fresh), DEFAULT_MAX_STALENESS).unwrap();
+        assert_eq!(price_data.price, Price::from_units(70_000));
+        assert_eq!(price_data.pair, pair);
+        assert_eq!(price_data.source, "binance");
+        assert_eq!(price_data.timestamp.timestamp(), 1700000000);
+        assert_eq!(price_data.volume, Some(3.5));
+
+        std::thread::sleep(Duration::from_millis(20));
+        assert!(
+            price_from_cache("binance", &pair, Some(fresh), Duration::from_millis(10)).is_err()
+        );
+    }
+
+    #[test]
+    fn test_trade_sizes_accumulate_per_minute() {
+        let trade = |event_time: i64, size: f64| PriceTick {
+            price: Price::from_units(70_000),
+            event_time,
+            volume: Some(TickVolume::Trade(size)),
+        };
+        let now = Instant::now();
+
+        // 1700000000 = 분 경계
+        let first = CachedTick::update(None, trade(1700000001, 0.5), now);
+        let second = CachedTick::update(Some(first), trade(1700000059, 0.25), now);
+        assert_eq!(second.volume, Some(0.75));
+
+        // 다음 분에는 새로 합산
+        let next_minute = CachedTick::update(Some(second), trade(1700000060, 0.1), now);
+        assert_eq!(next_minute.volume, Some(0.1));
+
+        // 캔들 거래량은 누적값이므로 더하지 않고 교체
+        let candle = PriceTick {
+            volume: Some(TickVolume::Candle(4.0)),
+            ..trade(1700000061, 0.0)
+        };
+        assert_eq!(
+            CachedTick::update(Some(next_minute), candle, now).volume,
+            Some(4.0)
+        );
+    }
+}
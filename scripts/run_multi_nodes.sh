@@ -9,7 +9,7 @@ echo "================================================"
 # Aggregator가 실행 중인지 확인
 if ! pgrep -f "aggregator" > /dev/null; then
     echo "❌ Aggregator is not running!"
-    echo "💡 Please start the aggregator first: cargo run -p aggregator"
+    echo "💡 Please start the aggregator first: cargo run -p aggregator -- --allow-tofu"
     exit 1
 fi
 
@@ -21,21 +21,21 @@ mkdir -p logs
 
 # Node 1: Binance
 echo "🟡 Starting Oracle Node 1 (Binance)..."
-cargo run -p oracle-node -- --exchange binance --node-id oracle-node-1 > logs/node1_binance.log 2>&1 &
+cargo run -p oracle-node -- --exchange binance --node-id oracle-node-1 --key-file data/oracle-node-1.key > logs/node1_binance.log 2>&1 &
 NODE1_PID=$!
 
 sleep 2
 
 # Node 2: Coinbase  
 echo "🔵 Starting Oracle Node 2 (Coinbase)..."
-cargo run -p oracle-node -- --exchange coinbase --node-id oracle-node-2 > logs/node2_coinbase.log 2>&1 &
+cargo run -p oracle-node -- --exchange coinbase --node-id oracle-node-2 --key-file data/oracle-node-2.key > logs/node2_coinbase.log 2>&1 &
 NODE2_PID=$!
 
 sleep 2
 
 # Node 3: Kraken
 echo "🟠 Starting Oracle Node 3 (Kraken)..."
-cargo run -p oracle-node -- --exchange kraken --node-id oracle-node-3 > logs/node3_kraken.log 2>&1 &
+cargo run -p oracle-node -- --exchange kraken --node-id oracle-node-3 --key-file data/oracle-node-3.key > logs/node3_kraken.log 2>&1 &
 NODE3_PID=$!
 
 echo ""